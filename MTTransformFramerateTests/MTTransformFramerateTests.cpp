@@ -33,11 +33,17 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <cstdio>
+#include <atomic>
+#include <algorithm>
 
 #include "blipvert.h"
 #include "Utilities.h"
 #include "YUVtoRGB.h"
 #include "ToFillColor.h"
+#include "TransformPlan.h"
+#include "ThreadPool.h"
+#include "Numa.h"
 
 using namespace std;
 using namespace blipvert;
@@ -153,8 +159,9 @@ void FramerateTest(const MediaFormatID& in_format, const MediaFormatID& out_form
             });
     }
 
-    t_stagetransformfunc pstage_in = FindTransformStage(in_format);
-    t_stagetransformfunc pstage_out = FindTransformStage(out_format);
+    // Stage the slices once. Each frame only rebases them onto the buffers.
+    TransformPlan plan;
+    CreateTransformPlan(plan, in_format, out_format, width, height, 0, 0, false, false, static_cast<uint8_t>(thread_count));
 
     Log("Framerate test: " + string(in_format) + " to " + string(out_format));
 
@@ -169,8 +176,7 @@ void FramerateTest(const MediaFormatID& in_format, const MediaFormatID& out_form
             for (int i = 0; i < thread_count; ++i)
             {
                 TransformStage work;
-                pstage_in(&work.inStage, i, thread_count, width, height, inBuf.get(), 0, false, nullptr);
-                pstage_out(&work.outStage, i, thread_count, width, height, outBuf.get(), 0, false, nullptr);
+                StageTransformPlan(plan, i, inBuf.get(), outBuf.get(), work);
 
                 jobQueue.push(move(work));
             }
@@ -198,6 +204,429 @@ void FramerateTest(const MediaFormatID& in_format, const MediaFormatID& out_form
         t.join();
 }
 
+// Per frame synchronization cost of the job queue above against the library's worker pool.
+// Each pattern is timed once with an empty slice function, which leaves only the hand-off and the
+// wait for the frame, and once doing the YUY2 to RGB32 transform.
+
+static void __cdecl EmptySlice(void*, uint8_t)
+{
+}
+
+typedef struct {
+    const TransformPlan* plan;
+    uint8_t* in_buf;
+    uint8_t* out_buf;
+} SyncTestFrame;
+
+static void __cdecl PlanSlice(void* context, uint8_t slice_index)
+{
+    SyncTestFrame* frame = static_cast<SyncTestFrame*>(context);
+    ExecuteTransformPlanSlice(*frame->plan, slice_index, frame->in_buf, frame->out_buf);
+}
+
+// Returns the average microseconds per frame for the queue pattern.
+double QueueFrameTime(const TransformPlan& plan, uint8_t* in_buf, uint8_t* out_buf, bool transform, int frames)
+{
+    queue<uint8_t> jobQueue;
+    mutex queueMutex;
+    condition_variable cv;
+    bool shutdown = false;
+    int jobsPending = 0;
+
+    vector<thread> workers;
+    for (int i = 0; i < plan.thread_count; ++i)
+    {
+        workers.emplace_back([&]() {
+            while (true)
+            {
+                uint8_t slice;
+                {
+                    unique_lock<mutex> lock(queueMutex);
+                    cv.wait(lock, [&]() { return !jobQueue.empty() || shutdown; });
+
+                    if (shutdown && jobQueue.empty())
+                        return;
+
+                    slice = jobQueue.front();
+                    jobQueue.pop();
+                }
+
+                if (transform)
+                    ExecuteTransformPlanSlice(plan, slice, in_buf, out_buf);
+
+                {
+                    lock_guard<mutex> lock(queueMutex);
+                    --jobsPending;
+                    if (jobsPending == 0)
+                        cv.notify_all();
+                }
+            }
+            });
+    }
+
+    auto start = chrono::steady_clock::now();
+
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            jobsPending = plan.thread_count;
+            for (uint8_t i = 0; i < plan.thread_count; ++i)
+                jobQueue.push(i);
+        }
+
+        cv.notify_all();
+
+        {
+            unique_lock<mutex> lock(queueMutex);
+            cv.wait(lock, [&]() { return jobsPending == 0; });
+        }
+    }
+
+    auto end = chrono::steady_clock::now();
+
+    {
+        lock_guard<mutex> lock(queueMutex);
+        shutdown = true;
+    }
+    cv.notify_all();
+    for (auto& t : workers)
+        t.join();
+
+    return static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(end - start).count()) / 1000.0 / frames;
+}
+
+// Returns the average microseconds per frame for the worker pool.
+double PoolFrameTime(const TransformPlan& plan, uint8_t* in_buf, uint8_t* out_buf, bool transform, int frames)
+{
+    SyncTestFrame context = { &plan, in_buf, out_buf };
+    t_slicefunc func = transform ? PlanSlice : EmptySlice;
+
+    // Warm the pool up so thread creation isn't timed.
+    RunSlices(func, &context, plan.thread_count);
+
+    auto start = chrono::steady_clock::now();
+
+    for (int frame = 0; frame < frames; ++frame)
+        RunSlices(func, &context, plan.thread_count);
+
+    auto end = chrono::steady_clock::now();
+    return static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(end - start).count()) / 1000.0 / frames;
+}
+
+string FormatMicroseconds(double us)
+{
+    char text[32];
+    snprintf(text, sizeof(text), "%9.1f us", us);
+    return string(text);
+}
+
+void SyncOverheadTest(int thread_count)
+{
+    const uint32_t resolutions[][2] = { { 1280, 720 }, { 1920, 1080 }, { 3840, 2160 } };
+
+    LogLine("Per-frame synchronization overhead, job queue vs. worker pool, YUY2 to RGB32...\n");
+
+    for (const auto& resolution : resolutions)
+    {
+        TransformPlan plan;
+        CreateTransformPlan(plan, MVFMT_YUY2, MVFMT_RGB32, resolution[0], resolution[1], 0, 0, false, false, static_cast<uint8_t>(thread_count));
+
+        uint32_t inBufSize = CalculateBufferSize(MVFMT_YUY2, resolution[0], resolution[1]);
+        uint32_t outBufSize = CalculateBufferSize(MVFMT_RGB32, resolution[0], resolution[1]);
+        unique_ptr<uint8_t[]> inBuf(new uint8_t[inBufSize]);
+        unique_ptr<uint8_t[]> outBuf(new uint8_t[outBufSize]);
+        memset(inBuf.get(), 128, inBufSize);
+
+        double queue_sync = QueueFrameTime(plan, inBuf.get(), outBuf.get(), false, 2000);
+        double pool_sync = PoolFrameTime(plan, inBuf.get(), outBuf.get(), false, 2000);
+        double queue_frame = QueueFrameTime(plan, inBuf.get(), outBuf.get(), true, numframes);
+        double pool_frame = PoolFrameTime(plan, inBuf.get(), outBuf.get(), true, numframes);
+
+        LogLine(to_string(resolution[0]) + " x " + to_string(resolution[1]) + " with " + to_string(plan.thread_count) + " slices:");
+        LogLine("    sync only:  queue " + FormatMicroseconds(queue_sync) + ", pool " + FormatMicroseconds(pool_sync));
+        LogLine("    transform:  queue " + FormatMicroseconds(queue_frame) + ", pool " + FormatMicroseconds(pool_frame));
+    }
+
+    LogLine("");
+}
+
+// Frame time spread of one fixed slice per thread against small row bands that the workers claim as they free up.
+// Each frame is timed on its own, first on quiet cores and then with busy threads running alongside the pool, the
+// way a neighbouring process or a slower efficiency core holds up whichever slice it lands on.
+
+typedef struct {
+    double p50;
+    double p99;
+    double max;
+} FrameTimes;
+
+// Returns the median, 99th percentile and slowest microseconds per frame for the plan on the worker pool.
+FrameTimes PlanFrameTimes(const TransformPlan& plan, uint8_t* in_buf, uint8_t* out_buf, int frames)
+{
+    ExecuteTransformPlanParallel(plan, in_buf, out_buf);
+
+    vector<double> times;
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        auto start = chrono::steady_clock::now();
+        ExecuteTransformPlanParallel(plan, in_buf, out_buf);
+        auto end = chrono::steady_clock::now();
+        times.push_back(static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(end - start).count()) / 1000.0);
+    }
+
+    sort(times.begin(), times.end());
+    FrameTimes result;
+    result.p50 = times[times.size() / 2];
+    result.p99 = times[min(times.size() - 1, (times.size() * 99) / 100)];
+    result.max = times.back();
+    return result;
+}
+
+string FormatFrameTimes(const FrameTimes& times)
+{
+    return "p50 " + FormatMicroseconds(times.p50) + ", p99 " + FormatMicroseconds(times.p99) + ", max " + FormatMicroseconds(times.max);
+}
+
+void TailLatencyTest(int thread_count)
+{
+    const uint32_t resolutions[][2] = { { 1920, 1080 }, { 3840, 2160 } };
+    const int frames = 500;
+
+    LogLine("Frame time spread, fixed slices vs. row bands, YUY2 to RGB32...\n");
+
+    for (int busy_count : { 0, 1, thread_count / 2 })
+    {
+        if (busy_count == thread_count / 2 && busy_count <= 1)
+            continue;
+
+        // Busy threads that compete with the pool for the cores until the test is done.
+        atomic<bool> stop_busy(false);
+        vector<thread> busy;
+        for (int i = 0; i < busy_count; ++i)
+        {
+            busy.emplace_back([&]() {
+                volatile uint64_t spin = 0;
+                while (!stop_busy.load(memory_order_relaxed))
+                    spin = spin + 1;
+                });
+        }
+
+        for (const auto& resolution : resolutions)
+        {
+            TransformPlan sliced;
+            TransformPlan banded;
+            CreateTransformPlan(sliced, MVFMT_YUY2, MVFMT_RGB32, resolution[0], resolution[1], 0, 0, false, false, static_cast<uint8_t>(thread_count));
+            CreateTransformPlan(banded, MVFMT_YUY2, MVFMT_RGB32, resolution[0], resolution[1], 0, 0, false, false, GetBandCount(resolution[1]));
+
+            uint32_t inBufSize = CalculateBufferSize(MVFMT_YUY2, resolution[0], resolution[1]);
+            uint32_t outBufSize = CalculateBufferSize(MVFMT_RGB32, resolution[0], resolution[1]);
+            unique_ptr<uint8_t[]> inBuf(new uint8_t[inBufSize]);
+            unique_ptr<uint8_t[]> outBuf(new uint8_t[outBufSize]);
+            memset(inBuf.get(), 128, inBufSize);
+
+            FrameTimes sliced_times = PlanFrameTimes(sliced, inBuf.get(), outBuf.get(), frames);
+            FrameTimes banded_times = PlanFrameTimes(banded, inBuf.get(), outBuf.get(), frames);
+
+            LogLine(to_string(resolution[0]) + " x " + to_string(resolution[1]) + " with " + to_string(busy_count) + " busy threads:");
+            LogLine("    " + to_string(sliced.thread_count) + " slices: " + FormatFrameTimes(sliced_times));
+            LogLine("    " + to_string(banded.thread_count) + " bands:  " + FormatFrameTimes(banded_times));
+        }
+
+        stop_busy.store(true);
+        for (auto& t : busy)
+            t.join();
+    }
+
+    LogLine("");
+}
+
+// Frames run back to back with ExecuteTransformPlanParallel(), which waits for each frame's last slice before the
+// next one starts, against frames handed to SubmitTransform() with up to 2, 4 and 8 in flight, where the workers
+// start on the next frame while the last slices of the one before finish. The submit time is how long the
+// submitting thread, such as a capture thread, is held up handing off each frame.
+
+typedef struct {
+    double frame;
+    double submit;
+} PipelineTimes;
+
+static void __cdecl ClearInFlight(void* context)
+{
+    static_cast<atomic<bool>*>(context)->store(false, memory_order_release);
+}
+
+// Returns the average microseconds per frame, and per SubmitTransform() call, with up to depth frames in flight.
+PipelineTimes PipelinedFrameTimes(const TransformPlan& plan, uint8_t* in_buf, vector<unique_ptr<uint8_t[]>>& out_bufs, int depth, int frames)
+{
+    vector<TransformJob> jobs(depth);
+    unique_ptr<atomic<bool>[]> in_flight(new atomic<bool>[depth]);
+    for (int index = 0; index < depth; ++index)
+        in_flight[index].store(false);
+
+    double submit_us = 0.0;
+    auto start = chrono::steady_clock::now();
+
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        int index = frame % depth;
+        while (in_flight[index].load(memory_order_acquire))
+            this_thread::yield();
+
+        in_flight[index].store(true);
+        auto submit_start = chrono::steady_clock::now();
+        SubmitTransform(plan, in_buf, out_bufs[index].get(), jobs[index], ClearInFlight, &in_flight[index]);
+        auto submit_end = chrono::steady_clock::now();
+        submit_us += static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(submit_end - submit_start).count()) / 1000.0;
+    }
+
+    for (int index = 0; index < depth; ++index)
+    {
+        while (in_flight[index].load(memory_order_acquire))
+            this_thread::yield();
+    }
+
+    auto end = chrono::steady_clock::now();
+    PipelineTimes result;
+    result.frame = static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(end - start).count()) / 1000.0 / frames;
+    result.submit = submit_us / frames;
+    return result;
+}
+
+void PipelineTest(int thread_count)
+{
+    const uint32_t resolutions[][2] = { { 1920, 1080 }, { 3840, 2160 } };
+    const int frames = 500;
+
+    LogLine("Blocking vs. pipelined frames, YUY2 to RGB32...\n");
+
+    for (const auto& resolution : resolutions)
+    {
+        TransformPlan plan;
+        CreateTransformPlan(plan, MVFMT_YUY2, MVFMT_RGB32, resolution[0], resolution[1], 0, 0, false, false, static_cast<uint8_t>(thread_count));
+
+        uint32_t inBufSize = CalculateBufferSize(MVFMT_YUY2, resolution[0], resolution[1]);
+        uint32_t outBufSize = CalculateBufferSize(MVFMT_RGB32, resolution[0], resolution[1]);
+        unique_ptr<uint8_t[]> inBuf(new uint8_t[inBufSize]);
+        memset(inBuf.get(), 128, inBufSize);
+
+        // One output frame per frame in flight.
+        vector<unique_ptr<uint8_t[]>> outBufs;
+        for (int index = 0; index < 8; ++index)
+            outBufs.emplace_back(new uint8_t[outBufSize]);
+
+        double blocking = PoolFrameTime(plan, inBuf.get(), outBufs[0].get(), true, frames);
+
+        LogLine(to_string(resolution[0]) + " x " + to_string(resolution[1]) + " with " + to_string(plan.thread_count) + " slices:");
+        LogLine("    blocking:     " + FormatMicroseconds(blocking) + " per frame");
+        for (int depth : { 2, 4, 8 })
+        {
+            PipelineTimes times = PipelinedFrameTimes(plan, inBuf.get(), outBufs, depth, frames);
+            LogLine("    " + to_string(depth) + " in flight:  " + FormatMicroseconds(times.frame) + " per frame, submit " + FormatMicroseconds(times.submit));
+        }
+    }
+
+    LogLine("");
+}
+
+// Throughput of a 4K YUY2 to RGB32 frame with its buffers in each node's memory, transformed by workers pinned to
+// each node's processors, then by a pool that keeps every frame on the node holding it. On a machine with one node
+// only the same-node numbers are shown.
+
+// Returns the GB/s read and written for frames run on the worker pool.
+double PoolThroughput(uint8_t* in_buf, uint32_t in_size, uint8_t* out_buf, uint32_t out_size, uint8_t thread_count, int frames)
+{
+    ParallelTransform(MVFMT_YUY2, MVFMT_RGB32, 3840, 2160, in_buf, 0, out_buf, 0, thread_count);
+
+    auto start = chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; ++frame)
+        ParallelTransform(MVFMT_YUY2, MVFMT_RGB32, 3840, 2160, in_buf, 0, out_buf, 0, thread_count);
+    auto end = chrono::steady_clock::now();
+
+    double seconds = static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(end - start).count()) / 1e9;
+    return static_cast<double>(in_size + out_size) * frames / seconds / 1e9;
+}
+
+string FormatThroughput(double gbps)
+{
+    char text[32];
+    snprintf(text, sizeof(text), "%6.2f GB/s", gbps);
+    return string(text);
+}
+
+void NumaPlacementTest()
+{
+    const int frames = 100;
+    uint32_t inBufSize = CalculateBufferSize(MVFMT_YUY2, 3840, 2160);
+    uint32_t outBufSize = CalculateBufferSize(MVFMT_RGB32, 3840, 2160);
+
+    vector<vector<uint32_t>> node_cpus;
+    vector<uint32_t> all_cpus;
+    for (uint32_t node = 0; node < GetNumaNodeCount(); node++)
+    {
+        vector<uint32_t> cpus;
+        GetNumaNodeCpus(node, cpus);
+        node_cpus.push_back(cpus);
+        all_cpus.insert(all_cpus.end(), cpus.begin(), cpus.end());
+    }
+
+    LogLine("NUMA placement, 3840 x 2160 YUY2 to RGB32, " + to_string(node_cpus.size()) + " node(s)...\n");
+
+    ThreadPoolOptions saved;
+    GetThreadPoolOptions(saved);
+
+    for (uint32_t memory_node = 0; memory_node < node_cpus.size(); memory_node++)
+    {
+        if (node_cpus[memory_node].empty())
+            continue;
+
+        uint8_t* inBuf = AllocateNodeBuffer(inBufSize, static_cast<int32_t>(memory_node));
+        uint8_t* outBuf = AllocateNodeBuffer(outBufSize, static_cast<int32_t>(memory_node));
+        if (inBuf == nullptr || outBuf == nullptr)
+        {
+            FreeNodeBuffer(inBuf, inBufSize);
+            FreeNodeBuffer(outBuf, outBufSize);
+            continue;
+        }
+
+        memset(inBuf, 128, inBufSize);
+        memset(outBuf, 0, outBufSize);
+
+        for (uint32_t cpu_node = 0; cpu_node < node_cpus.size(); cpu_node++)
+        {
+            const vector<uint32_t>& cpus = node_cpus[cpu_node];
+            if (cpus.empty())
+                continue;
+
+            // The calling thread runs slices too, so it's pinned to the node with the workers.
+            ThreadPoolOptions options = { static_cast<uint32_t>(cpus.size() > 1 ? cpus.size() - 1 : 1), { cpus }, false };
+            SetThreadPoolOptions(options);
+            SetCurrentThreadCpus(cpus);
+
+            uint8_t thread_count = static_cast<uint8_t>(min<size_t>(cpus.size(), 255));
+            double gbps = PoolThroughput(inBuf, inBufSize, outBuf, outBufSize, thread_count, frames);
+            LogLine("    memory on node " + to_string(memory_node) + ", threads on node " + to_string(cpu_node) + ": " +
+                FormatThroughput(gbps) + (memory_node == cpu_node ? " (same node)" : " (cross node)"));
+        }
+
+        // Workers on every node, with each frame kept on the node holding it.
+        ThreadPoolOptions options = { static_cast<uint32_t>(all_cpus.size()), {}, true };
+        SetThreadPoolOptions(options);
+        SetCurrentThreadCpus(all_cpus);
+
+        uint8_t thread_count = static_cast<uint8_t>(min<size_t>(node_cpus[memory_node].size(), 255));
+        double gbps = PoolThroughput(inBuf, inBufSize, outBuf, outBufSize, thread_count, frames);
+        LogLine("    memory on node " + to_string(memory_node) + ", numa_local pool:   " + FormatThroughput(gbps));
+
+        FreeNodeBuffer(inBuf, inBufSize);
+        FreeNodeBuffer(outBuf, outBufSize);
+    }
+
+    SetThreadPoolOptions(saved);
+    SetCurrentThreadCpus(all_cpus);
+    LogLine("");
+}
+
 void RunTest(const MediaFormatID& in_format, const MediaFormatID& out_format)
 {
     FramerateTest(in_format, out_format, 128, 128, 128, 255);
@@ -250,6 +679,11 @@ int main()
 
     auto start = chrono::steady_clock::now();
 
+    SyncOverheadTest(thread_count);
+    TailLatencyTest(thread_count);
+    PipelineTest(thread_count);
+    NumaPlacementTest();
+
     width = 1920;
     height = 1080;
     RunAllTransforms(thread_count);
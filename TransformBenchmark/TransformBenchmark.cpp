@@ -0,0 +1,705 @@
+//
+//  blipvert C++ library
+//
+//  MIT License
+//
+//  Copyright(c) 2021-2025 Don Jordan
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+//
+
+//
+// This console application benchmarks every transform in the library's transform and in-place transform tables,
+// along with the greyscale and vertical flip (single and multi-threaded), fill color and staging functions for each
+// format, fan-out conversions and RGB32 output with and without streaming stores. A memcpy of a YUY2 frame
+// is run first as the memory bandwidth ceiling. Each function is run over frames of color bar and noise content
+// after its buffers and caches have been warmed, and every frame is timed on its own so the results can be given
+// as ns/frame percentiles as well as GB/s and cycles/pixel.
+//
+// The summary goes to the console and, with --json, to a JSON file that can be diffed between releases
+// and processors. It only uses standard C++ and the library, so it builds anywhere the library does. On
+// Linux, from the repository root:
+//
+//    g++ -std=c++17 -O2 -pthread -Iblipvert blipvert/*.cpp TransformBenchmark/TransformBenchmark.cpp -o benchmark
+//
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <array>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+
+#include "blipvert.h"
+#include "CpuFeatures.h"
+#include "LookupTables.h"
+#include "Utilities.h"
+#include "TransformPlan.h"
+#include "ThreadPool.h"
+
+#if defined(BLIPVERT_X86_SIMD)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+using namespace std;
+using namespace blipvert;
+
+int32_t width = 1920;
+int32_t height = 1080;
+int32_t iterations = 200;
+int32_t warmup = 5;
+string content = "mixed";
+string filter;
+string jsonPath;
+
+vector<uint8_t> sourceFrame;    // RGB32 frame that each input buffer is converted from.
+
+// Palettes handed to the staging functions. The palettized formats need one and the others ignore it.
+array<xRGBQUAD, 256> inPalette = rgb8_greyscale_palette;
+array<xRGBQUAD, 256> outPalette = rgb8_greyscale_palette;
+
+typedef struct BenchmarkResult {
+    string kind;                // memcpy, transform, inplace, greyscale, greyscalemt, fill, flip, flipmt, staging, separate, fanout,
+                                // cached or stream.
+    string in_format;
+    string out_format;          // Only set for transforms and fan-outs.
+    double mean_ns;
+    double min_ns;
+    double p50_ns;
+    double p90_ns;
+    double p99_ns;
+    double max_ns;
+    double gb_per_sec;          // Bytes read plus bytes written, per second.
+    double cycles_per_pixel;    // Time stamp counter ticks per pixel, or -1 if there's no counter.
+} BenchmarkResult;
+
+vector<BenchmarkResult> results;
+
+// Reads the processor's time stamp counter. It ticks at a constant reference rate rather than the core
+// clock, so cycles/pixel is comparable between runs on a machine but drifts with turbo and power states.
+static inline uint64_t ReadCycleCounter()
+{
+#if defined(BLIPVERT_X86_SIMD)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static bool HasCycleCounter()
+{
+#if defined(BLIPVERT_X86_SIMD)
+    return true;
+#else
+    return false;
+#endif
+}
+
+//
+// Builds the RGB32 source frame. "bars" is the eight 75% color bars with a little grain, "noise" is
+// uniform random pixels and "mixed" is bars over the top half of the frame and noise over the bottom.
+// The bars give the transforms long runs of similar chroma and the noise gives them none. The seed is
+// fixed so every run sees the same frame.
+//
+void MakeSourceFrame()
+{
+    static const uint8_t bars[8][3] = {
+        { 191, 191, 191 }, { 191, 191, 0 }, { 0, 191, 191 }, { 0, 191, 0 },
+        { 191, 0, 191 }, { 191, 0, 0 }, { 0, 0, 191 }, { 16, 16, 16 }
+    };
+
+    mt19937 rng(0x626C6970);
+    uniform_int_distribution<int> pixel(0, 255);
+    uniform_int_distribution<int> grain(-6, 6);
+
+    sourceFrame.assign(static_cast<size_t>(width) * height * 4, 0);
+    uint8_t* pdst = sourceFrame.data();
+    for (int32_t y = 0; y < height; y++)
+    {
+        bool noise = content == "noise" || (content == "mixed" && y >= height / 2);
+        for (int32_t x = 0; x < width; x++)
+        {
+            const uint8_t* bar = bars[(x * 8) / width];
+            for (int component = 0; component < 3; component++)
+            {
+                if (noise)
+                {
+                    pdst[2 - component] = static_cast<uint8_t>(pixel(rng));
+                }
+                else
+                {
+                    pdst[2 - component] = static_cast<uint8_t>(min(255, max(0, bar[component] + grain(rng))));
+                }
+            }
+
+            pdst[3] = 0xFF;
+            pdst += 4;
+        }
+    }
+}
+
+// Fills buf with the source frame converted to the given format. Formats the library can't produce
+// from RGB32 get random bytes instead.
+void FillContent(const MediaFormatID& format, vector<uint8_t>& buf)
+{
+    if (format == MVFMT_RGB32 && buf.size() == sourceFrame.size())
+    {
+        memcpy(buf.data(), sourceFrame.data(), buf.size());
+        return;
+    }
+
+    t_transformfunc transform = FindVideoTransform(MVFMT_RGB32, format);
+    t_stagetransformfunc in_stage = FindTransformStage(MVFMT_RGB32);
+    t_stagetransformfunc out_stage = FindTransformStage(format);
+    if (transform && in_stage && out_stage)
+    {
+        Stage in;
+        Stage out;
+        in_stage(&in, 0, 1, width, height, sourceFrame.data(), 0, false, nullptr);
+        out_stage(&out, 0, 1, width, height, buf.data(), 0, false, outPalette.data());
+        transform(&in, &out);
+        return;
+    }
+
+    mt19937 rng(0x626C6970);
+    for (auto& value : buf)
+    {
+        value = static_cast<uint8_t>(rng());
+    }
+}
+
+// Returns the value at the given fraction of the sorted samples, using the nearest rank.
+double Percentile(const vector<double>& sorted, double fraction)
+{
+    size_t rank = static_cast<size_t>(fraction * static_cast<double>(sorted.size()) + 0.5);
+    rank = min(max(rank, static_cast<size_t>(1)), sorted.size());
+    return sorted[rank - 1];
+}
+
+//
+// Runs frame() warmup times untimed, then iterations times with each call timed on its own, and
+// records the result. bytes_per_frame is the memory the function reads and writes for one frame.
+//
+template <typename F>
+void Measure(const string& kind, const MediaFormatID& in_format, const MediaFormatID& out_format, uint64_t bytes_per_frame, F frame)
+{
+    for (int32_t count = 0; count < warmup; count++)
+    {
+        frame();
+    }
+
+    vector<double> times(iterations);
+    uint64_t cycles = 0;
+    for (int32_t count = 0; count < iterations; count++)
+    {
+        auto start = chrono::steady_clock::now();
+        uint64_t start_cycles = ReadCycleCounter();
+        frame();
+        uint64_t end_cycles = ReadCycleCounter();
+        auto end = chrono::steady_clock::now();
+
+        cycles += end_cycles - start_cycles;
+        times[count] = static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(end - start).count());
+    }
+
+    double total = 0.0;
+    for (double time : times)
+    {
+        total += time;
+    }
+
+    sort(times.begin(), times.end());
+
+    BenchmarkResult result;
+    result.kind = kind;
+    result.in_format = in_format;
+    result.out_format = out_format;
+    result.mean_ns = total / iterations;
+    result.min_ns = times.front();
+    result.p50_ns = Percentile(times, 0.50);
+    result.p90_ns = Percentile(times, 0.90);
+    result.p99_ns = Percentile(times, 0.99);
+    result.max_ns = times.back();
+    result.gb_per_sec = result.mean_ns > 0.0 ? static_cast<double>(bytes_per_frame) / result.mean_ns : 0.0;
+    result.cycles_per_pixel = HasCycleCounter() ?
+        static_cast<double>(cycles) / (static_cast<double>(iterations) * width * height) : -1.0;
+    results.push_back(result);
+
+    string name = out_format.empty() ? kind + " " + string(in_format) : string(in_format) + " to " + string(out_format);
+    if (kind != "transform" && !out_format.empty())
+        name = kind + " " + name;
+
+    ostringstream line;
+    line << fixed << left << setw(36) << name << right
+        << setprecision(0) << setw(12) << result.mean_ns
+        << setw(12) << result.p50_ns
+        << setw(12) << result.p99_ns
+        << setprecision(2) << setw(9) << result.gb_per_sec;
+    if (HasCycleCounter())
+        line << setw(9) << result.cycles_per_pixel;
+    cout << line.str() << endl;
+}
+
+bool Selected(const string& name)
+{
+    return filter.empty() || name.find(filter) != string::npos;
+}
+
+void BenchmarkTransform(const MediaFormatID& in_format, const MediaFormatID& out_format)
+{
+    if (!Selected(string(in_format) + " to " + string(out_format)))
+        return;
+
+    t_transformfunc transform = FindVideoTransform(in_format, out_format);
+    t_stagetransformfunc in_stage = FindTransformStage(in_format);
+    t_stagetransformfunc out_stage = FindTransformStage(out_format);
+    if (!transform || !in_stage || !out_stage)
+    {
+        cout << string(in_format) + " to " + string(out_format) + " skipped: no transform or staging function." << endl;
+        return;
+    }
+
+    uint32_t in_size = CalculateBufferSize(in_format, width, height);
+    uint32_t out_size = CalculateBufferSize(out_format, width, height);
+
+    // The vectors are zero filled, which also faults in every page before the warmup frames run.
+    vector<uint8_t> in_buf(in_size);
+    vector<uint8_t> out_buf(out_size);
+    FillContent(in_format, in_buf);
+
+    Stage in;
+    Stage out;
+    in_stage(&in, 0, 1, width, height, in_buf.data(), 0, false, inPalette.data());
+    out_stage(&out, 0, 1, width, height, out_buf.data(), 0, false, outPalette.data());
+
+    Measure("transform", in_format, out_format, static_cast<uint64_t>(in_size) + out_size, [&]() {
+        transform(&in, &out);
+        });
+}
+
+// Converts a frame in its own buffer, charged for reading the input and writing the output at the input stride.
+void BenchmarkInPlaceTransform(const MediaFormatID& in_format, const MediaFormatID& out_format)
+{
+    t_transformfunc transform = FindInPlaceTransform(in_format, out_format);
+    if (!transform || !Selected("inplace " + string(in_format) + " to " + string(out_format)))
+        return;
+
+    t_stagetransformfunc in_stage = FindTransformStage(in_format);
+    t_stagetransformfunc out_stage = FindTransformStage(out_format);
+    int32_t stride = CalculateMinimumLineStride(in_format, width, height);
+    uint32_t in_size = CalculateBufferSize(in_format, width, height, stride);
+    uint32_t out_size = CalculateBufferSize(out_format, width, height, stride);
+
+    vector<uint8_t> buf(in_size);
+    FillContent(in_format, buf);
+
+    Stage in;
+    Stage out;
+    in_stage(&in, 0, 1, width, height, buf.data(), stride, false, inPalette.data());
+    out_stage(&out, 0, 1, width, height, buf.data(), stride, false, outPalette.data());
+
+    Measure("inplace", in_format, out_format, static_cast<uint64_t>(in_size) + out_size, [&]() {
+        transform(&in, &out);
+        });
+}
+
+//
+// A memcpy of a YUY2 frame, charged for reading and writing it. Transforms that only move bytes around,
+// such as the packed 4:2:2 swizzles, can't go faster than this, so their GB/s compare directly.
+//
+void BenchmarkCopy()
+{
+    if (!Selected("memcpy " + string(MVFMT_YUY2)))
+        return;
+
+    uint32_t size = CalculateBufferSize(MVFMT_YUY2, width, height);
+    vector<uint8_t> in_buf(size);
+    vector<uint8_t> out_buf(size);
+    FillContent(MVFMT_YUY2, in_buf);
+
+    Measure("memcpy", MVFMT_YUY2, MVFMT_UNDEFINED, 2ULL * size, [&]() {
+        memcpy(out_buf.data(), in_buf.data(), size);
+        });
+}
+
+//
+// Greyscale, fill, flip and staging work on one buffer of the given format. Greyscale and flip run in
+// place, so they're charged for reading and writing the frame. Staging doesn't touch the frame at all.
+//
+void BenchmarkFormatFunctions(const MediaFormatID& format)
+{
+    uint32_t size = CalculateBufferSize(format, width, height);
+    vector<uint8_t> buf(size);
+
+    t_greyscalefunc greyscale = FindGreyscaleTransform(format);
+    if (greyscale && Selected("greyscale " + string(format)))
+    {
+        FillContent(format, buf);
+        Measure("greyscale", format, MVFMT_UNDEFINED, 2ULL * size, [&]() {
+            greyscale(width, height, buf.data(), 0, outPalette.data());
+            });
+    }
+
+    if (greyscale && Selected("greyscalemt " + string(format)))
+    {
+        uint8_t thread_count = static_cast<uint8_t>(min<uint32_t>(GetThreadPoolSize() + 1, 255));
+        FillContent(format, buf);
+        Measure("greyscalemt", format, MVFMT_UNDEFINED, 2ULL * size, [&]() {
+            ParallelGreyscale(format, width, height, buf.data(), 0, thread_count, outPalette.data());
+            });
+    }
+
+    t_fillcolorfunc fill = FindFillColorTransform(format);
+    if (fill && Selected("fill " + string(format)))
+    {
+        Measure("fill", format, MVFMT_UNDEFINED, size, [&]() {
+            fill(128, 128, 128, 255, width, height, buf.data(), 0);
+            });
+    }
+
+    t_flipverticalfunc flip = FindFlipVerticalTransform(format);
+    if (flip && Selected("flip " + string(format)))
+    {
+        FillContent(format, buf);
+        Measure("flip", format, MVFMT_UNDEFINED, 2ULL * size, [&]() {
+            flip(width, height, buf.data(), 0);
+            });
+    }
+
+    if (flip && Selected("flipmt " + string(format)))
+    {
+        // One slice for each worker and one for the calling thread.
+        uint8_t thread_count = static_cast<uint8_t>(min<uint32_t>(GetThreadPoolSize() + 1, 255));
+        FillContent(format, buf);
+        Measure("flipmt", format, MVFMT_UNDEFINED, 2ULL * size, [&]() {
+            ParallelFlipVertical(format, width, height, buf.data(), 0, thread_count);
+            });
+    }
+
+    t_stagetransformfunc stage = FindTransformStage(format);
+    if (stage && Selected("staging " + string(format)))
+    {
+        Stage result;
+        Measure("staging", format, MVFMT_UNDEFINED, 0, [&]() {
+            stage(&result, 0, 1, width, height, buf.data(), 0, false, inPalette.data());
+            });
+    }
+}
+
+//
+// Converts one input to RGB32, I420 and Y800, the preview, encoder and analytics copies of a camera frame,
+// first with three whole-frame transforms and then with a fan-out plan. Both are charged for the same bytes,
+// so the GB/s figures compare directly.
+//
+void BenchmarkFanOut(const MediaFormatID& in_format)
+{
+    vector<MediaFormatID> out_formats = { MVFMT_RGB32, MVFMT_I420, MVFMT_Y800 };
+    string outputs = "RGB32+I420+Y800";
+    bool separate_selected = Selected("separate " + string(in_format) + " to " + outputs);
+    bool fanout_selected = Selected("fanout " + string(in_format) + " to " + outputs);
+    if (!separate_selected && !fanout_selected)
+        return;
+
+    FanOutPlan fanout;
+    vector<TransformPlan> separate(out_formats.size());
+    bool created = CreateFanOutPlan(fanout, in_format, out_formats, width, height);
+    for (size_t index = 0; created && index < out_formats.size(); index++)
+    {
+        created = CreateTransformPlan(separate[index], in_format, out_formats[index], width, height);
+    }
+
+    if (!created)
+    {
+        cout << "fanout " + string(in_format) + " skipped: no transform for one of the outputs." << endl;
+        return;
+    }
+
+    uint32_t in_size = CalculateBufferSize(in_format, width, height);
+    vector<uint8_t> in_buf(in_size);
+    FillContent(in_format, in_buf);
+
+    uint64_t bytes = in_size;
+    vector<vector<uint8_t>> out_bufs;
+    vector<uint8_t*> out_ptrs;
+    for (const MediaFormatID& out_format : out_formats)
+    {
+        uint32_t out_size = CalculateBufferSize(out_format, width, height);
+        bytes += out_size;
+        out_bufs.emplace_back(out_size);
+        out_ptrs.push_back(out_bufs.back().data());
+    }
+
+    if (separate_selected)
+    {
+        Measure("separate", in_format, outputs, bytes, [&]() {
+            for (size_t index = 0; index < separate.size(); index++)
+                ExecuteTransformPlan(separate[index], in_buf.data(), out_ptrs[index]);
+            });
+    }
+
+    if (fanout_selected)
+    {
+        Measure("fanout", in_format, outputs, bytes, [&]() {
+            ExecuteFanOutPlan(fanout, in_buf.data(), out_ptrs.data());
+            });
+    }
+}
+
+//
+// Converts a frame to RGB32 with a plan, first with ordinary stores and then with streaming stores that
+// bypass the cache. The output buffer is 64-byte aligned so every row of a 4-byte-multiple width can stream.
+// Streaming pays off once the output no longer fits in the last level cache; below that it's usually slower.
+//
+void BenchmarkStoreMode(const MediaFormatID& in_format)
+{
+    string name = string(in_format) + " to " + string(MVFMT_RGB32);
+    bool cached_selected = Selected("cached " + name);
+    bool stream_selected = Selected("stream " + name);
+    if (!cached_selected && !stream_selected)
+        return;
+
+    TransformPlan plan;
+    if (!CreateTransformPlan(plan, in_format, MVFMT_RGB32, width, height, 0, 0, false, false, 1, inPalette.data()))
+    {
+        cout << "stream " + name + " skipped: no transform." << endl;
+        return;
+    }
+
+    uint32_t in_size = CalculateBufferSize(in_format, width, height);
+    uint32_t out_size = CalculateBufferSize(MVFMT_RGB32, width, height);
+    vector<uint8_t> in_buf(in_size);
+    vector<uint8_t> out_store(out_size + 64);
+    uint8_t* out_buf = out_store.data() + (64 - reinterpret_cast<uintptr_t>(out_store.data()) % 64);
+    FillContent(in_format, in_buf);
+
+    if (cached_selected)
+    {
+        plan.stream_stores = false;
+        Measure("cached", in_format, MVFMT_RGB32, static_cast<uint64_t>(in_size) + out_size, [&]() {
+            ExecuteTransformPlan(plan, in_buf.data(), out_buf);
+            });
+    }
+
+    if (stream_selected)
+    {
+        plan.stream_stores = true;
+        Measure("stream", in_format, MVFMT_RGB32, static_cast<uint64_t>(in_size) + out_size, [&]() {
+            ExecuteTransformPlan(plan, in_buf.data(), out_buf);
+            });
+    }
+}
+
+string JsonString(const string& value)
+{
+    string escaped = "\"";
+    for (char c : value)
+    {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+
+    return escaped + "\"";
+}
+
+bool WriteJson(const string& path)
+{
+    ofstream file(path);
+    if (!file.is_open())
+        return false;
+
+    const CpuFeatures& features = GetCpuFeatures();
+
+    file << fixed << setprecision(3);
+    file << "{\n";
+    file << "  \"width\": " << width << ",\n";
+    file << "  \"height\": " << height << ",\n";
+    file << "  \"iterations\": " << iterations << ",\n";
+    file << "  \"warmup\": " << warmup << ",\n";
+    file << "  \"content\": " << JsonString(content) << ",\n";
+    file << "  \"fixed_point_green\": " << (IsFixedPointGreen() ? "true" : "false") << ",\n";
+    file << "  \"cycle_counter\": " << JsonString(HasCycleCounter() ? "tsc" : "none") << ",\n";
+    file << "  \"cpu\": { \"sse2\": " << (features.sse2 ? "true" : "false")
+        << ", \"ssse3\": " << (features.ssse3 ? "true" : "false")
+        << ", \"sse41\": " << (features.sse41 ? "true" : "false")
+        << ", \"avx2\": " << (features.avx2 ? "true" : "false")
+        << ", \"llc_bytes\": " << features.llc_bytes << " },\n";
+    file << "  \"results\": [\n";
+
+    for (size_t index = 0; index < results.size(); index++)
+    {
+        const BenchmarkResult& result = results[index];
+        file << "    { \"kind\": " << JsonString(result.kind)
+            << ", \"in\": " << JsonString(result.in_format);
+        if (!result.out_format.empty())
+            file << ", \"out\": " << JsonString(result.out_format);
+        file << ", \"ns_mean\": " << result.mean_ns
+            << ", \"ns_min\": " << result.min_ns
+            << ", \"ns_p50\": " << result.p50_ns
+            << ", \"ns_p90\": " << result.p90_ns
+            << ", \"ns_p99\": " << result.p99_ns
+            << ", \"ns_max\": " << result.max_ns
+            << ", \"gb_per_sec\": " << result.gb_per_sec;
+        if (result.cycles_per_pixel >= 0.0)
+            file << ", \"cycles_per_pixel\": " << result.cycles_per_pixel;
+        else
+            file << ", \"cycles_per_pixel\": null";
+        file << " }" << (index + 1 < results.size() ? "," : "") << "\n";
+    }
+
+    file << "  ]\n";
+    file << "}\n";
+    return true;
+}
+
+void Usage()
+{
+    cout << "Usage: TransformBenchmark [options]\n"
+        "  --width N         Frame width, a multiple of 4 (default 1920)\n"
+        "  --height N        Frame height, a multiple of 4 (default 1080)\n"
+        "  --iterations N    Timed frames per benchmark (default 200)\n"
+        "  --warmup N        Untimed frames run first (default 5)\n"
+        "  --content TYPE    bars, noise or mixed (default mixed)\n"
+        "  --filter TEXT     Only run benchmarks whose name contains TEXT, e.g. \"YUY2 to\", \"inplace\", \"memcpy\" or \"flip\"\n"
+        "  --json PATH       Also write the results to PATH as JSON\n";
+}
+
+bool ParseArguments(int argc, char* argv[])
+{
+    for (int index = 1; index < argc; index++)
+    {
+        string arg = argv[index];
+        if (arg == "--help" || arg == "-h")
+            return false;
+
+        if (index + 1 >= argc)
+        {
+            cerr << "Missing value for " << arg << endl;
+            return false;
+        }
+
+        string value = argv[++index];
+        if (arg == "--width")
+            width = atoi(value.c_str());
+        else if (arg == "--height")
+            height = atoi(value.c_str());
+        else if (arg == "--iterations")
+            iterations = atoi(value.c_str());
+        else if (arg == "--warmup")
+            warmup = atoi(value.c_str());
+        else if (arg == "--content")
+            content = value;
+        else if (arg == "--filter")
+            filter = value;
+        else if (arg == "--json")
+            jsonPath = value;
+        else
+        {
+            cerr << "Unknown option " << arg << endl;
+            return false;
+        }
+    }
+
+    if (width <= 0 || height <= 0 || (width % 4) != 0 || (height % 4) != 0 || iterations <= 0 || warmup < 0 ||
+        (content != "bars" && content != "noise" && content != "mixed"))
+    {
+        cerr << "Invalid option value." << endl;
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    if (!ParseArguments(argc, argv))
+    {
+        Usage();
+        return 1;
+    }
+
+    InitializeLibrary();
+    MakeSourceFrame();
+
+    cout << "Benchmarking " << width << " x " << height << ", " << content << " content, " << iterations
+        << " frames after " << warmup << " warmup frames.\n" << endl;
+
+    ostringstream header;
+    header << left << setw(36) << "Benchmark" << right << setw(12) << "mean ns" << setw(12) << "p50 ns"
+        << setw(12) << "p99 ns" << setw(9) << "GB/s";
+    if (HasCycleCounter())
+        header << setw(9) << "cyc/px";
+    cout << header.str() << endl;
+
+    vector<pair<MediaFormatID, MediaFormatID>> pairs;
+    GetTransformFormatPairs(pairs);
+
+    BenchmarkCopy();
+
+    vector<MediaFormatID> formats;
+    for (auto& pair : pairs)
+    {
+        BenchmarkTransform(pair.first, pair.second);
+        BenchmarkInPlaceTransform(pair.first, pair.second);
+
+        for (const MediaFormatID& format : { pair.first, pair.second })
+        {
+            if (find(formats.begin(), formats.end(), format) == formats.end())
+                formats.push_back(format);
+        }
+    }
+
+    for (const MediaFormatID& format : formats)
+    {
+        BenchmarkFormatFunctions(format);
+    }
+
+    for (const MediaFormatID* format : { &MVFMT_YUY2, &MVFMT_UYVY, &MVFMT_NV12, &MVFMT_YV12 })
+    {
+        BenchmarkFanOut(*format);
+    }
+
+    for (const MediaFormatID* format : { &MVFMT_YUY2, &MVFMT_UYVY, &MVFMT_RGB24, &MVFMT_RGB565, &MVFMT_RGB555, &MVFMT_RGB8 })
+    {
+        BenchmarkStoreMode(*format);
+    }
+
+    if (!jsonPath.empty())
+    {
+        if (!WriteJson(jsonPath))
+        {
+            cerr << "Error: Could not write " << jsonPath << endl;
+            return 1;
+        }
+
+        cout << "\nResults written to " << jsonPath << endl;
+    }
+
+    return 0;
+}
@@ -36,11 +36,20 @@
 #include <memory>
 #include <chrono>
 #include <vector>
+#include <random>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #include "blipvert.h"
 #include "Utilities.h"
 #include "YUVtoRGB.h"
 #include "ToFillColor.h"
+#include "LookupTables.h"
 
 using namespace std;
 using namespace blipvert;
@@ -135,6 +144,161 @@ void FramerateTest(const MediaFormatID& in_format, const MediaFormatID& out_form
     LogLine(" @ " + to_string(framerate) + " fps.");
 }
 
+// Counts L1 data cache and last level cache read misses on the calling thread. The counters come from
+// perf_event_open() on Linux; anywhere else, or when the kernel doesn't allow them, Available() is false.
+class CacheMissCounter
+{
+public:
+    CacheMissCounter()
+    {
+#if defined(__linux__)
+        l1_fd = Open(PERF_COUNT_HW_CACHE_L1D);
+        ll_fd = Open(PERF_COUNT_HW_CACHE_LL);
+#endif
+    }
+
+    ~CacheMissCounter()
+    {
+#if defined(__linux__)
+        if (l1_fd >= 0) close(l1_fd);
+        if (ll_fd >= 0) close(ll_fd);
+#endif
+    }
+
+    bool Available() const
+    {
+        return l1_fd >= 0 && ll_fd >= 0;
+    }
+
+    void Start()
+    {
+#if defined(__linux__)
+        if (!Available())
+            return;
+        ioctl(l1_fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(ll_fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(l1_fd, PERF_EVENT_IOC_ENABLE, 0);
+        ioctl(ll_fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    void Stop(uint64_t& l1_misses, uint64_t& ll_misses)
+    {
+        l1_misses = 0;
+        ll_misses = 0;
+#if defined(__linux__)
+        if (!Available())
+            return;
+        ioctl(l1_fd, PERF_EVENT_IOC_DISABLE, 0);
+        ioctl(ll_fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(l1_fd, &l1_misses, sizeof(l1_misses)) != sizeof(l1_misses)) l1_misses = 0;
+        if (read(ll_fd, &ll_misses, sizeof(ll_misses)) != sizeof(ll_misses)) ll_misses = 0;
+#endif
+    }
+
+private:
+#if defined(__linux__)
+    static int Open(uint64_t cache)
+    {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.size = sizeof(attr);
+        attr.config = cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+
+    int l1_fd = -1;
+    int ll_fd = -1;
+};
+
+// Converts several independent streams of frames to RGB32 on one thread, a frame from each in turn, to show how
+// the green term's cache footprint holds up as the working set grows. The library decides which version of the
+// green term runs; build it with and without BLIPVERT_FIXED_POINT_GREEN to compare them on a given CPU.
+// The frames hold random bytes so the chroma pairs are spread over the whole range, which is the worst case
+// for uv_table.
+void GreenTermTest(const MediaFormatID& in_format)
+{
+    const int rounds = 20;
+    t_transformfunc transform = FindVideoTransform(in_format, MVFMT_RGB32);
+    t_stagetransformfunc pstage_in = FindTransformStage(in_format);
+    t_stagetransformfunc pstage_out = FindTransformStage(MVFMT_RGB32);
+
+    uint32_t inBufSize = CalculateBufferSize(in_format, width, height);
+    uint32_t outBufSize = CalculateBufferSize(MVFMT_RGB32, width, height);
+
+    CacheMissCounter counter;
+    mt19937 generator(1);
+
+    for (int streams : { 1, 2, 4, 8 })
+    {
+        vector<unique_ptr<uint8_t[]>> inBufs;
+        vector<unique_ptr<uint8_t[]>> outBufs;
+        vector<TransformStage> stages(streams);
+        for (int index = 0; index < streams; index++)
+        {
+            inBufs.emplace_back(new uint8_t[inBufSize]);
+            outBufs.emplace_back(new uint8_t[outBufSize]);
+            for (uint32_t offset = 0; offset < inBufSize; offset++)
+                inBufs[index][offset] = static_cast<uint8_t>(generator());
+
+            pstage_in(&stages[index].inStage, 0, 1, width, height, inBufs[index].get(), 0, false, nullptr);
+            pstage_out(&stages[index].outStage, 0, 1, width, height, outBufs[index].get(), 0, false, nullptr);
+        }
+
+        counter.Start();
+        auto start = chrono::steady_clock::now();
+
+        for (int round = 0; round < rounds; round++)
+            for (auto& stage : stages)
+                transform(&stage.inStage, &stage.outStage);
+
+        auto end = chrono::steady_clock::now();
+        uint64_t l1_misses;
+        uint64_t ll_misses;
+        counter.Stop(l1_misses, ll_misses);
+
+        int frames = rounds * streams;
+        double us = static_cast<double>(chrono::duration_cast<chrono::microseconds>(end - start).count()) / frames;
+        string line = string(in_format) + " to RGB32, " + to_string(streams) + " stream(s): " + to_string(static_cast<int>(us)) + " us/frame";
+        if (counter.Available())
+            line += ", L1D misses/frame " + to_string(l1_misses / frames) + ", LLC misses/frame " + to_string(ll_misses / frames);
+        LogLine(line);
+    }
+}
+
+void RunGreenTermTests()
+{
+    LogLine("YUV to RGB green term, " + string(IsFixedPointGreen() ? "fixed-point" : "uv_table") + " build, " +
+        to_string(width) + " x " + to_string(height) + "...\n");
+
+    GreenTermTest(MVFMT_YUY2);
+    GreenTermTest(MVFMT_I420);
+
+    LogLine("");
+}
+
+//
+// Times the first InitializeLibrary() call, which is the startup cost every process that uses the library pays,
+// and a second call to show that re-initializing is free.
+//
+void StartupLatencyTest()
+{
+    auto start = chrono::steady_clock::now();
+    InitializeLibrary();
+    auto first = chrono::steady_clock::now();
+    InitializeLibrary();
+    auto second = chrono::steady_clock::now();
+
+    long long first_us = chrono::duration_cast<chrono::microseconds>(first - start).count();
+    long long second_ns = chrono::duration_cast<chrono::nanoseconds>(second - first).count();
+    LogLine("Library startup: InitializeLibrary " + to_string(first_us) + " us, repeat call " + to_string(second_ns) + " ns\n");
+}
+
 void RunTest(const MediaFormatID& in_format, const MediaFormatID& out_format)
 {
     FramerateTest(in_format, out_format, 128, 128, 128, 255);
@@ -205,12 +369,13 @@ int main()
         return 1;
     }
 
-    InitializeLibrary();
+    StartupLatencyTest();
 
     auto start = chrono::steady_clock::now();
 
     width = 1920;
     height = 1080;
+    RunGreenTermTests();
     RunAllTransforms();
 
     width = 3840;
@@ -32,6 +32,10 @@
 #include "RGBtoYUV.h"
 #include "RGBtoRGB.h"
 #include "YUVtoYUV.h"
+#include "CpuFeatures.h"
+
+#include <thread>
+#include <vector>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace blipvert;
@@ -49,17 +53,31 @@ namespace BlipvertUnitTests
 
 		TEST_METHOD(FindValidTransform_UnitTest)
 		{
+			t_transformfunc expected = PackedY422_to_RGB32;
+#if defined(BLIPVERT_X86_SIMD)
+			if (GetCpuFeatures().avx2)
+				expected = PackedY422_to_RGB32_AVX2;
+			else if (GetCpuFeatures().sse41)
+				expected = PackedY422_to_RGB32_SSE41;
+#endif
+
 			t_transformfunc func = FindVideoTransform(MVFMT_UYVY, MVFMT_RGB32);
 			Assert::IsNotNull(reinterpret_cast<void*>(func), L"FindVideoTransform returned a null function pointer.");
-			Assert::AreEqual(reinterpret_cast<void*>(PackedY422_to_RGB32), reinterpret_cast<void*>(func), L"FindVideoTransform returned the wrong function pointer.");
+			Assert::AreEqual(reinterpret_cast<void*>(expected), reinterpret_cast<void*>(func), L"FindVideoTransform returned the wrong function pointer.");
 
 			func = FindVideoTransform(MVFMT_RGB555, MVFMT_RGBA);
 			Assert::IsNotNull(reinterpret_cast<void*>(func), L"FindVideoTransform returned a null function pointer.");
 			Assert::AreEqual(reinterpret_cast<void*>(RGB555_to_RGBA), reinterpret_cast<void*>(func), L"FindVideoTransform returned the wrong function pointer.");
 
-			 func = FindVideoTransform(MVFMT_RGB32, MVFMT_RGB565);
+			expected = RGB32_to_RGB565;
+#if defined(BLIPVERT_X86_SIMD)
+			if (GetCpuFeatures().sse41)
+				expected = RGB32_to_RGB565_SSE41;
+#endif
+
+			func = FindVideoTransform(MVFMT_RGB32, MVFMT_RGB565);
 			Assert::IsNotNull(reinterpret_cast<void*>(func), L"FindVideoTransform returned a null function pointer.");
-			Assert::AreEqual(reinterpret_cast<void*>(RGB32_to_RGB565), reinterpret_cast<void*>(func), L"FindVideoTransform returned the wrong function pointer.");
+			Assert::AreEqual(reinterpret_cast<void*>(expected), reinterpret_cast<void*>(func), L"FindVideoTransform returned the wrong function pointer.");
 
 
 			func = FindVideoTransform(MVFMT_cyuv, MVFMT_Y411);
@@ -67,6 +85,65 @@ namespace BlipvertUnitTests
 			Assert::AreEqual(reinterpret_cast<void*>(PackedY422_to_IYU1), reinterpret_cast<void*>(func), L"FindVideoTransform returned the wrong function pointer.");
 		}
 
+		TEST_METHOD(FindTransformByFormatIndex_UnitTest)
+		{
+			FormatIndex uyvy = GetFormatIndex(MVFMT_UYVY);
+			FormatIndex rgb32 = GetFormatIndex(MVFMT_RGB32);
+			Assert::AreNotEqual(FORMAT_INDEX_UNDEFINED, uyvy, L"GetFormatIndex did not find UYVY.");
+			Assert::AreNotEqual(FORMAT_INDEX_UNDEFINED, rgb32, L"GetFormatIndex did not find RGB32.");
+			Assert::AreEqual(FORMAT_INDEX_UNDEFINED, GetFormatIndex(MediaFormatID("wowzo")), L"GetFormatIndex found an unknown format.");
+
+			t_transformfunc func = FindVideoTransform(uyvy, rgb32);
+			Assert::IsNotNull(reinterpret_cast<void*>(func), L"FindVideoTransform returned a null function pointer.");
+			Assert::AreEqual(reinterpret_cast<void*>(FindVideoTransform(MVFMT_UYVY, MVFMT_RGB32)), reinterpret_cast<void*>(func), L"FindVideoTransform returned the wrong function pointer.");
+
+			// Duplicate formats resolve to their master format.
+			func = FindVideoTransform(GetFormatIndex(MVFMT_cyuv), GetFormatIndex(MVFMT_Y411));
+			Assert::AreEqual(reinterpret_cast<void*>(PackedY422_to_IYU1), reinterpret_cast<void*>(func), L"FindVideoTransform returned the wrong function pointer.");
+
+			t_stagetransformfunc stage = FindTransformStage(GetFormatIndex(MVFMT_YUNV));
+			Assert::AreEqual(reinterpret_cast<void*>(Stage_YUY2), reinterpret_cast<void*>(stage), L"FindTransformStage returned the wrong function pointer.");
+
+			Assert::IsNull(reinterpret_cast<void*>(FindVideoTransform(FORMAT_INDEX_UNDEFINED, rgb32)), L"FindVideoTransform returned a non-null function pointer.");
+			Assert::IsNull(reinterpret_cast<void*>(FindTransformStage(FORMAT_INDEX_UNDEFINED)), L"FindTransformStage returned a non-null function pointer.");
+		}
+
+		TEST_METHOD(InitializeLibraryRepeated_UnitTest)
+		{
+			t_transformfunc before = FindVideoTransform(MVFMT_UYVY, MVFMT_RGB32);
+
+			std::vector<std::thread> threads;
+			for (int index = 0; index < 4; index++)
+			{
+				threads.emplace_back([]() { InitializeLibrary(); });
+			}
+
+			for (auto& worker : threads)
+			{
+				worker.join();
+			}
+
+			Assert::IsTrue(IsInitialized.load(), L"IsInitialized is false after InitializeLibrary.");
+			Assert::IsTrue(before == FindVideoTransform(MVFMT_UYVY, MVFMT_RGB32), L"Re-initializing changed the transform table.");
+		}
+
+		TEST_METHOD(GetTransformFormatPairs_UnitTest)
+		{
+			std::vector<std::pair<MediaFormatID, MediaFormatID>> pairs;
+			GetTransformFormatPairs(pairs);
+			Assert::IsFalse(pairs.empty(), L"GetTransformFormatPairs returned no pairs.");
+
+			bool found = false;
+			for (auto& pair : pairs)
+			{
+				Assert::IsNotNull(reinterpret_cast<void*>(FindVideoTransform(pair.first, pair.second)), L"GetTransformFormatPairs returned a pair without a transform.");
+				Assert::IsTrue(pair.first != MVFMT_YUYV && pair.second != MVFMT_YUYV, L"GetTransformFormatPairs returned a duplicate format.");
+				found = found || (pair.first == MVFMT_YUY2 && pair.second == MVFMT_RGB32);
+			}
+
+			Assert::IsTrue(found, L"GetTransformFormatPairs didn't return YUY2 to RGB32.");
+		}
+
 		TEST_METHOD(FindInvalidTransform_UnitTest)
 		{
 			t_transformfunc func = FindVideoTransform(MVFMT_UYVY, MediaFormatID("wowzo"));
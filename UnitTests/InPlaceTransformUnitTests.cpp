@@ -0,0 +1,183 @@
+//
+//  blipvert C++ library
+//
+//  MIT License
+//
+//  Copyright(c) 2021-2025 Don Jordan
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+//
+
+
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include "blipvert.h"
+#include "CpuFeatures.h"
+#include "Utilities.h"
+#include "RGBtoRGB.h"
+#include "YUVtoYUV.h"
+
+#include <memory>
+#include <random>
+#include <cstring>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace blipvert;
+
+namespace BlipvertUnitTests
+{
+	TEST_CLASS(InPlaceTransformUnitTests)
+	{
+	public:
+
+		// Runs an in-place transform over a random frame and checks its output rows against the copying transform.
+		// The output either keeps the input stride and is done in slices, or is packed to its minimum stride
+		// in one slice.
+		void CompareInPlaceTransform(const MediaFormatID& inFormat, const MediaFormatID& outFormat, t_transformfunc inplace,
+			int32_t width, int32_t height, bool flipped, bool packed, uint8_t slices)
+		{
+			t_stagetransformfunc in_stager = FindTransformStage(inFormat);
+			t_stagetransformfunc out_stager = FindTransformStage(outFormat);
+			t_transformfunc copy = FindVideoTransform(inFormat, outFormat);
+			Assert::IsNotNull(reinterpret_cast<void*>(copy), L"Missing copying transform.");
+
+			VideoFormatInfo info;
+			Assert::IsTrue(GetVideoFormatInfo(outFormat, info));
+			int32_t row_bytes = width * info.effectiveBitsPerPixel / 8;
+
+			int32_t in_stride = CalculateMinimumLineStride(inFormat, width, height);
+			int32_t out_stride = packed ? CalculateMinimumLineStride(outFormat, width, height) : in_stride;
+			uint32_t in_size = CalculateBufferSize(inFormat, width, height, in_stride);
+
+			std::unique_ptr<uint8_t[]> in_buf(new uint8_t[in_size]);
+			std::unique_ptr<uint8_t[]> copy_buf(new uint8_t[in_size]);
+			std::unique_ptr<uint8_t[]> inplace_buf(new uint8_t[in_size]);
+
+			std::mt19937 generator(static_cast<uint32_t>(width * 131 + height));
+			std::uniform_int_distribution<int32_t> distribution(0, 255);
+			for (uint32_t index = 0; index < in_size; index++)
+			{
+				in_buf[index] = static_cast<uint8_t>(distribution(generator));
+			}
+
+			memcpy(inplace_buf.get(), in_buf.get(), in_size);
+
+			Stage in_stage;
+			Stage out_stage;
+
+			in_stager(&in_stage, 0, 1, width, height, in_buf.get(), in_stride, flipped, nullptr);
+			out_stager(&out_stage, 0, 1, width, height, copy_buf.get(), out_stride, flipped, nullptr);
+			copy(&in_stage, &out_stage);
+
+			for (uint8_t slice = 0; slice < slices; slice++)
+			{
+				in_stager(&in_stage, slice, slices, width, height, inplace_buf.get(), in_stride, flipped, nullptr);
+				out_stager(&out_stage, slice, slices, width, height, inplace_buf.get(), out_stride, flipped, nullptr);
+				inplace(&in_stage, &out_stage);
+			}
+
+			for (int32_t row = 0; row < height; row++)
+			{
+				Assert::IsTrue(memcmp(copy_buf.get() + row * out_stride, inplace_buf.get() + row * out_stride, row_bytes) == 0,
+					L"In-place transform output differs from the copying transform.");
+			}
+		}
+
+		void CompareInPlaceTransformSeries(const MediaFormatID& inFormat, const MediaFormatID& outFormat, t_transformfunc inplace)
+		{
+			const int32_t widths[] = { 8, 24, 40, 200, 1920 };
+			for (int32_t width : widths)
+			{
+				for (int32_t flip = 0; flip < 2; flip++)
+				{
+					CompareInPlaceTransform(inFormat, outFormat, inplace, width, 16, flip != 0, false, 1);
+					CompareInPlaceTransform(inFormat, outFormat, inplace, width, 16, flip != 0, false, 4);
+					CompareInPlaceTransform(inFormat, outFormat, inplace, width, 16, flip != 0, true, 1);
+				}
+			}
+		}
+
+		TEST_METHOD(InPlaceTransformsMatchCopy_UnitTest)
+		{
+			const MediaFormatID formats[] = {
+				MVFMT_RGBA, MVFMT_RGB32, MVFMT_RGB24, MVFMT_RGB565, MVFMT_RGB555, MVFMT_ARGB1555,
+				MVFMT_YUY2, MVFMT_UYVY, MVFMT_YVYU, MVFMT_VYUY, MVFMT_YUNV, MVFMT_UYNV, MVFMT_I420, MVFMT_NV12
+			};
+
+			int32_t found = 0;
+			for (const MediaFormatID& inFormat : formats)
+			{
+				for (const MediaFormatID& outFormat : formats)
+				{
+					t_transformfunc inplace = FindInPlaceTransform(inFormat, outFormat);
+					if (inplace == nullptr)
+						continue;
+
+					CompareInPlaceTransformSeries(inFormat, outFormat, inplace);
+					found++;
+				}
+			}
+
+			Assert::IsTrue(found >= 20, L"Fewer in-place transforms than expected.");
+		}
+
+		// The SIMD versions are selected when the processor has them, so check the generic ones directly too.
+		TEST_METHOD(GenericInPlaceTransforms_UnitTest)
+		{
+			CompareInPlaceTransformSeries(MVFMT_RGBA, MVFMT_RGB32, RGBA_to_RGB32_InPlace);
+			CompareInPlaceTransformSeries(MVFMT_RGB32, MVFMT_RGBA, RGB32_to_RGBA_InPlace);
+			CompareInPlaceTransformSeries(MVFMT_RGB32, MVFMT_RGB24, RGB32_to_RGB24_InPlace);
+			CompareInPlaceTransformSeries(MVFMT_RGB555, MVFMT_RGB565, RGB555_to_RGB565_InPlace);
+			CompareInPlaceTransformSeries(MVFMT_RGB565, MVFMT_RGB555, RGB565_to_RGB555_InPlace);
+			CompareInPlaceTransformSeries(MVFMT_YUY2, MVFMT_UYVY, PackedY422_to_PackedY422_InPlace);
+			CompareInPlaceTransformSeries(MVFMT_VYUY, MVFMT_YVYU, PackedY422_to_PackedY422_InPlace);
+		}
+
+#if defined(BLIPVERT_X86_SIMD)
+		TEST_METHOD(SIMDInPlaceTransforms_UnitTest)
+		{
+			if (GetCpuFeatures().sse41)
+			{
+				CompareInPlaceTransformSeries(MVFMT_RGBA, MVFMT_RGB32, RGBA_to_RGB32_InPlace_SSE41);
+				CompareInPlaceTransformSeries(MVFMT_RGB32, MVFMT_RGB24, RGB32_to_RGB24_InPlace_SSE41);
+				CompareInPlaceTransformSeries(MVFMT_RGB555, MVFMT_RGB565, RGB555_to_RGB565_InPlace_SSE41);
+				CompareInPlaceTransformSeries(MVFMT_RGB565, MVFMT_RGB555, RGB565_to_RGB555_InPlace_SSE41);
+				CompareInPlaceTransformSeries(MVFMT_YUY2, MVFMT_UYVY, PackedY422_to_PackedY422_InPlace_SSE41);
+				CompareInPlaceTransformSeries(MVFMT_VYUY, MVFMT_YVYU, PackedY422_to_PackedY422_InPlace_SSE41);
+			}
+
+			if (GetCpuFeatures().avx2)
+			{
+				CompareInPlaceTransformSeries(MVFMT_YUY2, MVFMT_UYVY, PackedY422_to_PackedY422_InPlace_AVX2);
+				CompareInPlaceTransformSeries(MVFMT_VYUY, MVFMT_YVYU, PackedY422_to_PackedY422_InPlace_AVX2);
+			}
+		}
+#endif
+
+		TEST_METHOD(NoInPlaceTransform_UnitTest)
+		{
+			Assert::IsNull(reinterpret_cast<void*>(FindInPlaceTransform(MVFMT_RGB24, MVFMT_RGB32)), L"RGB24 grows to RGB32.");
+			Assert::IsNull(reinterpret_cast<void*>(FindInPlaceTransform(MVFMT_RGB565, MVFMT_RGB32)), L"RGB565 grows to RGB32.");
+			Assert::IsNull(reinterpret_cast<void*>(FindInPlaceTransform(MVFMT_I420, MVFMT_YV12)), L"Planar formats aren't converted in place.");
+			Assert::IsNull(reinterpret_cast<void*>(FindInPlaceTransform(MVFMT_YUY2, MVFMT_I420)), L"YUY2 to I420 isn't converted in place.");
+			Assert::IsNull(reinterpret_cast<void*>(FindInPlaceTransform(MVFMT_UNDEFINED, MVFMT_RGB32)), L"Unknown format.");
+		}
+	};
+}
@@ -0,0 +1,316 @@
+//
+//  blipvert C++ library
+//
+//  MIT License
+//
+//  Copyright(c) 2021-2025 Don Jordan
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+//
+
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include "blipvert.h"
+#include "CpuFeatures.h"
+#include "Utilities.h"
+#include "RGBtoRGB.h"
+#include "PaletteTables.h"
+#include "TransformPlan.h"
+
+#include <memory>
+#include <random>
+#include <cstring>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace blipvert;
+
+namespace BlipvertUnitTests
+{
+	TEST_CLASS(PaletteTablesUnitTests)
+	{
+	public:
+
+		static void FillRandomPalette(xRGBQUAD* palette, uint16_t entries, uint32_t seed)
+		{
+			std::mt19937 generator(seed);
+			std::uniform_int_distribution<int32_t> distribution(0, 255);
+			for (uint16_t index = 0; index < entries; index++)
+			{
+				palette[index].rgbBlue = static_cast<uint8_t>(distribution(generator));
+				palette[index].rgbGreen = static_cast<uint8_t>(distribution(generator));
+				palette[index].rgbRed = static_cast<uint8_t>(distribution(generator));
+				palette[index].rgbReserved = static_cast<uint8_t>(distribution(generator));
+			}
+		}
+
+		// Returns the palette index of pixel x in an indexed row. RGB4 keeps its first pixel in the low nibble
+		// and RGB1 in the low bit.
+		static uint8_t GetPaletteIndex(const uint8_t* row, int32_t x, uint8_t bits)
+		{
+			if (bits == 8)
+				return row[x];
+			else if (bits == 4)
+				return (row[x / 2] >> ((x % 2) * 4)) & 0x0F;
+			else
+				return (row[x / 8] >> (x % 8)) & 0x01;
+		}
+
+		// Checks a frame expanded by the library's transform against the palette entry of every pixel. The pixels
+		// only use the first entries of the palette, or all 2^bits of them when entries is 0.
+		void CheckExpansion(const MediaFormatID& inFormat, const MediaFormatID& outFormat, uint8_t bits,
+			int32_t width, int32_t height, xRGBQUAD* palette, uint16_t entries = 0)
+		{
+			t_transformfunc transform = FindVideoTransform(inFormat, outFormat);
+			Assert::IsNotNull(reinterpret_cast<void*>(transform), L"Missing palette transform.");
+
+			// The rows are sized here rather than by CalculateBufferSize() so the odd widths keep their last byte.
+			int32_t in_stride = (width * bits + 7) / 8;
+			int32_t out_stride = width * (outFormat == MVFMT_RGB32 ? 4 : 2);
+			uint32_t in_size = in_stride * height;
+			uint32_t out_size = out_stride * height;
+
+			std::unique_ptr<uint8_t[]> in_buf(new uint8_t[in_size]);
+			std::unique_ptr<uint8_t[]> out_buf(new uint8_t[out_size]);
+
+			std::mt19937 generator(static_cast<uint32_t>(width * 31 + bits));
+			std::uniform_int_distribution<int32_t> distribution(0, 255);
+			for (uint32_t index = 0; index < in_size; index++)
+			{
+				uint8_t byte = static_cast<uint8_t>(distribution(generator));
+				if (entries != 0 && bits == 8)
+					byte = byte % entries;
+				else if (entries != 0 && bits == 4)
+					byte = static_cast<uint8_t>(((byte & 0x0F) % entries) | (((byte >> 4) % entries) << 4));
+				in_buf[index] = byte;
+			}
+			memset(out_buf.get(), 0, out_size);
+
+			Stage in_stage;
+			Stage out_stage;
+			FindTransformStage(inFormat)(&in_stage, 0, 1, width, height, in_buf.get(), in_stride, false, palette);
+			FindTransformStage(outFormat)(&out_stage, 0, 1, width, height, out_buf.get(), out_stride, false, nullptr);
+			transform(&in_stage, &out_stage);
+
+			for (int32_t y = 0; y < height; y++)
+			{
+				const uint8_t* in_row = in_buf.get() + y * in_stride;
+				const uint8_t* out_row = out_buf.get() + y * out_stride;
+				for (int32_t x = 0; x < width; x++)
+				{
+					const xRGBQUAD& color = palette[GetPaletteIndex(in_row, x, bits)];
+					if (outFormat == MVFMT_RGB32)
+					{
+						const uint8_t* pixel = out_row + x * 4;
+						Assert::IsTrue(pixel[0] == color.rgbBlue && pixel[1] == color.rgbGreen && pixel[2] == color.rgbRed && pixel[3] == 0xFF,
+							L"RGB32 pixel doesn't match its palette entry.");
+					}
+					else
+					{
+						uint16_t pixel = reinterpret_cast<const uint16_t*>(out_row)[x];
+						uint16_t expected = outFormat == MVFMT_RGB565 ?
+							static_cast<uint16_t>(((color.rgbRed & 0xF8) << 8) | ((color.rgbGreen & 0xFC) << 3) | (color.rgbBlue >> 3)) :
+							static_cast<uint16_t>(0x8000 | ((color.rgbRed & 0xF8) << 7) | ((color.rgbGreen & 0xF8) << 2) | (color.rgbBlue >> 3));
+						Assert::IsTrue(pixel == expected, L"16-bit pixel doesn't match its palette entry.");
+					}
+				}
+			}
+		}
+
+		void RunExpansionSeries(const MediaFormatID& inFormat, uint8_t bits)
+		{
+			xRGBQUAD palette[256];
+			FillRandomPalette(palette, static_cast<uint16_t>(1 << bits), bits);
+
+			const int32_t widths[] = { 8, 9, 15, 16, 17, 33, 640 };
+			for (int32_t width : widths)
+			{
+				CheckExpansion(inFormat, MVFMT_RGB32, bits, width, 4, palette);
+				CheckExpansion(inFormat, MVFMT_RGB565, bits, width, 4, palette);
+				CheckExpansion(inFormat, MVFMT_RGB555, bits, width, 4, palette);
+			}
+		}
+
+		TEST_METHOD(RGB8_Expansion_UnitTest)
+		{
+			RunExpansionSeries(MVFMT_RGB8, 8);
+		}
+
+		TEST_METHOD(RGB4_Expansion_UnitTest)
+		{
+			RunExpansionSeries(MVFMT_RGB4, 4);
+		}
+
+		TEST_METHOD(RGB1_Expansion_UnitTest)
+		{
+			RunExpansionSeries(MVFMT_RGB1, 1);
+		}
+
+		TEST_METHOD(PaletteTablesCache_UnitTest)
+		{
+			xRGBQUAD palette[16];
+			FillRandomPalette(palette, 16, 4);
+
+			const PaletteTables* tables = &GetPaletteTables(palette, 4, 16);
+			Assert::IsTrue(tables->source == palette && tables->entries == 16, L"Tables weren't built from the palette.");
+			Assert::IsTrue(&GetPaletteTables(palette, 4, 16) == tables, L"The same palette should reuse the cached tables.");
+
+			// Other bit depths are cached separately and don't evict the RGB4 tables.
+			xRGBQUAD mono[2];
+			FillRandomPalette(mono, 2, 1);
+			GetPaletteTables(mono, 1, 2);
+			uint32_t expected = tables->rgb32_byte[0x21][1];
+			Assert::IsTrue(GetPaletteTables(palette, 4, 16).rgb32_byte[0x21][1] == expected, L"RGB1 tables replaced the RGB4 tables.");
+
+			// A palette that's been changed in place gets new tables.
+			palette[2].rgbRed ^= 0xFF;
+			const PaletteTables& changed = GetPaletteTables(palette, 4, 16);
+			Assert::IsTrue((changed.rgb32_byte[0x21][1] & 0x00FF0000) == (static_cast<uint32_t>(palette[2].rgbRed) << 16),
+				L"A changed palette should rebuild its tables.");
+			CheckExpansion(MVFMT_RGB4, MVFMT_RGB32, 4, 40, 2, palette);
+		}
+
+		// A palette only has to hold the entries its pixels use, like a bitmap with a short biClrUsed color table.
+		// The palettes are allocated with exactly that many entries so a sanitizer build catches any read past them.
+		TEST_METHOD(ShortPalette_UnitTest)
+		{
+			for (uint8_t bits : { 8, 4 })
+			{
+				const MediaFormatID& inFormat = bits == 8 ? MVFMT_RGB8 : MVFMT_RGB4;
+				std::unique_ptr<xRGBQUAD[]> palette(new xRGBQUAD[6]);
+				FillRandomPalette(palette.get(), 6, bits + 6);
+
+				const int32_t widths[] = { 8, 9, 17, 640 };
+				for (int32_t width : widths)
+				{
+					CheckExpansion(inFormat, MVFMT_RGB32, bits, width, 4, palette.get(), 6);
+					CheckExpansion(inFormat, MVFMT_RGB565, bits, width, 4, palette.get(), 6);
+					CheckExpansion(inFormat, MVFMT_RGB555, bits, width, 4, palette.get(), 6);
+				}
+			}
+
+			// The tables hold as many entries as the frame uses, and grow when a later frame uses more.
+			xRGBQUAD palette[256];
+			FillRandomPalette(palette, 256, 3);
+			uint8_t pixels[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 2, 2, 2, 2, 2, 2, 2, 2 };
+			Stage in_stage;
+			Stage_RGB8(&in_stage, 0, 1, 8, 2, pixels, 8, false, palette);
+			Assert::AreEqual(static_cast<uint16_t>(8), CountPaletteEntriesUsed(&in_stage, 8), L"Wrong count of RGB8 entries used.");
+			Assert::AreEqual(static_cast<uint16_t>(8), GetPaletteTables(&in_stage, 8).entries, L"The tables read the wrong number of entries.");
+
+			pixels[3] = 200;
+			Assert::AreEqual(static_cast<uint16_t>(201), GetPaletteTables(&in_stage, 8).entries, L"The tables didn't grow for a higher index.");
+			Assert::AreEqual(static_cast<uint16_t>(201), GetPaletteTables(palette, 8, 8).entries, L"Fewer entries should reuse the tables.");
+
+			// Only the pixels count, not the unused bits of a row's last byte.
+			uint8_t nibbles[2] = { 0x92, 0xF3 };
+			Stage_RGB4(&in_stage, 0, 1, 3, 1, nibbles, 2, false, palette);
+			Assert::AreEqual(static_cast<uint16_t>(10), CountPaletteEntriesUsed(&in_stage, 4), L"Wrong count of RGB4 entries used.");
+			uint8_t mono_pixels[1] = { 0xF0 };
+			Stage_RGB1(&in_stage, 0, 1, 4, 1, mono_pixels, 1, false, palette);
+			Assert::AreEqual(static_cast<uint16_t>(1), CountPaletteEntriesUsed(&in_stage, 1), L"Wrong count of RGB1 entries used.");
+		}
+
+		// A stage that knows its palette's size reads that many entries without scanning the frame.
+		TEST_METHOD(KnownPaletteSize_UnitTest)
+		{
+			xRGBQUAD palette[256];
+			FillRandomPalette(palette, 256, 5);
+			uint8_t pixels[16] = { 0, 200, 2, 3, 4, 5, 6, 7, 2, 2, 2, 2, 2, 2, 2, 2 };
+			Stage in_stage;
+			Stage_RGB8(&in_stage, 0, 1, 8, 2, pixels, 8, false, palette);
+			Assert::AreEqual(static_cast<uint16_t>(0), in_stage.palette_entries, L"A caller's palette shouldn't have a known size.");
+			in_stage.palette_entries = 16;
+			Assert::AreEqual(static_cast<uint16_t>(16), GetPaletteTables(&in_stage, 8).entries, L"The tables didn't read the stage's palette entries.");
+
+			// The greyscale palettes the staging functions fall back on are full.
+			Stage_RGB8(&in_stage, 0, 1, 8, 2, pixels, 8, false, nullptr);
+			Assert::AreEqual(static_cast<uint16_t>(256), in_stage.palette_entries, L"The RGB8 greyscale palette should be full.");
+			Stage_RGB4(&in_stage, 0, 1, 8, 2, pixels, 4, false, nullptr);
+			Assert::AreEqual(static_cast<uint16_t>(16), in_stage.palette_entries, L"The RGB4 greyscale palette should be full.");
+			Stage_RGB1(&in_stage, 0, 1, 8, 2, pixels, 1, false, nullptr);
+			Assert::AreEqual(static_cast<uint16_t>(2), in_stage.palette_entries, L"The RGB1 greyscale palette should be full.");
+
+			// A plan passes the size to every slice. The palette holds exactly six entries, for a sanitizer build.
+			const int32_t width = 64;
+			const int32_t height = 32;
+			std::unique_ptr<xRGBQUAD[]> short_palette(new xRGBQUAD[6]);
+			FillRandomPalette(short_palette.get(), 6, 6);
+			TransformPlan plan;
+			Assert::IsTrue(CreateTransformPlan(plan, MVFMT_RGB8, MVFMT_RGB32, width, height, 0, 0, false, false, 4,
+				short_palette.get(), nullptr, 6), L"CreateTransformPlan failed.");
+			for (const TransformStage& stage : plan.stages)
+				Assert::AreEqual(static_cast<uint16_t>(6), stage.inStage.palette_entries, L"The plan didn't pass on the palette's size.");
+
+			std::vector<uint8_t> in_buf(width * height);
+			for (size_t index = 0; index < in_buf.size(); index++)
+				in_buf[index] = static_cast<uint8_t>(index % 6);
+			std::vector<uint32_t> out_buf(width * height, 0);
+			ExecuteTransformPlan(plan, in_buf.data(), reinterpret_cast<uint8_t*>(out_buf.data()));
+			for (size_t index = 0; index < in_buf.size(); index++)
+			{
+				const xRGBQUAD& color = short_palette[in_buf[index]];
+				uint32_t expected = color.rgbBlue | (color.rgbGreen << 8) | (color.rgbRed << 16) | 0xFF000000;
+				Assert::AreEqual(expected, out_buf[index], L"A planned RGB8 pixel doesn't match its palette entry.");
+			}
+		}
+
+#if defined(BLIPVERT_X86_SIMD)
+		TEST_METHOD(RGB8_to_RGB32_AVX2_UnitTest)
+		{
+			if (GetCpuFeatures().avx2)
+			{
+				xRGBQUAD palette[256];
+				FillRandomPalette(palette, 256, 8);
+
+				const int32_t widths[] = { 8, 9, 31, 640 };
+				for (int32_t width : widths)
+				{
+					uint32_t in_size = CalculateBufferSize(MVFMT_RGB8, width, 3);
+					uint32_t out_size = CalculateBufferSize(MVFMT_RGB32, width, 3);
+					std::unique_ptr<uint8_t[]> in_buf(new uint8_t[in_size]);
+					std::unique_ptr<uint8_t[]> generic_buf(new uint8_t[out_size]);
+					std::unique_ptr<uint8_t[]> simd_buf(new uint8_t[out_size]);
+					for (uint32_t index = 0; index < in_size; index++)
+					{
+						in_buf[index] = static_cast<uint8_t>(index * 37 + width);
+					}
+
+					Stage in_stage;
+					Stage out_stage;
+					Stage_RGB8(&in_stage, 0, 1, width, 3, in_buf.get(), 0, false, palette);
+					Stage_RGB32(&out_stage, 0, 1, width, 3, generic_buf.get(), 0, false);
+					RGB8_to_RGB32(&in_stage, &out_stage);
+
+					Stage_RGB8(&in_stage, 0, 1, width, 3, in_buf.get(), 0, false, palette);
+					Stage_RGB32(&out_stage, 0, 1, width, 3, simd_buf.get(), 0, true);
+					RGB8_to_RGB32_AVX2(&in_stage, &out_stage);
+
+					for (int32_t y = 0; y < 3; y++)
+					{
+						Assert::IsTrue(memcmp(generic_buf.get() + y * width * 4, simd_buf.get() + (2 - y) * width * 4, width * 4) == 0,
+							L"AVX2 RGB8 expansion differs from the generic transform.");
+					}
+				}
+			}
+		}
+#endif
+	};
+}
@@ -0,0 +1,443 @@
+//
+//  blipvert C++ library
+//
+//  MIT License
+//
+//  Copyright(c) 2021-2025 Don Jordan
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+//
+
+
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include "blipvert.h"
+#include "Utilities.h"
+#include "FrameView.h"
+
+#include <memory>
+#include <random>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace blipvert;
+
+namespace BlipvertUnitTests
+{
+	TEST_CLASS(PlaneFrameUnitTests)
+	{
+	public:
+
+		// The rows and row width of each plane of a format that keeps its chroma apart from the luma.
+		typedef struct PlaneShape {
+			int32_t count;
+			int32_t rows[3];
+			int32_t row_bytes[3];
+		} PlaneShape;
+
+		// Returns false for formats with a single plane.
+		bool GetPlaneShape(const MediaFormatID& format, int32_t width, int32_t height, PlaneShape& shape)
+		{
+			shape.rows[0] = height;
+			shape.row_bytes[0] = width;
+
+			if (format == MVFMT_I420 || format == MVFMT_IYUV || format == MVFMT_YV12 || format == MVFMT_IMC1 || format == MVFMT_IMC3)
+			{
+				shape.count = 3;
+				shape.rows[1] = shape.rows[2] = height / 2;
+				shape.row_bytes[1] = shape.row_bytes[2] = width / 2;
+			}
+			else if (format == MVFMT_YUV9 || format == MVFMT_YVU9)
+			{
+				shape.count = 3;
+				shape.rows[1] = shape.rows[2] = height / 4;
+				shape.row_bytes[1] = shape.row_bytes[2] = width / 4;
+			}
+			else if (format == MVFMT_YV16)
+			{
+				shape.count = 3;
+				shape.rows[1] = shape.rows[2] = height;
+				shape.row_bytes[1] = shape.row_bytes[2] = width / 2;
+			}
+			else if (format == MVFMT_NV12 || format == MVFMT_NV21 || format == MVFMT_IMC2 || format == MVFMT_IMC4)
+			{
+				shape.count = 2;
+				shape.rows[1] = height / 2;
+				shape.row_bytes[1] = width;
+			}
+			else
+			{
+				return false;
+			}
+
+			return true;
+		}
+
+		// Allocates every plane of a frame on its own, each with a different amount of row padding.
+		void AllocatePlanes(const PlaneShape& shape, int32_t padding, std::vector<std::vector<uint8_t>>& storage, PlaneFrame& frame)
+		{
+			memset(&frame, 0, sizeof(PlaneFrame));
+			storage.clear();
+			storage.resize(shape.count);
+			for (int32_t plane = 0; plane < shape.count; plane++)
+			{
+				// The U and V planes of a format share a stride.
+				int32_t stride = shape.row_bytes[plane] + padding * (plane == 0 ? 1 : 2);
+				storage[plane].assign(stride * shape.rows[plane], static_cast<uint8_t>(0));
+				frame.planes[plane] = storage[plane].data();
+				frame.strides[plane] = stride;
+			}
+		}
+
+		// Copies the rows of each plane between two plane frames of the same shape.
+		void CopyPlanes(const PlaneShape& shape, const PlaneFrame& from, const PlaneFrame& to)
+		{
+			for (int32_t plane = 0; plane < shape.count; plane++)
+			{
+				for (int32_t row = 0; row < shape.rows[plane]; row++)
+				{
+					memcpy(to.planes[plane] + row * to.strides[plane], from.planes[plane] + row * from.strides[plane], shape.row_bytes[plane]);
+				}
+			}
+		}
+
+		// Returns true if the rows of each plane of two plane frames of the same shape are the same.
+		bool ComparePlanes(const PlaneShape& shape, const PlaneFrame& frame1, const PlaneFrame& frame2)
+		{
+			for (int32_t plane = 0; plane < shape.count; plane++)
+			{
+				for (int32_t row = 0; row < shape.rows[plane]; row++)
+				{
+					if (memcmp(frame1.planes[plane] + row * frame1.strides[plane], frame2.planes[plane] + row * frame2.strides[plane], shape.row_bytes[plane]) != 0)
+						return false;
+				}
+			}
+
+			return true;
+		}
+
+		// Transforms a random frame held in one buffer, then again with every plane of the input and output in an
+		// allocation of its own, and checks the outputs are the same.
+		void CompareSeparateToContiguous(const MediaFormatID& inFormat, const MediaFormatID& outFormat, int32_t width, int32_t height,
+			uint8_t thread_count, bool flipped)
+		{
+			t_transformfunc transform = FindVideoTransform(inFormat, outFormat);
+			t_stagetransformfunc pstage_in = FindTransformStage(inFormat);
+			t_stagetransformfunc pstage_out = FindTransformStage(outFormat);
+			Assert::IsNotNull(reinterpret_cast<void*>(transform), L"FindVideoTransform failed.");
+
+			uint32_t in_size = CalculateBufferSize(inFormat, width, height);
+			uint32_t out_size = CalculateBufferSize(outFormat, width, height);
+			std::vector<uint8_t> in_buf(in_size);
+			std::vector<uint8_t> contiguous_buf(out_size, static_cast<uint8_t>(0));
+			std::vector<uint8_t> packed_buf(out_size, static_cast<uint8_t>(0));
+
+			std::mt19937 generator(static_cast<uint32_t>(width * height + thread_count));
+			for (uint32_t index = 0; index < in_size; index++)
+			{
+				in_buf[index] = static_cast<uint8_t>(generator());
+			}
+
+			xRGBQUAD palette[256];
+			for (int32_t index = 0; index < 256; index++)
+			{
+				uint32_t color = generator();
+				memcpy(&palette[index], &color, sizeof(xRGBQUAD));
+			}
+
+			// Split the input into separate planes, and allocate the output the same way.
+			PlaneFrame in_frame;
+			PlaneFrame out_frame;
+			PlaneShape in_shape;
+			PlaneShape out_shape;
+			std::vector<std::vector<uint8_t>> in_planes;
+			std::vector<std::vector<uint8_t>> out_planes;
+			Assert::IsTrue(GetFramePlanes(inFormat, width, height, in_buf.data(), 0, in_frame), L"GetFramePlanes failed.");
+			if (GetPlaneShape(inFormat, width, height, in_shape))
+			{
+				PlaneFrame contiguous = in_frame;
+				AllocatePlanes(in_shape, 32, in_planes, in_frame);
+				CopyPlanes(in_shape, contiguous, in_frame);
+			}
+
+			bool out_separate = GetPlaneShape(outFormat, width, height, out_shape);
+			if (out_separate)
+				AllocatePlanes(out_shape, 48, out_planes, out_frame);
+			else
+				Assert::IsTrue(GetFramePlanes(outFormat, width, height, packed_buf.data(), 0, out_frame), L"GetFramePlanes failed.");
+
+			for (uint8_t index = 0; index < thread_count; index++)
+			{
+				Stage in_stage;
+				Stage out_stage;
+				pstage_in(&in_stage, index, thread_count, width, height, in_buf.data(), 0, flipped, palette);
+				pstage_out(&out_stage, index, thread_count, width, height, contiguous_buf.data(), 0, false, nullptr);
+				transform(&in_stage, &out_stage);
+
+				Assert::IsTrue(StagePlanes(&in_stage, inFormat, index, thread_count, width, height, in_frame, flipped, palette), L"StagePlanes failed.");
+				Assert::IsTrue(StagePlanes(&out_stage, outFormat, index, thread_count, width, height, out_frame), L"StagePlanes failed.");
+				transform(&in_stage, &out_stage);
+			}
+
+			if (out_separate)
+			{
+				PlaneFrame contiguous;
+				Assert::IsTrue(GetFramePlanes(outFormat, width, height, contiguous_buf.data(), 0, contiguous), L"GetFramePlanes failed.");
+				Assert::IsTrue(ComparePlanes(out_shape, contiguous, out_frame), L"The separate planes differ from a contiguous buffer.");
+			}
+			else
+			{
+				Assert::IsTrue(packed_buf == contiguous_buf, L"The separate planes differ from a contiguous buffer.");
+			}
+		}
+
+		// Views a random frame of inFormat as outFormat, and checks the view holds the same pixels the transform
+		// between the formats makes.
+		void CompareViewToTransform(const MediaFormatID& inFormat, const MediaFormatID& outFormat, int32_t width, int32_t height)
+		{
+			PlaneShape in_shape;
+			PlaneShape out_shape;
+			Assert::IsTrue(GetPlaneShape(inFormat, width, height, in_shape), L"The input format has a single plane.");
+			if (!GetPlaneShape(outFormat, width, height, out_shape))
+			{
+				// Y800
+				out_shape.count = 1;
+				out_shape.rows[0] = height;
+				out_shape.row_bytes[0] = width;
+			}
+
+			PlaneFrame in_frame;
+			PlaneFrame out_frame;
+			std::vector<std::vector<uint8_t>> in_planes;
+			std::vector<std::vector<uint8_t>> out_planes;
+			AllocatePlanes(in_shape, 16, in_planes, in_frame);
+			AllocatePlanes(out_shape, 0, out_planes, out_frame);
+
+			std::mt19937 generator(static_cast<uint32_t>(width * height));
+			for (std::vector<uint8_t>& plane : in_planes)
+			{
+				for (uint8_t& value : plane)
+				{
+					value = static_cast<uint8_t>(generator());
+				}
+			}
+
+			Stage in_stage;
+			Stage out_stage;
+			Assert::IsTrue(StagePlanes(&in_stage, inFormat, 0, 1, width, height, in_frame), L"StagePlanes failed.");
+			Assert::IsTrue(StagePlanes(&out_stage, outFormat, 0, 1, width, height, out_frame), L"StagePlanes failed.");
+			FindVideoTransform(inFormat, outFormat)(&in_stage, &out_stage);
+
+			PlaneFrame view;
+			Assert::IsTrue(GetFrameView(inFormat, outFormat, in_frame, view), L"GetFrameView failed.");
+			Assert::IsTrue(view.planes[0] == in_frame.planes[0], L"The view doesn't share the input's planes.");
+			Assert::IsTrue(ComparePlanes(out_shape, view, out_frame), L"The view differs from the transform.");
+		}
+
+		TEST_METHOD(StagePlanesMatchesStaging_UnitTest)
+		{
+			std::vector<std::pair<MediaFormatID, MediaFormatID>> pairs;
+			GetTransformFormatPairs(pairs);
+
+			std::vector<MediaFormatID> formats;
+			for (const auto& pair : pairs)
+			{
+				// A few packed formats have transforms of their own but no staging function.
+				if (FindTransformStage(pair.first) != nullptr && std::find(formats.begin(), formats.end(), pair.first) == formats.end())
+					formats.push_back(pair.first);
+			}
+
+			int32_t width = 320;
+			int32_t height = 240;
+			std::vector<uint8_t> buf(CalculateBufferSize(MVFMT_RGBA, width, height));
+
+			// A plane frame that describes a contiguous buffer must stage exactly like the buffer itself.
+			for (const MediaFormatID& format : formats)
+			{
+				PlaneFrame frame;
+				Assert::IsTrue(GetFramePlanes(format, width, height, buf.data(), 0, frame), L"GetFramePlanes failed.");
+
+				for (uint8_t thread_count : { 1, 3 })
+				{
+					for (uint8_t index = 0; index < thread_count; index++)
+					{
+						for (bool flipped : { false, true })
+						{
+							Stage expected;
+							Stage planes;
+							FindTransformStage(format)(&expected, index, thread_count, width, height, buf.data(), frame.strides[0], flipped, nullptr);
+							Assert::IsTrue(StagePlanes(&planes, format, index, thread_count, width, height, frame, flipped), L"StagePlanes failed.");
+							Assert::IsTrue(memcmp(&expected, &planes, sizeof(Stage)) == 0, L"StagePlanes staged a contiguous frame differently.");
+						}
+					}
+				}
+			}
+		}
+
+		TEST_METHOD(SeparatePlanesMatchContiguous_UnitTest)
+		{
+			std::vector<std::pair<MediaFormatID, MediaFormatID>> pairs;
+			GetTransformFormatPairs(pairs);
+
+			for (const auto& pair : pairs)
+			{
+				PlaneShape shape;
+				if (!GetPlaneShape(pair.first, 16, 16, shape) && !GetPlaneShape(pair.second, 16, 16, shape))
+					continue;
+
+				CompareSeparateToContiguous(pair.first, pair.second, 320, 240, 1, false);
+				CompareSeparateToContiguous(pair.first, pair.second, 320, 240, 3, true);
+			}
+		}
+
+		TEST_METHOD(ChromaRowsFollowStride_UnitTest)
+		{
+			int32_t width = 64;
+			int32_t height = 64;
+
+			// Every chroma row of the input has its own value, so a transform that loses its place in the
+			// chroma plane shows up as repeated rows in the output.
+			for (const MediaFormatID& inFormat : { MVFMT_I420, MVFMT_YUV9 })
+			{
+				int32_t decimation = (inFormat == MVFMT_I420) ? 2 : 4;
+				int32_t uv_width = width / decimation;
+				int32_t uv_height = height / decimation;
+
+				std::vector<uint8_t> y(width * height, static_cast<uint8_t>(128));
+				std::vector<uint8_t> u(uv_width * uv_height);
+				std::vector<uint8_t> v(uv_width * uv_height);
+				for (int32_t row = 0; row < uv_height; row++)
+				{
+					memset(u.data() + row * uv_width, 16 + row, uv_width);
+					memset(v.data() + row * uv_width, 240 - row, uv_width);
+				}
+
+				std::vector<uint8_t> out_y(width * height);
+				std::vector<uint8_t> out_uv(width * height / 2);
+				PlaneFrame in_frame = { { y.data(), u.data(), v.data() }, { width, uv_width, uv_width } };
+				PlaneFrame out_frame = { { out_y.data(), out_uv.data(), nullptr }, { width, width, 0 } };
+
+				Stage in_stage;
+				Stage out_stage;
+				Assert::IsTrue(StagePlanes(&in_stage, inFormat, 0, 1, width, height, in_frame), L"StagePlanes failed.");
+				Assert::IsTrue(StagePlanes(&out_stage, MVFMT_NV12, 0, 1, width, height, out_frame), L"StagePlanes failed.");
+				FindVideoTransform(inFormat, MVFMT_NV12)(&in_stage, &out_stage);
+
+				for (int32_t row = 0; row < height / 2; row++)
+				{
+					uint8_t* uvp = out_uv.data() + row * width;
+					int32_t in_row = row * 2 / decimation;
+					Assert::AreEqual(static_cast<int32_t>(16 + in_row), static_cast<int32_t>(uvp[0]), L"A U row came from the wrong input row.");
+					Assert::AreEqual(static_cast<int32_t>(240 - in_row), static_cast<int32_t>(uvp[1]), L"A V row came from the wrong input row.");
+				}
+			}
+		}
+
+		TEST_METHOD(FrameViewMatchesTransform_UnitTest)
+		{
+			CompareViewToTransform(MVFMT_I420, MVFMT_YV12, 320, 240);
+			CompareViewToTransform(MVFMT_YV12, MVFMT_I420, 320, 240);
+			CompareViewToTransform(MVFMT_IYUV, MVFMT_YV12, 320, 240);
+			CompareViewToTransform(MVFMT_I420, MVFMT_IMC1, 320, 240);
+			CompareViewToTransform(MVFMT_IMC1, MVFMT_IMC3, 320, 240);
+			CompareViewToTransform(MVFMT_IMC3, MVFMT_IMC1, 320, 240);
+			CompareViewToTransform(MVFMT_YUV9, MVFMT_YVU9, 320, 240);
+			CompareViewToTransform(MVFMT_YVU9, MVFMT_YUV9, 320, 240);
+			CompareViewToTransform(MVFMT_I420, MVFMT_Y800, 320, 240);
+			CompareViewToTransform(MVFMT_NV12, MVFMT_Y800, 320, 240);
+			CompareViewToTransform(MVFMT_YV16, MVFMT_Y800, 320, 240);
+			CompareViewToTransform(MVFMT_IMC2, MVFMT_Y800, 320, 240);
+		}
+
+		TEST_METHOD(ViewOrTransform_UnitTest)
+		{
+			int32_t width = 64;
+			int32_t height = 64;
+			std::vector<uint8_t> in_buf(CalculateBufferSize(MVFMT_I420, width, height));
+			std::vector<uint8_t> out_buf(CalculateBufferSize(MVFMT_RGB32, width, height));
+			std::vector<uint8_t> flipped_buf(CalculateBufferSize(MVFMT_YV12, width, height));
+			for (size_t index = 0; index < in_buf.size(); index++)
+			{
+				in_buf[index] = static_cast<uint8_t>(index * 7);
+			}
+
+			PlaneFrame in;
+			PlaneFrame out;
+			PlaneFrame result;
+			Assert::IsTrue(GetFramePlanes(MVFMT_I420, width, height, in_buf.data(), 0, in), L"GetFramePlanes failed.");
+			Assert::IsTrue(GetFramePlanes(MVFMT_YV12, width, height, out_buf.data(), 0, out), L"GetFramePlanes failed.");
+
+			// Same flip, so the result is a view of the input.
+			Assert::IsTrue(ViewOrTransform(MVFMT_I420, MVFMT_YV12, width, height, in, false, out, false, result), L"ViewOrTransform failed.");
+			Assert::IsTrue(result.planes[0] == in.planes[0] && result.planes[1] == in.planes[1] && result.planes[2] == in.planes[2], L"The result isn't a view of the input.");
+
+			// A flip has to be copied.
+			Assert::IsTrue(ViewOrTransform(MVFMT_I420, MVFMT_YV12, width, height, in, false, out, true, result), L"ViewOrTransform failed.");
+			Assert::IsTrue(result.planes[0] == out.planes[0], L"The flipped result isn't the output frame.");
+
+			t_transformfunc transform = FindVideoTransform(MVFMT_I420, MVFMT_YV12);
+			Stage in_stage;
+			Stage out_stage;
+			Stage_I420(&in_stage, 0, 1, width, height, in_buf.data(), 0, false);
+			Stage_YV12(&out_stage, 0, 1, width, height, flipped_buf.data(), 0, true);
+			transform(&in_stage, &out_stage);
+			Assert::IsTrue(memcmp(flipped_buf.data(), out_buf.data(), flipped_buf.size()) == 0, L"The flipped result differs from the transform.");
+
+			// Formats with different layouts are always transformed.
+			Assert::IsTrue(GetFramePlanes(MVFMT_RGB32, width, height, out_buf.data(), 0, out), L"GetFramePlanes failed.");
+			Assert::IsTrue(ViewOrTransform(MVFMT_I420, MVFMT_RGB32, width, height, in, false, out, false, result), L"ViewOrTransform failed.");
+			Assert::IsTrue(result.planes[0] == out.planes[0], L"The RGB32 result isn't the output frame.");
+
+			PlaneFrame view;
+			Assert::IsFalse(GetFrameView(MVFMT_NV12, MVFMT_NV21, in, view), L"NV12 can't be viewed as NV21.");
+			Assert::IsFalse(GetFrameView(MVFMT_IMC2, MVFMT_IMC4, in, view), L"IMC2 can't be viewed as IMC4.");
+			Assert::IsFalse(GetFrameView(MVFMT_YUY2, MVFMT_Y800, in, view), L"YUY2 can't be viewed as Y800.");
+			Assert::IsFalse(GetFrameView(MVFMT_I420, MVFMT_YUV9, in, view), L"I420 can't be viewed as YUV9.");
+			Assert::IsFalse(ViewOrTransform(MVFMT_Y800, MVFMT_RGB8, width, height, in, false, out, false, result), L"ViewOrTransform succeeded without a transform.");
+		}
+
+		TEST_METHOD(InvalidPlanes_UnitTest)
+		{
+			std::vector<uint8_t> y(64 * 64);
+			std::vector<uint8_t> u(32 * 32);
+			std::vector<uint8_t> v(96 * 32);
+
+			Stage stage;
+			PlaneFrame frame = { { y.data(), u.data(), v.data() }, { 64, 32, 32 } };
+			Assert::IsTrue(StagePlanes(&stage, MVFMT_I420, 0, 1, 64, 64, frame), L"StagePlanes failed.");
+			Assert::IsTrue(stage.uplane == u.data() && stage.vplane == v.data(), L"StagePlanes didn't use the frame's planes.");
+
+			frame.strides[2] = 48;
+			Assert::IsFalse(StagePlanes(&stage, MVFMT_I420, 0, 1, 64, 64, frame), L"StagePlanes accepted different U and V strides.");
+
+			frame.planes[2] = nullptr;
+			frame.strides[2] = 32;
+			Assert::IsFalse(StagePlanes(&stage, MVFMT_YV12, 0, 1, 64, 64, frame), L"StagePlanes accepted a missing plane.");
+			Assert::IsFalse(StagePlanes(&stage, MediaFormatID("wowzo"), 0, 1, 64, 64, frame), L"StagePlanes succeeded for an unknown format.");
+
+			PlaneFrame nv12 = { { y.data(), v.data(), nullptr }, { 64, 96, 0 } };
+			Assert::IsTrue(StagePlanes(&stage, MVFMT_NV12, 0, 1, 64, 64, nv12), L"StagePlanes failed.");
+			Assert::AreEqual(96, stage.uv_stride, L"The chroma plane has the wrong stride.");
+			Assert::AreEqual(64, stage.stride, L"The luma plane has the wrong stride.");
+		}
+	};
+}
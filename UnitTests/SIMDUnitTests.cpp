@@ -0,0 +1,348 @@
+//
+//  blipvert C++ library
+//
+//  MIT License
+//
+//  Copyright(c) 2021-2025 Don Jordan
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+//
+
+
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include "blipvert.h"
+#include "CpuFeatures.h"
+#include "Utilities.h"
+#include "YUVtoRGB.h"
+#include "RGBtoYUV.h"
+#include "YUVtoYUV.h"
+#include "RGBtoRGB.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <cstring>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace blipvert;
+
+namespace BlipvertUnitTests
+{
+	// Runs a SIMD transform and its generic version over the same random frame and checks that no byte of the results
+	// differs by more than tolerance. Widths that aren't a multiple of the SIMD block size exercise the leftover columns.
+	// The generic version is run a second time over a differently filled buffer to find the padding bytes it leaves
+	// alone, such as the ends of the IMC1 chroma rows, and the SIMD version must leave them alone too. in_stride is 0
+	// for the input format's minimum stride.
+	void CompareSIMDTransform(const MediaFormatID& inFormat, const MediaFormatID& outFormat, t_transformfunc generic, t_transformfunc simd,
+		int32_t width, int32_t height, int32_t in_stride, bool in_flipped, bool flipped, int32_t tolerance)
+	{
+		t_stagetransformfunc in_stager = FindTransformStage(inFormat);
+		t_stagetransformfunc out_stager = FindTransformStage(outFormat);
+		Assert::IsNotNull(reinterpret_cast<void*>(in_stager), L"Missing input staging function.");
+		Assert::IsNotNull(reinterpret_cast<void*>(out_stager), L"Missing output staging function.");
+
+		uint32_t in_size = CalculateBufferSize(inFormat, width, height, in_stride);
+		uint32_t out_size = CalculateBufferSize(outFormat, width, height);
+
+		std::unique_ptr<uint8_t[]> in_buf(new uint8_t[in_size]);
+		std::unique_ptr<uint8_t[]> generic_buf(new uint8_t[out_size]);
+		std::unique_ptr<uint8_t[]> padding_buf(new uint8_t[out_size]);
+		std::unique_ptr<uint8_t[]> simd_buf(new uint8_t[out_size]);
+
+		std::mt19937 generator(static_cast<uint32_t>(width * 131 + height * 7 + in_stride));
+		std::uniform_int_distribution<int32_t> distribution(0, 255);
+		for (uint32_t index = 0; index < in_size; index++)
+		{
+			in_buf[index] = static_cast<uint8_t>(distribution(generator));
+		}
+
+		memset(generic_buf.get(), 0xA5, out_size);
+		memset(padding_buf.get(), 0x5A, out_size);
+		memset(simd_buf.get(), 0x5A, out_size);
+
+		Stage in_stage;
+		Stage out_stage;
+
+		in_stager(&in_stage, 0, 1, width, height, in_buf.get(), in_stride, in_flipped, nullptr);
+		out_stager(&out_stage, 0, 1, width, height, generic_buf.get(), 0, flipped, nullptr);
+		generic(&in_stage, &out_stage);
+
+		in_stager(&in_stage, 0, 1, width, height, in_buf.get(), in_stride, in_flipped, nullptr);
+		out_stager(&out_stage, 0, 1, width, height, padding_buf.get(), 0, flipped, nullptr);
+		generic(&in_stage, &out_stage);
+
+		in_stager(&in_stage, 0, 1, width, height, in_buf.get(), in_stride, in_flipped, nullptr);
+		out_stager(&out_stage, 0, 1, width, height, simd_buf.get(), 0, flipped, nullptr);
+		simd(&in_stage, &out_stage);
+
+		for (uint32_t index = 0; index < out_size; index++)
+		{
+			if (generic_buf[index] != padding_buf[index])
+			{
+				Assert::IsTrue(simd_buf[index] == padding_buf[index], L"SIMD transform wrote a byte the generic transform leaves alone.");
+				continue;
+			}
+
+			int32_t difference = static_cast<int32_t>(generic_buf[index]) - static_cast<int32_t>(simd_buf[index]);
+			Assert::IsTrue(difference <= tolerance && difference >= -tolerance, L"SIMD transform output differs from the generic transform.");
+		}
+	}
+
+	// Returns the number of rows each chroma row covers in a format: 2 for the 4:2:0 formats, 4 for YUV9 and YVU9 and
+	// 1 for the rest. Frames of those formats have to be a whole number of chroma rows high.
+	int32_t GetChromaRowGranularity(const MediaFormatID& format)
+	{
+		uint8_t buf[64];
+		Stage stage;
+		FindTransformStage(format)(&stage, 0, 1, 8, 16, buf, 0, false, nullptr);
+		return stage.uv_height > 0 ? 16 / stage.uv_height : 1;
+	}
+
+	void CompareSIMDTransformSeries(const MediaFormatID& inFormat, const MediaFormatID& outFormat, t_transformfunc generic, t_transformfunc simd,
+		int32_t tolerance = 0)
+	{
+		// Odd numbers of chroma rows leave the kernels a last row, row pair or block of their own, and the padded input
+		// stride catches kernels that step rows by the width instead of the stride.
+		const int32_t widths[] = { 8, 16, 24, 40, 72, 200, 1920 };
+		const int32_t chroma_rows[] = { 1, 3, 7, 8 };
+		int32_t granularity = std::max(GetChromaRowGranularity(inFormat), GetChromaRowGranularity(outFormat));
+		for (int32_t width : widths)
+		{
+			for (int32_t rows : chroma_rows)
+			{
+				int32_t height = rows * granularity;
+				int32_t padded_stride = CalculateMinimumLineStride(inFormat, width, height) + 64;
+				for (int32_t in_stride : { 0, padded_stride })
+				{
+					for (bool in_flipped : { false, true })
+					{
+						CompareSIMDTransform(inFormat, outFormat, generic, simd, width, height, in_stride, in_flipped, false, tolerance);
+						CompareSIMDTransform(inFormat, outFormat, generic, simd, width, height, in_stride, in_flipped, true, tolerance);
+					}
+				}
+			}
+		}
+	}
+
+#if defined(BLIPVERT_X86_SIMD)
+
+	TEST_CLASS(SIMDUnitTests)
+	{
+	public:
+
+		//
+		// Packed Y422 to RGB
+		//
+
+		void RunPackedY422toRGB(const MediaFormatID& inFormat)
+		{
+			if (GetCpuFeatures().sse41)
+			{
+				CompareSIMDTransformSeries(inFormat, MVFMT_RGB32, PackedY422_to_RGB32, PackedY422_to_RGB32_SSE41);
+				CompareSIMDTransformSeries(inFormat, MVFMT_RGB24, PackedY422_to_RGB24, PackedY422_to_RGB24_SSE41);
+				CompareSIMDTransformSeries(inFormat, MVFMT_RGB565, PackedY422_to_RGB565, PackedY422_to_RGB565_SSE41);
+				CompareSIMDTransformSeries(inFormat, MVFMT_RGB555, PackedY422_to_RGB555, PackedY422_to_RGB555_SSE41);
+			}
+
+			if (GetCpuFeatures().avx2)
+			{
+				CompareSIMDTransformSeries(inFormat, MVFMT_RGB32, PackedY422_to_RGB32, PackedY422_to_RGB32_AVX2);
+				CompareSIMDTransformSeries(inFormat, MVFMT_RGB24, PackedY422_to_RGB24, PackedY422_to_RGB24_AVX2);
+				CompareSIMDTransformSeries(inFormat, MVFMT_RGB565, PackedY422_to_RGB565, PackedY422_to_RGB565_AVX2);
+				CompareSIMDTransformSeries(inFormat, MVFMT_RGB555, PackedY422_to_RGB555, PackedY422_to_RGB555_AVX2);
+			}
+		}
+
+		TEST_METHOD(YUY2_to_RGB_SIMD_UnitTest)
+		{
+			RunPackedY422toRGB(MVFMT_YUY2);
+		}
+
+		TEST_METHOD(UYVY_to_RGB_SIMD_UnitTest)
+		{
+			RunPackedY422toRGB(MVFMT_UYVY);
+		}
+
+		TEST_METHOD(YVYU_to_RGB_SIMD_UnitTest)
+		{
+			RunPackedY422toRGB(MVFMT_YVYU);
+		}
+
+		TEST_METHOD(VYUY_to_RGB_SIMD_UnitTest)
+		{
+			RunPackedY422toRGB(MVFMT_VYUY);
+		}
+
+		//
+		// Packed Y422 to packed Y422
+		//
+
+		void RunPackedY422toPackedY422(const MediaFormatID& inFormat)
+		{
+			for (const MediaFormatID* outFormat : { &MVFMT_YUY2, &MVFMT_UYVY, &MVFMT_YVYU, &MVFMT_VYUY })
+			{
+				if (*outFormat == inFormat)
+					continue;
+
+				if (GetCpuFeatures().sse41)
+					CompareSIMDTransformSeries(inFormat, *outFormat, PackedY422_to_PackedY422, PackedY422_to_PackedY422_SSE41);
+
+				if (GetCpuFeatures().avx2)
+					CompareSIMDTransformSeries(inFormat, *outFormat, PackedY422_to_PackedY422, PackedY422_to_PackedY422_AVX2);
+			}
+		}
+
+		TEST_METHOD(YUY2_to_PackedY422_SIMD_UnitTest)
+		{
+			RunPackedY422toPackedY422(MVFMT_YUY2);
+		}
+
+		TEST_METHOD(UYVY_to_PackedY422_SIMD_UnitTest)
+		{
+			RunPackedY422toPackedY422(MVFMT_UYVY);
+		}
+
+		TEST_METHOD(YVYU_to_PackedY422_SIMD_UnitTest)
+		{
+			RunPackedY422toPackedY422(MVFMT_YVYU);
+		}
+
+		TEST_METHOD(VYUY_to_PackedY422_SIMD_UnitTest)
+		{
+			RunPackedY422toPackedY422(MVFMT_VYUY);
+		}
+
+		//
+		// NVx chroma interleave and deinterleave
+		//
+
+		void RunNVxInterleave(const MediaFormatID& nvFormat)
+		{
+			for (const MediaFormatID* format : { &MVFMT_I420, &MVFMT_YV12, &MVFMT_YUV9, &MVFMT_YVU9 })
+			{
+				if (GetCpuFeatures().sse41)
+				{
+					CompareSIMDTransformSeries(*format, nvFormat, PlanarYUV_to_NVx, PlanarYUV_to_NVx_SSE41);
+					CompareSIMDTransformSeries(nvFormat, *format, NVx_to_PlanarYUV, NVx_to_PlanarYUV_SSE41);
+				}
+
+				if (GetCpuFeatures().avx2)
+				{
+					CompareSIMDTransformSeries(*format, nvFormat, PlanarYUV_to_NVx, PlanarYUV_to_NVx_AVX2);
+					CompareSIMDTransformSeries(nvFormat, *format, NVx_to_PlanarYUV, NVx_to_PlanarYUV_AVX2);
+				}
+			}
+
+			for (const MediaFormatID* format : { &MVFMT_IMC1, &MVFMT_IMC2, &MVFMT_IMC3, &MVFMT_IMC4 })
+			{
+				if (GetCpuFeatures().sse41)
+				{
+					CompareSIMDTransformSeries(*format, nvFormat, IMCx_to_NVx, IMCx_to_NVx_SSE41);
+					CompareSIMDTransformSeries(nvFormat, *format, NVx_to_IMCx, NVx_to_IMCx_SSE41);
+				}
+
+				if (GetCpuFeatures().avx2)
+				{
+					CompareSIMDTransformSeries(*format, nvFormat, IMCx_to_NVx, IMCx_to_NVx_AVX2);
+					CompareSIMDTransformSeries(nvFormat, *format, NVx_to_IMCx, NVx_to_IMCx_AVX2);
+				}
+			}
+		}
+
+		TEST_METHOD(NV12_Interleave_SIMD_UnitTest)
+		{
+			RunNVxInterleave(MVFMT_NV12);
+		}
+
+		TEST_METHOD(NV21_Interleave_SIMD_UnitTest)
+		{
+			RunNVxInterleave(MVFMT_NV21);
+		}
+
+		//
+		// RGB to RGB
+		//
+
+		TEST_METHOD(RGB24_RGB32_SIMD_UnitTest)
+		{
+			if (GetCpuFeatures().sse41)
+			{
+				CompareSIMDTransformSeries(MVFMT_RGB24, MVFMT_RGB32, RGB24_to_RGB32, RGB24_to_RGB32_SSE41);
+				CompareSIMDTransformSeries(MVFMT_RGB32, MVFMT_RGB24, RGB32_to_RGB24, RGB32_to_RGB24_SSE41);
+			}
+		}
+
+		TEST_METHOD(RGB32_to_RGB16_SIMD_UnitTest)
+		{
+			if (GetCpuFeatures().sse41)
+			{
+				CompareSIMDTransformSeries(MVFMT_RGB32, MVFMT_RGB565, RGB32_to_RGB565, RGB32_to_RGB565_SSE41);
+				CompareSIMDTransformSeries(MVFMT_RGB32, MVFMT_RGB555, RGB32_to_RGB555, RGB32_to_RGB555_SSE41);
+			}
+		}
+
+		TEST_METHOD(RGB16_to_RGB32_SIMD_UnitTest)
+		{
+			if (GetCpuFeatures().sse41)
+			{
+				CompareSIMDTransformSeries(MVFMT_RGB565, MVFMT_RGB32, RGB565_to_RGB32, RGB565_to_RGB32_SSE41);
+				CompareSIMDTransformSeries(MVFMT_RGB555, MVFMT_RGB32, RGB555_to_RGB32, RGB555_to_RGB32_SSE41);
+			}
+		}
+
+		//
+		// RGB to planar YUV
+		//
+
+		// The SIMD encoders use fixed-point dot products instead of the lookup tables and may be off by 1.
+		void RunRGBtoPlanarYUV(const MediaFormatID& outFormat)
+		{
+			if (GetCpuFeatures().sse41)
+			{
+				CompareSIMDTransformSeries(MVFMT_RGB32, outFormat, RGB32_to_PlanarYUV, RGB32_to_PlanarYUV_SSE41, 1);
+				CompareSIMDTransformSeries(MVFMT_RGB24, outFormat, RGB24_to_PlanarYUV, RGB24_to_PlanarYUV_SSE41, 1);
+			}
+
+			if (GetCpuFeatures().avx2)
+			{
+				CompareSIMDTransformSeries(MVFMT_RGB32, outFormat, RGB32_to_PlanarYUV, RGB32_to_PlanarYUV_AVX2, 1);
+				CompareSIMDTransformSeries(MVFMT_RGB24, outFormat, RGB24_to_PlanarYUV, RGB24_to_PlanarYUV_AVX2, 1);
+			}
+		}
+
+		TEST_METHOD(RGB_to_I420_SIMD_UnitTest)
+		{
+			RunRGBtoPlanarYUV(MVFMT_I420);
+		}
+
+		TEST_METHOD(RGB_to_YV12_SIMD_UnitTest)
+		{
+			RunRGBtoPlanarYUV(MVFMT_YV12);
+		}
+
+		TEST_METHOD(RGB_to_YVU9_SIMD_UnitTest)
+		{
+			RunRGBtoPlanarYUV(MVFMT_YVU9);
+		}
+	};
+
+#endif
+}
@@ -0,0 +1,577 @@
+//
+//  blipvert C++ library
+//
+//  MIT License
+//
+//  Copyright(c) 2021-2025 Don Jordan
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+//
+
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include "blipvert.h"
+#include "Utilities.h"
+#include "ThreadPool.h"
+#include "TransformPlan.h"
+#include "Numa.h"
+
+#include <atomic>
+#include <memory>
+#include <random>
+#include <vector>
+#include <future>
+#include <thread>
+#include <chrono>
+#include <cstring>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace blipvert;
+
+namespace BlipvertUnitTests
+{
+	static void __cdecl CountSlice(void* context, uint8_t slice_index)
+	{
+		std::atomic<uint32_t>* counts = static_cast<std::atomic<uint32_t>*>(context);
+		counts[slice_index].fetch_add(1);
+	}
+
+	// Counts the slice after holding its thread long enough that the caller's wait outlasts its spin.
+	static void __cdecl SlowCountSlice(void* context, uint8_t slice_index)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(slice_index % 2 ? 20 : 1));
+		CountSlice(context, slice_index);
+	}
+
+	typedef struct {
+		std::atomic<uint32_t> counts[8];
+		std::atomic<uint32_t> done;
+		std::atomic<uint32_t>* frames_done;
+	} SubmittedFrame;
+
+	static void __cdecl CountFrameSlice(void* context, uint8_t slice_index)
+	{
+		static_cast<SubmittedFrame*>(context)->counts[slice_index].fetch_add(1);
+	}
+
+	static void __cdecl CountFrameDone(void* context)
+	{
+		SubmittedFrame* frame = static_cast<SubmittedFrame*>(context);
+		frame->done.fetch_add(1);
+		frame->frames_done->fetch_add(1);
+	}
+
+	// Resubmits the same job from its own completion until the chain has run out.
+	typedef struct {
+		TransformPlan plan;
+		std::vector<uint8_t> in_buf;
+		std::vector<uint8_t> out_buf;
+		TransformJob job;
+		std::atomic<uint32_t> frames_left;
+	} FrameChain;
+
+	static void __cdecl ResubmitFrame(void* context)
+	{
+		FrameChain* chain = static_cast<FrameChain*>(context);
+		if (chain->frames_left.fetch_sub(1) > 1)
+			SubmitTransform(chain->plan, chain->in_buf.data(), chain->out_buf.data(), chain->job, ResubmitFrame, chain);
+	}
+
+	// A frame whose done function transforms a frame of its own with ParallelTransform.
+	typedef struct {
+		std::atomic<bool>* gate_open;
+		std::vector<uint8_t>* in_buf;
+		std::vector<uint8_t> out_buf;
+		std::atomic<uint32_t>* frames_done;
+	} NestedTransformFrame;
+
+	static void __cdecl WaitForGate(void* context, uint8_t slice_index)
+	{
+		while (!static_cast<std::atomic<bool>*>(context)->load())
+			std::this_thread::yield();
+	}
+
+	static void __cdecl NoSlice(void* context, uint8_t slice_index)
+	{
+	}
+
+	static void __cdecl NestedTransformDone(void* context)
+	{
+		// The next slot is the gate frame's, so the gate has to open for this frame to be submitted.
+		NestedTransformFrame* frame = static_cast<NestedTransformFrame*>(context);
+		frame->gate_open->store(true);
+		ParallelTransform(MVFMT_I420, MVFMT_RGB24, 128, 96, frame->in_buf->data(), 0, frame->out_buf.data(), 0, 24);
+		frame->frames_done->fetch_add(1);
+	}
+
+	static void __cdecl CountTransformDone(void* context)
+	{
+		static_cast<std::atomic<uint32_t>*>(context)->fetch_add(1);
+	}
+
+	TEST_CLASS(ThreadPoolUnitTests)
+	{
+	public:
+
+		// Transforms a random frame with ParallelTransform, or ParallelTransformBands when band_rows isn't 0, and on a
+		// single thread, and checks the results are the same.
+		void CompareParallelToSingle(const MediaFormatID& inFormat, const MediaFormatID& outFormat, int32_t width, int32_t height,
+			uint8_t thread_count, bool out_flipped, int32_t band_rows = 0)
+		{
+			uint32_t in_size = CalculateBufferSize(inFormat, width, height);
+			uint32_t out_size = CalculateBufferSize(outFormat, width, height);
+
+			std::unique_ptr<uint8_t[]> in_buf(new uint8_t[in_size]);
+			std::unique_ptr<uint8_t[]> parallel_buf(new uint8_t[out_size]);
+			std::unique_ptr<uint8_t[]> single_buf(new uint8_t[out_size]);
+
+			std::mt19937 generator(static_cast<uint32_t>(width * height));
+			for (uint32_t index = 0; index < in_size; index++)
+			{
+				in_buf[index] = static_cast<uint8_t>(generator());
+			}
+
+			memset(parallel_buf.get(), 0, out_size);
+			memset(single_buf.get(), 0, out_size);
+
+			if (band_rows)
+			{
+				Assert::IsTrue(ParallelTransformBands(inFormat, outFormat, width, height, in_buf.get(), 0, parallel_buf.get(), 0, band_rows, false, out_flipped),
+					L"ParallelTransformBands failed.");
+			}
+			else
+			{
+				Assert::IsTrue(ParallelTransform(inFormat, outFormat, width, height, in_buf.get(), 0, parallel_buf.get(), 0, thread_count, false, out_flipped),
+					L"ParallelTransform failed.");
+			}
+
+			TransformPlan plan;
+			Assert::IsTrue(CreateTransformPlan(plan, inFormat, outFormat, width, height, 0, 0, false, out_flipped, 1), L"CreateTransformPlan failed.");
+			ExecuteTransformPlan(plan, in_buf.get(), single_buf.get());
+
+			Assert::IsTrue(memcmp(parallel_buf.get(), single_buf.get(), out_size) == 0, L"ParallelTransform's output differs from a single thread.");
+		}
+
+		TEST_METHOD(RunSlicesRunsEverySliceOnce_UnitTest)
+		{
+			const uint8_t slice_count = 37;
+			std::atomic<uint32_t> counts[slice_count];
+
+			for (int frame = 0; frame < 500; frame++)
+			{
+				for (auto& count : counts)
+					count.store(0);
+
+				RunSlices(CountSlice, counts, slice_count);
+
+				for (auto& count : counts)
+					Assert::AreEqual(static_cast<uint32_t>(1), count.load(), L"A slice was not run exactly once.");
+			}
+		}
+
+		// The callers finish their own slices well before the workers' slow ones, so they go to sleep waiting for
+		// their frames and have to be woken by whichever thread finishes them.
+		TEST_METHOD(RunSlicesWaitsForSlowSlices_UnitTest)
+		{
+			const uint8_t slice_count = 6;
+			SetThreadPoolSize(3);
+
+			std::vector<std::thread> callers;
+			std::atomic<uint32_t> failures(0);
+			for (int caller = 0; caller < 3; caller++)
+			{
+				callers.emplace_back([&failures]() {
+					std::atomic<uint32_t> counts[slice_count];
+					for (int frame = 0; frame < 10; frame++)
+					{
+						for (auto& count : counts)
+							count.store(0);
+
+						RunSlices(SlowCountSlice, counts, slice_count);
+
+						for (auto& count : counts)
+						{
+							if (count.load() != 1)
+								failures.fetch_add(1);
+						}
+					}
+					});
+			}
+
+			for (auto& caller : callers)
+				caller.join();
+			SetThreadPoolSize(0);
+
+			Assert::AreEqual(static_cast<uint32_t>(0), failures.load(), L"A slice was not run exactly once before RunSlices returned.");
+		}
+
+		TEST_METHOD(ParallelTransformMatchesSingleThread_UnitTest)
+		{
+			CompareParallelToSingle(MVFMT_YUY2, MVFMT_RGB32, 320, 240, 4, false);
+			CompareParallelToSingle(MVFMT_YUY2, MVFMT_RGB32, 320, 240, 8, true);
+			CompareParallelToSingle(MVFMT_RGB32, MVFMT_I420, 320, 240, 4, false);
+			CompareParallelToSingle(MVFMT_I420, MVFMT_RGB24, 320, 240, 6, true);
+			CompareParallelToSingle(MVFMT_NV12, MVFMT_YV12, 320, 240, 4, false);
+			CompareParallelToSingle(MVFMT_RGB565, MVFMT_NV21, 320, 240, 3, false);
+		}
+
+		TEST_METHOD(GetBandCount_UnitTest)
+		{
+			Assert::AreEqual(33, static_cast<int32_t>(GetBandCount(1080)), L"Wrong band count for 1080 rows.");
+			Assert::AreEqual(67, static_cast<int32_t>(GetBandCount(2160, 32)), L"Wrong band count for 2160 rows.");
+			Assert::AreEqual(67, static_cast<int32_t>(GetBandCount(2160, 30)), L"The band rows weren't rounded up to the row granularity.");
+			Assert::AreEqual(255, static_cast<int32_t>(GetBandCount(4320, 4)), L"The band count wasn't limited to 255.");
+			Assert::AreEqual(1, static_cast<int32_t>(GetBandCount(20)), L"A short frame wasn't left as one band.");
+			Assert::AreEqual(1, static_cast<int32_t>(GetBandCount(2)), L"A frame of less than one band wasn't left as one band.");
+			Assert::AreEqual(100, static_cast<int32_t>(GetBandCount(400, 0)), L"A band of 0 rows wasn't rounded up to the row granularity.");
+		}
+
+		TEST_METHOD(ParallelTransformBandsMatchesSingleThread_UnitTest)
+		{
+			for (int32_t band_rows : { 1, 16, 30, 64 })
+			{
+				CompareParallelToSingle(MVFMT_YUY2, MVFMT_RGB32, 320, 1080, 0, false, band_rows);
+				CompareParallelToSingle(MVFMT_RGB32, MVFMT_I420, 320, 722, 0, true, band_rows);
+				CompareParallelToSingle(MVFMT_NV12, MVFMT_YV12, 320, 240, 0, false, band_rows);
+				CompareParallelToSingle(MVFMT_YUV9, MVFMT_RGB24, 320, 244, 0, true, band_rows);
+			}
+		}
+
+		TEST_METHOD(ExecuteTransformPlanParallel_UnitTest)
+		{
+			TransformPlan plan;
+			Assert::IsTrue(CreateTransformPlan(plan, MVFMT_UYVY, MVFMT_RGB24, 128, 96, 0, 0, false, false, 4), L"CreateTransformPlan failed.");
+
+			uint32_t in_size = CalculateBufferSize(MVFMT_UYVY, 128, 96);
+			uint32_t out_size = CalculateBufferSize(MVFMT_RGB24, 128, 96);
+
+			std::unique_ptr<uint8_t[]> in_buf(new uint8_t[in_size]);
+			std::unique_ptr<uint8_t[]> parallel_buf(new uint8_t[out_size]);
+			std::unique_ptr<uint8_t[]> single_buf(new uint8_t[out_size]);
+			for (uint32_t index = 0; index < in_size; index++)
+			{
+				in_buf[index] = static_cast<uint8_t>(index * 7);
+			}
+
+			ExecuteTransformPlanParallel(plan, in_buf.get(), parallel_buf.get());
+			ExecuteTransformPlan(plan, in_buf.get(), single_buf.get());
+
+			Assert::IsTrue(memcmp(parallel_buf.get(), single_buf.get(), out_size) == 0, L"The parallel plan's output differs from a single thread.");
+		}
+
+		TEST_METHOD(ThreadPoolResize_UnitTest)
+		{
+			std::atomic<uint32_t> counts[16];
+
+			SetThreadPoolSize(3);
+			Assert::AreEqual(static_cast<uint32_t>(3), GetThreadPoolSize(), L"The pool has the wrong size.");
+
+			for (auto& count : counts)
+				count.store(0);
+			RunSlices(CountSlice, counts, 16);
+			for (auto& count : counts)
+				Assert::AreEqual(static_cast<uint32_t>(1), count.load(), L"A slice was not run exactly once.");
+
+			ShutdownThreadPool();
+			SetThreadPoolSize(0);
+
+			for (auto& count : counts)
+				count.store(0);
+			RunSlices(CountSlice, counts, 16);
+			for (auto& count : counts)
+				Assert::AreEqual(static_cast<uint32_t>(1), count.load(), L"A slice was not run after the pool was restarted.");
+		}
+
+		TEST_METHOD(NumaTopology_UnitTest)
+		{
+			uint32_t node_count = GetNumaNodeCount();
+			Assert::IsTrue(node_count >= 1, L"There are no NUMA nodes.");
+
+			std::vector<uint32_t> cpus;
+			uint32_t cpu_count = 0;
+			for (uint32_t node = 0; node < node_count; node++)
+			{
+				if (!GetNumaNodeCpus(node, cpus))
+					continue;
+
+				cpu_count += static_cast<uint32_t>(cpus.size());
+				for (uint32_t cpu : cpus)
+					Assert::AreEqual(static_cast<int32_t>(node), GetCpuNumaNode(cpu), L"A processor isn't on the node that lists it.");
+			}
+
+			Assert::IsTrue(cpu_count > 0, L"No node has any processors.");
+			Assert::IsTrue(GetCurrentNumaNode() < static_cast<int32_t>(node_count), L"The current node is out of range.");
+		}
+
+		TEST_METHOD(NodeBuffer_UnitTest)
+		{
+			const size_t size = 1024 * 1024;
+			for (uint32_t node = 0; node < GetNumaNodeCount(); node++)
+			{
+				std::vector<uint32_t> cpus;
+				if (!GetNumaNodeCpus(node, cpus))
+					continue;
+
+				uint8_t* buf = AllocateNodeBuffer(size, static_cast<int32_t>(node));
+				Assert::IsNotNull(buf, L"AllocateNodeBuffer failed.");
+				memset(buf, 0x5A, size);
+
+				// -1 where the OS won't say.
+				int32_t buf_node = GetBufferNumaNode(buf + size / 2);
+				Assert::IsTrue(buf_node == -1 || buf_node == static_cast<int32_t>(node), L"The buffer isn't on its node.");
+				FreeNodeBuffer(buf, size);
+			}
+		}
+
+		TEST_METHOD(PinnedThreadPool_UnitTest)
+		{
+			ThreadPoolOptions options = { 3, {}, true };
+			std::vector<uint32_t> cpus;
+			for (uint32_t node = 0; node < GetNumaNodeCount(); node++)
+			{
+				if (GetNumaNodeCpus(node, cpus))
+					options.cpu_sets.push_back(cpus);
+			}
+			SetThreadPoolOptions(options);
+
+			ThreadPoolOptions result;
+			GetThreadPoolOptions(result);
+			Assert::AreEqual(static_cast<uint32_t>(3), GetThreadPoolSize(), L"The pool has the wrong size.");
+			Assert::IsTrue(result.numa_local && result.cpu_sets == options.cpu_sets, L"The pool options weren't kept.");
+
+			uint32_t in_size = CalculateBufferSize(MVFMT_YUY2, 320, 240);
+			uint32_t out_size = CalculateBufferSize(MVFMT_RGB32, 320, 240);
+			uint8_t* in_buf = AllocateNodeBuffer(in_size, 0);
+			uint8_t* out_buf = AllocateNodeBuffer(out_size, 0);
+			std::unique_ptr<uint8_t[]> single_buf(new uint8_t[out_size]);
+			for (uint32_t index = 0; index < in_size; index++)
+			{
+				in_buf[index] = static_cast<uint8_t>(index * 11);
+			}
+
+			std::atomic<uint32_t> counts[16];
+			for (auto& count : counts)
+				count.store(0);
+			RunSlicesNear(CountSlice, counts, 16, in_buf);
+			for (auto& count : counts)
+				Assert::AreEqual(static_cast<uint32_t>(1), count.load(), L"A slice kept on the buffer's node was not run exactly once.");
+
+			Assert::IsTrue(ParallelTransform(MVFMT_YUY2, MVFMT_RGB32, 320, 240, in_buf, 0, out_buf, 0, 8), L"ParallelTransform failed.");
+			TransformPlan plan;
+			Assert::IsTrue(CreateTransformPlan(plan, MVFMT_YUY2, MVFMT_RGB32, 320, 240), L"CreateTransformPlan failed.");
+			ExecuteTransformPlan(plan, in_buf, single_buf.get());
+			bool same = memcmp(out_buf, single_buf.get(), out_size) == 0;
+
+			FreeNodeBuffer(in_buf, in_size);
+			FreeNodeBuffer(out_buf, out_size);
+			SetThreadPoolOptions({ 0, {}, false });
+
+			Assert::IsTrue(same, L"The pinned pool's output differs from a single thread.");
+		}
+
+		TEST_METHOD(SubmitSlicesRunsEverySliceOnce_UnitTest)
+		{
+			// More frames than the pool holds, so some submissions wait for a slot.
+			const uint32_t frame_count = 3 * MaxFramesInFlight;
+			std::unique_ptr<SubmittedFrame[]> frames(new SubmittedFrame[frame_count]);
+			std::atomic<uint32_t> frames_done(0);
+
+			SetThreadPoolSize(3);
+			for (uint32_t index = 0; index < frame_count; index++)
+			{
+				for (auto& count : frames[index].counts)
+					count.store(0);
+				frames[index].done.store(0);
+				frames[index].frames_done = &frames_done;
+				SubmitSlices(CountFrameSlice, &frames[index], 8, CountFrameDone);
+			}
+
+			while (frames_done.load() < frame_count)
+				std::this_thread::yield();
+
+			for (uint32_t index = 0; index < frame_count; index++)
+			{
+				Assert::AreEqual(static_cast<uint32_t>(1), frames[index].done.load(), L"A frame's done function was not called exactly once.");
+				for (auto& count : frames[index].counts)
+					Assert::AreEqual(static_cast<uint32_t>(1), count.load(), L"A submitted slice was not run exactly once.");
+			}
+
+			SetThreadPoolSize(0);
+		}
+
+		TEST_METHOD(SubmitTransformMatchesSingleThread_UnitTest)
+		{
+			const uint32_t frame_count = 24;
+			TransformPlan plan;
+			Assert::IsTrue(CreateTransformPlan(plan, MVFMT_YUY2, MVFMT_RGB32, 320, 240, 0, 0, false, false, 8), L"CreateTransformPlan failed.");
+
+			uint32_t in_size = CalculateBufferSize(MVFMT_YUY2, 320, 240);
+			uint32_t out_size = CalculateBufferSize(MVFMT_RGB32, 320, 240);
+			std::vector<std::vector<uint8_t>> in_bufs(frame_count, std::vector<uint8_t>(in_size));
+			std::vector<std::vector<uint8_t>> out_bufs(frame_count, std::vector<uint8_t>(out_size, 0));
+			for (uint32_t frame = 0; frame < frame_count; frame++)
+			{
+				for (uint32_t index = 0; index < in_size; index++)
+					in_bufs[frame][index] = static_cast<uint8_t>(index * 3 + frame * 17);
+			}
+
+			// Every other frame uses a completion callback, the rest a future.
+			SetThreadPoolSize(3);
+			std::vector<TransformJob> jobs(frame_count);
+			std::vector<std::future<void>> futures;
+			std::atomic<uint32_t> callbacks(0);
+			for (uint32_t frame = 0; frame < frame_count; frame++)
+			{
+				if (frame % 2)
+					futures.push_back(SubmitTransform(plan, in_bufs[frame].data(), out_bufs[frame].data()));
+				else
+					SubmitTransform(plan, in_bufs[frame].data(), out_bufs[frame].data(), jobs[frame], CountTransformDone, &callbacks);
+			}
+
+			for (auto& future : futures)
+				future.wait();
+			while (callbacks.load() < frame_count / 2)
+				std::this_thread::yield();
+			SetThreadPoolSize(0);
+
+			std::vector<uint8_t> single_buf(out_size);
+			for (uint32_t frame = 0; frame < frame_count; frame++)
+			{
+				ExecuteTransformPlan(plan, in_bufs[frame].data(), single_buf.data());
+				Assert::IsTrue(out_bufs[frame] == single_buf, L"A submitted frame's output differs from a single thread.");
+			}
+		}
+
+		TEST_METHOD(SubmitTransformFromCompletion_UnitTest)
+		{
+			FrameChain chain;
+			Assert::IsTrue(CreateTransformPlan(chain.plan, MVFMT_I420, MVFMT_RGB24, 128, 96, 0, 0, false, false, 4), L"CreateTransformPlan failed.");
+			chain.in_buf.assign(CalculateBufferSize(MVFMT_I420, 128, 96), 100);
+			chain.out_buf.assign(CalculateBufferSize(MVFMT_RGB24, 128, 96), 0);
+			chain.frames_left.store(50);
+
+			SetThreadPoolSize(2);
+			SubmitTransform(chain.plan, chain.in_buf.data(), chain.out_buf.data(), chain.job, ResubmitFrame, &chain);
+			while (chain.frames_left.load() != 0)
+				std::this_thread::yield();
+			SetThreadPoolSize(0);
+
+			std::vector<uint8_t> single_buf(chain.out_buf.size());
+			ExecuteTransformPlan(chain.plan, chain.in_buf.data(), single_buf.data());
+			Assert::IsTrue(chain.out_buf == single_buf, L"The chained frames' output differs from a single thread.");
+		}
+
+		// More chains than the pool has frame slots, so submitting often has to wait, and the frames finished while
+		// it does submit frames of their own.
+		TEST_METHOD(SubmitTransformChainsFillRing_UnitTest)
+		{
+			std::vector<FrameChain> chains(MaxFramesInFlight * 2);
+			for (auto& chain : chains)
+			{
+				Assert::IsTrue(CreateTransformPlan(chain.plan, MVFMT_I420, MVFMT_RGB24, 128, 96, 0, 0, false, false, 4), L"CreateTransformPlan failed.");
+				chain.in_buf.assign(CalculateBufferSize(MVFMT_I420, 128, 96), 100);
+				chain.out_buf.assign(CalculateBufferSize(MVFMT_RGB24, 128, 96), 0);
+				chain.frames_left.store(20);
+			}
+
+			SetThreadPoolSize(3);
+			for (auto& chain : chains)
+				SubmitTransform(chain.plan, chain.in_buf.data(), chain.out_buf.data(), chain.job, ResubmitFrame, &chain);
+			for (auto& chain : chains)
+			{
+				while (chain.frames_left.load() != 0)
+					std::this_thread::yield();
+			}
+			SetThreadPoolSize(0);
+
+			std::vector<uint8_t> single_buf(chains[0].out_buf.size());
+			ExecuteTransformPlan(chains[0].plan, chains[0].in_buf.data(), single_buf.data());
+			for (auto& chain : chains)
+				Assert::IsTrue(chain.out_buf == single_buf, L"A chained frame's output differs from a single thread.");
+		}
+
+		// Resizing the pool finishes the frames in flight, so it runs the chain's done functions and the frames they
+		// submit without holding up their submissions.
+		TEST_METHOD(ResizeFinishesChainedFrames_UnitTest)
+		{
+			FrameChain chain;
+			Assert::IsTrue(CreateTransformPlan(chain.plan, MVFMT_I420, MVFMT_RGB24, 128, 96, 0, 0, false, false, 4), L"CreateTransformPlan failed.");
+			chain.in_buf.assign(CalculateBufferSize(MVFMT_I420, 128, 96), 100);
+			chain.out_buf.assign(CalculateBufferSize(MVFMT_RGB24, 128, 96), 0);
+			chain.frames_left.store(50);
+
+			SetThreadPoolSize(2);
+			SubmitTransform(chain.plan, chain.in_buf.data(), chain.out_buf.data(), chain.job, ResubmitFrame, &chain);
+			SetThreadPoolSize(0);
+
+			Assert::AreEqual(static_cast<uint32_t>(0), chain.frames_left.load(), L"Resizing the pool returned before the chained frames finished.");
+		}
+
+		// The pool's only worker is held up and the ring is full, so ParallelTransform runs the other frames while it
+		// waits for a slot, and their done functions call ParallelTransform on the same thread.
+		TEST_METHOD(ParallelTransformFromDoneWhileRingFull_UnitTest)
+		{
+			std::vector<uint8_t> nested_in(CalculateBufferSize(MVFMT_I420, 128, 96));
+			for (size_t index = 0; index < nested_in.size(); index++)
+				nested_in[index] = static_cast<uint8_t>(index * 5 + 1);
+			std::vector<uint8_t> in_buf(CalculateBufferSize(MVFMT_YUY2, 320, 240));
+			for (size_t index = 0; index < in_buf.size(); index++)
+				in_buf[index] = static_cast<uint8_t>(index * 3 + 7);
+			std::vector<uint8_t> out_buf(CalculateBufferSize(MVFMT_RGB32, 320, 240), 0);
+
+			SetThreadPoolSize(1);
+			std::atomic<bool> gate_open(false);
+			std::atomic<uint32_t> frames_done(0);
+			std::vector<NestedTransformFrame> frames(MaxFramesInFlight - 1);
+			SubmitSlices(WaitForGate, &gate_open, 1, nullptr);
+			for (auto& frame : frames)
+			{
+				frame.gate_open = &gate_open;
+				frame.in_buf = &nested_in;
+				frame.out_buf.assign(CalculateBufferSize(MVFMT_RGB24, 128, 96), 0);
+				frame.frames_done = &frames_done;
+				SubmitSlices(NoSlice, &frame, 2, NestedTransformDone);
+			}
+
+			Assert::IsTrue(ParallelTransform(MVFMT_YUY2, MVFMT_RGB32, 320, 240, in_buf.data(), 0, out_buf.data(), 0, 4), L"ParallelTransform failed.");
+			while (frames_done.load() < frames.size())
+				std::this_thread::yield();
+			SetThreadPoolSize(0);
+
+			std::vector<uint8_t> single_buf(out_buf.size());
+			TransformPlan plan;
+			Assert::IsTrue(CreateTransformPlan(plan, MVFMT_YUY2, MVFMT_RGB32, 320, 240), L"CreateTransformPlan failed.");
+			ExecuteTransformPlan(plan, in_buf.data(), single_buf.data());
+			Assert::IsTrue(out_buf == single_buf, L"The waiting frame's output changed when a done function transformed another.");
+
+			std::vector<uint8_t> nested_single(frames[0].out_buf.size());
+			Assert::IsTrue(CreateTransformPlan(plan, MVFMT_I420, MVFMT_RGB24, 128, 96), L"CreateTransformPlan failed.");
+			ExecuteTransformPlan(plan, nested_in.data(), nested_single.data());
+			for (auto& frame : frames)
+				Assert::IsTrue(frame.out_buf == nested_single, L"A done function's ParallelTransform output differs from a single thread.");
+		}
+
+		TEST_METHOD(InvalidParallelTransform_UnitTest)
+		{
+			uint8_t buf[64];
+			Assert::IsFalse(ParallelTransform(MVFMT_UYVY, MediaFormatID("wowzo"), 4, 4, buf, 0, buf, 0, 4), L"ParallelTransform succeeded for an unknown format.");
+		}
+	};
+}
@@ -33,11 +33,20 @@
 #include "ToFillColor.h"
 
 #include "BufferChecks.h"
+#include "LookupTables.h"
+#include "CommonMacros.h"
+#include "ThreadPool.h"
 
 #include <memory>
+#include <random>
+#include <locale>
+#include <string>
+#include <cstring>
+#include <vector>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace blipvert;
+using namespace std;
 
 namespace BlipvertUnitTests
 {
@@ -175,8 +184,248 @@ namespace BlipvertUnitTests
 			RunYUV8bitAlphaTestSeries(MVFMT_YV16);
 		}
 
+		TEST_METHOD(ParallelGreyscaleUnitTest)
+		{
+			for (const MediaFormatID* format : GreyscaleFormats)
+			{
+				RunParallelGreyscaleTest(*format);
+			}
+
+			uint32_t saveb = StrideBump;
+			StrideBump = StrideBumpTestValue;
+
+			for (const MediaFormatID* format : GreyscaleFormats)
+			{
+				RunParallelGreyscaleTest(*format);
+			}
+
+			StrideBump = saveb;
+		}
+
+		TEST_METHOD(RGBLumaUnitTest)
+		{
+			// Odd widths leave columns for the generic code after the vectorized ones.
+			for (int32_t width = 8; width <= 72; width++)
+			{
+				RunRGBLumaTest(MVFMT_RGBA, width);
+				RunRGBLumaTest(MVFMT_RGB32, width);
+				RunRGBLumaTest(MVFMT_RGB24, width);
+				RunRGBLumaTest(MVFMT_RGB565, width);
+				RunRGBLumaTest(MVFMT_RGB555, width);
+				RunRGBLumaTest(MVFMT_ARGB1555, width);
+			}
+		}
+
 	private:
 
+		vector<const MediaFormatID*> GreyscaleFormats = {
+			&MVFMT_RGBA,
+			&MVFMT_RGB32,
+			&MVFMT_RGB24,
+			&MVFMT_RGB565,
+			&MVFMT_RGB555,
+			&MVFMT_ARGB1555,
+			&MVFMT_RGB8,
+			&MVFMT_RGB4,
+			&MVFMT_RGB1,
+			&MVFMT_AYUV,
+			&MVFMT_YUY2,
+			&MVFMT_UYVY,
+			&MVFMT_YVYU,
+			&MVFMT_VYUY,
+			&MVFMT_IYU1,
+			&MVFMT_IYU2,
+			&MVFMT_I420,
+			&MVFMT_YV12,
+			&MVFMT_YVU9,
+			&MVFMT_YUV9,
+			&MVFMT_Y41P,
+			&MVFMT_CLJR,
+			&MVFMT_IMC1,
+			&MVFMT_IMC2,
+			&MVFMT_IMC3,
+			&MVFMT_IMC4,
+			&MVFMT_NV12,
+			&MVFMT_NV21,
+			&MVFMT_Y42T,
+			&MVFMT_Y41T,
+			&MVFMT_YV16
+		};
+
+		wstring utf8ToUtf16Str(const string& str)
+		{
+			vector<wchar_t> buf(str.size());
+			use_facet<ctype<wchar_t>>(locale{}).widen(str.data(), str.data() + str.size(), buf.data());
+			return wstring(buf.data(), buf.size());
+		}
+
+		// Converts a random frame and palette with every slice count and checks them against the single threaded
+		// transform. The slices are also run one at a time in reverse order, which shows they don't depend on each other.
+		void RunParallelGreyscaleTest(const MediaFormatID& format)
+		{
+			wstring formatName = utf8ToUtf16Str(format);
+
+			t_greyscalefunc greyscale = FindGreyscaleTransform(format);
+			Assert::IsNotNull(reinterpret_cast<void*>(greyscale), wstring(L"FindGreyscaleTransform returned a null function pointer: " + formatName).c_str());
+
+			t_greyscaleslicefunc greyscale_slice = FindGreyscaleSliceTransform(format);
+			Assert::IsNotNull(reinterpret_cast<void*>(greyscale_slice), wstring(L"FindGreyscaleSliceTransform returned a null function pointer: " + formatName).c_str());
+
+			uint32_t width = TestBufferWidth;
+			uint32_t height = TestBufferHeight;
+			uint32_t stride = CalculateStrideBump(format, width, height);
+			uint32_t bufSize = CalculateBufferSize(format, width, height, stride);
+			Assert::IsTrue(bufSize != 0, wstring(L"bufSize size retuned zero: " + formatName).c_str());
+
+			std::unique_ptr<uint8_t[]> originalBuf(new uint8_t[bufSize]);
+			std::unique_ptr<uint8_t[]> expectedBuf(new uint8_t[bufSize]);
+			std::unique_ptr<uint8_t[]> testBuf(new uint8_t[bufSize]);
+			xRGBQUAD originalPalette[256];
+			xRGBQUAD expectedPalette[256];
+			xRGBQUAD testPalette[256];
+
+			std::mt19937 generator(bufSize);
+			std::uniform_int_distribution<int32_t> distribution(0, 255);
+			for (uint32_t index = 0; index < bufSize; index++)
+			{
+				originalBuf[index] = static_cast<uint8_t>(distribution(generator));
+			}
+
+			for (xRGBQUAD& entry : originalPalette)
+			{
+				entry.rgbRed = static_cast<uint8_t>(distribution(generator));
+				entry.rgbGreen = static_cast<uint8_t>(distribution(generator));
+				entry.rgbBlue = static_cast<uint8_t>(distribution(generator));
+				entry.rgbReserved = 0;
+			}
+
+			memcpy(expectedBuf.get(), originalBuf.get(), bufSize);
+			memcpy(expectedPalette, originalPalette, sizeof(expectedPalette));
+			greyscale(width, height, expectedBuf.get(), stride, expectedPalette);
+
+			const uint8_t thread_counts[] = { 1, 2, 3, 5, 8 };
+			for (uint8_t thread_count : thread_counts)
+			{
+				memcpy(testBuf.get(), originalBuf.get(), bufSize);
+				memcpy(testPalette, originalPalette, sizeof(testPalette));
+				Assert::IsTrue(ParallelGreyscale(format, width, height, testBuf.get(), stride, thread_count, testPalette), wstring(L"ParallelGreyscale failed: " + formatName).c_str());
+				Assert::AreEqual(0, memcmp(testBuf.get(), expectedBuf.get(), bufSize), wstring(L"Parallel greyscale did not match the single threaded transform: " + formatName).c_str());
+				Assert::AreEqual(0, memcmp(testPalette, expectedPalette, sizeof(testPalette)), wstring(L"Parallel greyscale palette did not match the single threaded transform: " + formatName).c_str());
+
+				memcpy(testBuf.get(), originalBuf.get(), bufSize);
+				memcpy(testPalette, originalPalette, sizeof(testPalette));
+				for (uint8_t index = thread_count; index > 0; index--)
+				{
+					greyscale_slice(index - 1, thread_count, width, height, testBuf.get(), stride, testPalette);
+				}
+				Assert::AreEqual(0, memcmp(testBuf.get(), expectedBuf.get(), bufSize), wstring(L"Greyscale slices did not match the single threaded transform: " + formatName).c_str());
+				Assert::AreEqual(0, memcmp(testPalette, expectedPalette, sizeof(testPalette)), wstring(L"Greyscale slice palette did not match the single threaded transform: " + formatName).c_str());
+			}
+		}
+
+		// Converts random pixels and checks each one against the lookup tables. The vectorized kernels can be 1 away
+		// from the tables, so any Y within 1 is accepted. The alpha must be kept as it was.
+		void RunRGBLumaTest(const MediaFormatID& format, int32_t width)
+		{
+			wstring formatName = utf8ToUtf16Str(format);
+
+			t_greyscalefunc greyscale = FindGreyscaleTransform(format);
+			Assert::IsNotNull(reinterpret_cast<void*>(greyscale), wstring(L"FindGreyscaleTransform returned a null function pointer: " + formatName).c_str());
+
+			int32_t height = 4;
+			int32_t bytes_per_pixel = (format == MVFMT_RGBA || format == MVFMT_RGB32) ? 4 : (format == MVFMT_RGB24 ? 3 : 2);
+			int32_t stride = width * bytes_per_pixel + 4;
+			int32_t bufSize = stride * height;
+
+			std::unique_ptr<uint8_t[]> originalBuf(new uint8_t[bufSize]);
+			std::unique_ptr<uint8_t[]> testBuf(new uint8_t[bufSize]);
+
+			std::mt19937 generator(width);
+			std::uniform_int_distribution<int32_t> distribution(0, 255);
+			for (int32_t index = 0; index < bufSize; index++)
+			{
+				originalBuf[index] = static_cast<uint8_t>(distribution(generator));
+			}
+
+			memcpy(testBuf.get(), originalBuf.get(), bufSize);
+			greyscale(width, height, testBuf.get(), stride, nullptr);
+
+			for (int32_t y = 0; y < height; y++)
+			{
+				for (int32_t x = 0; x < width; x++)
+				{
+					const uint8_t* in = originalBuf.get() + y * stride + x * bytes_per_pixel;
+					const uint8_t* out = testBuf.get() + y * stride + x * bytes_per_pixel;
+					Assert::IsTrue(IsGreyscalePixel(format, in, out), wstring(L"Greyscale pixel is more than 1 away from the lookup tables: " + formatName).c_str());
+				}
+			}
+
+			Assert::AreEqual(0, memcmp(testBuf.get() + width * bytes_per_pixel, originalBuf.get() + width * bytes_per_pixel, stride - width * bytes_per_pixel), wstring(L"Greyscale wrote past the end of the row: " + formatName).c_str());
+		}
+
+		bool IsGreyscalePixel(const MediaFormatID& format, const uint8_t* in, const uint8_t* out)
+		{
+			// The pixels sit at any byte offset in the row, so they're copied out rather than read through a cast.
+			uint16_t in_word;
+			uint16_t out_word;
+			memcpy(&in_word, in, sizeof(in_word));
+			memcpy(&out_word, out, sizeof(out_word));
+			uint32_t in_dword = 0;
+			uint32_t out_dword = 0;
+			if (format == MVFMT_RGBA || format == MVFMT_RGB32)
+			{
+				memcpy(&in_dword, in, sizeof(in_dword));
+				memcpy(&out_dword, out, sizeof(out_dword));
+			}
+
+			uint8_t red, green, blue;
+			if (format == MVFMT_RGB565)
+			{
+				UnpackRGB565Word(in_word, red, green, blue);
+			}
+			else if (format == MVFMT_RGB555 || format == MVFMT_ARGB1555)
+			{
+				UnpackRGB555Word(in_word, red, green, blue);
+			}
+			else
+			{
+				red = in[2];
+				green = in[1];
+				blue = in[0];
+			}
+
+			int32_t expected = ((yr_table[red] + yg_table[green] + yb_table[blue]) >> 15) + 16;
+			for (int32_t Y = expected - 1; Y <= expected + 1; Y++)
+			{
+				if (format == MVFMT_RGBA)
+				{
+					if (out_dword == ((in_dword & 0xFF000000) | rgba_greyscale[Y]))
+						return true;
+				}
+				else if (format == MVFMT_RGB32)
+				{
+					if (out_dword == rgb32_greyscale[Y])
+						return true;
+				}
+				else if (format == MVFMT_RGB24)
+				{
+					if (out[0] == Y && out[1] == Y && out[2] == Y)
+						return true;
+				}
+				else if (format == MVFMT_RGB565)
+				{
+					if (out_word == rgb565_greyscale[Y])
+						return true;
+				}
+				else if (out_word == ((in_word & RGB555_ALPHA_MASK) | rgba555_greyscale[Y]))
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
 		void RunRGB8bitTestSeries(const MediaFormatID& format)
 		{
 			for (const RGBATestData& testData : BlipvertUnitTests::TestMetaData)
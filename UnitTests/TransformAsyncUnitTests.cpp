@@ -0,0 +1,203 @@
+//
+//  blipvert C++ library
+//
+//  MIT License
+//
+//  Copyright(c) 2021-2025 Don Jordan
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+//
+
+
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include "blipvert.h"
+#include "Utilities.h"
+#include "ThreadPool.h"
+#include "TransformPlan.h"
+#include "TransformAsync.h"
+
+// The awaiter only exists when the tests are built as C++20 with coroutine support.
+#if !defined(__cpp_impl_coroutine) || !__has_include(<coroutine>)
+#error The unit tests must be built as C++20 with coroutine support.
+#endif
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <thread>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace blipvert;
+
+namespace BlipvertUnitTests
+{
+	// A coroutine that starts running when it's called and frees its frame when it ends.
+	typedef struct DetachedCoroutine {
+		struct promise_type {
+			DetachedCoroutine get_return_object() noexcept { return {}; }
+			std::suspend_never initial_suspend() noexcept { return {}; }
+			std::suspend_never final_suspend() noexcept { return {}; }
+			void return_void() noexcept {}
+			void unhandled_exception() noexcept { std::terminate(); }
+		};
+	} DetachedCoroutine;
+
+	typedef struct {
+		std::thread::id awaited_on;
+		std::thread::id resumed_on;
+		std::atomic<bool> finished;
+	} AwaitRecord;
+
+	static DetachedCoroutine AwaitTransform(const TransformPlan& plan, uint8_t* in_buf, uint8_t* out_buf, AwaitRecord& record)
+	{
+		record.awaited_on = std::this_thread::get_id();
+		co_await TransformAsync(plan, in_buf, out_buf);
+		record.resumed_on = std::this_thread::get_id();
+		record.finished.store(true);
+	}
+
+	typedef struct {
+		std::atomic<bool> started;
+		std::atomic<bool> open;
+	} Gate;
+
+	// Holds the worker that claims it until the gate opens.
+	static void __cdecl WaitAtGate(void* context, uint8_t slice_index)
+	{
+		Gate* gate = static_cast<Gate*>(context);
+		gate->started.store(true);
+		while (!gate->open.load())
+			std::this_thread::yield();
+	}
+
+	TEST_CLASS(TransformAsyncUnitTests)
+	{
+	public:
+
+		// Fills a frame with a pattern and returns the plan's output for it from a single thread.
+		static std::vector<uint8_t> ExpectedOutput(const TransformPlan& plan, const MediaFormatID& inFormat, const MediaFormatID& outFormat,
+			std::vector<uint8_t>& in_buf)
+		{
+			in_buf.resize(CalculateBufferSize(inFormat, plan.width, plan.height));
+			for (size_t index = 0; index < in_buf.size(); index++)
+				in_buf[index] = static_cast<uint8_t>(index * 7 + 3);
+
+			std::vector<uint8_t> out_buf(CalculateBufferSize(outFormat, plan.width, plan.height), 0);
+			ExecuteTransformPlan(plan, in_buf.data(), out_buf.data());
+			return out_buf;
+		}
+
+		// The frame finishes before await_suspend() returns, so the coroutine carries on on the thread that awaited.
+		TEST_METHOD(FrameFinishedBeforeSuspend_UnitTest)
+		{
+			TransformPlan plan;
+			Assert::IsTrue(CreateTransformPlan(plan, MVFMT_YUY2, MVFMT_RGB32, 64, 32, 0, 0, false, false, 2), L"CreateTransformPlan failed.");
+			std::vector<uint8_t> in_buf;
+			std::vector<uint8_t> expected = ExpectedOutput(plan, MVFMT_YUY2, MVFMT_RGB32, in_buf);
+			std::vector<uint8_t> out_buf(expected.size(), 0);
+
+			// A frame without slices is done as soon as it's submitted, whatever the pool's size, so the awaiter
+			// sees it finished first. Awaiting it skips the submission altogether.
+			TransformPlan empty_plan = plan;
+			empty_plan.thread_count = 0;
+			empty_plan.stages.clear();
+			TransformAwaiter awaiter(empty_plan, in_buf.data(), out_buf.data());
+			Assert::IsTrue(awaiter.await_ready(), L"A plan without slices should not suspend.");
+			Assert::IsFalse(awaiter.await_suspend(std::noop_coroutine()), L"The awaiter suspended after its frame finished.");
+
+			AwaitRecord record;
+			record.finished.store(false);
+			AwaitTransform(empty_plan, in_buf.data(), out_buf.data(), record);
+			Assert::IsTrue(record.finished.load(), L"Awaiting an empty plan suspended the coroutine.");
+
+			// Without workers the frame runs inside SubmitSlices(), so the coroutine finishes before the call returns.
+			// The default pool has none on a machine with a single hardware thread.
+			SetThreadPoolSize(0);
+			if (GetThreadPoolSize() == 0)
+			{
+				record.finished.store(false);
+				AwaitTransform(plan, in_buf.data(), out_buf.data(), record);
+				Assert::IsTrue(record.finished.load(), L"The coroutine suspended on a pool without workers.");
+				Assert::IsTrue(record.resumed_on == record.awaited_on, L"The coroutine moved threads on a pool without workers.");
+				Assert::IsTrue(out_buf == expected, L"The awaited frame's output differs from a single thread.");
+			}
+		}
+
+		// The pool's only worker is held up, so the coroutine suspends and the worker resumes it from the frame's
+		// done function once the gate opens.
+		TEST_METHOD(ResumedByDoneFunction_UnitTest)
+		{
+			TransformPlan plan;
+			Assert::IsTrue(CreateTransformPlan(plan, MVFMT_I420, MVFMT_RGB24, 128, 96, 0, 0, false, false, 4), L"CreateTransformPlan failed.");
+			std::vector<uint8_t> in_buf;
+			std::vector<uint8_t> expected = ExpectedOutput(plan, MVFMT_I420, MVFMT_RGB24, in_buf);
+			std::vector<uint8_t> out_buf(expected.size(), 0);
+
+			SetThreadPoolSize(1);
+			Gate gate;
+			gate.started.store(false);
+			gate.open.store(false);
+			SubmitSlices(WaitAtGate, &gate, 1, nullptr);
+			while (!gate.started.load())
+				std::this_thread::yield();
+
+			AwaitRecord record;
+			record.finished.store(false);
+			AwaitTransform(plan, in_buf.data(), out_buf.data(), record);
+			bool suspended = !record.finished.load();
+
+			gate.open.store(true);
+			while (!record.finished.load())
+				std::this_thread::yield();
+			SetThreadPoolSize(0);
+
+			Assert::IsTrue(suspended, L"The coroutine didn't suspend while its frame was queued.");
+			Assert::IsTrue(record.resumed_on != record.awaited_on, L"The coroutine wasn't resumed by the worker.");
+			Assert::IsTrue(out_buf == expected, L"The awaited frame's output differs from a single thread.");
+		}
+
+		// A coroutine resumed on a worker awaits its next frame from there, until the stream runs out.
+		TEST_METHOD(AwaitFramesInSequence_UnitTest)
+		{
+			TransformPlan plan;
+			Assert::IsTrue(CreateTransformPlan(plan, MVFMT_RGB32, MVFMT_NV12, 128, 64, 0, 0, false, true, 4), L"CreateTransformPlan failed.");
+			std::vector<uint8_t> in_buf;
+			std::vector<uint8_t> expected = ExpectedOutput(plan, MVFMT_RGB32, MVFMT_NV12, in_buf);
+
+			SetThreadPoolSize(3);
+			std::vector<std::vector<uint8_t>> out_bufs(20, std::vector<uint8_t>(expected.size(), 0));
+			std::atomic<bool> finished(false);
+			[](const TransformPlan& plan, uint8_t* in_buf, std::vector<std::vector<uint8_t>>& out_bufs, std::atomic<bool>& finished) -> DetachedCoroutine {
+				for (auto& out_buf : out_bufs)
+					co_await TransformAsync(plan, in_buf, out_buf.data());
+				finished.store(true);
+			}(plan, in_buf.data(), out_bufs, finished);
+
+			while (!finished.load())
+				std::this_thread::yield();
+			SetThreadPoolSize(0);
+
+			for (auto& out_buf : out_bufs)
+				Assert::IsTrue(out_buf == expected, L"An awaited frame's output differs from a single thread.");
+		}
+	};
+}
@@ -0,0 +1,611 @@
+//
+//  blipvert C++ library
+//
+//  MIT License
+//
+//  Copyright(c) 2021-2025 Don Jordan
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+//
+
+
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include "blipvert.h"
+#include "Utilities.h"
+#include "TransformPlan.h"
+#include "CpuFeatures.h"
+
+#include <memory>
+#include <random>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <locale>
+#include <future>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace blipvert;
+
+namespace BlipvertUnitTests
+{
+	TEST_CLASS(TransformPlanUnitTests)
+	{
+	public:
+
+		std::wstring utf8ToUtf16Str(const std::string& str)
+		{
+			std::vector<wchar_t> buf(str.size());
+			std::use_facet<std::ctype<wchar_t>>(std::locale{}).widen(str.data(), str.data() + str.size(), buf.data());
+			return std::wstring(buf.data(), buf.size());
+		}
+
+		// Transforms a random frame with a plan and with per-frame staging, and checks the results are the same.
+		void ComparePlanToStaging(const MediaFormatID& inFormat, const MediaFormatID& outFormat, int32_t width, int32_t height,
+			uint8_t thread_count, bool out_flipped)
+		{
+			TransformPlan plan;
+			Assert::IsTrue(CreateTransformPlan(plan, inFormat, outFormat, width, height, 0, 0, false, out_flipped, thread_count), L"CreateTransformPlan failed.");
+			Assert::AreEqual(static_cast<int32_t>(GetCommonMaxThreadCount(inFormat, outFormat, width, height, thread_count)),
+				static_cast<int32_t>(plan.thread_count), L"The plan has the wrong thread count.");
+
+			uint32_t in_size = CalculateBufferSize(inFormat, width, height);
+			uint32_t out_size = CalculateBufferSize(outFormat, width, height);
+
+			std::unique_ptr<uint8_t[]> in_buf(new uint8_t[in_size]);
+			std::unique_ptr<uint8_t[]> plan_buf(new uint8_t[out_size]);
+			std::unique_ptr<uint8_t[]> staged_buf(new uint8_t[out_size]);
+
+			std::mt19937 generator(static_cast<uint32_t>(width + height));
+			for (uint32_t index = 0; index < in_size; index++)
+			{
+				in_buf[index] = static_cast<uint8_t>(generator());
+			}
+
+			memset(plan_buf.get(), 0, out_size);
+			memset(staged_buf.get(), 0, out_size);
+
+			ExecuteTransformPlan(plan, in_buf.get(), plan_buf.get());
+
+			t_transformfunc transform = FindVideoTransform(inFormat, outFormat);
+			t_stagetransformfunc pstage_in = FindTransformStage(inFormat);
+			t_stagetransformfunc pstage_out = FindTransformStage(outFormat);
+			for (uint8_t index = 0; index < plan.thread_count; index++)
+			{
+				Stage in_stage;
+				Stage out_stage;
+				pstage_in(&in_stage, index, plan.thread_count, width, height, in_buf.get(), 0, false, nullptr);
+				pstage_out(&out_stage, index, plan.thread_count, width, height, staged_buf.get(), 0, out_flipped, nullptr);
+				transform(&in_stage, &out_stage);
+			}
+
+			Assert::IsTrue(memcmp(plan_buf.get(), staged_buf.get(), out_size) == 0, L"The plan's output differs from per-frame staging.");
+		}
+
+		// Transforms a random frame split into thread_count slices and as a single slice, and checks the results are the same.
+		void CompareSlicedToSingle(const MediaFormatID& inFormat, const MediaFormatID& outFormat, int32_t width, int32_t height,
+			uint8_t thread_count, bool out_flipped)
+		{
+			TransformPlan sliced;
+			TransformPlan single;
+			Assert::IsTrue(CreateTransformPlan(sliced, inFormat, outFormat, width, height, 0, 0, false, out_flipped, thread_count), L"CreateTransformPlan failed.");
+			Assert::IsTrue(CreateTransformPlan(single, inFormat, outFormat, width, height, 0, 0, false, out_flipped, 1), L"CreateTransformPlan failed.");
+			Assert::AreEqual(static_cast<int32_t>(thread_count), static_cast<int32_t>(sliced.thread_count), L"The requested thread count was reduced.");
+
+			uint32_t in_size = CalculateBufferSize(inFormat, width, height);
+			uint32_t out_size = CalculateBufferSize(outFormat, width, height);
+
+			std::unique_ptr<uint8_t[]> in_buf(new uint8_t[in_size]);
+			std::unique_ptr<uint8_t[]> sliced_buf(new uint8_t[out_size]);
+			std::unique_ptr<uint8_t[]> single_buf(new uint8_t[out_size]);
+
+			std::mt19937 generator(static_cast<uint32_t>(height * 256 + thread_count));
+			for (uint32_t index = 0; index < in_size; index++)
+			{
+				in_buf[index] = static_cast<uint8_t>(generator());
+			}
+
+			memset(sliced_buf.get(), 0, out_size);
+			memset(single_buf.get(), 0, out_size);
+
+			ExecuteTransformPlan(sliced, in_buf.get(), sliced_buf.get());
+			ExecuteTransformPlan(single, in_buf.get(), single_buf.get());
+
+			Assert::IsTrue(memcmp(sliced_buf.get(), single_buf.get(), out_size) == 0, L"The sliced output differs from a single slice.");
+		}
+
+		// Converts a random frame to every output with a fan-out plan, and checks each output matches a single
+		// whole-frame transform. out_flipped is empty or has a flag per output.
+		void CompareFanOutToSeparate(const MediaFormatID& inFormat, const std::vector<MediaFormatID>& outFormats,
+			int32_t width, int32_t height, bool parallel, const std::vector<bool>& out_flipped = {})
+		{
+			FanOutPlan plan;
+			Assert::IsTrue(CreateFanOutPlan(plan, inFormat, outFormats, width, height, 0, {}, false, nullptr, {}, out_flipped),
+				L"CreateFanOutPlan failed.");
+			Assert::AreEqual(outFormats.size(), plan.outputs.size(), L"The plan has the wrong number of outputs.");
+
+			uint32_t in_size = CalculateBufferSize(inFormat, width, height);
+			std::unique_ptr<uint8_t[]> in_buf(new uint8_t[in_size]);
+			std::mt19937 generator(static_cast<uint32_t>(width * height));
+			for (uint32_t index = 0; index < in_size; index++)
+			{
+				in_buf[index] = static_cast<uint8_t>(generator());
+			}
+
+			std::vector<std::vector<uint8_t>> fanout_bufs;
+			std::vector<uint8_t*> out_bufs;
+			for (const MediaFormatID& outFormat : outFormats)
+			{
+				fanout_bufs.emplace_back(CalculateBufferSize(outFormat, width, height), static_cast<uint8_t>(0));
+				out_bufs.push_back(fanout_bufs.back().data());
+			}
+
+			if (parallel)
+				ExecuteFanOutPlanParallel(plan, in_buf.get(), out_bufs.data());
+			else
+				ExecuteFanOutPlan(plan, in_buf.get(), out_bufs.data());
+
+			for (size_t index = 0; index < outFormats.size(); index++)
+			{
+				TransformPlan single;
+				bool out_flip = out_flipped.empty() ? false : out_flipped[index];
+				Assert::IsTrue(CreateTransformPlan(single, inFormat, outFormats[index], width, height, 0, 0, false, out_flip), L"CreateTransformPlan failed.");
+
+				std::vector<uint8_t> single_buf(fanout_bufs[index].size(), 0);
+				ExecuteTransformPlan(single, in_buf.get(), single_buf.data());
+
+				Assert::IsTrue(single_buf == fanout_bufs[index], L"A fan-out output differs from its single transform.");
+			}
+		}
+
+		// Transforms a random frame into 64-byte aligned buffers with and without streaming stores, and checks the
+		// results are the same.
+		void CompareStreamingToCached(const MediaFormatID& inFormat, const MediaFormatID& outFormat, int32_t width, int32_t height,
+			uint8_t thread_count)
+		{
+			uint32_t in_size = CalculateBufferSize(inFormat, width, height);
+			uint32_t out_size = CalculateBufferSize(outFormat, width, height);
+
+			std::unique_ptr<uint8_t[]> in_buf(new uint8_t[in_size]);
+			std::unique_ptr<uint8_t[]> cached_store(new uint8_t[out_size + 64]);
+			std::unique_ptr<uint8_t[]> stream_store(new uint8_t[out_size + 64]);
+			uint8_t* cached_buf = cached_store.get() + (64 - reinterpret_cast<uintptr_t>(cached_store.get()) % 64);
+			uint8_t* stream_buf = stream_store.get() + (64 - reinterpret_cast<uintptr_t>(stream_store.get()) % 64);
+
+			std::mt19937 generator(static_cast<uint32_t>(width * 7 + height));
+			for (uint32_t index = 0; index < in_size; index++)
+			{
+				in_buf[index] = static_cast<uint8_t>(generator());
+			}
+
+			xRGBQUAD palette[256];
+			for (int index = 0; index < 256; index++)
+			{
+				palette[index].rgbRed = static_cast<uint8_t>(generator());
+				palette[index].rgbGreen = static_cast<uint8_t>(generator());
+				palette[index].rgbBlue = static_cast<uint8_t>(generator());
+				palette[index].rgbReserved = 0;
+			}
+
+			TransformPlan plan;
+			Assert::IsTrue(CreateTransformPlan(plan, inFormat, outFormat, width, height, 0, 0, false, false, thread_count, palette),
+				L"CreateTransformPlan failed.");
+
+			memset(cached_buf, 0, out_size);
+			memset(stream_buf, 0xCD, out_size);
+
+			plan.stream_stores = false;
+			ExecuteTransformPlan(plan, in_buf.get(), cached_buf);
+			plan.stream_stores = true;
+			ExecuteTransformPlan(plan, in_buf.get(), stream_buf);
+
+			Assert::IsTrue(memcmp(cached_buf, stream_buf, out_size) == 0, L"The streamed output differs from cached stores.");
+		}
+
+		// Transforms a random frame cut into tiles and as a single slice, and checks the results are the same.
+		// Returns the number of columns the tiled plan used.
+		int32_t CompareTiledToSingle(const MediaFormatID& inFormat, const MediaFormatID& outFormat, int32_t width, int32_t height,
+			uint8_t tile_count, bool out_flipped)
+		{
+			TransformPlan tiled;
+			TransformPlan single;
+			Assert::IsTrue(CreateTiledTransformPlan(tiled, inFormat, outFormat, width, height, 0, 0, false, out_flipped, tile_count), L"CreateTiledTransformPlan failed.");
+
+			// Compare with the same rows uncut, since a few vertically filtered transforms already differ between row slicings.
+			uint8_t row_count = static_cast<uint8_t>(tiled.thread_count / tiled.column_count);
+			Assert::IsTrue(CreateTransformPlan(single, inFormat, outFormat, width, height, 0, 0, false, out_flipped, row_count), L"CreateTransformPlan failed.");
+
+			uint32_t in_size = CalculateBufferSize(inFormat, width, height);
+			uint32_t out_size = CalculateBufferSize(outFormat, width, height);
+
+			std::unique_ptr<uint8_t[]> in_buf(new uint8_t[in_size]);
+			std::unique_ptr<uint8_t[]> tiled_buf(new uint8_t[out_size]);
+			std::unique_ptr<uint8_t[]> single_buf(new uint8_t[out_size]);
+
+			std::mt19937 generator(static_cast<uint32_t>(width + tile_count));
+			for (uint32_t index = 0; index < in_size; index++)
+			{
+				in_buf[index] = static_cast<uint8_t>(generator());
+			}
+
+			memset(tiled_buf.get(), 0, out_size);
+			memset(single_buf.get(), 0, out_size);
+
+			// Run the tiles backwards so a tile that writes past its columns is overwritten by the wrong neighbour.
+			for (int index = tiled.thread_count - 1; index >= 0; index--)
+			{
+				ExecuteTransformPlanSlice(tiled, static_cast<uint8_t>(index), in_buf.get(), tiled_buf.get());
+			}
+			ExecuteTransformPlan(single, in_buf.get(), single_buf.get());
+
+			std::wstring message = L"The tiled output differs from the uncut rows for " + utf8ToUtf16Str(std::string(inFormat)) +
+				L" to " + utf8ToUtf16Str(std::string(outFormat)) + L".";
+			Assert::IsTrue(memcmp(tiled_buf.get(), single_buf.get(), out_size) == 0, message.c_str());
+			return tiled.column_count;
+		}
+
+		// Transforms a random frame with both the input and the output flipped, and checks the result matches the
+		// transform with neither flipped.
+		void CompareFlippedBothToUnflipped(const MediaFormatID& inFormat, const MediaFormatID& outFormat, int32_t width, int32_t height,
+			uint8_t thread_count)
+		{
+			TransformPlan flipped;
+			TransformPlan unflipped;
+			Assert::IsTrue(CreateTransformPlan(flipped, inFormat, outFormat, width, height, 0, 0, true, true, thread_count), L"CreateTransformPlan failed.");
+			Assert::IsTrue(CreateTransformPlan(unflipped, inFormat, outFormat, width, height, 0, 0, false, false, thread_count), L"CreateTransformPlan failed.");
+
+			uint32_t in_size = CalculateBufferSize(inFormat, width, height);
+			uint32_t out_size = CalculateBufferSize(outFormat, width, height);
+
+			std::unique_ptr<uint8_t[]> in_buf(new uint8_t[in_size]);
+			std::unique_ptr<uint8_t[]> flipped_buf(new uint8_t[out_size]);
+			std::unique_ptr<uint8_t[]> unflipped_buf(new uint8_t[out_size]);
+
+			std::mt19937 generator(static_cast<uint32_t>(width * 3 + height));
+			for (uint32_t index = 0; index < in_size; index++)
+			{
+				in_buf[index] = static_cast<uint8_t>(generator());
+			}
+
+			memset(flipped_buf.get(), 0, out_size);
+			memset(unflipped_buf.get(), 0, out_size);
+
+			ExecuteTransformPlan(flipped, in_buf.get(), flipped_buf.get());
+			ExecuteTransformPlan(unflipped, in_buf.get(), unflipped_buf.get());
+
+			std::wstring message = L"The flipped output differs from the unflipped output for " + utf8ToUtf16Str(std::string(inFormat)) +
+				L" to " + utf8ToUtf16Str(std::string(outFormat)) + L".";
+			Assert::IsTrue(memcmp(flipped_buf.get(), unflipped_buf.get(), out_size) == 0, message.c_str());
+		}
+
+		// Runs a plan that failed to build every way a plan can be run, and checks none of them touches the output.
+		void RunFailedPlan(const TransformPlan& plan)
+		{
+			Assert::IsNull(reinterpret_cast<void*>(plan.transform), L"A failed plan has a transform.");
+			Assert::AreEqual(0, static_cast<int32_t>(plan.thread_count), L"A failed plan has slices.");
+			Assert::AreEqual(1, static_cast<int32_t>(plan.column_count), L"A failed plan has tiles.");
+			Assert::IsFalse(plan.stream_stores, L"A failed plan streams its stores.");
+			Assert::IsTrue(plan.stages.empty(), L"A failed plan has stages.");
+
+			std::vector<uint8_t> in_buf(64 * 64 * 4, static_cast<uint8_t>(0x5A));
+			std::vector<uint8_t> out_buf(64 * 64 * 4, static_cast<uint8_t>(0xCD));
+			std::vector<uint8_t> expected = out_buf;
+
+			ExecuteTransformPlan(plan, in_buf.data(), out_buf.data());
+			ExecuteTransformPlanParallel(plan, in_buf.data(), out_buf.data());
+			SubmitTransform(plan, in_buf.data(), out_buf.data()).get();
+			Assert::IsTrue(out_buf == expected, L"Running a failed plan changed the output.");
+		}
+
+		TEST_METHOD(SliceRowsCoverFrame_UnitTest)
+		{
+			for (int32_t height : { 4, 6, 100, 720, 722, 1080, 1088, 2160 })
+			{
+				for (int thread_count = 1; thread_count <= 64 && thread_count <= height / SliceRowGranularity; thread_count++)
+				{
+					int32_t next_row = 0;
+					int32_t smallest = height;
+					int32_t largest = 0;
+					for (int index = 0; index < thread_count; index++)
+					{
+						int32_t first_row;
+						int32_t slice_height;
+						GetSliceRows(static_cast<uint8_t>(index), static_cast<uint8_t>(thread_count), height, first_row, slice_height);
+						Assert::AreEqual(next_row, first_row, L"The slices are not contiguous.");
+						Assert::AreEqual(0, first_row % SliceRowGranularity, L"A slice does not start on a row group.");
+						next_row = first_row + slice_height;
+						if (index < thread_count - 1)
+						{
+							smallest = std::min(smallest, slice_height);
+							largest = std::max(largest, slice_height);
+						}
+					}
+
+					Assert::AreEqual(height, next_row, L"The slices do not cover the frame.");
+					Assert::IsTrue(thread_count == 1 || largest - smallest <= SliceRowGranularity, L"The slices are uneven.");
+				}
+			}
+		}
+
+		TEST_METHOD(UnevenSlicesMatchSingleSlice_UnitTest)
+		{
+			// 1080 / 4 = 270 row groups don't divide by 7, 16 or 32, and 722 leaves two rows over for the last slice.
+			for (uint8_t thread_count : { 3, 7, 16, 32 })
+			{
+				CompareSlicedToSingle(MVFMT_RGB32, MVFMT_I420, 64, 1080, thread_count, false);
+				CompareSlicedToSingle(MVFMT_I420, MVFMT_RGB24, 64, 1080, thread_count, true);
+				CompareSlicedToSingle(MVFMT_YUY2, MVFMT_NV12, 64, 722, thread_count, false);
+				CompareSlicedToSingle(MVFMT_NV21, MVFMT_IMC2, 64, 722, thread_count, true);
+				CompareSlicedToSingle(MVFMT_RGB565, MVFMT_YVU9, 64, 1088, thread_count, false);
+				CompareSlicedToSingle(MVFMT_YUV9, MVFMT_YV16, 64, 1088, thread_count, true);
+				CompareSlicedToSingle(MVFMT_UYVY, MVFMT_RGB32, 64, 722, thread_count, true);
+			}
+		}
+
+		TEST_METHOD(PlanMatchesStaging_UnitTest)
+		{
+			ComparePlanToStaging(MVFMT_YUY2, MVFMT_RGB32, 64, 64, 1, false);
+			ComparePlanToStaging(MVFMT_YUY2, MVFMT_RGB32, 64, 64, 4, true);
+			ComparePlanToStaging(MVFMT_RGB32, MVFMT_I420, 64, 64, 4, false);
+			ComparePlanToStaging(MVFMT_I420, MVFMT_RGB24, 64, 64, 2, true);
+			ComparePlanToStaging(MVFMT_NV12, MVFMT_YV12, 64, 64, 4, false);
+			ComparePlanToStaging(MVFMT_RGB565, MVFMT_NV21, 64, 64, 2, false);
+		}
+
+		TEST_METHOD(PlanReusedAcrossBuffers_UnitTest)
+		{
+			TransformPlan plan;
+			Assert::IsTrue(CreateTransformPlan(plan, MVFMT_RGB32, MVFMT_YV12, 32, 32), L"CreateTransformPlan failed.");
+
+			uint32_t in_size = CalculateBufferSize(MVFMT_RGB32, 32, 32);
+			uint32_t out_size = CalculateBufferSize(MVFMT_YV12, 32, 32);
+
+			std::unique_ptr<uint8_t[]> first_in(new uint8_t[in_size]);
+			std::unique_ptr<uint8_t[]> second_in(new uint8_t[in_size]);
+			std::unique_ptr<uint8_t[]> first_out(new uint8_t[out_size]);
+			std::unique_ptr<uint8_t[]> second_out(new uint8_t[out_size]);
+			memset(first_in.get(), 0x20, in_size);
+			memset(second_in.get(), 0xE0, in_size);
+
+			ExecuteTransformPlan(plan, first_in.get(), first_out.get());
+			ExecuteTransformPlan(plan, second_in.get(), second_out.get());
+
+			Assert::AreNotEqual(first_out[0], second_out[0], L"The plan did not follow the new buffers.");
+		}
+
+		TEST_METHOD(FanOutMatchesSeparate_UnitTest)
+		{
+			std::vector<MediaFormatID> outFormats = { MVFMT_RGB32, MVFMT_I420, MVFMT_Y800 };
+			for (const MediaFormatID* inFormat : { &MVFMT_YUY2, &MVFMT_UYVY, &MVFMT_NV12, &MVFMT_YV12, &MVFMT_RGB24, &MVFMT_RGB565 })
+			{
+				CompareFanOutToSeparate(*inFormat, outFormats, 640, 480, false);
+				CompareFanOutToSeparate(*inFormat, outFormats, 176, 146, false);
+			}
+
+			CompareFanOutToSeparate(MVFMT_YUY2, { MVFMT_RGB565, MVFMT_YV12, MVFMT_UYVY, MVFMT_AYUV }, 320, 240, false);
+			CompareFanOutToSeparate(MVFMT_NV12, { MVFMT_RGB32, MVFMT_I420, MVFMT_Y800 }, 640, 480, false, { true, false, true });
+		}
+
+		TEST_METHOD(FanOutParallel_UnitTest)
+		{
+			CompareFanOutToSeparate(MVFMT_YUY2, { MVFMT_RGB32, MVFMT_I420, MVFMT_Y800 }, 1280, 720, true);
+			CompareFanOutToSeparate(MVFMT_NV12, { MVFMT_RGB32, MVFMT_I420, MVFMT_Y800 }, 1280, 720, true);
+			CompareFanOutToSeparate(MVFMT_YUY2, { MVFMT_RGB32, MVFMT_I420, MVFMT_Y800 }, 1280, 720, true, { false, true, true });
+		}
+
+		TEST_METHOD(FanOutBands_UnitTest)
+		{
+			FanOutPlan plan;
+			Assert::IsTrue(CreateFanOutPlan(plan, MVFMT_YUY2, { MVFMT_RGB32, MVFMT_I420, MVFMT_Y800 }, 1920, 1080), L"CreateFanOutPlan failed.");
+			Assert::IsTrue(plan.band_count > 1, L"A 1080p frame was not split into bands.");
+			for (const TransformPlan& output : plan.outputs)
+			{
+				Assert::AreEqual(static_cast<int32_t>(plan.band_count), static_cast<int32_t>(output.thread_count), L"An output has different bands.");
+			}
+
+			// RGB8 can't be sliced, so the whole plan falls back to one band.
+			Assert::IsTrue(CreateFanOutPlan(plan, MVFMT_RGB8, { MVFMT_RGB32, MVFMT_I420 }, 1920, 1080), L"CreateFanOutPlan failed.");
+			Assert::AreEqual(1, static_cast<int32_t>(plan.band_count), L"The plan was split for a format that can't be sliced.");
+
+			Assert::IsFalse(CreateFanOutPlan(plan, MVFMT_YUY2, { MVFMT_RGB32, MediaFormatID("wowzo") }, 64, 64), L"CreateFanOutPlan succeeded for an unknown format.");
+			Assert::IsTrue(plan.outputs.empty(), L"A failed plan has outputs.");
+			Assert::IsFalse(CreateFanOutPlan(plan, MVFMT_YUY2, { MVFMT_RGB32 }, 64, 64, 0, { 256, 256 }), L"CreateFanOutPlan accepted the wrong number of strides.");
+			Assert::IsFalse(CreateFanOutPlan(plan, MVFMT_YUY2, { MVFMT_RGB32 }, 64, 64, 0, {}, false, nullptr, {}, { true, false }),
+				L"CreateFanOutPlan accepted the wrong number of flip flags.");
+		}
+
+		TEST_METHOD(StreamingStores_UnitTest)
+		{
+			// 1920 wide rows stay aligned; 100 and 36 wide rows alternate and exercise the unaligned fallback and the
+			// leftover columns.
+			for (const MediaFormatID* inFormat : { &MVFMT_YUY2, &MVFMT_UYVY, &MVFMT_RGB24, &MVFMT_RGB565, &MVFMT_RGB555, &MVFMT_RGB8 })
+			{
+				CompareStreamingToCached(*inFormat, MVFMT_RGB32, 1920, 68, 1);
+				CompareStreamingToCached(*inFormat, MVFMT_RGB32, 100, 32, 1);
+				CompareStreamingToCached(*inFormat, MVFMT_RGB32, 36, 16, 1);
+			}
+
+			CompareStreamingToCached(MVFMT_YUY2, MVFMT_RGB32, 1920, 1080, 4);
+			CompareStreamingToCached(MVFMT_RGB24, MVFMT_RGB32, 1280, 720, 3);
+
+			// Formats without a streaming kernel ignore the flag.
+			CompareStreamingToCached(MVFMT_I420, MVFMT_RGB32, 640, 480, 1);
+			CompareStreamingToCached(MVFMT_RGB32, MVFMT_YUY2, 640, 480, 2);
+		}
+
+		TEST_METHOD(StreamingStoresSelection_UnitTest)
+		{
+			uint32_t threshold = GetStreamingStoreThreshold();
+			Assert::IsTrue(threshold > 0, L"There is no streaming store threshold.");
+
+			TransformPlan plan;
+			Assert::IsTrue(CreateTransformPlan(plan, MVFMT_YUY2, MVFMT_RGB32, 64, 64), L"CreateTransformPlan failed.");
+			Assert::IsFalse(plan.stream_stores, L"A small frame selected streaming stores.");
+
+			// Plans don't allocate, so a frame just past the threshold can be planned without the memory behind it.
+			int32_t width = 8192;
+			int32_t height = static_cast<int32_t>(threshold / (width * 4)) + 4;
+			Assert::IsTrue(CreateTransformPlan(plan, MVFMT_YUY2, MVFMT_RGB32, width, height), L"CreateTransformPlan failed.");
+			Assert::IsTrue(plan.stream_stores, L"A frame bigger than the threshold did not select streaming stores.");
+		}
+
+		TEST_METHOD(TileColumnsCoverFrame_UnitTest)
+		{
+			for (int32_t width : { 128, 136, 1000, 1920, 7680 })
+			{
+				for (int column_count = 1; column_count <= 16 && column_count <= width / TileColumnGranularity; column_count++)
+				{
+					int32_t next_column = 0;
+					for (int index = 0; index < column_count; index++)
+					{
+						int32_t first_column;
+						int32_t tile_width;
+						GetTileColumns(static_cast<uint8_t>(index), static_cast<uint8_t>(column_count), width, first_column, tile_width);
+						Assert::AreEqual(next_column, first_column, L"The tiles are not contiguous.");
+						Assert::AreEqual(0, first_column % TileColumnGranularity, L"A tile does not start on a column group.");
+						Assert::IsTrue(tile_width >= TileColumnGranularity, L"A tile is narrower than a column group.");
+						next_column = first_column + tile_width;
+					}
+
+					Assert::AreEqual(width, next_column, L"The tiles do not cover the frame.");
+				}
+			}
+		}
+
+		TEST_METHOD(TileShape_UnitTest)
+		{
+			uint8_t rows;
+			uint8_t columns;
+			GetTileShape(MVFMT_YUY2, MVFMT_RGB32, 7680, 64, 16, rows, columns);
+			Assert::AreEqual(4, static_cast<int32_t>(rows), L"Wrong row count for a 7680 x 64 strip.");
+			Assert::AreEqual(4, static_cast<int32_t>(columns), L"Wrong column count for a 7680 x 64 strip.");
+
+			GetTileShape(MVFMT_YUY2, MVFMT_RGB32, 1920, 1080, 16, rows, columns);
+			Assert::AreEqual(16, static_cast<int32_t>(rows), L"A tall frame wasn't left in row slices.");
+			Assert::AreEqual(1, static_cast<int32_t>(columns), L"A tall frame was cut into columns.");
+
+			GetTileShape(MVFMT_NV12, MVFMT_I420, 4096, 8, 32, rows, columns);
+			Assert::AreEqual(1, static_cast<int32_t>(rows), L"An 8 row strip was cut into rows.");
+			Assert::AreEqual(32, static_cast<int32_t>(columns), L"Wrong column count for an 8 row strip.");
+
+			GetTileShape(MVFMT_RGB8, MVFMT_RGB32, 7680, 64, 16, rows, columns);
+			Assert::AreEqual(1, static_cast<int32_t>(rows * columns), L"A palettized format was cut into tiles.");
+
+			GetTileShape(MVFMT_CLJR, MVFMT_YUY2, 7680, 64, 16, rows, columns);
+			Assert::AreEqual(1, static_cast<int32_t>(columns), L"A CLJR input was cut into columns.");
+		}
+
+		TEST_METHOD(TiledMatchesSingleSlice_UnitTest)
+		{
+			std::vector<std::pair<MediaFormatID, MediaFormatID>> pairs;
+			GetTransformFormatPairs(pairs);
+
+			bool out_flipped = false;
+			for (auto& pair : pairs)
+			{
+				if (pair.first == MVFMT_RGB8 || pair.first == MVFMT_RGB4 || pair.first == MVFMT_RGB1 ||
+					pair.second == MVFMT_RGB8 || pair.second == MVFMT_RGB4 || pair.second == MVFMT_RGB1)
+				{
+					continue;
+				}
+
+				// The interlaced aliases have no staging functions of their own.
+				TransformPlan plan;
+				if (!CreateTransformPlan(plan, pair.first, pair.second, 1000, 40))
+					continue;
+
+				// Uncut, IMC1 and IMC3 copy their chroma planes whole, including the unused half of each row.
+				if ((pair.first == MVFMT_IMC1 || pair.first == MVFMT_IMC3) && (pair.second == MVFMT_IMC1 || pair.second == MVFMT_IMC3))
+					continue;
+
+				// 1000 columns leave 8 over for the last tile, and 40 rows give two row slices of six tiles.
+				int32_t expected = (pair.first == MVFMT_CLJR || pair.first == MVFMT_IYU1) ? 1 : 6;
+				Assert::AreEqual(expected, CompareTiledToSingle(pair.first, pair.second, 1000, 40, 12, out_flipped), L"The frame wasn't cut into columns.");
+				out_flipped = !out_flipped;
+			}
+
+			CompareTiledToSingle(MVFMT_YUY2, MVFMT_RGB32, 7680, 64, 16, false);
+			CompareTiledToSingle(MVFMT_NV12, MVFMT_I420, 4096, 8, 32, true);
+		}
+
+		TEST_METHOD(TiledPlanParallel_UnitTest)
+		{
+			TransformPlan plan;
+			Assert::IsTrue(CreateTiledTransformPlan(plan, MVFMT_UYVY, MVFMT_YV12, 3840, 32, 0, 0, false, false, 16), L"CreateTiledTransformPlan failed.");
+			Assert::AreEqual(8, static_cast<int32_t>(plan.column_count), L"Wrong column count for a 3840 x 32 strip.");
+
+			uint32_t in_size = CalculateBufferSize(MVFMT_UYVY, 3840, 32);
+			uint32_t out_size = CalculateBufferSize(MVFMT_YV12, 3840, 32);
+			std::vector<uint8_t> in_buf(in_size);
+			std::vector<uint8_t> parallel_buf(out_size, 0);
+			std::vector<uint8_t> single_buf(out_size, 0);
+			for (uint32_t index = 0; index < in_size; index++)
+			{
+				in_buf[index] = static_cast<uint8_t>(index * 13);
+			}
+
+			ExecuteTransformPlanParallel(plan, in_buf.data(), parallel_buf.data());
+			ExecuteTransformPlan(plan, in_buf.data(), single_buf.data());
+			Assert::IsTrue(parallel_buf == single_buf, L"The parallel tiled output differs.");
+		}
+
+		TEST_METHOD(FlippedInAndOut_UnitTest)
+		{
+			for (uint8_t thread_count = 1; thread_count <= 2; thread_count++)
+			{
+				CompareFlippedBothToUnflipped(MVFMT_Y800, MVFMT_I420, 64, 16, thread_count);
+				CompareFlippedBothToUnflipped(MVFMT_Y800, MVFMT_IMC1, 64, 16, thread_count);
+				CompareFlippedBothToUnflipped(MVFMT_Y800, MVFMT_YV16, 64, 16, thread_count);
+				CompareFlippedBothToUnflipped(MVFMT_Y800, MVFMT_NV12, 64, 16, thread_count);
+			}
+		}
+
+		TEST_METHOD(InvalidPlan_UnitTest)
+		{
+			TransformPlan plan;
+			Assert::IsFalse(CreateTransformPlan(plan, MVFMT_UYVY, MediaFormatID("wowzo"), 64, 64), L"CreateTransformPlan succeeded for an unknown format.");
+			Assert::IsNull(reinterpret_cast<void*>(plan.transform), L"A failed plan has a transform.");
+		}
+
+		TEST_METHOD(FailedPlanRunsNothing_UnitTest)
+		{
+			TransformPlan fresh;
+			Assert::IsFalse(CreateTransformPlan(fresh, MVFMT_UYVY, MediaFormatID("wowzo"), 64, 64, 0, 0, false, false, 4),
+				L"CreateTransformPlan succeeded for an unknown format.");
+			RunFailedPlan(fresh);
+
+			// A plan that held tiles and streamed its stores is left empty by a failed rebuild.
+			TransformPlan reused;
+			Assert::IsTrue(CreateTiledTransformPlan(reused, MVFMT_RGB32, MVFMT_YUY2, 1024, 16, 0, 0, false, false, 4),
+				L"CreateTiledTransformPlan failed.");
+			Assert::IsTrue(reused.column_count > 1, L"The plan wasn't tiled.");
+			reused.stream_stores = true;
+			Assert::IsFalse(CreateTiledTransformPlan(reused, MediaFormatID("wowzo"), MVFMT_YUY2, 1024, 16, 0, 0, false, false, 4),
+				L"CreateTiledTransformPlan succeeded for an unknown format.");
+			RunFailedPlan(reused);
+
+			Assert::IsTrue(CreateTransformPlan(reused, MVFMT_RGB32, MVFMT_YUY2, 64, 64, 0, 0, false, false, 4), L"CreateTransformPlan failed.");
+			Assert::IsFalse(CreateTransformPlan(reused, MVFMT_RGB32, MediaFormatID("wowzo"), 64, 64, 0, 0, false, false, 4),
+				L"CreateTransformPlan succeeded for an unknown format.");
+			RunFailedPlan(reused);
+		}
+	};
+}
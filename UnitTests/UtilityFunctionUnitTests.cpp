@@ -34,6 +34,7 @@
 #include "RGBtoYUV.h"
 #include "RGBtoRGB.h"
 #include "YUVtoYUV.h"
+#include "LookupTables.h"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace blipvert;
@@ -140,6 +141,25 @@ namespace BlipvertUnitTests
 			Assert::AreEqual(static_cast<int>(1), static_cast<int>(maxdelta), L"YUVtoRGBPixel_UnitTest Maximum deviation from slow to fast calculations != 1.");
 		}
 
+		TEST_METHOD(FixedPointGreen_UnitTest)
+		{
+			int32_t maxdelta = 0;
+			for (int32_t U = 0; U < 256; U++)
+			{
+				for (int32_t V = 0; V < 256; V++)
+				{
+					int32_t expected = static_cast<int32_t>(-0.813 * V - 0.391 * U + 154.112);
+					int32_t delta = abs(FixedPointGreen(U, V) - expected);
+					if (delta > maxdelta)
+					{
+						maxdelta = delta;
+					}
+				}
+			}
+
+			Assert::IsTrue(maxdelta <= 1, L"FixedPointGreen_UnitTest Maximum deviation from the table formula > 1.");
+		}
+
 		TEST_METHOD(CalculateBufferSize_UnitTest)
 		{
 			uint32_t size = CalculateBufferSize(MVFMT_UYVY, 2592, 1944);
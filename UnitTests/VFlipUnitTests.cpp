@@ -35,12 +35,14 @@
 #include "YUVtoYUV.h"
 #include "ToFillColor.h"
 #include "BufferChecks.h"
+#include "ThreadPool.h"
 
 #include <memory>
 #include <iostream>
 #include <string>
 #include <locale>
 #include <vector>
+#include <random>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace blipvert;
@@ -77,9 +79,82 @@ namespace BlipvertUnitTests
 			StrideBump = saveb;
 		}
 
+		TEST_METHOD(ParallelFlipUnitTest)
+		{
+			RunAllParallelFlipTests();
+
+			uint32_t saveb = StrideBump;
+			StrideBump = StrideBumpTestValue;
+
+			RunAllParallelFlipTests();
+
+			StrideBump = saveb;
+		}
+
 	private:
 		uint8_t alpha = 255;
 
+		void RunAllParallelFlipTests()
+		{
+			for (const MediaFormatID* format : RGBFormats)
+			{
+				RunParallelFlipTest(*format);
+			}
+
+			for (const MediaFormatID* format : YUVFormats)
+			{
+				RunParallelFlipTest(*format);
+			}
+		}
+
+		// Flips a random frame with every slice count and checks it against the single threaded flip. The slices are
+		// also run one at a time in reverse order, which shows they don't depend on each other.
+		void RunParallelFlipTest(const MediaFormatID& format)
+		{
+			wstring formatName = utf8ToUtf16Str(format);
+
+			t_flipverticalfunc flip = FindFlipVerticalTransform(format);
+			Assert::IsNotNull(reinterpret_cast<void*>(flip), wstring(L"FindFlipVerticalTransform returned a null function pointer: " + formatName).c_str());
+
+			t_flipverticalslicefunc flip_slice = FindFlipVerticalSliceTransform(format);
+			Assert::IsNotNull(reinterpret_cast<void*>(flip_slice), wstring(L"FindFlipVerticalSliceTransform returned a null function pointer: " + formatName).c_str());
+
+			uint32_t width = TestBufferWidth;
+			uint32_t height = TestBufferHeight;
+			uint32_t stride = CalculateStrideBump(format, width, height);
+			uint32_t bufSize = CalculateBufferSize(format, width, height, stride);
+			Assert::IsTrue(bufSize != 0, wstring(L"bufSize size retuned zero: " + formatName).c_str());
+
+			std::unique_ptr<uint8_t[]> expectedBuf(new uint8_t[bufSize]);
+			std::unique_ptr<uint8_t[]> testBuf(new uint8_t[bufSize]);
+
+			std::mt19937 generator(bufSize);
+			std::uniform_int_distribution<int32_t> distribution(0, 255);
+			for (uint32_t index = 0; index < bufSize; index++)
+			{
+				expectedBuf[index] = static_cast<uint8_t>(distribution(generator));
+			}
+
+			std::unique_ptr<uint8_t[]> originalBuf(new uint8_t[bufSize]);
+			memcpy(originalBuf.get(), expectedBuf.get(), bufSize);
+			flip(width, height, expectedBuf.get(), stride);
+
+			const uint8_t thread_counts[] = { 1, 2, 3, 5, 8 };
+			for (uint8_t thread_count : thread_counts)
+			{
+				memcpy(testBuf.get(), originalBuf.get(), bufSize);
+				Assert::IsTrue(ParallelFlipVertical(format, width, height, testBuf.get(), stride, thread_count), wstring(L"ParallelFlipVertical failed: " + formatName).c_str());
+				Assert::AreEqual(0, memcmp(testBuf.get(), expectedBuf.get(), bufSize), wstring(L"Parallel flip did not match the single threaded flip: " + formatName).c_str());
+
+				memcpy(testBuf.get(), originalBuf.get(), bufSize);
+				for (uint8_t index = thread_count; index > 0; index--)
+				{
+					flip_slice(index - 1, thread_count, width, height, testBuf.get(), stride);
+				}
+				Assert::AreEqual(0, memcmp(testBuf.get(), expectedBuf.get(), bufSize), wstring(L"Flip slices did not match the single threaded flip: " + formatName).c_str());
+			}
+		}
+
 		vector<const MediaFormatID*> RGBFormats = {
 			&MVFMT_RGBA,
 			&MVFMT_RGB32,
@@ -35,6 +35,8 @@
 #include "BufferChecks.h"
 
 #include <memory>
+#include <random>
+#include <cstring>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace blipvert;
@@ -2354,6 +2356,17 @@ namespace BlipvertUnitTests
 			Run8bitTestSeries(MVFMT_NV12, MVFMT_YVU9);
 		}
 
+		TEST_METHOD(NVx_to_YUV9_Reference_UnitTest)
+		{
+			for (int32_t height : { 4, 12, 16, 36 })
+			{
+				RunNVxToYUV9ReferenceTest(MVFMT_NV12, MVFMT_YUV9, 64, height, 0);
+				RunNVxToYUV9ReferenceTest(MVFMT_NV12, MVFMT_YVU9, 64, height, 0);
+				RunNVxToYUV9ReferenceTest(MVFMT_NV21, MVFMT_YUV9, 64, height, 0);
+				RunNVxToYUV9ReferenceTest(MVFMT_NV12, MVFMT_YUV9, 64, height, 64 + StrideBumpTestValue);
+			}
+		}
+
 		TEST_METHOD(NV12_to_IYU1_UnitTest)
 		{
 			Run8bitTestSeries(MVFMT_NV12, MVFMT_IYU1);
@@ -2901,6 +2914,53 @@ namespace BlipvertUnitTests
 		}
 
 	private:
+		// Converts a random NV12 or NV21 frame to YUV9 or YVU9, and checks each output chroma sample is the
+		// average of the 2 x 2 input chroma samples it covers.
+		void RunNVxToYUV9ReferenceTest(const MediaFormatID& inFormat, const MediaFormatID& outFormat, int32_t width, int32_t height,
+			int32_t in_stride)
+		{
+			t_transformfunc transform = FindVideoTransform(inFormat, outFormat);
+			Assert::IsNotNull(reinterpret_cast<void*>(transform), L"FindVideoTransform returned a null function pointer.");
+
+			uint32_t in_size = CalculateBufferSize(inFormat, width, height, in_stride);
+			uint32_t out_size = CalculateBufferSize(outFormat, width, height);
+
+			std::unique_ptr<uint8_t[]> in_buf(new uint8_t[in_size]);
+			std::unique_ptr<uint8_t[]> out_buf(new uint8_t[out_size]);
+			std::mt19937 generator(static_cast<uint32_t>(height));
+			for (uint32_t index = 0; index < in_size; index++)
+			{
+				in_buf[index] = static_cast<uint8_t>(generator());
+			}
+			memset(out_buf.get(), 0, out_size);
+
+			Stage in;
+			Stage out;
+			FindTransformStage(inFormat)(&in, 0, 1, width, height, in_buf.get(), in_stride, false, nullptr);
+			FindTransformStage(outFormat)(&out, 0, 1, width, height, out_buf.get(), 0, false, nullptr);
+			transform(&in, &out);
+
+			for (int32_t y = 0; y < height; y++)
+			{
+				Assert::IsTrue(memcmp(in.buf + y * in.stride, out.buf + y * out.y_stride, width) == 0, L"A Y row differs from the input.");
+			}
+
+			for (int32_t y = 0; y < height / 4; y++)
+			{
+				uint8_t* in_line = in.uvplane + y * 2 * in.uv_stride;
+				for (int32_t x = 0; x < width / 4; x++)
+				{
+					uint8_t* in_pixel = in_line + x * 4;
+					int32_t u = (in_pixel[in.u_index] + in_pixel[in.u_index + 2] +
+						in_pixel[in.uv_stride + in.u_index] + in_pixel[in.uv_stride + in.u_index + 2]) >> 2;
+					int32_t v = (in_pixel[in.v_index] + in_pixel[in.v_index + 2] +
+						in_pixel[in.uv_stride + in.v_index] + in_pixel[in.uv_stride + in.v_index + 2]) >> 2;
+					Assert::AreEqual(u, static_cast<int32_t>(out.uplane[y * out.uv_stride + x]), L"A U sample isn't the average of its input samples.");
+					Assert::AreEqual(v, static_cast<int32_t>(out.vplane[y * out.uv_stride + x]), L"A V sample isn't the average of its input samples.");
+				}
+			}
+		}
+
 		void Run8bitAlphaTestSeries(const MediaFormatID& inFormat, const MediaFormatID& outFormat)
 		{
 			for (const RGBATestData& testData : BlipvertUnitTests::AlphaTestMetaData)
@@ -1,4 +1,4 @@
-/
+//
 //  blipvert C++ library
 //
 //  MIT License
@@ -109,4 +109,21 @@ namespace blipvert
 #define Scale8BitTo16Bit(value) (static_cast<uint16_t>(value) * 257);
 #define Scale16BitTo8Bit(value) (static_cast<uint8_t>((value + 128) / 257))
 #define Swap16BitEndian(value) ((value >> 8) | (value << 8))
+
+// RGB to YUV coefficients for the SIMD kernels, which multiply 16-bit B, G, R, 1 pixels with pmaddwd. They are
+// scaled by 32768, the same scale the lookup tables use, and the fourth coefficient is a rounding bias. The
+// coefficients and biases were searched so the result is never more than 1 away from the sum of the three
+// rounded table entries, and is exact for black, white, grey and the primary and secondary colors.
+#define YUV_COEFF_YR 8421
+#define YUV_COEFF_YG 16515
+#define YUV_COEFF_YB 3211
+#define YUV_BIAS_Y 172
+#define YUV_COEFF_UR (-4850)
+#define YUV_COEFF_UG (-9535)
+#define YUV_COEFF_UB 14385
+#define YUV_BIAS_U 84
+#define YUV_COEFF_VR 14385
+#define YUV_COEFF_VG (-12059)
+#define YUV_COEFF_VB (-2326)
+#define YUV_BIAS_V 72
 }
@@ -0,0 +1,160 @@
+//
+//  blipvert C++ library
+//
+//  MIT License
+//
+//  Copyright(c) 2021-2025 Don Jordan
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+//
+
+#include "pch.h"
+#include "CpuFeatures.h"
+
+#if defined(BLIPVERT_X86_SIMD)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+using namespace blipvert;
+
+static CpuFeatures DetectedFeatures = { false, false, false, false, 0 };
+
+#if defined(BLIPVERT_X86_SIMD)
+
+static void QueryCpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4])
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int index = 0; index < 4; index++)
+        regs[index] = static_cast<uint32_t>(info[index]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+static uint64_t ReadXCR0()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+// Returns the size of the largest cache described by the deterministic cache parameters leaf, which is leaf 4
+// on Intel and 0x8000001D on AMD. Both have the same layout, one subleaf per cache until the type is 0.
+static uint32_t QueryLargestCache(uint32_t leaf)
+{
+    uint32_t largest = 0;
+    uint32_t regs[4];
+    for (uint32_t subleaf = 0; subleaf < 16; subleaf++)
+    {
+        QueryCpuid(leaf, subleaf, regs);
+        if ((regs[0] & 0x1F) == 0)
+            break;
+
+        uint32_t ways = (regs[1] >> 22) + 1;
+        uint32_t partitions = ((regs[1] >> 12) & 0x3FF) + 1;
+        uint32_t line_size = (regs[1] & 0xFFF) + 1;
+        uint32_t sets = regs[2] + 1;
+        uint64_t size = static_cast<uint64_t>(ways) * partitions * line_size * sets;
+        if (size > largest && size <= UINT32_MAX)
+            largest = static_cast<uint32_t>(size);
+    }
+
+    return largest;
+}
+
+static uint32_t DetectLastLevelCache(uint32_t max_leaf)
+{
+    uint32_t llc = 0;
+    if (max_leaf >= 4)
+        llc = QueryLargestCache(4);
+
+    if (llc == 0)
+    {
+        uint32_t regs[4];
+        QueryCpuid(0x80000000, 0, regs);
+        uint32_t max_extended_leaf = regs[0];
+        if (max_extended_leaf >= 0x8000001D)
+            llc = QueryLargestCache(0x8000001D);
+
+        // Older AMD processors only have the L2 and L3 sizes, in KB and 512 KB units.
+        if (llc == 0 && max_extended_leaf >= 0x80000006)
+        {
+            QueryCpuid(0x80000006, 0, regs);
+            uint32_t l3 = (regs[3] >> 18) * 512 * 1024;
+            uint32_t l2 = (regs[2] >> 16) * 1024;
+            llc = l3 ? l3 : l2;
+        }
+    }
+
+    return llc;
+}
+
+#endif
+
+void blipvert::DetectCpuFeatures()
+{
+    CpuFeatures features = { false, false, false, false, 0 };
+
+#if defined(BLIPVERT_X86_SIMD)
+    uint32_t regs[4];
+    QueryCpuid(0, 0, regs);
+    uint32_t max_leaf = regs[0];
+
+    if (max_leaf >= 1)
+    {
+        QueryCpuid(1, 0, regs);
+        features.sse2 = (regs[3] & (1u << 26)) != 0;
+        features.ssse3 = (regs[2] & (1u << 9)) != 0;
+        features.sse41 = (regs[2] & (1u << 19)) != 0;
+
+        // AVX2 also needs the OS to save the upper halves of the YMM registers on a context switch.
+        bool osxsave = (regs[2] & (1u << 27)) != 0;
+        bool avx = (regs[2] & (1u << 28)) != 0;
+        if (osxsave && avx && (ReadXCR0() & 0x06) == 0x06 && max_leaf >= 7)
+        {
+            QueryCpuid(7, 0, regs);
+            features.avx2 = (regs[1] & (1u << 5)) != 0;
+        }
+    }
+
+    features.llc_bytes = DetectLastLevelCache(max_leaf);
+#endif
+
+    DetectedFeatures = features;
+}
+
+const CpuFeatures& blipvert::GetCpuFeatures()
+{
+    return DetectedFeatures;
+}
+
+uint32_t blipvert::GetStreamingStoreThreshold()
+{
+    return DetectedFeatures.llc_bytes ? DetectedFeatures.llc_bytes : DefaultStreamingStoreThreshold;
+}
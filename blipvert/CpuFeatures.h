@@ -0,0 +1,68 @@
+#pragma once
+
+//
+//  blipvert C++ library
+//
+//  MIT License
+//
+//  Copyright(c) 2021-2025 Don Jordan
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+//
+
+#include "blipverttypes.h"
+
+// The SSE4.1 and AVX2 kernels are only compiled for x86 and x64 targets.
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define BLIPVERT_X86_SIMD
+#endif
+
+// GCC and Clang need a per-function target attribute to emit instructions above the compiler's
+// baseline. MSVC allows the intrinsics for any instruction set without one.
+#if defined(BLIPVERT_X86_SIMD) && (defined(__GNUC__) || defined(__clang__))
+#define BLIPVERT_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define BLIPVERT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define BLIPVERT_TARGET_SSE41
+#define BLIPVERT_TARGET_AVX2
+#endif
+
+namespace blipvert
+{
+    typedef struct CpuFeatures {
+        bool sse2;          // SSE2 (always present on x64)
+        bool ssse3;         // SSSE3 (pshufb)
+        bool sse41;         // SSE4.1
+        bool avx2;          // AVX2, with the OS saving the YMM registers
+        uint32_t llc_bytes; // Size of the last level cache, 0 if CPUID doesn't report it
+    } CpuFeatures;
+
+    // Queries the processor with CPUID. This is called once by InitializeLibrary().
+    void DetectCpuFeatures();
+
+    // Returns the instruction set extensions found on the host processor.
+    const CpuFeatures& GetCpuFeatures();
+
+    // Used when CPUID doesn't report the last level cache.
+    const uint32_t DefaultStreamingStoreThreshold = 8 * 1024 * 1024;
+
+    // Output frames bigger than this many bytes don't fit in the cache alongside their input, so transform plans
+    // write them with non-temporal stores, see Stage::stream_stores. It's the size of the last level cache.
+    uint32_t GetStreamingStoreThreshold();
+}
@@ -28,133 +28,185 @@
 #include "FlipVertical.h"
 #include "blipvert.h"
 #include "CommonMacros.h"
+#include "CpuFeatures.h"
+#include "Staging.h"
+
+#include <cstring>
+
+#if defined(BLIPVERT_X86_SIMD)
+#include <immintrin.h>
+#endif
 
 using namespace blipvert;
 
-void FlipSinglePlane(int32_t height, uint8_t* buf, int32_t stride)
+// Bytes swapped per pass, one cache line from each row.
+const int32_t FlipLineBytes = 64;
+
+#if defined(BLIPVERT_X86_SIMD)
+BLIPVERT_TARGET_AVX2 static void SwapRows_AVX2(uint8_t* top, uint8_t* bottom, int32_t length)
 {
-    uint8_t* yp_top = buf;
-    uint8_t* yp_bottom = buf + (stride * (height - 1));
-    int32_t count = stride / sizeof(uint32_t);
-    int32_t remainder = stride % sizeof(uint32_t);
-    for (int32_t y = 0; y < height / 2; y++)
+    for (; length >= FlipLineBytes; length -= FlipLineBytes)
     {
-        uint32_t* xp_top = reinterpret_cast<uint32_t*>(yp_top);
-        uint32_t* xp_bottom = reinterpret_cast<uint32_t*>(yp_bottom);
+        __m256i top0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(top));
+        __m256i top1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(top + 32));
+        __m256i bottom0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bottom));
+        __m256i bottom1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bottom + 32));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(top), bottom0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(top + 32), bottom1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(bottom), top0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(bottom + 32), top1);
+        top += FlipLineBytes;
+        bottom += FlipLineBytes;
+    }
 
-        for (int32_t x = 0; x < count; x++)
-        {
-            uint32_t temp = *xp_top;
-            *xp_top++ = *xp_bottom;
-            *xp_bottom++ = temp;
-        }
+    if (length)
+    {
+        uint8_t bounce[FlipLineBytes];
+        memcpy(bounce, top, length);
+        memcpy(top, bottom, length);
+        memcpy(bottom, bounce, length);
+    }
+}
+#endif
 
-        if (remainder)
-        {
-            uint8_t* r_top = reinterpret_cast<uint8_t*>(xp_top);
-            uint8_t* r_bottom = reinterpret_cast<uint8_t*>(xp_bottom);
-            for (int32_t x = 0; x < remainder; x++)
-            {
-                uint8_t temp = *r_top;
-                *r_top++ = *r_bottom;
-                *r_bottom++ = temp;
-            }
-        }
+// Swaps two rows a cache line at a time through a bounce buffer. The fixed size copies compile to vector loads
+// and stores, or the AVX2 version does the same with the line held in registers.
+static void SwapRows(uint8_t* top, uint8_t* bottom, int32_t length, bool avx2)
+{
+#if defined(BLIPVERT_X86_SIMD)
+    if (avx2)
+    {
+        SwapRows_AVX2(top, bottom, length);
+        return;
+    }
+#endif
+
+    uint8_t bounce[FlipLineBytes];
+    for (; length >= FlipLineBytes; length -= FlipLineBytes)
+    {
+        memcpy(bounce, top, FlipLineBytes);
+        memcpy(top, bottom, FlipLineBytes);
+        memcpy(bottom, bounce, FlipLineBytes);
+        top += FlipLineBytes;
+        bottom += FlipLineBytes;
+    }
+
+    if (length)
+    {
+        memcpy(bounce, top, length);
+        memcpy(top, bottom, length);
+        memcpy(bottom, bounce, length);
+    }
+}
+
+// Swaps the rows of one slice of a plane with their mirror rows. The top half of the plane is cut into slices
+// with GetSliceRows(), so each row pair belongs to exactly one slice.
+static void FlipSinglePlane(uint8_t thread_index, uint8_t thread_count, int32_t height, uint8_t* buf, int32_t stride)
+{
+    int32_t first_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height / 2, first_row, slice_height);
 
+    bool avx2 = GetCpuFeatures().avx2;
+    uint8_t* yp_top = buf + (stride * first_row);
+    uint8_t* yp_bottom = buf + (stride * (height - 1 - first_row));
+    for (int32_t y = 0; y < slice_height; y++)
+    {
+        SwapRows(yp_top, yp_bottom, stride, avx2);
         yp_top += stride;
         yp_bottom -= stride;
     }
 }
 
-void blipvert::FlipVertical_RGBA(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_RGBA(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
     if (!stride)
         stride = width * 4;
 
-    FlipSinglePlane(height, buf, stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, stride);
 }
 
-void blipvert::FlipVertical_RGB32(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_RGB32(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
     if (!stride)
         stride = width * 4;
 
-    FlipSinglePlane(height, buf, stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, stride);
 }
 
-void blipvert::FlipVertical_RGB24(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_RGB24(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
     if (!stride)
         stride = width * 3;
 
-    FlipSinglePlane(height, buf, stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, stride);
 }
 
-void blipvert::FlipVertical_RGB565(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_RGB565(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
     if (!stride)
         stride = width * 2;
 
-    FlipSinglePlane(height, buf, stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, stride);
 }
 
-void blipvert::FlipVertical_RGB555(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_RGB555(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
     if (!stride)
         stride = width * 2;
 
-    FlipSinglePlane(height, buf, stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, stride);
 }
 
-void blipvert::FlipVertical_ARGB1555(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_ARGB1555(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
     if (!stride)
         stride = width * 2;
 
-    FlipSinglePlane(height, buf, stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, stride);
 }
 
-void blipvert::FlipVertical_AYUV(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_AYUV(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
     if (!stride)
         stride = width * 4;
 
-    FlipSinglePlane(height, buf, stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, stride);
 }
 
-void blipvert::FlipVertical_UYVY(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_UYVY(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
     if (!stride)
         stride = width * 2;
 
-    FlipSinglePlane(height, buf, stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, stride);
 }
 
-void blipvert::FlipVertical_YVYU(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_YVYU(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
     if (!stride)
         stride = width * 2;
 
-    FlipSinglePlane(height, buf, stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, stride);
 }
 
-void blipvert::FlipVertical_VYUY(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_VYUY(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
     if (!stride)
         stride = width * 2;
 
-    FlipSinglePlane(height, buf, stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, stride);
 }
 
-void blipvert::FlipVertical_YUY2(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_YUY2(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
     if (!stride)
         stride = width * 2;
 
-    FlipSinglePlane(height, buf, stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, stride);
 }
 
-void FlipVertical_PlanarYUV(int32_t width, int32_t height, uint8_t* buf, int32_t stride, int32_t decimation)
+static void FlipVertical_PlanarYUV(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, int32_t decimation)
 {
     int32_t uv_width = width / decimation;
     int32_t uv_height = height / decimation;
@@ -174,81 +226,81 @@ void FlipVertical_PlanarYUV(int32_t width, int32_t height, uint8_t* buf, int32_t
     uint8_t* uplane = buf + (y_stride * height);
     uint8_t* vplane = uplane + (uv_stride * uv_height);
 
-    FlipSinglePlane(height, buf, y_stride);
-    FlipSinglePlane(uv_height, uplane, uv_stride);
-    FlipSinglePlane(uv_height, vplane, uv_stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, y_stride);
+    FlipSinglePlane(thread_index, thread_count, uv_height, uplane, uv_stride);
+    FlipSinglePlane(thread_index, thread_count, uv_height, vplane, uv_stride);
 }
 
 
-void blipvert::FlipVertical_I420(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_I420(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
-    FlipVertical_PlanarYUV(width, height, buf, stride, 2);
+    FlipVertical_PlanarYUV(thread_index, thread_count, width, height, buf, stride, 2);
 }
 
-void blipvert::FlipVertical_YV12(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_YV12(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
-    FlipVertical_PlanarYUV(width, height, buf, stride, 2);
+    FlipVertical_PlanarYUV(thread_index, thread_count, width, height, buf, stride, 2);
 }
 
-void blipvert::FlipVertical_YVU9(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_YVU9(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
-    FlipVertical_PlanarYUV(width, height, buf, stride, 4);
+    FlipVertical_PlanarYUV(thread_index, thread_count, width, height, buf, stride, 4);
 }
 
-void blipvert::FlipVertical_YUV9(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_YUV9(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
-    FlipVertical_PlanarYUV(width, height, buf, stride, 4);
+    FlipVertical_PlanarYUV(thread_index, thread_count, width, height, buf, stride, 4);
 }
 
-void blipvert::FlipVertical_IYU1(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_IYU1(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
     if (!stride)
         stride = width * 12 / 8;
 
-    FlipSinglePlane(height, buf, stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, stride);
 }
 
-void blipvert::FlipVertical_IYU2(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_IYU2(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
     if (!stride)
         stride = width * 3;
 
-    FlipSinglePlane(height, buf, stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, stride);
 }
 
-void blipvert::FlipVertical_Y800(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_Y800(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
     if (!stride)
         stride = width;
 
-    FlipSinglePlane(height, buf, stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, stride);
 }
 
-void blipvert::FlipVertical_Y16(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_Y16(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
     if (!stride)
         stride = width * 2;
 
-    FlipSinglePlane(height, buf, stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, stride);
 }
 
-void blipvert::FlipVertical_Y41P(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_Y41P(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
     if (!stride)
         stride = width / 8 * 12;
 
-    FlipSinglePlane(height, buf, stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, stride);
 }
 
-void blipvert::FlipVertical_CLJR(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_CLJR(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
     if (!stride)
         stride = width;
 
-    FlipSinglePlane(height, buf, stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, stride);
 }
 
-void FlipVertical_IMCx(int32_t width, int32_t height, uint8_t* buf, int32_t stride, bool ufirst, bool interlaced)
+static void FlipVertical_IMCx(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, bool ufirst, bool interlaced)
 {
     if (!stride)
         stride = width;
@@ -291,39 +343,39 @@ void FlipVertical_IMCx(int32_t width, int32_t height, uint8_t* buf, int32_t stri
         uvplane = vplane;
     }
 
-    FlipSinglePlane(height, buf, stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, stride);
     if (interlaced)
     {
-        FlipSinglePlane(uv_height, uvplane, stride);
+        FlipSinglePlane(thread_index, thread_count, uv_height, uvplane, stride);
     }
     else
     {
-        FlipSinglePlane(uv_height, uplane, stride);
-        FlipSinglePlane(uv_height, vplane, stride);
+        FlipSinglePlane(thread_index, thread_count, uv_height, uplane, stride);
+        FlipSinglePlane(thread_index, thread_count, uv_height, vplane, stride);
     }
 }
 
-void blipvert::FlipVertical_IMC1(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_IMC1(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
-    FlipVertical_IMCx(width, height, buf, stride, false, false);
+    FlipVertical_IMCx(thread_index, thread_count, width, height, buf, stride, false, false);
 }
 
-void blipvert::FlipVertical_IMC2(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_IMC2(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
-    FlipVertical_IMCx(width, height, buf, stride, false, true);
+    FlipVertical_IMCx(thread_index, thread_count, width, height, buf, stride, false, true);
 }
 
-void blipvert::FlipVertical_IMC3(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_IMC3(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
-    FlipVertical_IMCx(width, height, buf, stride, true, false);
+    FlipVertical_IMCx(thread_index, thread_count, width, height, buf, stride, true, false);
 }
 
-void blipvert::FlipVertical_IMC4(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_IMC4(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
-    FlipVertical_IMCx(width, height, buf, stride, true, true);
+    FlipVertical_IMCx(thread_index, thread_count, width, height, buf, stride, true, true);
 }
 
-void FlipVertical_NVx(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+static void FlipVertical_NVx(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
     if (!stride)
         stride = width;
@@ -333,37 +385,37 @@ void FlipVertical_NVx(int32_t width, int32_t height, uint8_t* buf, int32_t strid
 
     uint8_t* uvplane = buf + (stride * height);
 
-    FlipSinglePlane(height, buf, stride);
-    FlipSinglePlane(uv_height, uvplane, stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, stride);
+    FlipSinglePlane(thread_index, thread_count, uv_height, uvplane, stride);
 }
 
-void blipvert::FlipVertical_NV12(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_NV12(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
-    FlipVertical_NVx(width, height, buf, stride);
+    FlipVertical_NVx(thread_index, thread_count, width, height, buf, stride);
 }
 
-void blipvert::FlipVertical_NV21(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_NV21(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
-    FlipVertical_NVx(width, height, buf, stride);
+    FlipVertical_NVx(thread_index, thread_count, width, height, buf, stride);
 }
 
-void blipvert::FlipVertical_Y42T(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_Y42T(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
     if (!stride)
         stride = width * 2;
 
-    FlipSinglePlane(height, buf, stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, stride);
 }
 
-void blipvert::FlipVertical_Y41T(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_Y41T(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
     if (!stride)
         stride = width / 8 * 12;
 
-    FlipSinglePlane(height, buf, stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, stride);
 }
 
-void blipvert::FlipVertical_YV16(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+void blipvert::FlipVerticalSlice_YV16(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
     int32_t uv_width = width / 2;
 
@@ -382,7 +434,161 @@ void blipvert::FlipVertical_YV16(int32_t width, int32_t height, uint8_t* buf, in
     uint8_t* vplane = buf + (y_stride * height);
     uint8_t* uplane = vplane + (uv_stride * height);
 
-    FlipSinglePlane(height, buf, y_stride);
-    FlipSinglePlane(height, vplane, uv_stride);
-    FlipSinglePlane(height, uplane, uv_stride);
+    FlipSinglePlane(thread_index, thread_count, height, buf, y_stride);
+    FlipSinglePlane(thread_index, thread_count, height, vplane, uv_stride);
+    FlipSinglePlane(thread_index, thread_count, height, uplane, uv_stride);
+}
+
+//
+// Whole frame flips on the calling thread.
+//
+
+void blipvert::FlipVertical_RGBA(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_RGBA(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_RGB32(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_RGB32(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_RGB24(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_RGB24(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_RGB565(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_RGB565(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_RGB555(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_RGB555(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_ARGB1555(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_ARGB1555(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_AYUV(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_AYUV(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_UYVY(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_UYVY(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_YVYU(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_YVYU(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_VYUY(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_VYUY(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_YUY2(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_YUY2(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_I420(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_I420(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_YV12(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_YV12(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_YVU9(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_YVU9(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_YUV9(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_YUV9(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_IYU1(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_IYU1(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_IYU2(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_IYU2(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_Y800(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_Y800(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_Y16(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_Y16(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_Y41P(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_Y41P(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_CLJR(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_CLJR(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_IMC1(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_IMC1(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_IMC2(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_IMC2(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_IMC3(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_IMC3(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_IMC4(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_IMC4(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_NV12(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_NV12(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_NV21(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_NV21(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_Y42T(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_Y42T(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_Y41T(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_Y41T(0, 1, width, height, buf, stride);
+}
+
+void blipvert::FlipVertical_YV16(int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    FlipVerticalSlice_YV16(0, 1, width, height, buf, stride);
 }
@@ -66,5 +66,42 @@ namespace blipvert
     void FlipVertical_Y42T(int32_t width, int32_t height, uint8_t* buf, int32_t stride);
     void FlipVertical_Y41T(int32_t width, int32_t height, uint8_t* buf, int32_t stride);
     void FlipVertical_YV16(int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+
+    // Flips one slice of a bitmap in place. The top half of each plane is cut into thread_count slices the way the
+    // Stage_* functions cut a frame, and slice thread_index swaps its rows with their mirror rows in the bottom half.
+    // Running every slice, from any threads, flips the whole bitmap. See ParallelFlipVertical() in ThreadPool.h.
+    typedef void(__cdecl* t_flipverticalslicefunc) (uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+
+    void FlipVerticalSlice_RGBA(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_RGB32(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_RGB24(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_RGB565(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_RGB555(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_ARGB1555(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+
+    void FlipVerticalSlice_AYUV(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_UYVY(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_YVYU(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_VYUY(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_YUY2(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_I420(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_YV12(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_YVU9(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_YUV9(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_IYU1(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_IYU2(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_Y800(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_Y16(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_Y41P(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_CLJR(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_IMC1(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_IMC2(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_IMC3(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_IMC4(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_NV12(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_NV21(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_Y42T(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_Y41T(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
+    void FlipVerticalSlice_YV16(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
 };
 
@@ -0,0 +1,101 @@
+//
+//  blipvert C++ library
+//
+//  MIT License
+//
+//  Copyright(c) 2021-2025 Don Jordan
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+//
+
+#include "pch.h"
+#include "FrameView.h"
+#include "blipvert.h"
+
+#include <cstring>
+
+using namespace blipvert;
+
+// The staging function stands in for the format, since duplicate format names share their main format's.
+static bool IsQuarterChromaStager(t_stagetransformfunc pstage)
+{
+    return pstage == Stage_I420 || pstage == Stage_YV12 || pstage == Stage_IMC1 || pstage == Stage_IMC3;
+}
+
+static bool IsSixteenthChromaStager(t_stagetransformfunc pstage)
+{
+    return pstage == Stage_YUV9 || pstage == Stage_YVU9;
+}
+
+static bool IsPlanarYUVStager(t_stagetransformfunc pstage)
+{
+    return IsQuarterChromaStager(pstage) || IsSixteenthChromaStager(pstage) ||
+        pstage == Stage_YV16 || pstage == Stage_NV12 || pstage == Stage_NV21 ||
+        pstage == Stage_IMC2 || pstage == Stage_IMC4;
+}
+
+bool blipvert::GetFrameView(const MediaFormatID& inFormat, const MediaFormatID& outFormat, const PlaneFrame& in, PlaneFrame& view)
+{
+    t_stagetransformfunc pstage_in = FindTransformStage(inFormat);
+    t_stagetransformfunc pstage_out = FindTransformStage(outFormat);
+    if (pstage_in == nullptr || pstage_out == nullptr || in.planes[0] == nullptr)
+        return false;
+
+    if (pstage_in == pstage_out ||
+        (IsQuarterChromaStager(pstage_in) && IsQuarterChromaStager(pstage_out)) ||
+        (IsSixteenthChromaStager(pstage_in) && IsSixteenthChromaStager(pstage_out)))
+    {
+        // The planes are named, so the frame already describes the output format.
+        view = in;
+        return true;
+    }
+
+    if (pstage_out == Stage_Y800 && IsPlanarYUVStager(pstage_in))
+    {
+        memset(&view, 0, sizeof(PlaneFrame));
+        view.planes[0] = in.planes[0];
+        view.strides[0] = in.strides[0];
+        return true;
+    }
+
+    return false;
+}
+
+bool blipvert::ViewOrTransform(const MediaFormatID& inFormat, const MediaFormatID& outFormat, int32_t width, int32_t height,
+    const PlaneFrame& in, bool in_flipped, const PlaneFrame& out, bool out_flipped, PlaneFrame& result,
+    xRGBQUAD* in_palette, xRGBQUAD* out_palette)
+{
+    // A view keeps the input's row order, so it can't flip the frame.
+    if (in_flipped == out_flipped && GetFrameView(inFormat, outFormat, in, result))
+        return true;
+
+    t_transformfunc transform = FindVideoTransform(inFormat, outFormat);
+    if (transform == nullptr)
+        return false;
+
+    Stage in_stage;
+    Stage out_stage;
+    if (!StagePlanes(&in_stage, inFormat, 0, 1, width, height, in, in_flipped, in_palette) ||
+        !StagePlanes(&out_stage, outFormat, 0, 1, width, height, out, out_flipped, out_palette))
+        return false;
+
+    transform(&in_stage, &out_stage);
+    result = out;
+    return true;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+//
+//  blipvert C++ library
+//
+//  MIT License
+//
+//  Copyright(c) 2021-2025 Don Jordan
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+//
+
+#include "blipverttypes.h"
+#include "Staging.h"
+
+namespace blipvert
+{
+    //
+    // A frame view describes a frame of one format as a frame of another without copying any pixels. It works
+    // when the output format keeps its pixels exactly the way the input does once the planes are named, see
+    // PlaneFrame in Staging.h:
+    //
+    //      I420, IYUV, YV12, IMC1 and IMC3 all have one Y plane and quarter size U and V planes.
+    //      YUV9 and YVU9 have one Y plane and sixteenth size U and V planes.
+    //      Y800 is the Y plane of any of the planar YUV formats.
+    //      A format is a view of itself.
+    //
+    // A view shares the input's planes, so it's only good for as long as they are.
+    //
+
+    // Describes a frame of inFormat as a frame of outFormat without copying it.
+    //
+    // Parameters:
+    //      inFormat:       IN  -> The media format of the frame.
+    //      outFormat:      IN  -> The media format to view it as.
+    //      in:             IN  -> The frame's planes and strides.
+    //      view:           OUT -> The frame described as outFormat.
+    // Returns false if outFormat doesn't keep its pixels the way inFormat does, or a plane of the frame is missing.
+    bool GetFrameView(const MediaFormatID& inFormat, const MediaFormatID& outFormat, const PlaneFrame& in, PlaneFrame& view);
+
+    // Makes a frame of outFormat from a frame of inFormat, as a view of the input when GetFrameView() allows it
+    // and both frames are flipped the same way, or else by transforming the input into out on the calling thread.
+    //
+    // Parameters:
+    //      inFormat:       IN  -> The media format of the input frame.
+    //      outFormat:      IN  -> The media format wanted.
+    //      width, height:  IN  -> The logical dimensions of the frames.
+    //      in:             IN  -> The input frame's planes and strides.
+    //      in_flipped:     IN  -> true if the input frame is flipped.
+    //      out:            IN  -> The planes to transform into when a view isn't possible.
+    //      out_flipped:    IN  -> true if the output frame should be flipped.
+    //      result:         OUT -> The output frame, either a view of in or out itself.
+    //      in_palette:     IN  -> The input palette for palettized formats, nullptr otherwise.
+    //      out_palette:    IN  -> The output palette for palettized formats, nullptr otherwise.
+    // Returns false if a view isn't possible and there's no transform between the formats either.
+    bool ViewOrTransform(const MediaFormatID& inFormat, const MediaFormatID& outFormat, int32_t width, int32_t height,
+        const PlaneFrame& in, bool in_flipped, const PlaneFrame& out, bool out_flipped, PlaneFrame& result,
+        xRGBQUAD* in_palette = nullptr, xRGBQUAD* out_palette = nullptr);
+}
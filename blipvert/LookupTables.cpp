@@ -32,119 +32,154 @@ using namespace blipvert;
 
 #define SATTAB_OFFSET 300
 
-int32_t blipvert::yr_table[256];
-int32_t blipvert::yg_table[256];
-int32_t blipvert::yb_table[256];
-int32_t blipvert::ur_table[256];
-int32_t blipvert::ug_table[256];
-int32_t blipvert::ub_table[256];
-int32_t blipvert::vr_table[256];
-int32_t blipvert::vg_table[256];
-int32_t blipvert::vb_table[256];
-
-int32_t blipvert::luminance_table[256];
-int32_t blipvert::u_table[256];
-int32_t blipvert::v_table[256];
-int32_t blipvert::uv_table[256][256];
-uint8_t blipvert::saturation_table[900];
-
-uint32_t blipvert::rgba_greyscale[256];
-uint32_t blipvert::rgb32_greyscale[256];
-uint16_t blipvert::rgb565_greyscale[256];
-uint16_t blipvert::rgb555_greyscale[256];
-uint16_t blipvert::rgba555_greyscale[256];
-
-xRGBQUAD blipvert::rgb1_greyscale_palette[2] { { 0, 0, 0, 255} , {255, 255, 255, 255} };
-xRGBQUAD blipvert::rgb4_greyscale_palette[16];
-xRGBQUAD blipvert::rgb8_greyscale_palette[256];
-
-void blipvert::InitLookupTables()
+//
+// Every table is generated by the compiler and lives in read-only data, so there's nothing to build at
+// startup and processes running the library share the same pages.
+//
+
+template <typename T, size_t N, typename F>
+static constexpr std::array<T, N> MakeTable(F entry)
 {
-    //    Build the RGB to YUV transform lookup tables.
-     //
-     //    RGB to YUV transform formula used:
-     //
-     //    Y =  0.257R + 0.504G + 0.098B + 16
-     //    U = -0.148R - 0.291G + 0.439B + 128
-     //    V =  0.439R - 0.368G - 0.071B + 128
+    std::array<T, N> table{};
+    for (size_t index = 0; index < N; index++)
+    {
+        table[index] = entry(static_cast<int16_t>(index));
+    }
+    return table;
+}
 
-    xRGBQUAD quad = { 0xFF, 0xFF,0xFF,0xFF };
+//    RGB to YUV transform formula used:
+//
+//    Y =  0.257R + 0.504G + 0.098B + 16
+//    U = -0.148R - 0.291G + 0.439B + 128
+//    V =  0.439R - 0.368G - 0.071B + 128
+//
+// Each term is scaled by 32768.
 
+static constexpr std::array<int32_t, 256> MakeRGBtoYUVTable(double coefficient)
+{
+    std::array<int32_t, 256> table{};
     for (int16_t index = 0; index < 256; index++)
     {
         double scalar = static_cast<double>(index) * 32768.0;
-        yr_table[index] = static_cast<int32_t>((0.257 * scalar) + 0.5);
-        yg_table[index] = static_cast<int32_t>((0.504 * scalar) + 0.5);
-        yb_table[index] = static_cast<int32_t>((0.098 * scalar) + 0.5);
-
-        ur_table[index] = static_cast<int32_t>((-0.148 * scalar) + 0.5);
-        ug_table[index] = static_cast<int32_t>((-0.291 * scalar) + 0.5);
-        ub_table[index] = static_cast<int32_t>((0.439 * scalar) + 0.5);
-
-        vr_table[index] = static_cast<int32_t>((0.439 * scalar) + 0.5);
-        vg_table[index] = static_cast<int32_t>((-0.368 * scalar) + 0.5);
-        vb_table[index] = static_cast<int32_t>((-0.071 * scalar) + 0.5);
-
-        // Greyscale extensions
-        rgba_greyscale[index] = ((static_cast<uint32_t>(index) << 16) | (static_cast<uint32_t>(index) << 8) | static_cast<uint32_t>(index));
-        rgb32_greyscale[index] = (0xFF000000 | (static_cast<uint32_t>(index) << 16) | (static_cast<uint32_t>(index) << 8) | static_cast<uint32_t>(index));
-        PackRGB565Word(rgb565_greyscale[index], static_cast<uint16_t>(index), static_cast<uint16_t>(index), static_cast<uint16_t>(index));
-        PackRGB555Word(rgb555_greyscale[index], static_cast<uint16_t>(index), static_cast<uint16_t>(index), static_cast<uint16_t>(index));
-        PackARGB555Word(rgba555_greyscale[index], 0, static_cast<uint16_t>(index), static_cast<uint16_t>(index), static_cast<uint16_t>(index));
-
-        quad.rgbBlue = static_cast<uint8_t>(index);
-        quad.rgbGreen = static_cast<uint8_t>(index);
-        quad.rgbRed = static_cast<uint8_t>(index);
-        rgb8_greyscale_palette[index] = quad;
+        table[index] = static_cast<int32_t>((coefficient * scalar) + 0.5);
     }
+    return table;
+}
+
+constexpr std::array<int32_t, 256> blipvert::yr_table = MakeRGBtoYUVTable(0.257);
+constexpr std::array<int32_t, 256> blipvert::yg_table = MakeRGBtoYUVTable(0.504);
+constexpr std::array<int32_t, 256> blipvert::yb_table = MakeRGBtoYUVTable(0.098);
+constexpr std::array<int32_t, 256> blipvert::ur_table = MakeRGBtoYUVTable(-0.148);
+constexpr std::array<int32_t, 256> blipvert::ug_table = MakeRGBtoYUVTable(-0.291);
+constexpr std::array<int32_t, 256> blipvert::ub_table = MakeRGBtoYUVTable(0.439);
+constexpr std::array<int32_t, 256> blipvert::vr_table = MakeRGBtoYUVTable(0.439);
+constexpr std::array<int32_t, 256> blipvert::vg_table = MakeRGBtoYUVTable(-0.368);
+constexpr std::array<int32_t, 256> blipvert::vb_table = MakeRGBtoYUVTable(-0.071);
+
+//    YUV to RGB transform formula used:
+//
+//    B = 1.164(Y - 16) + 2.018(U - 128)
+//    G = 1.164(Y - 16) - 0.813(V - 128) - 0.391(U - 128)
+//    R = 1.164(Y - 16) + 1.596(V - 128)
+//
+// Which simplifies to:
+//
+//    B = 1.164Y + 2.018U - 276.928
+//    G = 1.164Y - 0.813V - 0.391U + 154.112
+//    R = 1.164Y + 1.596V - 204.288
 
-    // RGB 4 greyscale
-    uint8_t value = 0;
-    for (int16_t index = 0; index < 16; index++)
-    {
-        quad.rgbBlue = value;
-        quad.rgbGreen = value;
-        quad.rgbRed = value;
-        rgb4_greyscale_palette[index] = quad;
-        value += 17;
-    }
+constexpr std::array<int32_t, 256> blipvert::luminance_table = MakeTable<int32_t, 256>([](int16_t index) {
+    return static_cast<int32_t>(1.164 * index) + SATTAB_OFFSET;
+    });
 
-    //    Build the YUV to RGB transform lookup tables.
-    //
-    //    YUV to RGB transform formula used:
-    //
-    //    B = 1.164(Y - 16) + 2.018(U - 128)
-    //    G = 1.164(Y - 16) - 0.813(V - 128) - 0.391(U - 128)
-    //    R = 1.164(Y - 16) + 1.596(V - 128)
-    //
-    // Which simplifies to:
-    //
-    //    B = 1.164Y + 2.018U - 276.928
-    //    G = 1.164Y - 0.813V - 0.391U + 154.112
-    //    R = 1.164Y + 1.596V - 204.288
+constexpr std::array<int32_t, 256> blipvert::u_table = MakeTable<int32_t, 256>([](int16_t index) {
+    return static_cast<int32_t>(2.018 * index - 276.928);
+    });
 
-    for (int16_t index = 0; index < 256; index++)
-    {
-        luminance_table[index] = static_cast<int32_t>(1.164 * index) + SATTAB_OFFSET;
-        u_table[index] = static_cast<int32_t>(2.018 * index - 276.928);
-        v_table[index] = static_cast<int32_t>(1.596 * index - 204.288);
-    }
+constexpr std::array<int32_t, 256> blipvert::v_table = MakeTable<int32_t, 256>([](int16_t index) {
+    return static_cast<int32_t>(1.596 * index - 204.288);
+    });
 
+#if !defined(BLIPVERT_FIXED_POINT_GREEN)
+static constexpr std::array<std::array<int32_t, 256>, 256> MakeUVTable()
+{
+    std::array<std::array<int32_t, 256>, 256> table{};
     for (int16_t u = 0; u < 256; u++)
     {
         for (int16_t v = 0; v < 256; v++)
         {
-            uv_table[u][v] = static_cast<int32_t>(-0.813 * v - 0.391 * u + 154.112);
+            table[u][v] = static_cast<int32_t>(-0.813 * v - 0.391 * u + 154.112);
         }
     }
-
-    for (int16_t val = -SATTAB_OFFSET; val < 600; val++)
+    return table;
+}
+
+constexpr std::array<std::array<int32_t, 256>, 256> blipvert::uv_table = MakeUVTable();
+#endif
+
+constexpr std::array<uint8_t, 900> blipvert::saturation_table = MakeTable<uint8_t, 900>([](int16_t index) {
+    int16_t val = index - SATTAB_OFFSET;
+    if (val < 0)
+        return static_cast<uint8_t>(0);
+    else if (val > 255)
+        return static_cast<uint8_t>(255);
+    else
+        return static_cast<uint8_t>(val);
+    });
+
+// Greyscale extensions
+
+constexpr std::array<uint32_t, 256> blipvert::rgba_greyscale = MakeTable<uint32_t, 256>([](int16_t index) {
+    return ((static_cast<uint32_t>(index) << 16) | (static_cast<uint32_t>(index) << 8) | static_cast<uint32_t>(index));
+    });
+
+constexpr std::array<uint32_t, 256> blipvert::rgb32_greyscale = MakeTable<uint32_t, 256>([](int16_t index) {
+    return (0xFF000000 | (static_cast<uint32_t>(index) << 16) | (static_cast<uint32_t>(index) << 8) | static_cast<uint32_t>(index));
+    });
+
+constexpr std::array<uint16_t, 256> blipvert::rgb565_greyscale = MakeTable<uint16_t, 256>([](int16_t index) {
+    uint16_t word = 0;
+    PackRGB565Word(word, static_cast<uint16_t>(index), static_cast<uint16_t>(index), static_cast<uint16_t>(index));
+    return word;
+    });
+
+constexpr std::array<uint16_t, 256> blipvert::rgb555_greyscale = MakeTable<uint16_t, 256>([](int16_t index) {
+    uint16_t word = 0;
+    PackRGB555Word(word, static_cast<uint16_t>(index), static_cast<uint16_t>(index), static_cast<uint16_t>(index));
+    return word;
+    });
+
+constexpr std::array<uint16_t, 256> blipvert::rgba555_greyscale = MakeTable<uint16_t, 256>([](int16_t index) {
+    uint16_t word = 0;
+    PackARGB555Word(word, 0, static_cast<uint16_t>(index), static_cast<uint16_t>(index), static_cast<uint16_t>(index));
+    return word;
+    });
+
+// The palettes are handed out through Stage::palette, which isn't const, so they stay writable. They're still
+// filled in by the compiler.
+
+template <size_t N>
+static constexpr std::array<xRGBQUAD, N> MakeGreyscalePalette()
+{
+    std::array<xRGBQUAD, N> palette{};
+    for (size_t index = 0; index < N; index++)
     {
-        if (val < 0)
-            saturation_table[val + SATTAB_OFFSET] = 0;
-        else if (val > 255)
-            saturation_table[val + SATTAB_OFFSET] = 255;
-        else
-            saturation_table[val + SATTAB_OFFSET] = static_cast<uint8_t>(val);
+        uint8_t value = static_cast<uint8_t>(index * (255 / (N - 1)));
+        palette[index] = { value, value, value, 0xFF };
     }
-}
\ No newline at end of file
+    return palette;
+}
+
+std::array<xRGBQUAD, 2> blipvert::rgb1_greyscale_palette = MakeGreyscalePalette<2>();
+std::array<xRGBQUAD, 16> blipvert::rgb4_greyscale_palette = MakeGreyscalePalette<16>();
+std::array<xRGBQUAD, 256> blipvert::rgb8_greyscale_palette = MakeGreyscalePalette<256>();
+
+bool blipvert::IsFixedPointGreen()
+{
+#if defined(BLIPVERT_FIXED_POINT_GREEN)
+    return true;
+#else
+    return false;
+#endif
+}
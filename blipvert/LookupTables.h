@@ -28,34 +28,69 @@
 
 #include "blipverttypes.h"
 
+#include <array>
+
 namespace blipvert
 {
-    extern int32_t yr_table[256];
-    extern int32_t yg_table[256];
-    extern int32_t yb_table[256];
-    extern int32_t ur_table[256];
-    extern int32_t ug_table[256];
-    extern int32_t ub_table[256];
-    extern int32_t vr_table[256];
-    extern int32_t vg_table[256];
-    extern int32_t vb_table[256];
-
-    extern int32_t luminance_table[256];
-    extern int32_t u_table[256];
-    extern int32_t v_table[256];
-    extern int32_t uv_table[256][256];
-    extern uint8_t saturation_table[900];
-
-    extern uint32_t rgba_greyscale[256];
-    extern uint32_t rgb32_greyscale[256];
-    extern uint16_t rgb565_greyscale[256];
-    extern uint16_t rgb555_greyscale[256];
-    extern uint16_t rgba555_greyscale[256];
-
-    extern xRGBQUAD rgb1_greyscale_palette[2];
-    extern xRGBQUAD rgb4_greyscale_palette[16];
-    extern xRGBQUAD rgb8_greyscale_palette[256];
-
-    void InitLookupTables();
+    extern const std::array<int32_t, 256> yr_table;
+    extern const std::array<int32_t, 256> yg_table;
+    extern const std::array<int32_t, 256> yb_table;
+    extern const std::array<int32_t, 256> ur_table;
+    extern const std::array<int32_t, 256> ug_table;
+    extern const std::array<int32_t, 256> ub_table;
+    extern const std::array<int32_t, 256> vr_table;
+    extern const std::array<int32_t, 256> vg_table;
+    extern const std::array<int32_t, 256> vb_table;
+
+    extern const std::array<int32_t, 256> luminance_table;
+    extern const std::array<int32_t, 256> u_table;
+    extern const std::array<int32_t, 256> v_table;
+#if !defined(BLIPVERT_FIXED_POINT_GREEN)
+    extern const std::array<std::array<int32_t, 256>, 256> uv_table;
+#endif
+    extern const std::array<uint8_t, 900> saturation_table;
+
+    extern const std::array<uint32_t, 256> rgba_greyscale;
+    extern const std::array<uint32_t, 256> rgb32_greyscale;
+    extern const std::array<uint16_t, 256> rgb565_greyscale;
+    extern const std::array<uint16_t, 256> rgb555_greyscale;
+    extern const std::array<uint16_t, 256> rgba555_greyscale;
+
+    extern std::array<xRGBQUAD, 2> rgb1_greyscale_palette;
+    extern std::array<xRGBQUAD, 16> rgb4_greyscale_palette;
+    extern std::array<xRGBQUAD, 256> rgb8_greyscale_palette;
+
+    //
+    // The green term of the YUV to RGB transform depends on both U and V, so the table version needs a 256 KB
+    // table. Defining BLIPVERT_FIXED_POINT_GREEN when building the library drops uv_table and computes the term
+    // with 16 bit fixed-point multiply-adds instead:
+    //
+    //    G' = trunc((UV_GREEN_U_SCALE * U + UV_GREEN_V_SCALE * V + UV_GREEN_OFFSET) / 2^UV_GREEN_SHIFT)
+    //
+    // which is -0.391U - 0.813V + 154.112 scaled by 32768. The constants were tuned so it agrees with uv_table
+    // to within 1 and stays within 1 of SlowYUVtoRGB() after the luminance term is added.
+    //
+    const int32_t UV_GREEN_U_SCALE = -12812;
+    const int32_t UV_GREEN_V_SCALE = -26641;
+    const int32_t UV_GREEN_OFFSET = 5049982;
+    const int32_t UV_GREEN_SHIFT = 15;
+
+    inline int32_t FixedPointGreen(int32_t u, int32_t v)
+    {
+        return (UV_GREEN_U_SCALE * u + UV_GREEN_V_SCALE * v + UV_GREEN_OFFSET) / (1 << UV_GREEN_SHIFT);
+    }
+
+    // Returns the green chroma term for a U and V pair.
+    inline int32_t GreenChroma(int32_t u, int32_t v)
+    {
+#if defined(BLIPVERT_FIXED_POINT_GREEN)
+        return FixedPointGreen(u, v);
+#else
+        return uv_table[u][v];
+#endif
+    }
+
+    // Returns true if the library was built with BLIPVERT_FIXED_POINT_GREEN.
+    bool IsFixedPointGreen();
 }
 
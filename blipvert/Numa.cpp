@@ -0,0 +1,392 @@
+//
+//  blipvert C++ library
+//
+//  MIT License
+//
+//  Copyright(c) 2021-2025 Don Jordan
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+//
+
+#include "pch.h"
+#include "Numa.h"
+
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__linux__)
+#include <fstream>
+#include <string>
+#include <cstdlib>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#else
+#include <new>
+#endif
+
+using namespace blipvert;
+
+#if defined(_WIN32)
+
+// Processors per processor group.
+static const uint32_t GroupSize = 64;
+
+static int32_t GetProcessorNode(const PROCESSOR_NUMBER& number)
+{
+    USHORT node;
+    if (!GetNumaProcessorNodeEx(const_cast<PROCESSOR_NUMBER*>(&number), &node) || node == 0xFFFF)
+        return -1;
+
+    return static_cast<int32_t>(node);
+}
+
+uint32_t blipvert::GetNumaNodeCount()
+{
+    ULONG highest;
+    if (!GetNumaHighestNodeNumber(&highest))
+        return 1;
+
+    return static_cast<uint32_t>(highest) + 1;
+}
+
+bool blipvert::GetNumaNodeCpus(uint32_t node, std::vector<uint32_t>& cpus)
+{
+    cpus.clear();
+
+    GROUP_AFFINITY affinity;
+    if (node > 0xFFFF || !GetNumaNodeProcessorMaskEx(static_cast<USHORT>(node), &affinity))
+        return false;
+
+    for (uint32_t bit = 0; bit < sizeof(KAFFINITY) * 8; bit++)
+    {
+        if (affinity.Mask & (static_cast<KAFFINITY>(1) << bit))
+            cpus.push_back(affinity.Group * GroupSize + bit);
+    }
+
+    return !cpus.empty();
+}
+
+int32_t blipvert::GetCpuNumaNode(uint32_t cpu)
+{
+    PROCESSOR_NUMBER number = {};
+    number.Group = static_cast<WORD>(cpu / GroupSize);
+    number.Number = static_cast<BYTE>(cpu % GroupSize);
+    return GetProcessorNode(number);
+}
+
+int32_t blipvert::GetCurrentNumaNode()
+{
+    PROCESSOR_NUMBER number;
+    GetCurrentProcessorNumberEx(&number);
+    return GetProcessorNode(number);
+}
+
+int32_t blipvert::GetBufferNumaNode(const void* buf)
+{
+    PSAPI_WORKING_SET_EX_INFORMATION info = {};
+    info.VirtualAddress = const_cast<void*>(buf);
+    if (!QueryWorkingSetEx(GetCurrentProcess(), &info, sizeof(info)) || !info.VirtualAttributes.Valid)
+        return -1;
+
+    return static_cast<int32_t>(info.VirtualAttributes.Node);
+}
+
+uint8_t* blipvert::AllocateNodeBuffer(size_t size, int32_t node)
+{
+    if (size == 0)
+        return nullptr;
+
+    if (node < 0)
+        node = GetCurrentNumaNode();
+
+    void* buf;
+    if (node >= 0)
+        buf = VirtualAllocExNuma(GetCurrentProcess(), nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, static_cast<DWORD>(node));
+    else
+        buf = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+
+    return static_cast<uint8_t*>(buf);
+}
+
+void blipvert::FreeNodeBuffer(uint8_t* buf, size_t size)
+{
+    if (buf != nullptr)
+        VirtualFree(buf, 0, MEM_RELEASE);
+}
+
+bool blipvert::SetCurrentThreadCpus(const std::vector<uint32_t>& cpus)
+{
+    if (cpus.empty())
+        return false;
+
+    GROUP_AFFINITY affinity = {};
+    affinity.Group = static_cast<WORD>(cpus[0] / GroupSize);
+    for (uint32_t cpu : cpus)
+    {
+        if (cpu / GroupSize == affinity.Group && cpu % GroupSize < sizeof(KAFFINITY) * 8)
+            affinity.Mask |= static_cast<KAFFINITY>(1) << (cpu % GroupSize);
+    }
+
+    return affinity.Mask != 0 && SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+}
+
+#elif defined(__linux__)
+
+static const char* NodeDirectory = "/sys/devices/system/node/";
+
+// Reads a sysfs list such as "0-3,8-11". Returns false if the file can't be read.
+static bool ReadSysfsList(const std::string& path, std::vector<uint32_t>& values)
+{
+    values.clear();
+
+    std::ifstream file(path);
+    std::string text;
+    if (!file || !std::getline(file, text))
+        return false;
+
+    const char* next = text.c_str();
+    while (*next != '\0')
+    {
+        char* end;
+        uint32_t first = static_cast<uint32_t>(strtoul(next, &end, 10));
+        if (end == next)
+            break;
+
+        uint32_t last = first;
+        if (*end == '-')
+        {
+            next = end + 1;
+            last = static_cast<uint32_t>(strtoul(next, &end, 10));
+        }
+
+        for (uint32_t value = first; value <= last; value++)
+        {
+            values.push_back(value);
+        }
+
+        next = (*end == ',') ? end + 1 : end;
+    }
+
+    return true;
+}
+
+// False when the kernel has no NUMA support, in which case everything is on node 0.
+static bool HasNumaNodes()
+{
+    std::vector<uint32_t> nodes;
+    return ReadSysfsList(std::string(NodeDirectory) + "online", nodes) && !nodes.empty();
+}
+
+uint32_t blipvert::GetNumaNodeCount()
+{
+    std::vector<uint32_t> nodes;
+    if (!ReadSysfsList(std::string(NodeDirectory) + "online", nodes) || nodes.empty())
+        return 1;
+
+    return nodes.back() + 1;
+}
+
+bool blipvert::GetNumaNodeCpus(uint32_t node, std::vector<uint32_t>& cpus)
+{
+    cpus.clear();
+
+    if (!HasNumaNodes())
+    {
+        if (node != 0)
+            return false;
+
+        uint32_t hardware_threads = std::thread::hardware_concurrency();
+        for (uint32_t cpu = 0; cpu < hardware_threads; cpu++)
+        {
+            cpus.push_back(cpu);
+        }
+        return !cpus.empty();
+    }
+
+    return ReadSysfsList(std::string(NodeDirectory) + "node" + std::to_string(node) + "/cpulist", cpus) && !cpus.empty();
+}
+
+int32_t blipvert::GetCpuNumaNode(uint32_t cpu)
+{
+    std::vector<uint32_t> cpus;
+    uint32_t node_count = GetNumaNodeCount();
+    for (uint32_t node = 0; node < node_count; node++)
+    {
+        if (GetNumaNodeCpus(node, cpus))
+        {
+            for (uint32_t node_cpu : cpus)
+            {
+                if (node_cpu == cpu)
+                    return static_cast<int32_t>(node);
+            }
+        }
+    }
+
+    return -1;
+}
+
+int32_t blipvert::GetCurrentNumaNode()
+{
+    unsigned int cpu;
+    unsigned int node;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0)
+        return -1;
+
+    return static_cast<int32_t>(node);
+}
+
+int32_t blipvert::GetBufferNumaNode(const void* buf)
+{
+    uintptr_t page_mask = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE)) - 1;
+    void* page = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(buf) & ~page_mask);
+
+    // Without a list of nodes to move to, move_pages() only reports where the page is, or -ENOENT if it isn't
+    // mapped yet.
+    int status = -1;
+    if (syscall(SYS_move_pages, 0, 1UL, &page, nullptr, &status, 0) == 0)
+        return status >= 0 ? status : -1;
+
+    // move_pages() can be blocked by a seccomp filter. get_mempolicy() reports the same thing, although it faults
+    // an unmapped page in.
+    int node = -1;
+    if (syscall(SYS_get_mempolicy, &node, nullptr, 0UL, page, MPOL_F_NODE | MPOL_F_ADDR) == 0)
+        return node;
+
+    return -1;
+}
+
+uint8_t* blipvert::AllocateNodeBuffer(size_t size, int32_t node)
+{
+    if (size == 0)
+        return nullptr;
+
+    void* buf = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buf == MAP_FAILED)
+        return nullptr;
+
+    if (node < 0)
+        node = GetCurrentNumaNode();
+
+    // The node is preferred rather than required, so the pages come from another node instead of the process
+    // being killed when the node runs out of memory. If the policy can't be set the pages go wherever they're
+    // first written.
+    if (node >= 0 && HasNumaNodes())
+    {
+        const size_t bits = sizeof(unsigned long) * 8;
+        std::vector<unsigned long> mask(node / bits + 1, 0);
+        mask[node / bits] |= 1UL << (node % bits);
+
+        // The kernel counts one less node than it's given.
+        syscall(SYS_mbind, buf, size, MPOL_PREFERRED, mask.data(), mask.size() * bits + 1, 0);
+    }
+
+    return static_cast<uint8_t*>(buf);
+}
+
+void blipvert::FreeNodeBuffer(uint8_t* buf, size_t size)
+{
+    if (buf != nullptr)
+        munmap(buf, size);
+}
+
+bool blipvert::SetCurrentThreadCpus(const std::vector<uint32_t>& cpus)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    bool any = false;
+    for (uint32_t cpu : cpus)
+    {
+        if (cpu < CPU_SETSIZE)
+        {
+            CPU_SET(cpu, &set);
+            any = true;
+        }
+    }
+
+    return any && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+#else
+
+// No NUMA support, so the machine is one node.
+
+uint32_t blipvert::GetNumaNodeCount()
+{
+    return 1;
+}
+
+bool blipvert::GetNumaNodeCpus(uint32_t node, std::vector<uint32_t>& cpus)
+{
+    cpus.clear();
+    if (node == 0)
+    {
+        uint32_t hardware_threads = std::thread::hardware_concurrency();
+        for (uint32_t cpu = 0; cpu < hardware_threads; cpu++)
+        {
+            cpus.push_back(cpu);
+        }
+    }
+
+    return !cpus.empty();
+}
+
+int32_t blipvert::GetCpuNumaNode(uint32_t cpu)
+{
+    return cpu < std::thread::hardware_concurrency() ? 0 : -1;
+}
+
+int32_t blipvert::GetCurrentNumaNode()
+{
+    return 0;
+}
+
+int32_t blipvert::GetBufferNumaNode(const void* buf)
+{
+    return 0;
+}
+
+uint8_t* blipvert::AllocateNodeBuffer(size_t size, int32_t node)
+{
+    if (size == 0)
+        return nullptr;
+
+    return new (std::nothrow) uint8_t[size];
+}
+
+void blipvert::FreeNodeBuffer(uint8_t* buf, size_t size)
+{
+    delete[] buf;
+}
+
+bool blipvert::SetCurrentThreadCpus(const std::vector<uint32_t>& cpus)
+{
+    return false;
+}
+
+#endif
@@ -0,0 +1,76 @@
+#pragma once
+
+//
+//  blipvert C++ library
+//
+//  MIT License
+//
+//  Copyright(c) 2021-2025 Don Jordan
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+//
+
+#include "blipverttypes.h"
+
+#include <vector>
+
+namespace blipvert
+{
+    //
+    // Processor and memory placement.
+    //
+    // On a machine with more than one NUMA node, a thread that reads or writes memory attached to another node's
+    // socket gets a fraction of the bandwidth it gets from its own. These functions report the nodes, the processors
+    // on them and the node a buffer's memory is on, pin threads to processors and allocate buffers on a node, so the
+    // worker pool can keep a frame on the node that holds it, see ThreadPoolOptions.
+    //
+    // Processors are numbered the way the OS numbers them. On Windows a processor's number is its processor group
+    // times 64 plus its number in the group. Where the OS doesn't report NUMA nodes the machine is one node that
+    // holds every processor.
+    //
+
+    // Returns the number of NUMA nodes, at least 1. Nodes are numbered from 0, and on Linux there can be gaps
+    // in the numbering for nodes that are offline.
+    uint32_t GetNumaNodeCount();
+
+    // Fills cpus with the processors on a node. Returns false, leaving cpus empty, if the node has none.
+    bool GetNumaNodeCpus(uint32_t node, std::vector<uint32_t>& cpus);
+
+    // Returns the node a processor is on, or -1 if it isn't known.
+    int32_t GetCpuNumaNode(uint32_t cpu);
+
+    // Returns the node of the processor the calling thread is running on, or -1 if it isn't known.
+    int32_t GetCurrentNumaNode();
+
+    // Returns the node holding the memory page at buf, or -1 if it isn't known, such as for a page that hasn't been
+    // written yet. On Linux this is found with move_pages(), or get_mempolicy() where move_pages() isn't allowed.
+    int32_t GetBufferNumaNode(const void* buf);
+
+    // Allocates size bytes of page aligned memory on a node, or on the calling thread's node when node is -1. The
+    // pages are only committed when they're first written but still come from the node's memory, whichever thread
+    // writes them. Returns nullptr if the memory can't be allocated. Free it with FreeNodeBuffer().
+    uint8_t* AllocateNodeBuffer(size_t size, int32_t node = -1);
+
+    // Frees a buffer from AllocateNodeBuffer(). size must be the size it was allocated with.
+    void FreeNodeBuffer(uint8_t* buf, size_t size);
+
+    // Restricts the calling thread to a set of processors. On Windows the processors must be in one processor group
+    // and any in other groups than the first one's are ignored. Returns false if the thread couldn't be pinned.
+    bool SetCurrentThreadCpus(const std::vector<uint32_t>& cpus);
+}
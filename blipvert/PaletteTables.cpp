@@ -0,0 +1,160 @@
+//
+//  blipvert C++ library
+//
+//  MIT License
+//
+//  Copyright(c) 2021-2025 Don Jordan
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+//
+
+#include "pch.h"
+#include "PaletteTables.h"
+#include "CommonMacros.h"
+
+#include <cstring>
+#include <memory>
+
+using namespace blipvert;
+
+static void BuildPaletteTables(PaletteTables& tables, const xRGBQUAD* palette, uint8_t bits, uint16_t entries)
+{
+    tables.source = palette;
+    tables.entries = entries;
+    tables.palette.fill(xRGBQUAD());
+    memcpy(tables.palette.data(), palette, entries * sizeof(xRGBQUAD));
+
+    for (uint16_t index = 0; index < 256; index++)
+    {
+        const xRGBQUAD& color = tables.palette[index];
+        tables.rgb32[index] = static_cast<uint32_t>(color.rgbBlue) |
+            (static_cast<uint32_t>(color.rgbGreen) << 8) |
+            (static_cast<uint32_t>(color.rgbRed) << 16) |
+            0xFF000000;
+        PackRGB565Word(tables.rgb565[index], color.rgbRed, color.rgbGreen, color.rgbBlue);
+        PackRGB555Word(tables.rgb555[index], color.rgbRed, color.rgbGreen, color.rgbBlue);
+    }
+
+    if (bits == 8)
+        return;
+
+    uint8_t pixels = bits == 4 ? 2 : 8;
+    uint8_t shift = bits;
+    uint8_t mask = static_cast<uint8_t>((1 << bits) - 1);
+    for (uint16_t byte = 0; byte < 256; byte++)
+    {
+        for (uint8_t pixel = 0; pixel < pixels; pixel++)
+        {
+            uint8_t index = (byte >> (pixel * shift)) & mask;
+            tables.rgb32_byte[byte][pixel] = tables.rgb32[index];
+            tables.rgb565_byte[byte][pixel] = tables.rgb565[index];
+            tables.rgb555_byte[byte][pixel] = tables.rgb555[index];
+        }
+    }
+}
+
+const PaletteTables& blipvert::GetPaletteTables(const xRGBQUAD* palette, uint8_t bits, uint16_t entries)
+{
+    // One set per bit depth, so a thread expanding RGB8 and RGB1 frames in turn doesn't rebuild either.
+    thread_local std::unique_ptr<PaletteTables> cache[3];
+
+    std::unique_ptr<PaletteTables>& tables = cache[bits == 8 ? 0 : (bits == 4 ? 1 : 2)];
+    if (tables == nullptr)
+    {
+        tables.reset(new PaletteTables);
+    }
+    else if (tables->source == palette && tables->entries >= entries &&
+        memcmp(tables->palette.data(), palette, entries * sizeof(xRGBQUAD)) == 0)
+    {
+        return *tables;
+    }
+
+    BuildPaletteTables(*tables, palette, bits, entries);
+    return *tables;
+}
+
+const PaletteTables& blipvert::GetPaletteTables(const Stage* in, uint8_t bits)
+{
+    // The scan reads the whole slice once more, so it's only done when the palette's size isn't known.
+    uint16_t entries = in->palette_entries;
+    if (entries == 0)
+        entries = CountPaletteEntriesUsed(in, bits);
+    else if (entries > (1 << bits))
+        entries = static_cast<uint16_t>(1 << bits);
+
+    return GetPaletteTables(in->palette, bits, entries);
+}
+
+uint16_t blipvert::CountPaletteEntriesUsed(const Stage* in, uint8_t bits)
+{
+    if (in->width <= 0 || in->height <= 0)
+        return 0;
+
+    // Only the pixels are looked at, not the unused bits at the end of an RGB4 or RGB1 row.
+    uint8_t highest = 0;
+    uint8_t* row = in->buf;
+    for (int32_t y = 0; y < in->height; y++)
+    {
+        if (bits == 8)
+        {
+            for (int32_t x = 0; x < in->width; x++)
+            {
+                highest = row[x] > highest ? row[x] : highest;
+            }
+        }
+        else if (bits == 4)
+        {
+            int32_t bytes = in->width / 2;
+            for (int32_t x = 0; x < bytes; x++)
+            {
+                uint8_t low = row[x] & 0x0F;
+                uint8_t high = row[x] >> 4;
+                highest = low > highest ? low : highest;
+                highest = high > highest ? high : highest;
+            }
+
+            if (in->width & 1)
+            {
+                uint8_t low = row[bytes] & 0x0F;
+                highest = low > highest ? low : highest;
+            }
+        }
+        else
+        {
+            int32_t bytes = in->width / 8;
+            uint8_t set = 0;
+            for (int32_t x = 0; x < bytes; x++)
+            {
+                set |= row[x];
+            }
+
+            if (in->width & 7)
+                set |= row[bytes] & static_cast<uint8_t>((1 << (in->width & 7)) - 1);
+
+            highest = set ? 1 : 0;
+        }
+
+        if (highest == (1 << bits) - 1)
+            break;
+
+        row += in->stride;
+    }
+
+    return static_cast<uint16_t>(highest + 1);
+}
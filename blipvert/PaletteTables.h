@@ -0,0 +1,79 @@
+#pragma once
+
+//
+//  blipvert C++ library
+//
+//  MIT License
+//
+//  Copyright(c) 2021-2025 Don Jordan
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+//
+
+#include "blipverttypes.h"
+#include "Staging.h"
+
+#include <array>
+
+namespace blipvert
+{
+    //
+    // Palette tables expand the indexed RGB formats without looking up and packing each pixel's palette entry.
+    // The entry tables give the finished output pixel for a palette index. The byte tables give every output
+    // pixel a whole input byte makes: two for RGB4, low nibble first, and eight for RGB1, low bit first.
+    // RGB8 doesn't have byte tables, its bytes are already indexes.
+    //
+    // The tables are built from a palette the first time a thread expands a frame with it and are kept per
+    // thread, one set for each bit depth. A frame with the same palette uses the cached set. The palette's
+    // entries are compared as well as its address, so a palette that's been changed in place is rebuilt.
+    // A palette only has to hold the entries its pixels use, such as a bitmap's biClrUsed colors, and the table
+    // entries past the ones read are black. A stage's palette_entries says how many that is. The staging functions
+    // set it for the greyscale palettes they fall back on, and a caller that knows its palette's size can set it
+    // on its stages, or once on a transform plan's. Otherwise each frame is scanned for its highest index first.
+    //
+    typedef struct PaletteTables {
+        const xRGBQUAD* source;                                 // The palette the tables were built from.
+        uint16_t entries;                                       // Palette entries read, at most 256, 16 or 2.
+        std::array<xRGBQUAD, 256> palette;                      // Copy of the palette's entries.
+        std::array<uint32_t, 256> rgb32;                        // Index to RGB32, with the alpha byte set.
+        std::array<uint16_t, 256> rgb565;                       // Index to RGB565.
+        std::array<uint16_t, 256> rgb555;                       // Index to RGB555.
+        std::array<std::array<uint32_t, 8>, 256> rgb32_byte;    // RGB4 or RGB1 byte to RGB32 pixels.
+        std::array<std::array<uint16_t, 8>, 256> rgb565_byte;   // RGB4 or RGB1 byte to RGB565 pixels.
+        std::array<std::array<uint16_t, 8>, 256> rgb555_byte;   // RGB4 or RGB1 byte to RGB555 pixels.
+    } PaletteTables;
+
+    // Returns the calling thread's tables for a palette, building them if the palette isn't the one they were
+    // last built from or they hold fewer entries.
+    //
+    // Parameters:
+    //      palette:        IN  -> The palette.
+    //      bits:           IN  -> Bits per pixel of the indexed format: 8, 4 or 1.
+    //      entries:        IN  -> The number of leading palette entries to read, up to 2^bits.
+    // The result stays good on the calling thread until it asks for tables of the same bit depth and a different palette.
+    const PaletteTables& GetPaletteTables(const xRGBQUAD* palette, uint8_t bits, uint16_t entries);
+
+    // Same as above, for the palette of an indexed stage. It reads in->palette_entries entries, or as many as the
+    // stage's pixels use when that's 0.
+    const PaletteTables& GetPaletteTables(const Stage* in, uint8_t bits);
+
+    // Returns one more than the highest palette index of any pixel in an indexed stage, so at least 1, or 0 for a
+    // stage without pixels.
+    uint16_t CountPaletteEntriesUsed(const Stage* in, uint8_t bits);
+}
@@ -30,8 +30,15 @@
 #include "CommonMacros.h"
 #include "blipvert.h"
 #include "LookupTables.h"
+#include "CpuFeatures.h"
+#include "StreamingStores.h"
+#include "PaletteTables.h"
 #include <cstring>
 
+#if defined(BLIPVERT_X86_SIMD)
+#include <immintrin.h>
+#endif
+
 using namespace blipvert;
 
 
@@ -174,7 +181,7 @@ void blipvert::RGB32_to_RGBA(Stage* in, Stage* out)
     int32_t in_stride = in->stride;
     int32_t out_stride = out->stride;
 
-    if (out_stride == in_stride && !out->flipped)
+    if (out_stride == in_stride && !out->flipped && !out->tiled)
     {
         memcpy(out_buf, in_buf, out_stride * height);
         return;
@@ -391,7 +398,7 @@ void blipvert::RGB555_to_ARGB1555(Stage* in, Stage* out)
     int32_t in_stride = in->stride;
     int32_t out_stride = out->stride;
 
-    if (out_stride == in_stride && !out->flipped)
+    if (out_stride == in_stride && !out->flipped && !out->tiled)
     {
         memcpy(out_buf, in_buf, out_stride * height);
         return;
@@ -557,7 +564,7 @@ void blipvert::RGB8_to_RGB32(Stage* in, Stage* out)
     int32_t height = in->height;
     int32_t in_stride = in->stride;
     int32_t out_stride = out->stride;
-    xRGBQUAD* in_palette = in->palette;
+    const uint32_t* rgb32 = GetPaletteTables(in, 8).rgb32.data();
 
     do
     {
@@ -566,7 +573,7 @@ void blipvert::RGB8_to_RGB32(Stage* in, Stage* out)
         int32_t hcount = width;
         do
         {
-            *pdst++ = (*reinterpret_cast<uint32_t*>(&in_palette[*psrc++]) | 0xFF000000);
+            *pdst++ = rgb32[*psrc++];
         } while (--hcount);
 
         in_buf += in_stride;
@@ -610,7 +617,7 @@ void blipvert::RGB8_to_RGB565(Stage* in, Stage* out)
     int32_t height = in->height;
     int32_t in_stride = in->stride;
     int32_t out_stride = out->stride;
-    xRGBQUAD* in_palette = in->palette;
+    const uint16_t* rgb565 = GetPaletteTables(in, 8).rgb565.data();
 
     do
     {
@@ -619,10 +626,7 @@ void blipvert::RGB8_to_RGB565(Stage* in, Stage* out)
         int32_t hcount = width;
         do
         {
-            PackRGB565Word(*pdst++, in_palette[*psrc].rgbRed,
-                in_palette[*psrc].rgbGreen,
-                in_palette[*psrc].rgbBlue);
-            psrc++;
+            *pdst++ = rgb565[*psrc++];
         } while (--hcount);
 
         in_buf += in_stride;
@@ -638,7 +642,7 @@ void blipvert::RGB8_to_RGB555(Stage* in, Stage* out)
     int32_t height = in->height;
     int32_t in_stride = in->stride;
     int32_t out_stride = out->stride;
-    xRGBQUAD* in_palette = in->palette;
+    const uint16_t* rgb555 = GetPaletteTables(in, 8).rgb555.data();
 
     do
     {
@@ -647,10 +651,7 @@ void blipvert::RGB8_to_RGB555(Stage* in, Stage* out)
         int32_t hcount = width;
         do
         {
-            PackRGB555Word(*pdst++, in_palette[*psrc].rgbRed,
-                in_palette[*psrc].rgbGreen,
-                in_palette[*psrc].rgbBlue);
-            psrc++;
+            *pdst++ = rgb555[*psrc++];
         } while (--hcount);
 
         in_buf += in_stride;
@@ -670,7 +671,7 @@ void blipvert::RGB4_to_RGB32(Stage* in, Stage* out)
     int32_t height = in->height;
     int32_t in_stride = in->stride;
     int32_t out_stride = out->stride;
-    xRGBQUAD* in_palette = in->palette;
+    const PaletteTables& tables = GetPaletteTables(in, 4);
     bool has_odd = in->has_odd;
 
     do
@@ -678,16 +679,16 @@ void blipvert::RGB4_to_RGB32(Stage* in, Stage* out)
         uint8_t* psrc = in_buf;
         uint32_t* pdst = reinterpret_cast<uint32_t*>(out_buf);
         int32_t hcount = width / 2;
-        do
+        while (hcount--)
         {
-            *pdst++ = (*reinterpret_cast<uint32_t*>(&in_palette[*psrc & 0x0F]) | 0xFF000000);
-            *pdst++ = (*reinterpret_cast<uint32_t*>(&in_palette[(*psrc & 0xF0) >> 4]) | 0xFF000000);
-            psrc++;
-        } while (--hcount);
+            const uint32_t* pixels = tables.rgb32_byte[*psrc++].data();
+            *pdst++ = pixels[0];
+            *pdst++ = pixels[1];
+        }
 
         if (has_odd)
         {
-            *pdst = (*reinterpret_cast<uint32_t*>(&in_palette[*psrc & 0x0F]) | 0xFF000000);
+            *pdst = tables.rgb32[*psrc & 0x0F];
         }
 
         in_buf += in_stride;
@@ -747,7 +748,7 @@ void blipvert::RGB4_to_RGB565(Stage* in, Stage* out)
     int32_t height = in->height;
     int32_t in_stride = in->stride;
     int32_t out_stride = out->stride;
-    xRGBQUAD* in_palette = in->palette;
+    const PaletteTables& tables = GetPaletteTables(in, 4);
     bool has_odd = in->has_odd;
 
     do
@@ -755,19 +756,16 @@ void blipvert::RGB4_to_RGB565(Stage* in, Stage* out)
         uint8_t* psrc = in_buf;
         uint16_t* pdst = reinterpret_cast<uint16_t*>(out_buf);
         int32_t hcount = width / 2;
-        do
+        while (hcount--)
         {
-            xRGBQUAD color = in_palette[*psrc & 0x0F];
-            PackRGB565Word(*pdst++, color.rgbRed, color.rgbGreen, color.rgbBlue);
-            color = in_palette[(*psrc & 0xF0) >> 4];
-            PackRGB565Word(*pdst++, color.rgbRed, color.rgbGreen, color.rgbBlue);
-            psrc++;
-        } while (--hcount);
+            const uint16_t* pixels = tables.rgb565_byte[*psrc++].data();
+            *pdst++ = pixels[0];
+            *pdst++ = pixels[1];
+        }
 
         if (has_odd)
         {
-            xRGBQUAD color = in_palette[*psrc & 0x0F];
-            PackRGB565Word(*pdst++, color.rgbRed, color.rgbGreen, color.rgbBlue);
+            *pdst = tables.rgb565[*psrc & 0x0F];
         }
 
         in_buf += in_stride;
@@ -783,7 +781,7 @@ void blipvert::RGB4_to_RGB555(Stage* in, Stage* out)
     int32_t height = in->height;
     int32_t in_stride = in->stride;
     int32_t out_stride = out->stride;
-    xRGBQUAD* in_palette = in->palette;
+    const PaletteTables& tables = GetPaletteTables(in, 4);
     bool has_odd = in->has_odd;
 
     do
@@ -791,19 +789,16 @@ void blipvert::RGB4_to_RGB555(Stage* in, Stage* out)
         uint8_t* psrc = in_buf;
         uint16_t* pdst = reinterpret_cast<uint16_t*>(out_buf);
         int32_t hcount = width / 2;
-        do
+        while (hcount--)
         {
-            xRGBQUAD color = in_palette[*psrc & 0x0F];
-            PackRGB555Word(*pdst++, color.rgbRed, color.rgbGreen, color.rgbBlue);
-            color = in_palette[(*psrc & 0xF0) >> 4];
-            PackRGB555Word(*pdst++, color.rgbRed, color.rgbGreen, color.rgbBlue);
-            psrc++;
-        } while (--hcount);
+            const uint16_t* pixels = tables.rgb555_byte[*psrc++].data();
+            *pdst++ = pixels[0];
+            *pdst++ = pixels[1];
+        }
 
         if (has_odd)
         {
-            xRGBQUAD color = in_palette[*psrc & 0x0F];
-            PackRGB555Word(*pdst++, color.rgbRed, color.rgbGreen, color.rgbBlue);
+            *pdst = tables.rgb555[*psrc & 0x0F];
         }
 
         in_buf += in_stride;
@@ -823,7 +818,7 @@ void blipvert::RGB1_to_RGB32(Stage* in, Stage* out)
     int32_t height = in->height;
     int32_t in_stride = in->stride;
     int32_t out_stride = out->stride;
-    xRGBQUAD* in_palette = in->palette;
+    const PaletteTables& tables = GetPaletteTables(in, 1);
     uint16_t remainder = in->remainder;
 
     do
@@ -831,25 +826,15 @@ void blipvert::RGB1_to_RGB32(Stage* in, Stage* out)
         uint8_t* psrc = in_buf;
         uint32_t* pdst = reinterpret_cast<uint32_t*>(out_buf);
         int32_t hcount = width / 8;
-        do
+        while (hcount--)
         {
-            uint8_t mask = 1;
-            do
-            {
-                *pdst++ = (*reinterpret_cast<uint32_t*>(&in_palette[*psrc & mask ? 1 : 0]) | 0xFF000000);
-            } while (mask <<= 1);
-            psrc++;
-        } while (--hcount);
+            memcpy(pdst, tables.rgb32_byte[*psrc++].data(), 8 * sizeof(uint32_t));
+            pdst += 8;
+        }
 
         if (remainder)
         {
-            uint16_t bcount = remainder;
-            uint8_t mask = 1;
-            do
-            {
-                *pdst = (*reinterpret_cast<uint32_t*>(&in_palette[*psrc & mask ? 1 : 0]) | 0xFF000000);
-                mask <<= 1;
-            } while (--bcount);
+            memcpy(pdst, tables.rgb32_byte[*psrc].data(), remainder * sizeof(uint32_t));
         }
 
         in_buf += in_stride;
@@ -913,7 +898,7 @@ void blipvert::RGB1_to_RGB565(Stage* in, Stage* out)
     int32_t height = in->height;
     int32_t in_stride = in->stride;
     int32_t out_stride = out->stride;
-    xRGBQUAD* in_palette = in->palette;
+    const PaletteTables& tables = GetPaletteTables(in, 1);
     uint16_t remainder = in->remainder;
 
     do
@@ -921,27 +906,15 @@ void blipvert::RGB1_to_RGB565(Stage* in, Stage* out)
         uint8_t* psrc = in_buf;
         uint16_t* pdst = reinterpret_cast<uint16_t*>(out_buf);
         int32_t hcount = width / 8;
-        do
+        while (hcount--)
         {
-            uint8_t mask = 1;
-            do
-            {
-                xRGBQUAD color = in_palette[*psrc & mask ? 1 : 0];
-                PackRGB565Word(*pdst++, color.rgbRed, color.rgbGreen, color.rgbBlue);
-            } while (mask <<= 1);
-            psrc++;
-        } while (--hcount);
+            memcpy(pdst, tables.rgb565_byte[*psrc++].data(), 8 * sizeof(uint16_t));
+            pdst += 8;
+        }
 
         if (remainder)
         {
-            uint16_t bcount = remainder;
-            uint8_t mask = 1;
-            do
-            {
-                xRGBQUAD color = in_palette[*psrc & mask ? 1 : 0];
-                PackRGB565Word(*pdst++, color.rgbRed, color.rgbGreen, color.rgbBlue);
-                mask <<= 1;
-            } while (--bcount);
+            memcpy(pdst, tables.rgb565_byte[*psrc].data(), remainder * sizeof(uint16_t));
         }
 
         in_buf += in_stride;
@@ -957,7 +930,7 @@ void blipvert::RGB1_to_RGB555(Stage* in, Stage* out)
     int32_t height = in->height;
     int32_t in_stride = in->stride;
     int32_t out_stride = out->stride;
-    xRGBQUAD* in_palette = in->palette;
+    const PaletteTables& tables = GetPaletteTables(in, 1);
     uint16_t remainder = in->remainder;
 
     do
@@ -965,30 +938,661 @@ void blipvert::RGB1_to_RGB555(Stage* in, Stage* out)
         uint8_t* psrc = in_buf;
         uint16_t* pdst = reinterpret_cast<uint16_t*>(out_buf);
         int32_t hcount = width / 8;
+        while (hcount--)
+        {
+            memcpy(pdst, tables.rgb555_byte[*psrc++].data(), 8 * sizeof(uint16_t));
+            pdst += 8;
+        }
+
+        if (remainder)
+        {
+            memcpy(pdst, tables.rgb555_byte[*psrc].data(), remainder * sizeof(uint16_t));
+        }
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+    } while (--height);
+}
+
+//
+// In-place RGB to RGB transforms
+//
+// These convert a frame in its own buffer. The input and output stages point to the same memory and
+// are flipped the same way. Every pixel is read before the output that replaces it is written and the
+// rows are walked up from the lowest address, so the output can be packed tighter than the input.
+//
+
+void blipvert::RGBA_to_RGB32_InPlace(Stage* in, Stage* out)
+{
+    uint8_t* in_buf;
+    uint8_t* out_buf;
+    int32_t in_stride;
+    int32_t out_stride;
+    GetInPlaceRows(in, out, in_buf, out_buf, in_stride, out_stride);
+    int32_t width = in->width;
+    int32_t height = in->height;
+
+    do
+    {
+        uint32_t* psrc = reinterpret_cast<uint32_t*>(in_buf);
+        uint32_t* pdst = reinterpret_cast<uint32_t*>(out_buf);
+        int32_t hcount = width;
         do
         {
-            uint8_t mask = 1;
-            do
-            {
-                xRGBQUAD color = in_palette[*psrc & mask ? 1 : 0];
-                PackRGB555Word(*pdst++, color.rgbRed, color.rgbGreen, color.rgbBlue);
-            } while (mask <<= 1);
-            psrc++;
+            *pdst++ = *psrc++ | 0xFF000000;
         } while (--hcount);
 
-        if (remainder)
+        in_buf += in_stride;
+        out_buf += out_stride;
+    } while (--height);
+}
+
+void blipvert::RGB32_to_RGBA_InPlace(Stage* in, Stage* out)
+{
+    uint8_t* in_buf;
+    uint8_t* out_buf;
+    int32_t in_stride;
+    int32_t out_stride;
+    GetInPlaceRows(in, out, in_buf, out_buf, in_stride, out_stride);
+    int32_t width = in->width;
+    int32_t height = in->height;
+
+    // The pixels are the same, so only rows that move need to be touched.
+    if (in_buf == out_buf && in_stride == out_stride)
+        return;
+
+    do
+    {
+        memmove(out_buf, in_buf, width * 4);
+        in_buf += in_stride;
+        out_buf += out_stride;
+    } while (--height);
+}
+
+void blipvert::RGB32_to_RGB24_InPlace(Stage* in, Stage* out)
+{
+    uint8_t* in_buf;
+    uint8_t* out_buf;
+    int32_t in_stride;
+    int32_t out_stride;
+    GetInPlaceRows(in, out, in_buf, out_buf, in_stride, out_stride);
+    int32_t width = in->width;
+    int32_t height = in->height;
+
+    do
+    {
+        uint8_t* psrc = in_buf;
+        uint8_t* pdst = out_buf;
+        int32_t hcount = width;
+        do
         {
-            uint16_t bcount = remainder;
-            uint8_t mask = 1;
-            do
-            {
-                xRGBQUAD color = in_palette[*psrc & mask ? 1 : 0];
-                PackRGB555Word(*pdst++, color.rgbRed, color.rgbGreen, color.rgbBlue);
-                mask <<= 1;
-            } while (--bcount);
+            uint8_t blue = psrc[0];
+            uint8_t green = psrc[1];
+            uint8_t red = psrc[2];
+            *pdst++ = blue;
+            *pdst++ = green;
+            *pdst++ = red;
+            psrc += 4;
+        } while (--hcount);
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+    } while (--height);
+}
+
+void blipvert::RGB555_to_RGB565_InPlace(Stage* in, Stage* out)
+{
+    uint8_t* in_buf;
+    uint8_t* out_buf;
+    int32_t in_stride;
+    int32_t out_stride;
+    GetInPlaceRows(in, out, in_buf, out_buf, in_stride, out_stride);
+    int32_t width = in->width;
+    int32_t height = in->height;
+
+    do
+    {
+        uint16_t* psrc = reinterpret_cast<uint16_t*>(in_buf);
+        uint16_t* pdst = reinterpret_cast<uint16_t*>(out_buf);
+        int32_t hcount = width;
+        do
+        {
+            uint16_t pixel = *psrc++;
+            *pdst++ = ((pixel & (RGB555_RED_MASK | RGB555_GREEN_MASK)) << 1) | (pixel & RGB565_BLUE_MASK);
+        } while (--hcount);
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+    } while (--height);
+}
+
+void blipvert::RGB565_to_RGB555_InPlace(Stage* in, Stage* out)
+{
+    uint8_t* in_buf;
+    uint8_t* out_buf;
+    int32_t in_stride;
+    int32_t out_stride;
+    GetInPlaceRows(in, out, in_buf, out_buf, in_stride, out_stride);
+    int32_t width = in->width;
+    int32_t height = in->height;
+
+    do
+    {
+        uint16_t* psrc = reinterpret_cast<uint16_t*>(in_buf);
+        uint16_t* pdst = reinterpret_cast<uint16_t*>(out_buf);
+        int32_t hcount = width;
+        do
+        {
+            uint16_t pixel = *psrc++;
+            *pdst++ = RGB555_ALPHA_MASK | (((pixel & (RGB565_RED_MASK | RGB565_GREEN_MASK)) >> 1) & (RGB555_RED_MASK | RGB555_GREEN_MASK)) | (pixel & RGB555_BLUE_MASK);
+        } while (--hcount);
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+    } while (--height);
+}
+
+#if defined(BLIPVERT_X86_SIMD)
+
+//
+// SSE4.1 in-place RGB to RGB
+//
+// Each block of pixels is loaded before its output is stored, and the output of a block never reaches
+// past the end of the input block it came from. The columns left over at the end of a row are done
+// right away, before the next row's output can land on them.
+//
+
+BLIPVERT_TARGET_SSE41 void blipvert::RGBA_to_RGB32_InPlace_SSE41(Stage* in, Stage* out)
+{
+    uint8_t* in_buf;
+    uint8_t* out_buf;
+    int32_t in_stride;
+    int32_t out_stride;
+    GetInPlaceRows(in, out, in_buf, out_buf, in_stride, out_stride);
+    int32_t width = in->width;
+    int32_t height = in->height;
+    int32_t simd_width = width & ~3;
+
+    const __m128i alpha = _mm_set1_epi32(static_cast<int32_t>(0xFF000000));
+
+    do
+    {
+        uint32_t* psrc = reinterpret_cast<uint32_t*>(in_buf);
+        uint32_t* pdst = reinterpret_cast<uint32_t*>(out_buf);
+        int32_t x = 0;
+        for (; x < simd_width; x += 4)
+        {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc + x));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pdst + x), _mm_or_si128(pixels, alpha));
+        }
+
+        for (; x < width; x++)
+        {
+            pdst[x] = psrc[x] | 0xFF000000;
+        }
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+    } while (--height);
+}
+
+// Packs 16 RGB32 pixels (64 bytes) into 48 bytes of RGB24. All of the input is loaded before the output is stored.
+BLIPVERT_TARGET_SSE41 static inline void PackRGB32x16toRGB24_SSE41(const uint8_t* psrc, uint8_t* pdst)
+{
+    // Packs the blue, green and red bytes of 4 pixels into the low 12 bytes.
+    const __m128i pack = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+    __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc)), pack);
+    __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc + 16)), pack);
+    __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc + 32)), pack);
+    __m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc + 48)), pack);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pdst), _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pdst + 16), _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pdst + 32), _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+}
+
+BLIPVERT_TARGET_SSE41 void blipvert::RGB32_to_RGB24_InPlace_SSE41(Stage* in, Stage* out)
+{
+    uint8_t* in_buf;
+    uint8_t* out_buf;
+    int32_t in_stride;
+    int32_t out_stride;
+    GetInPlaceRows(in, out, in_buf, out_buf, in_stride, out_stride);
+    int32_t width = in->width;
+    int32_t height = in->height;
+    int32_t simd_width = width & ~15;
+
+    do
+    {
+        uint8_t* psrc = in_buf;
+        uint8_t* pdst = out_buf;
+        int32_t x = 0;
+        for (; x < simd_width; x += 16)
+        {
+            PackRGB32x16toRGB24_SSE41(psrc, pdst);
+            psrc += 64;
+            pdst += 48;
+        }
+
+        for (; x < width; x++)
+        {
+            uint8_t blue = psrc[0];
+            uint8_t green = psrc[1];
+            uint8_t red = psrc[2];
+            *pdst++ = blue;
+            *pdst++ = green;
+            *pdst++ = red;
+            psrc += 4;
+        }
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+    } while (--height);
+}
+
+BLIPVERT_TARGET_SSE41 void blipvert::RGB555_to_RGB565_InPlace_SSE41(Stage* in, Stage* out)
+{
+    uint8_t* in_buf;
+    uint8_t* out_buf;
+    int32_t in_stride;
+    int32_t out_stride;
+    GetInPlaceRows(in, out, in_buf, out_buf, in_stride, out_stride);
+    int32_t width = in->width;
+    int32_t height = in->height;
+    int32_t simd_width = width & ~7;
+
+    const __m128i red_green = _mm_set1_epi16(static_cast<int16_t>(RGB555_RED_MASK | RGB555_GREEN_MASK));
+    const __m128i blue = _mm_set1_epi16(static_cast<int16_t>(RGB565_BLUE_MASK));
+
+    do
+    {
+        uint16_t* psrc = reinterpret_cast<uint16_t*>(in_buf);
+        uint16_t* pdst = reinterpret_cast<uint16_t*>(out_buf);
+        int32_t x = 0;
+        for (; x < simd_width; x += 8)
+        {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc + x));
+            __m128i result = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(pixels, red_green), 1), _mm_and_si128(pixels, blue));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pdst + x), result);
+        }
+
+        for (; x < width; x++)
+        {
+            uint16_t pixel = psrc[x];
+            pdst[x] = ((pixel & (RGB555_RED_MASK | RGB555_GREEN_MASK)) << 1) | (pixel & RGB565_BLUE_MASK);
         }
 
         in_buf += in_stride;
         out_buf += out_stride;
     } while (--height);
 }
+
+BLIPVERT_TARGET_SSE41 void blipvert::RGB565_to_RGB555_InPlace_SSE41(Stage* in, Stage* out)
+{
+    uint8_t* in_buf;
+    uint8_t* out_buf;
+    int32_t in_stride;
+    int32_t out_stride;
+    GetInPlaceRows(in, out, in_buf, out_buf, in_stride, out_stride);
+    int32_t width = in->width;
+    int32_t height = in->height;
+    int32_t simd_width = width & ~7;
+
+    const __m128i red_green = _mm_set1_epi16(static_cast<int16_t>(RGB555_RED_MASK | RGB555_GREEN_MASK));
+    const __m128i blue = _mm_set1_epi16(static_cast<int16_t>(RGB555_BLUE_MASK));
+    const __m128i alpha = _mm_set1_epi16(static_cast<int16_t>(RGB555_ALPHA_MASK));
+
+    do
+    {
+        uint16_t* psrc = reinterpret_cast<uint16_t*>(in_buf);
+        uint16_t* pdst = reinterpret_cast<uint16_t*>(out_buf);
+        int32_t x = 0;
+        for (; x < simd_width; x += 8)
+        {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc + x));
+            __m128i result = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(pixels, 1), red_green), _mm_and_si128(pixels, blue));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pdst + x), _mm_or_si128(result, alpha));
+        }
+
+        for (; x < width; x++)
+        {
+            uint16_t pixel = psrc[x];
+            pdst[x] = RGB555_ALPHA_MASK | (((pixel & (RGB565_RED_MASK | RGB565_GREEN_MASK)) >> 1) & (RGB555_RED_MASK | RGB555_GREEN_MASK)) | (pixel & RGB555_BLUE_MASK);
+        }
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+    } while (--height);
+}
+
+//
+// SSE4.1 RGB to RGB
+//
+// RGB24 and RGB32 are converted with pshufb. The 16-bit formats are packed and unpacked with the same
+// shifts and masks as the PackRGB565Word, PackRGB555Word, UnpackRGB565Word and UnpackRGB555Word macros,
+// done on 4 or 8 pixels at once, so the output is identical to the generic transforms.
+//
+
+BLIPVERT_TARGET_SSE41 void blipvert::RGB24_to_RGB32_SSE41(Stage* in, Stage* out)
+{
+    uint8_t* in_buf = in->buf;
+    uint8_t* out_buf = out->buf;
+    int32_t width = in->width;
+    int32_t height = in->height;
+    int32_t in_stride = in->stride;
+    int32_t out_stride = out->stride;
+    int32_t simd_width = width & ~15;
+
+    // Spreads 4 RGB24 pixels from the low 12 bytes out to 4 bytes each.
+    const __m128i expand = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int32_t>(0xFF000000));
+
+    do
+    {
+        uint8_t* psrc = in_buf;
+        uint8_t* pdst = out_buf;
+        bool stream = StreamRow(out, pdst, 16);
+        int32_t x = 0;
+        for (; x < simd_width; x += 16)
+        {
+            __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc));
+            __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc + 16));
+            __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc + 32));
+            StoreSI128(pdst, _mm_or_si128(_mm_shuffle_epi8(v0, expand), alpha), stream);
+            StoreSI128(pdst + 16, _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(v1, v0, 12), expand), alpha), stream);
+            StoreSI128(pdst + 32, _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(v2, v1, 8), expand), alpha), stream);
+            StoreSI128(pdst + 48, _mm_or_si128(_mm_shuffle_epi8(_mm_srli_si128(v2, 4), expand), alpha), stream);
+            psrc += 48;
+            pdst += 64;
+        }
+
+        for (; x < width; x++)
+        {
+            *pdst++ = *psrc++;
+            *pdst++ = *psrc++;
+            *pdst++ = *psrc++;
+            *pdst++ = 0xFF;
+        }
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+    } while (--height);
+
+    EndStreaming(out);
+}
+
+BLIPVERT_TARGET_SSE41 void blipvert::RGB32_to_RGB24_SSE41(Stage* in, Stage* out)
+{
+    uint8_t* in_buf = in->buf;
+    uint8_t* out_buf = out->buf;
+    int32_t width = in->width;
+    int32_t height = in->height;
+    int32_t in_stride = in->stride;
+    int32_t out_stride = out->stride;
+    int32_t simd_width = width & ~15;
+
+    do
+    {
+        uint8_t* psrc = in_buf;
+        uint8_t* pdst = out_buf;
+        int32_t x = 0;
+        for (; x < simd_width; x += 16)
+        {
+            PackRGB32x16toRGB24_SSE41(psrc, pdst);
+            psrc += 64;
+            pdst += 48;
+        }
+
+        for (; x < width; x++)
+        {
+            *pdst++ = *psrc++;
+            *pdst++ = *psrc++;
+            *pdst++ = *psrc++;
+            psrc++;
+        }
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+    } while (--height);
+}
+
+// Packs 8 RGB32 pixels into 8 RGB565 words.
+BLIPVERT_TARGET_SSE41 static inline __m128i PackRGB32x8toRGB565_SSE41(__m128i p0, __m128i p1)
+{
+    const __m128i blue = _mm_set1_epi32(0x001F);
+    const __m128i green = _mm_set1_epi32(0x07E0);
+    const __m128i red = _mm_set1_epi32(0xF800);
+
+    __m128i w0 = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p0, 3), blue), _mm_and_si128(_mm_srli_epi32(p0, 5), green)),
+        _mm_and_si128(_mm_srli_epi32(p0, 8), red));
+    __m128i w1 = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p1, 3), blue), _mm_and_si128(_mm_srli_epi32(p1, 5), green)),
+        _mm_and_si128(_mm_srli_epi32(p1, 8), red));
+    return _mm_packus_epi32(w0, w1);
+}
+
+// Packs 8 RGB32 pixels into 8 RGB555 words with the alpha bit set.
+BLIPVERT_TARGET_SSE41 static inline __m128i PackRGB32x8toRGB555_SSE41(__m128i p0, __m128i p1)
+{
+    const __m128i blue = _mm_set1_epi32(0x001F);
+    const __m128i green = _mm_set1_epi32(0x03E0);
+    const __m128i red = _mm_set1_epi32(0x7C00);
+    const __m128i alpha = _mm_set1_epi16(static_cast<int16_t>(RGB555_ALPHA_MASK));
+
+    __m128i w0 = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p0, 3), blue), _mm_and_si128(_mm_srli_epi32(p0, 6), green)),
+        _mm_and_si128(_mm_srli_epi32(p0, 9), red));
+    __m128i w1 = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p1, 3), blue), _mm_and_si128(_mm_srli_epi32(p1, 6), green)),
+        _mm_and_si128(_mm_srli_epi32(p1, 9), red));
+    return _mm_or_si128(_mm_packus_epi32(w0, w1), alpha);
+}
+
+BLIPVERT_TARGET_SSE41 void blipvert::RGB32_to_RGB565_SSE41(Stage* in, Stage* out)
+{
+    uint8_t* in_buf = in->buf;
+    uint8_t* out_buf = out->buf;
+    int32_t width = in->width;
+    int32_t height = in->height;
+    int32_t in_stride = in->stride;
+    int32_t out_stride = out->stride;
+    int32_t simd_width = width & ~7;
+
+    do
+    {
+        uint8_t* psrc = in_buf;
+        uint16_t* pdst = reinterpret_cast<uint16_t*>(out_buf);
+        int32_t x = 0;
+        for (; x < simd_width; x += 8)
+        {
+            __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc));
+            __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc + 16));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pdst), PackRGB32x8toRGB565_SSE41(p0, p1));
+            psrc += 32;
+            pdst += 8;
+        }
+
+        for (; x < width; x++)
+        {
+            PackRGB565Word(*pdst++, psrc[2], psrc[1], psrc[0]);
+            psrc += 4;
+        }
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+    } while (--height);
+}
+
+BLIPVERT_TARGET_SSE41 void blipvert::RGB32_to_RGB555_SSE41(Stage* in, Stage* out)
+{
+    uint8_t* in_buf = in->buf;
+    uint8_t* out_buf = out->buf;
+    int32_t width = in->width;
+    int32_t height = in->height;
+    int32_t in_stride = in->stride;
+    int32_t out_stride = out->stride;
+    int32_t simd_width = width & ~7;
+
+    do
+    {
+        uint8_t* psrc = in_buf;
+        uint16_t* pdst = reinterpret_cast<uint16_t*>(out_buf);
+        int32_t x = 0;
+        for (; x < simd_width; x += 8)
+        {
+            __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc));
+            __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc + 16));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pdst), PackRGB32x8toRGB555_SSE41(p0, p1));
+            psrc += 32;
+            pdst += 8;
+        }
+
+        for (; x < width; x++)
+        {
+            PackRGB555Word(*pdst++, psrc[2], psrc[1], psrc[0]);
+            psrc += 4;
+        }
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+    } while (--height);
+}
+
+// Unpacks 8 16-bit pixels into 8 RGB32 pixels with an opaque alpha. bg holds the blue and green bytes
+// of each pixel and r its red byte.
+BLIPVERT_TARGET_SSE41 static inline void StoreBGRx8asRGB32_SSE41(uint8_t* pdst, __m128i bg, __m128i r, bool stream)
+{
+    __m128i ra = _mm_or_si128(r, _mm_set1_epi16(static_cast<int16_t>(0xFF00)));
+    StoreSI128(pdst, _mm_unpacklo_epi16(bg, ra), stream);
+    StoreSI128(pdst + 16, _mm_unpackhi_epi16(bg, ra), stream);
+}
+
+BLIPVERT_TARGET_SSE41 void blipvert::RGB565_to_RGB32_SSE41(Stage* in, Stage* out)
+{
+    uint8_t* in_buf = in->buf;
+    uint8_t* out_buf = out->buf;
+    int32_t width = in->width;
+    int32_t height = in->height;
+    int32_t in_stride = in->stride;
+    int32_t out_stride = out->stride;
+    int32_t simd_width = width & ~7;
+
+    const __m128i blue = _mm_set1_epi16(static_cast<int16_t>(RGB565_BLUE_MASK));
+    const __m128i green = _mm_set1_epi16(static_cast<int16_t>(RGB565_GREEN_MASK));
+
+    do
+    {
+        uint16_t* psrc = reinterpret_cast<uint16_t*>(in_buf);
+        uint8_t* pdst = out_buf;
+        bool stream = StreamRow(out, pdst, 16);
+        int32_t x = 0;
+        for (; x < simd_width; x += 8)
+        {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc));
+            __m128i bg = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(pixels, blue), 3), _mm_slli_epi16(_mm_and_si128(pixels, green), 5));
+            __m128i r = _mm_slli_epi16(_mm_srli_epi16(pixels, 11), 3);
+            StoreBGRx8asRGB32_SSE41(pdst, bg, r, stream);
+            psrc += 8;
+            pdst += 32;
+        }
+
+        for (; x < width; x++)
+        {
+            uint16_t source = *psrc;
+            UnpackRGB565Word(source, pdst[2], pdst[1], pdst[0])
+            pdst[3] = 0xFF;
+            psrc++;
+            pdst += 4;
+        }
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+    } while (--height);
+
+    EndStreaming(out);
+}
+
+BLIPVERT_TARGET_SSE41 void blipvert::RGB555_to_RGB32_SSE41(Stage* in, Stage* out)
+{
+    uint8_t* in_buf = in->buf;
+    uint8_t* out_buf = out->buf;
+    int32_t width = in->width;
+    int32_t height = in->height;
+    int32_t in_stride = in->stride;
+    int32_t out_stride = out->stride;
+    int32_t simd_width = width & ~7;
+
+    const __m128i blue = _mm_set1_epi16(static_cast<int16_t>(RGB555_BLUE_MASK));
+    const __m128i green = _mm_set1_epi16(static_cast<int16_t>(RGB555_GREEN_MASK));
+    const __m128i red = _mm_set1_epi16(static_cast<int16_t>(RGB555_RED_MASK));
+
+    do
+    {
+        uint16_t* psrc = reinterpret_cast<uint16_t*>(in_buf);
+        uint8_t* pdst = out_buf;
+        bool stream = StreamRow(out, pdst, 16);
+        int32_t x = 0;
+        for (; x < simd_width; x += 8)
+        {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc));
+            __m128i bg = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(pixels, blue), 3), _mm_slli_epi16(_mm_and_si128(pixels, green), 6));
+            __m128i r = _mm_srli_epi16(_mm_and_si128(pixels, red), 7);
+            StoreBGRx8asRGB32_SSE41(pdst, bg, r, stream);
+            psrc += 8;
+            pdst += 32;
+        }
+
+        for (; x < width; x++)
+        {
+            uint16_t source = *psrc;
+            UnpackRGB555Word(source, pdst[2], pdst[1], pdst[0])
+            pdst[3] = 0xFF;
+            psrc++;
+            pdst += 4;
+        }
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+    } while (--height);
+
+    EndStreaming(out);
+}
+
+BLIPVERT_TARGET_AVX2 void blipvert::RGB8_to_RGB32_AVX2(Stage* in, Stage* out)
+{
+    uint8_t* in_buf = in->buf;
+    uint8_t* out_buf = out->buf;
+    int32_t width = in->width;
+    int32_t height = in->height;
+    int32_t in_stride = in->stride;
+    int32_t out_stride = out->stride;
+    const uint32_t* rgb32 = GetPaletteTables(in, 8).rgb32.data();
+    const int* table = reinterpret_cast<const int*>(rgb32);
+    int32_t simd_width = width & ~7;
+
+    do
+    {
+        uint8_t* psrc = in_buf;
+        uint32_t* pdst = reinterpret_cast<uint32_t*>(out_buf);
+        bool stream = StreamRow(out, out_buf, 32);
+        int32_t x = 0;
+        for (; x < simd_width; x += 8)
+        {
+            // Eight indexes widened to dwords, then one gather from the expanded palette.
+            __m256i indexes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(psrc)));
+            StoreSI256(reinterpret_cast<uint8_t*>(pdst), _mm256_i32gather_epi32(table, indexes, 4), stream);
+            psrc += 8;
+            pdst += 8;
+        }
+
+        for (; x < width; x++)
+        {
+            *pdst++ = rgb32[*psrc++];
+        }
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+    } while (--height);
+
+    EndStreaming(out);
+}
+
+#endif
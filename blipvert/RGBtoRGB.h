@@ -29,6 +29,7 @@
 
 #include "blipverttypes.h"
 #include "Staging.h"
+#include "CpuFeatures.h"
 
 namespace blipvert
 {
@@ -72,5 +73,32 @@ namespace blipvert
     void RGB1_to_RGB24(Stage* in, Stage* out);
     void RGB1_to_RGB565(Stage* in, Stage* out);
     void RGB1_to_RGB555(Stage* in, Stage* out);
+
+    // In-place RGB to RGB transforms. The input and output stages share one buffer, see FindInPlaceTransform().
+    void RGBA_to_RGB32_InPlace(Stage* in, Stage* out);
+    void RGB32_to_RGBA_InPlace(Stage* in, Stage* out);
+    void RGB32_to_RGB24_InPlace(Stage* in, Stage* out);
+    void RGB555_to_RGB565_InPlace(Stage* in, Stage* out);
+    void RGB565_to_RGB555_InPlace(Stage* in, Stage* out);
+
+#if defined(BLIPVERT_X86_SIMD)
+    // SSE4.1 versions of the in-place transforms. Their output is identical to the generic versions.
+    void RGBA_to_RGB32_InPlace_SSE41(Stage* in, Stage* out);
+    void RGB32_to_RGB24_InPlace_SSE41(Stage* in, Stage* out);
+    void RGB555_to_RGB565_InPlace_SSE41(Stage* in, Stage* out);
+    void RGB565_to_RGB555_InPlace_SSE41(Stage* in, Stage* out);
+
+    // SSE4.1 versions of the RGB24, RGB32 and 16-bit RGB transforms. Their output is identical to the
+    // generic versions. InitializeLibrary() selects them when the processor supports them.
+    void RGB24_to_RGB32_SSE41(Stage* in, Stage* out);
+    void RGB32_to_RGB24_SSE41(Stage* in, Stage* out);
+    void RGB32_to_RGB565_SSE41(Stage* in, Stage* out);
+    void RGB32_to_RGB555_SSE41(Stage* in, Stage* out);
+    void RGB565_to_RGB32_SSE41(Stage* in, Stage* out);
+    void RGB555_to_RGB32_SSE41(Stage* in, Stage* out);
+
+    // AVX2 version of RGB8_to_RGB32. It gathers eight pixels at a time from the palette's RGB32 table, see PaletteTables.h.
+    void RGB8_to_RGB32_AVX2(Stage* in, Stage* out);
+#endif
 }
 
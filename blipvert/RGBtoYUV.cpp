@@ -29,6 +29,11 @@
 #include "CommonMacros.h"
 #include "LookupTables.h"
 #include "blipvert.h"
+#include "CpuFeatures.h"
+
+#if defined(BLIPVERT_X86_SIMD)
+#include <immintrin.h>
+#endif
 
 using namespace blipvert;
 
@@ -1015,8 +1020,8 @@ void blipvert::RGB32_to_IMCx(Stage* in, Stage* out)
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
 
-        uplane += out_stride;
-        vplane += out_stride;
+        uplane += uv_stride;
+        vplane += uv_stride;
     }
 }
 
@@ -1078,8 +1083,8 @@ void blipvert::RGB24_to_IMCx(Stage* in, Stage* out)
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
 
-        uplane += out_stride;
-        vplane += out_stride;
+        uplane += uv_stride;
+        vplane += uv_stride;
     }
 }
 
@@ -1149,8 +1154,8 @@ void blipvert::RGB565_to_IMCx(Stage* in, Stage* out)
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
 
-        uplane += out_stride;
-        vplane += out_stride;
+        uplane += uv_stride;
+        vplane += uv_stride;
     }
 }
 
@@ -1220,8 +1225,8 @@ void blipvert::RGB555_to_IMCx(Stage* in, Stage* out)
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
 
-        uplane += out_stride;
-        vplane += out_stride;
+        uplane += uv_stride;
+        vplane += uv_stride;
     }
 }
 
@@ -1296,8 +1301,8 @@ void blipvert::RGB8_to_IMCx(Stage* in, Stage* out)
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
 
-        uplane += out_stride;
-        vplane += out_stride;
+        uplane += uv_stride;
+        vplane += uv_stride;
     }
 }
 
@@ -1794,6 +1799,7 @@ void blipvert::RGB32_to_NVx(Stage* in, Stage* out)
     int32_t in_stride = in->stride;
 
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     uint8_t* out_uvplane = out->uvplane;
     uint16_t out_u = out->u_index;
     uint16_t out_v = out->v_index;
@@ -1847,7 +1853,7 @@ void blipvert::RGB32_to_NVx(Stage* in, Stage* out)
 
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
-        out_uvplane += out_stride;
+        out_uvplane += out_uv_stride;
     }
 }
 
@@ -2347,6 +2353,7 @@ void blipvert::RGB24_to_NVx(Stage* in, Stage* out)
     int32_t in_stride = in->stride;
 
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     uint8_t* out_uvplane = out->uvplane;
     uint16_t out_u = out->u_index;
     uint16_t out_v = out->v_index;
@@ -2400,7 +2407,7 @@ void blipvert::RGB24_to_NVx(Stage* in, Stage* out)
 
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
-        out_uvplane += out_stride;
+        out_uvplane += out_uv_stride;
     }
 }
 
@@ -2932,6 +2939,7 @@ void blipvert::RGB565_to_NVx(Stage* in, Stage* out)
     int32_t height = in->height;
     int32_t in_stride = in->stride;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     uint8_t* out_uvplane = out->uvplane;
     uint16_t out_u = out->u_index;
     uint16_t out_v = out->v_index;
@@ -2993,7 +3001,7 @@ void blipvert::RGB565_to_NVx(Stage* in, Stage* out)
 
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
-        out_uvplane += out_stride;
+        out_uvplane += out_uv_stride;
     }
 }
 
@@ -3731,6 +3739,7 @@ void blipvert::RGB555_to_NVx(Stage* in, Stage* out)
     int32_t height = in->height;
     int32_t in_stride = in->stride;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     uint8_t* out_uvplane = out->uvplane;
     uint16_t out_u = out->u_index;
     uint16_t out_v = out->v_index;
@@ -3793,7 +3802,7 @@ void blipvert::RGB555_to_NVx(Stage* in, Stage* out)
 
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
-        out_uvplane += out_stride;
+        out_uvplane += out_uv_stride;
     }
 }
 
@@ -4353,6 +4362,7 @@ void blipvert::RGB8_to_NVx(Stage* in, Stage* out)
     int32_t height = in->height;
     int32_t in_stride = in->stride;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     uint8_t* out_uvplane = out->uvplane;
     uint16_t out_u = out->u_index;
     uint16_t out_v = out->v_index;
@@ -4419,7 +4429,7 @@ void blipvert::RGB8_to_NVx(Stage* in, Stage* out)
 
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
-        out_uvplane += out_stride;
+        out_uvplane += out_uv_stride;
     }
 }
 
@@ -4609,3 +4619,387 @@ void blipvert::RGB8_to_YV16(Stage* in, Stage* out)
         vplane += uv_stride;
     }
 }
+
+#if defined(BLIPVERT_X86_SIMD)
+
+//
+// SSE4.1 and AVX2 RGBx to PlanarYUV
+//
+// Each pixel is widened to 16-bit B, G, R, 1 and multiplied with pmaddwd against the RGB to YUV
+// coefficients in CommonMacros.h. The 2x2 chroma average is done on the widened pixels before the
+// U and V dot products, just like the table-driven version.
+// Only the 2x2 decimation (I420, YV12) is vectorized. 4x4 decimation goes to the generic version.
+//
+
+// Converts the columns a SIMD kernel left over, and any decimation it doesn't handle, with the generic transform.
+static void PlanarYUVRemainingColumns(t_transformfunc transform, Stage* in, Stage* out, int32_t done, int32_t in_bytes_per_pixel)
+{
+    if (done >= in->width)
+        return;
+
+    Stage in_strip = *in;
+    Stage out_strip = *out;
+    in_strip.buf += done * in_bytes_per_pixel;
+    in_strip.width -= done;
+    out_strip.buf += done;
+    out_strip.uplane += done / out->decimation;
+    out_strip.vplane += done / out->decimation;
+    out_strip.width -= done;
+    transform(&in_strip, &out_strip);
+}
+
+// Computes Y for the 4 BGR1 pixels in px. The results are 32-bit.
+BLIPVERT_TARGET_SSE41 static inline __m128i BGR1toY_SSE41(__m128i px, __m128i coeff)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(px, zero), coeff);
+    __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(px, zero), coeff);
+    return _mm_srai_epi32(_mm_hadd_epi32(lo, hi), 15);
+}
+
+// Averages the 2x2 blocks of the 4 BGR1 pixels in top and bottom into 2 16-bit BGR1 pixels.
+BLIPVERT_TARGET_SSE41 static inline __m128i AverageBGR1_SSE41(__m128i top, __m128i bottom)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+    __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+    return _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi)), 2);
+}
+
+// Computes U or V for 4 averaged pixels.
+BLIPVERT_TARGET_SSE41 static inline __m128i AveragedBGR1toUV_SSE41(__m128i c0, __m128i c1, __m128i coeff)
+{
+    return _mm_srai_epi32(_mm_hadd_epi32(_mm_madd_epi16(c0, coeff), _mm_madd_epi16(c1, coeff)), 15);
+}
+
+// Writes 16 Y samples for each of the two rows and 8 U and V samples from 16 BGR1 pixels per row.
+BLIPVERT_TARGET_SSE41 static inline void BGR1toPlanarYUV_SSE41(const __m128i* top, const __m128i* bottom,
+    uint8_t* ytop, uint8_t* ybottom, uint8_t* up, uint8_t* vp)
+{
+    const __m128i ycoeff = _mm_setr_epi16(YUV_COEFF_YB, YUV_COEFF_YG, YUV_COEFF_YR, YUV_BIAS_Y, YUV_COEFF_YB, YUV_COEFF_YG, YUV_COEFF_YR, YUV_BIAS_Y);
+    const __m128i ucoeff = _mm_setr_epi16(YUV_COEFF_UB, YUV_COEFF_UG, YUV_COEFF_UR, YUV_BIAS_U, YUV_COEFF_UB, YUV_COEFF_UG, YUV_COEFF_UR, YUV_BIAS_U);
+    const __m128i vcoeff = _mm_setr_epi16(YUV_COEFF_VB, YUV_COEFF_VG, YUV_COEFF_VR, YUV_BIAS_V, YUV_COEFF_VB, YUV_COEFF_VG, YUV_COEFF_VR, YUV_BIAS_V);
+    const __m128i y_offset = _mm_set1_epi16(16);
+    const __m128i uv_offset = _mm_set1_epi16(128);
+
+    __m128i y01 = _mm_add_epi16(_mm_packs_epi32(BGR1toY_SSE41(top[0], ycoeff), BGR1toY_SSE41(top[1], ycoeff)), y_offset);
+    __m128i y23 = _mm_add_epi16(_mm_packs_epi32(BGR1toY_SSE41(top[2], ycoeff), BGR1toY_SSE41(top[3], ycoeff)), y_offset);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(ytop), _mm_packus_epi16(y01, y23));
+
+    y01 = _mm_add_epi16(_mm_packs_epi32(BGR1toY_SSE41(bottom[0], ycoeff), BGR1toY_SSE41(bottom[1], ycoeff)), y_offset);
+    y23 = _mm_add_epi16(_mm_packs_epi32(BGR1toY_SSE41(bottom[2], ycoeff), BGR1toY_SSE41(bottom[3], ycoeff)), y_offset);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(ybottom), _mm_packus_epi16(y01, y23));
+
+    __m128i c0 = AverageBGR1_SSE41(top[0], bottom[0]);
+    __m128i c1 = AverageBGR1_SSE41(top[1], bottom[1]);
+    __m128i c2 = AverageBGR1_SSE41(top[2], bottom[2]);
+    __m128i c3 = AverageBGR1_SSE41(top[3], bottom[3]);
+
+    __m128i u = _mm_add_epi16(_mm_packs_epi32(AveragedBGR1toUV_SSE41(c0, c1, ucoeff), AveragedBGR1toUV_SSE41(c2, c3, ucoeff)), uv_offset);
+    __m128i v = _mm_add_epi16(_mm_packs_epi32(AveragedBGR1toUV_SSE41(c0, c1, vcoeff), AveragedBGR1toUV_SSE41(c2, c3, vcoeff)), uv_offset);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(up), _mm_packus_epi16(u, u));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(vp), _mm_packus_epi16(v, v));
+}
+
+// Loads 16 RGB32 pixels and replaces the alpha bytes with 1.
+BLIPVERT_TARGET_SSE41 static inline void LoadRGB32asBGR1_SSE41(const uint8_t* psrc, __m128i* px)
+{
+    const __m128i rgb_mask = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i one = _mm_set1_epi32(0x01000000);
+    for (int index = 0; index < 4; index++)
+    {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc + index * 16));
+        px[index] = _mm_or_si128(_mm_and_si128(pixels, rgb_mask), one);
+    }
+}
+
+// Loads 16 RGB24 pixels (48 bytes) and expands them to BGR1.
+BLIPVERT_TARGET_SSE41 static inline void LoadRGB24asBGR1_SSE41(const uint8_t* psrc, __m128i* px)
+{
+    const __m128i expand = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i one = _mm_set1_epi32(0x01000000);
+    __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc));
+    __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc + 16));
+    __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc + 32));
+    px[0] = _mm_or_si128(_mm_shuffle_epi8(v0, expand), one);
+    px[1] = _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(v1, v0, 12), expand), one);
+    px[2] = _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(v2, v1, 8), expand), one);
+    px[3] = _mm_or_si128(_mm_shuffle_epi8(_mm_srli_si128(v2, 4), expand), one);
+}
+
+BLIPVERT_TARGET_SSE41 void blipvert::RGB32_to_PlanarYUV_SSE41(Stage* in, Stage* out)
+{
+    if (out->decimation != 2)
+    {
+        RGB32_to_PlanarYUV(in, out);
+        return;
+    }
+
+    uint8_t* in_buf = in->buf;
+    uint8_t* out_buf = out->buf;
+    int32_t width = in->width & ~15;
+    int32_t height = in->height;
+    int32_t in_stride = in->stride;
+    int32_t y_stride = out->y_stride;
+    uint8_t* uplane = out->uplane;
+    uint8_t* vplane = out->vplane;
+    int32_t uv_stride = out->uv_stride;
+
+    int32_t in_stride_x_2 = in->stride * 2;
+    int32_t y_stride_x_2 = y_stride * 2;
+
+    __m128i top[4];
+    __m128i bottom[4];
+
+    for (int32_t y = 0; y < height; y += 2)
+    {
+        uint8_t* psrc = in_buf;
+        uint8_t* yp = out_buf;
+        for (int32_t x = 0; x < width; x += 16)
+        {
+            LoadRGB32asBGR1_SSE41(psrc, top);
+            LoadRGB32asBGR1_SSE41(psrc + in_stride, bottom);
+            BGR1toPlanarYUV_SSE41(top, bottom, yp, yp + y_stride, uplane + (x >> 1), vplane + (x >> 1));
+
+            psrc += 64;
+            yp += 16;
+        }
+        in_buf += in_stride_x_2;
+        out_buf += y_stride_x_2;
+
+        uplane += uv_stride;
+        vplane += uv_stride;
+    }
+
+    PlanarYUVRemainingColumns(RGB32_to_PlanarYUV, in, out, width, 4);
+}
+
+BLIPVERT_TARGET_SSE41 void blipvert::RGB24_to_PlanarYUV_SSE41(Stage* in, Stage* out)
+{
+    if (out->decimation != 2)
+    {
+        RGB24_to_PlanarYUV(in, out);
+        return;
+    }
+
+    uint8_t* in_buf = in->buf;
+    uint8_t* out_buf = out->buf;
+    int32_t width = in->width & ~15;
+    int32_t height = in->height;
+    int32_t in_stride = in->stride;
+    int32_t y_stride = out->y_stride;
+    uint8_t* uplane = out->uplane;
+    uint8_t* vplane = out->vplane;
+    int32_t uv_stride = out->uv_stride;
+
+    int32_t in_stride_x_2 = in->stride * 2;
+    int32_t y_stride_x_2 = y_stride * 2;
+
+    __m128i top[4];
+    __m128i bottom[4];
+
+    for (int32_t y = 0; y < height; y += 2)
+    {
+        uint8_t* psrc = in_buf;
+        uint8_t* yp = out_buf;
+        for (int32_t x = 0; x < width; x += 16)
+        {
+            LoadRGB24asBGR1_SSE41(psrc, top);
+            LoadRGB24asBGR1_SSE41(psrc + in_stride, bottom);
+            BGR1toPlanarYUV_SSE41(top, bottom, yp, yp + y_stride, uplane + (x >> 1), vplane + (x >> 1));
+
+            psrc += 48;
+            yp += 16;
+        }
+        in_buf += in_stride_x_2;
+        out_buf += y_stride_x_2;
+
+        uplane += uv_stride;
+        vplane += uv_stride;
+    }
+
+    PlanarYUVRemainingColumns(RGB24_to_PlanarYUV, in, out, width, 3);
+}
+
+// The AVX2 versions hold 8 pixels per register, 4 in each 128-bit lane, and work through 32 pixels
+// per row at a time. The in-lane packs leave the results lane interleaved, so they are put back in
+// order with a 32-bit permute before being stored.
+
+BLIPVERT_TARGET_AVX2 static inline __m256i BGR1toY_AVX2(__m256i px, __m256i coeff)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi8(px, zero), coeff);
+    __m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi8(px, zero), coeff);
+    return _mm256_srai_epi32(_mm256_hadd_epi32(lo, hi), 15);
+}
+
+BLIPVERT_TARGET_AVX2 static inline __m256i AverageBGR1_AVX2(__m256i top, __m256i bottom)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i lo = _mm256_add_epi16(_mm256_unpacklo_epi8(top, zero), _mm256_unpacklo_epi8(bottom, zero));
+    __m256i hi = _mm256_add_epi16(_mm256_unpackhi_epi8(top, zero), _mm256_unpackhi_epi8(bottom, zero));
+    return _mm256_srli_epi16(_mm256_add_epi16(_mm256_unpacklo_epi64(lo, hi), _mm256_unpackhi_epi64(lo, hi)), 2);
+}
+
+BLIPVERT_TARGET_AVX2 static inline __m256i AveragedBGR1toUV_AVX2(__m256i c0, __m256i c1, __m256i coeff)
+{
+    return _mm256_srai_epi32(_mm256_hadd_epi32(_mm256_madd_epi16(c0, coeff), _mm256_madd_epi16(c1, coeff)), 15);
+}
+
+BLIPVERT_TARGET_AVX2 static inline void BGR1toPlanarYUV_AVX2(const __m256i* top, const __m256i* bottom,
+    uint8_t* ytop, uint8_t* ybottom, uint8_t* up, uint8_t* vp)
+{
+    const __m256i ycoeff = _mm256_setr_epi16(YUV_COEFF_YB, YUV_COEFF_YG, YUV_COEFF_YR, YUV_BIAS_Y, YUV_COEFF_YB, YUV_COEFF_YG, YUV_COEFF_YR, YUV_BIAS_Y,
+        YUV_COEFF_YB, YUV_COEFF_YG, YUV_COEFF_YR, YUV_BIAS_Y, YUV_COEFF_YB, YUV_COEFF_YG, YUV_COEFF_YR, YUV_BIAS_Y);
+    const __m256i ucoeff = _mm256_setr_epi16(YUV_COEFF_UB, YUV_COEFF_UG, YUV_COEFF_UR, YUV_BIAS_U, YUV_COEFF_UB, YUV_COEFF_UG, YUV_COEFF_UR, YUV_BIAS_U,
+        YUV_COEFF_UB, YUV_COEFF_UG, YUV_COEFF_UR, YUV_BIAS_U, YUV_COEFF_UB, YUV_COEFF_UG, YUV_COEFF_UR, YUV_BIAS_U);
+    const __m256i vcoeff = _mm256_setr_epi16(YUV_COEFF_VB, YUV_COEFF_VG, YUV_COEFF_VR, YUV_BIAS_V, YUV_COEFF_VB, YUV_COEFF_VG, YUV_COEFF_VR, YUV_BIAS_V,
+        YUV_COEFF_VB, YUV_COEFF_VG, YUV_COEFF_VR, YUV_BIAS_V, YUV_COEFF_VB, YUV_COEFF_VG, YUV_COEFF_VR, YUV_BIAS_V);
+    const __m256i y_offset = _mm256_set1_epi16(16);
+    const __m256i uv_offset = _mm256_set1_epi16(128);
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    __m256i y01 = _mm256_add_epi16(_mm256_packs_epi32(BGR1toY_AVX2(top[0], ycoeff), BGR1toY_AVX2(top[1], ycoeff)), y_offset);
+    __m256i y23 = _mm256_add_epi16(_mm256_packs_epi32(BGR1toY_AVX2(top[2], ycoeff), BGR1toY_AVX2(top[3], ycoeff)), y_offset);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(ytop), _mm256_permutevar8x32_epi32(_mm256_packus_epi16(y01, y23), order));
+
+    y01 = _mm256_add_epi16(_mm256_packs_epi32(BGR1toY_AVX2(bottom[0], ycoeff), BGR1toY_AVX2(bottom[1], ycoeff)), y_offset);
+    y23 = _mm256_add_epi16(_mm256_packs_epi32(BGR1toY_AVX2(bottom[2], ycoeff), BGR1toY_AVX2(bottom[3], ycoeff)), y_offset);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(ybottom), _mm256_permutevar8x32_epi32(_mm256_packus_epi16(y01, y23), order));
+
+    __m256i c0 = AverageBGR1_AVX2(top[0], bottom[0]);
+    __m256i c1 = AverageBGR1_AVX2(top[1], bottom[1]);
+    __m256i c2 = AverageBGR1_AVX2(top[2], bottom[2]);
+    __m256i c3 = AverageBGR1_AVX2(top[3], bottom[3]);
+
+    __m256i u = _mm256_permutevar8x32_epi32(_mm256_packs_epi32(AveragedBGR1toUV_AVX2(c0, c1, ucoeff), AveragedBGR1toUV_AVX2(c2, c3, ucoeff)), order);
+    __m256i v = _mm256_permutevar8x32_epi32(_mm256_packs_epi32(AveragedBGR1toUV_AVX2(c0, c1, vcoeff), AveragedBGR1toUV_AVX2(c2, c3, vcoeff)), order);
+    u = _mm256_add_epi16(u, uv_offset);
+    v = _mm256_add_epi16(v, uv_offset);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(up), _mm_packus_epi16(_mm256_castsi256_si128(u), _mm256_extracti128_si256(u, 1)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(vp), _mm_packus_epi16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+}
+
+// Loads 32 RGB32 pixels and replaces the alpha bytes with 1.
+BLIPVERT_TARGET_AVX2 static inline void LoadRGB32asBGR1_AVX2(const uint8_t* psrc, __m256i* px)
+{
+    const __m256i rgb_mask = _mm256_set1_epi32(0x00FFFFFF);
+    const __m256i one = _mm256_set1_epi32(0x01000000);
+    for (int index = 0; index < 4; index++)
+    {
+        __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(psrc + index * 32));
+        px[index] = _mm256_or_si256(_mm256_and_si256(pixels, rgb_mask), one);
+    }
+}
+
+// Loads 32 RGB24 pixels (96 bytes) and expands them to BGR1. The high lane is loaded 4 bytes
+// early so that the last load doesn't read past the end of the row.
+BLIPVERT_TARGET_AVX2 static inline void LoadRGB24asBGR1_AVX2(const uint8_t* psrc, __m256i* px)
+{
+    const __m256i expand = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+        4, 5, 6, -1, 7, 8, 9, -1, 10, 11, 12, -1, 13, 14, 15, -1);
+    const __m256i one = _mm256_set1_epi32(0x01000000);
+    for (int index = 0; index < 4; index++)
+    {
+        const uint8_t* pgroup = psrc + index * 24;
+        __m256i pixels = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pgroup))),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(pgroup + 8)), 1);
+        px[index] = _mm256_or_si256(_mm256_shuffle_epi8(pixels, expand), one);
+    }
+}
+
+BLIPVERT_TARGET_AVX2 void blipvert::RGB32_to_PlanarYUV_AVX2(Stage* in, Stage* out)
+{
+    if (out->decimation != 2)
+    {
+        RGB32_to_PlanarYUV(in, out);
+        return;
+    }
+
+    uint8_t* in_buf = in->buf;
+    uint8_t* out_buf = out->buf;
+    int32_t width = in->width & ~31;
+    int32_t height = in->height;
+    int32_t in_stride = in->stride;
+    int32_t y_stride = out->y_stride;
+    uint8_t* uplane = out->uplane;
+    uint8_t* vplane = out->vplane;
+    int32_t uv_stride = out->uv_stride;
+
+    int32_t in_stride_x_2 = in->stride * 2;
+    int32_t y_stride_x_2 = y_stride * 2;
+
+    __m256i top[4];
+    __m256i bottom[4];
+
+    for (int32_t y = 0; y < height; y += 2)
+    {
+        uint8_t* psrc = in_buf;
+        uint8_t* yp = out_buf;
+        for (int32_t x = 0; x < width; x += 32)
+        {
+            LoadRGB32asBGR1_AVX2(psrc, top);
+            LoadRGB32asBGR1_AVX2(psrc + in_stride, bottom);
+            BGR1toPlanarYUV_AVX2(top, bottom, yp, yp + y_stride, uplane + (x >> 1), vplane + (x >> 1));
+
+            psrc += 128;
+            yp += 32;
+        }
+        in_buf += in_stride_x_2;
+        out_buf += y_stride_x_2;
+
+        uplane += uv_stride;
+        vplane += uv_stride;
+    }
+
+    PlanarYUVRemainingColumns(RGB32_to_PlanarYUV_SSE41, in, out, width, 4);
+}
+
+BLIPVERT_TARGET_AVX2 void blipvert::RGB24_to_PlanarYUV_AVX2(Stage* in, Stage* out)
+{
+    if (out->decimation != 2)
+    {
+        RGB24_to_PlanarYUV(in, out);
+        return;
+    }
+
+    uint8_t* in_buf = in->buf;
+    uint8_t* out_buf = out->buf;
+    int32_t width = in->width & ~31;
+    int32_t height = in->height;
+    int32_t in_stride = in->stride;
+    int32_t y_stride = out->y_stride;
+    uint8_t* uplane = out->uplane;
+    uint8_t* vplane = out->vplane;
+    int32_t uv_stride = out->uv_stride;
+
+    int32_t in_stride_x_2 = in->stride * 2;
+    int32_t y_stride_x_2 = y_stride * 2;
+
+    __m256i top[4];
+    __m256i bottom[4];
+
+    for (int32_t y = 0; y < height; y += 2)
+    {
+        uint8_t* psrc = in_buf;
+        uint8_t* yp = out_buf;
+        for (int32_t x = 0; x < width; x += 32)
+        {
+            LoadRGB24asBGR1_AVX2(psrc, top);
+            LoadRGB24asBGR1_AVX2(psrc + in_stride, bottom);
+            BGR1toPlanarYUV_AVX2(top, bottom, yp, yp + y_stride, uplane + (x >> 1), vplane + (x >> 1));
+
+            psrc += 96;
+            yp += 32;
+        }
+        in_buf += in_stride_x_2;
+        out_buf += y_stride_x_2;
+
+        uplane += uv_stride;
+        vplane += uv_stride;
+    }
+
+    PlanarYUVRemainingColumns(RGB24_to_PlanarYUV_SSE41, in, out, width, 3);
+}
+
+#endif
@@ -28,6 +28,7 @@
 
 #include "blipverttypes.h"
 #include "Staging.h"
+#include "CpuFeatures.h"
 
 namespace blipvert
 {
@@ -115,5 +116,16 @@ namespace blipvert
     void RGB8_to_Y42T(Stage* in, Stage* out);
     void RGB8_to_Y41T(Stage* in, Stage* out);
     void RGB8_to_YV16(Stage* in, Stage* out);
+
+#if defined(BLIPVERT_X86_SIMD)
+    // SSE4.1 and AVX2 versions of the RGB to 4:2:0 planar transforms. The output stays within +/-1
+    // of the table-driven versions. InitializeLibrary() selects them when the processor supports them.
+
+    void RGB32_to_PlanarYUV_SSE41(Stage* in, Stage* out);
+    void RGB24_to_PlanarYUV_SSE41(Stage* in, Stage* out);
+
+    void RGB32_to_PlanarYUV_AVX2(Stage* in, Stage* out);
+    void RGB24_to_PlanarYUV_AVX2(Stage* in, Stage* out);
+#endif
 }
 
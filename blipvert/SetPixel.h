@@ -26,6 +26,8 @@
 //  SOFTWARE.
 //
 
+#include "blipverttypes.h"
+
 namespace blipvert
 {
     // TODO: This is a hack for unit testing purposes.
@@ -35,11 +35,49 @@
 using namespace blipvert;
 using namespace std;
 
+void blipvert::GetSliceRows(uint8_t thread_index, uint8_t thread_count, int32_t height, int32_t& first_row, int32_t& slice_height)
+{
+    // Hand out whole groups of SliceRowGranularity rows, one extra group to each of the first slices until they're
+    // used up, so the slice heights differ by at most one group.
+    int32_t groups = height / SliceRowGranularity;
+    int32_t groups_per_slice = groups / thread_count;
+    int32_t extra_groups = groups % thread_count;
+
+    first_row = (thread_index * groups_per_slice + min(static_cast<int32_t>(thread_index), extra_groups)) * SliceRowGranularity;
+    slice_height = (groups_per_slice + (thread_index < extra_groups ? 1 : 0)) * SliceRowGranularity;
+
+    // The last slice also takes the rows that don't fill a group.
+    if (thread_index == thread_count - 1)
+        slice_height = height - first_row;
+}
+
+void blipvert::GetTileColumns(uint8_t column_index, uint8_t column_count, int32_t width, int32_t& first_column, int32_t& tile_width)
+{
+    // The same split as GetSliceRows(), in groups of TileColumnGranularity columns.
+    int32_t groups = width / TileColumnGranularity;
+    int32_t groups_per_tile = groups / column_count;
+    int32_t extra_groups = groups % column_count;
+
+    first_column = (column_index * groups_per_tile + min(static_cast<int32_t>(column_index), extra_groups)) * TileColumnGranularity;
+    tile_width = (groups_per_tile + (column_index < extra_groups ? 1 : 0)) * TileColumnGranularity;
+
+    if (column_index == column_count - 1)
+        tile_width = width - first_column;
+}
+
+uint8_t blipvert::GetBandCount(int32_t height, int32_t band_rows)
+{
+    int32_t rows = max(SliceRowGranularity, (band_rows + SliceRowGranularity - 1) / SliceRowGranularity * SliceRowGranularity);
+    return static_cast<uint8_t>(max(1, min(height / rows, 255)));
+}
+
 void blipvert::Stage_RGBA(Stage* result, uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, bool flipped, xRGBQUAD* palette)
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->format = &MVFMT_RGBA;
     result->thread_index = thread_index;
@@ -53,12 +91,12 @@ void blipvert::Stage_RGBA(Stage* result, uint8_t thread_index, uint8_t thread_co
 
     if (result->flipped)
     {
-        result->buf = buf + (result->stride * ((height - 1) - thread_index * (slice_height)));
+        result->buf = buf + (result->stride * ((height - 1) - slice_row));
         result->stride = -result->stride;
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->stride;
+        result->buf = buf + slice_row * result->stride;
     }
 }
 
@@ -66,7 +104,9 @@ void blipvert::Stage_RGB32(Stage* result, uint8_t thread_index, uint8_t thread_c
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->format = &MVFMT_RGB32;
     result->thread_index = thread_index;
@@ -80,12 +120,12 @@ void blipvert::Stage_RGB32(Stage* result, uint8_t thread_index, uint8_t thread_c
 
     if (result->flipped)
     {
-        result->buf = buf + (result->stride * ((height - 1) - thread_index * (slice_height)));
+        result->buf = buf + (result->stride * ((height - 1) - slice_row));
         result->stride = -result->stride;
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->stride;
+        result->buf = buf + slice_row * result->stride;
     }
 }
 
@@ -93,7 +133,9 @@ void blipvert::Stage_RGB24(Stage* result, uint8_t thread_index, uint8_t thread_c
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->format = &MVFMT_RGB24;
     result->thread_index = thread_index;
@@ -107,12 +149,12 @@ void blipvert::Stage_RGB24(Stage* result, uint8_t thread_index, uint8_t thread_c
 
     if (result->flipped)
     {
-        result->buf = buf + (result->stride * ((height - 1) - thread_index * (slice_height)));
+        result->buf = buf + (result->stride * ((height - 1) - slice_row));
         result->stride = -result->stride;
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->stride;
+        result->buf = buf + slice_row * result->stride;
     }
 }
 
@@ -120,7 +162,9 @@ void blipvert::Stage_RGB565(Stage* result, uint8_t thread_index, uint8_t thread_
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->format = &MVFMT_RGB565;
     result->thread_index = thread_index;
@@ -134,12 +178,12 @@ void blipvert::Stage_RGB565(Stage* result, uint8_t thread_index, uint8_t thread_
 
     if (result->flipped)
     {
-        result->buf = buf + (result->stride * ((height - 1) - thread_index * (slice_height)));
+        result->buf = buf + (result->stride * ((height - 1) - slice_row));
         result->stride = -result->stride;
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->stride;
+        result->buf = buf + slice_row * result->stride;
     }
 }
 
@@ -147,7 +191,9 @@ void blipvert::Stage_RGB555(Stage* result, uint8_t thread_index, uint8_t thread_
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->format = &MVFMT_RGB555;
     result->thread_index = thread_index;
@@ -160,12 +206,12 @@ void blipvert::Stage_RGB555(Stage* result, uint8_t thread_index, uint8_t thread_
         result->stride = width * 2;
     if (result->flipped)
     {
-        result->buf = buf + (result->stride * ((height - 1) - thread_index * (slice_height)));
+        result->buf = buf + (result->stride * ((height - 1) - slice_row));
         result->stride = -result->stride;
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->stride;
+        result->buf = buf + slice_row * result->stride;
     }
 }
 
@@ -173,7 +219,9 @@ void blipvert::Stage_ARGB1555(Stage* result, uint8_t thread_index, uint8_t threa
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->format = &MVFMT_ARGB1555;
     result->thread_index = thread_index;
@@ -187,12 +235,12 @@ void blipvert::Stage_ARGB1555(Stage* result, uint8_t thread_index, uint8_t threa
 
     if (result->flipped)
     {
-        result->buf = buf + (result->stride * ((height - 1) - thread_index * (slice_height)));
+        result->buf = buf + (result->stride * ((height - 1) - slice_row));
         result->stride = -result->stride;
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->stride;
+        result->buf = buf + slice_row * result->stride;
     }
 }
 
@@ -200,7 +248,9 @@ void blipvert::Stage_RGB8(Stage* result, uint8_t thread_index, uint8_t thread_co
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->format = &MVFMT_RGB8;
     result->thread_index = thread_index;
@@ -213,14 +263,20 @@ void blipvert::Stage_RGB8(Stage* result, uint8_t thread_index, uint8_t thread_co
     if (result->stride < width)
         result->stride = width;
 
+    if (result->palette == nullptr)
+    {
+        result->palette = rgb8_greyscale_palette.data();
+        result->palette_entries = static_cast<uint16_t>(rgb8_greyscale_palette.size());
+    }
+
     if (result->flipped)
     {
-        result->buf = buf + (result->stride * ((height - 1) - thread_index * (slice_height)));
+        result->buf = buf + (result->stride * ((height - 1) - slice_row));
         result->stride = -result->stride;
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->stride;
+        result->buf = buf + slice_row * result->stride;
     }
 }
 
@@ -228,7 +284,9 @@ void blipvert::Stage_RGB4(Stage* result, uint8_t thread_index, uint8_t thread_co
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->format = &MVFMT_RGB4;
     result->thread_index = thread_index;
@@ -249,16 +307,19 @@ void blipvert::Stage_RGB4(Stage* result, uint8_t thread_index, uint8_t thread_co
     }
 
     if (result->palette == nullptr)
-        result->palette = rgb4_greyscale_palette;
+    {
+        result->palette = rgb4_greyscale_palette.data();
+        result->palette_entries = static_cast<uint16_t>(rgb4_greyscale_palette.size());
+    }
 
     if (result->flipped)
     {
-        result->buf = buf + (result->stride * ((height - 1) - thread_index * (slice_height)));
+        result->buf = buf + (result->stride * ((height - 1) - slice_row));
         result->stride = -result->stride;
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->stride;
+        result->buf = buf + slice_row * result->stride;
     }
 }
 
@@ -266,7 +327,9 @@ void blipvert::Stage_RGB1(Stage* result, uint8_t thread_index, uint8_t thread_co
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->format = &MVFMT_RGB1;
     result->width = width;
@@ -286,16 +349,19 @@ void blipvert::Stage_RGB1(Stage* result, uint8_t thread_index, uint8_t thread_co
     }
 
     if (result->palette == nullptr)
-        result->palette = rgb1_greyscale_palette;
+    {
+        result->palette = rgb1_greyscale_palette.data();
+        result->palette_entries = static_cast<uint16_t>(rgb1_greyscale_palette.size());
+    }
 
     if (result->flipped)
     {
-        result->buf = buf + (result->stride * ((height - 1) - thread_index * (slice_height)));
+        result->buf = buf + (result->stride * ((height - 1) - slice_row));
         result->stride = -result->stride;
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->stride;
+        result->buf = buf + slice_row * result->stride;
     }
 }
 
@@ -303,7 +369,9 @@ void Stage_PackedY422(Stage* result, uint8_t thread_index, uint8_t thread_count,
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->width = width;
     result->height = slice_height;
@@ -315,12 +383,12 @@ void Stage_PackedY422(Stage* result, uint8_t thread_index, uint8_t thread_count,
 
     if (result->flipped)
     {
-        result->buf = buf + (result->stride * ((height - 1) - thread_index * (slice_height)));
+        result->buf = buf + (result->stride * ((height - 1) - slice_row));
         result->stride = -result->stride;
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->stride;
+        result->buf = buf + slice_row * result->stride;
     }
 }
 
@@ -373,7 +441,9 @@ void Stage_PlanarYUV(Stage* result, uint8_t thread_index, uint8_t thread_count,
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->decimation = decimation;
     result->width = width;
@@ -382,7 +452,8 @@ void Stage_PlanarYUV(Stage* result, uint8_t thread_index, uint8_t thread_count,
 
     result->uv_width = width / decimation;
     result->uv_height = height / decimation;
-    result->uv_slice_height = height / decimation / thread_count;
+    result->uv_slice_height = (slice_row + slice_height) / decimation - slice_row / decimation;
+    int32_t uv_slice_row = slice_row / decimation;
 
     if (stride <= width)
     {
@@ -397,9 +468,9 @@ void Stage_PlanarYUV(Stage* result, uint8_t thread_index, uint8_t thread_count,
 
     if (flipped)
     {
-        result->buf = buf + (result->y_stride * ((height - 1) - thread_index * slice_height));
+        result->buf = buf + (result->y_stride * ((height - 1) - slice_row));
 
-        int32_t offset_from_bottom = (result->uv_stride * ((result->uv_height - 1) - thread_index * result->uv_slice_height));
+        int32_t offset_from_bottom = (result->uv_stride * ((result->uv_height - 1) - uv_slice_row));
 
         if (ufirst)
         {
@@ -422,9 +493,9 @@ void Stage_PlanarYUV(Stage* result, uint8_t thread_index, uint8_t thread_count,
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->y_stride;
+        result->buf = buf + slice_row * result->y_stride;
 
-        int32_t offset_from_top = thread_index * result->uv_slice_height * result->uv_stride;
+        int32_t offset_from_top = uv_slice_row * result->uv_stride;
 
         if (ufirst)
         {
@@ -471,7 +542,9 @@ void blipvert::Stage_IYU1(Stage* result, uint8_t thread_index, uint8_t thread_co
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->format = &MVFMT_IYU1;
     result->width = width;
@@ -484,12 +557,12 @@ void blipvert::Stage_IYU1(Stage* result, uint8_t thread_index, uint8_t thread_co
 
     if (result->flipped)
     {
-        result->buf = buf + (result->stride * ((height - 1) - thread_index * (slice_height)));
+        result->buf = buf + (result->stride * ((height - 1) - slice_row));
         result->stride = -result->stride;
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->stride;
+        result->buf = buf + slice_row * result->stride;
     }
 }
 
@@ -497,7 +570,9 @@ void blipvert::Stage_IYU2(Stage* result, uint8_t thread_index, uint8_t thread_co
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->format = &MVFMT_IYU2;
     result->width = width;
@@ -510,12 +585,12 @@ void blipvert::Stage_IYU2(Stage* result, uint8_t thread_index, uint8_t thread_co
 
     if (result->flipped)
     {
-        result->buf = buf + (result->stride * ((height - 1) - thread_index * (slice_height)));
+        result->buf = buf + (result->stride * ((height - 1) - slice_row));
         result->stride = -result->stride;
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->stride;
+        result->buf = buf + slice_row * result->stride;
     }
 }
 
@@ -523,7 +598,9 @@ void blipvert::Stage_Y41P(Stage* result, uint8_t thread_index, uint8_t thread_co
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->format = &MVFMT_Y41P;
     result->width = width;
@@ -536,12 +613,12 @@ void blipvert::Stage_Y41P(Stage* result, uint8_t thread_index, uint8_t thread_co
 
     if (result->flipped)
     {
-        result->buf = buf + (result->stride * ((height - 1) - thread_index * (slice_height)));
+        result->buf = buf + (result->stride * ((height - 1) - slice_row));
         result->stride = -result->stride;
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->stride;
+        result->buf = buf + slice_row * result->stride;
     }
 }
 
@@ -549,7 +626,9 @@ void blipvert::Stage_CLJR(Stage* result, uint8_t thread_index, uint8_t thread_co
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->format = &MVFMT_CLJR;
     result->width = width;
@@ -562,12 +641,12 @@ void blipvert::Stage_CLJR(Stage* result, uint8_t thread_index, uint8_t thread_co
 
     if (result->flipped)
     {
-        result->buf = buf + (result->stride * ((height - 1) - thread_index * (slice_height)));
+        result->buf = buf + (result->stride * ((height - 1) - slice_row));
         result->stride = -result->stride;
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->stride;
+        result->buf = buf + slice_row * result->stride;
     }
 }
 
@@ -575,7 +654,9 @@ void blipvert::Stage_Y800(Stage* result, uint8_t thread_index, uint8_t thread_co
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->format = &MVFMT_Y800;
     result->width = width;
@@ -588,12 +669,12 @@ void blipvert::Stage_Y800(Stage* result, uint8_t thread_index, uint8_t thread_co
 
     if (result->flipped)
     {
-        result->buf = buf + (result->stride * ((height - 1) - thread_index * (slice_height)));
+        result->buf = buf + (result->stride * ((height - 1) - slice_row));
         result->stride = -result->stride;
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->stride;
+        result->buf = buf + slice_row * result->stride;
     }
 }
 
@@ -601,7 +682,9 @@ void blipvert::Stage_Y16(Stage* result, uint8_t thread_index, uint8_t thread_cou
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->format = &MVFMT_Y16;
     result->width = width;
@@ -614,12 +697,12 @@ void blipvert::Stage_Y16(Stage* result, uint8_t thread_index, uint8_t thread_cou
 
     if (result->flipped)
     {
-        result->buf = buf + (result->stride * ((height - 1) - (thread_index * slice_height)));
+        result->buf = buf + (result->stride * ((height - 1) - slice_row));
         result->stride = -result->stride;
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->stride;
+        result->buf = buf + slice_row * result->stride;
     }
 }
 
@@ -627,7 +710,9 @@ void blipvert::Stage_AYUV(Stage* result, uint8_t thread_index, uint8_t thread_co
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->format = &MVFMT_AYUV;
     result->thread_index = thread_index;
@@ -641,12 +726,12 @@ void blipvert::Stage_AYUV(Stage* result, uint8_t thread_index, uint8_t thread_co
 
     if (result->flipped)
     {
-        result->buf = buf + (result->stride * ((height - 1) - (thread_index * slice_height)));
+        result->buf = buf + (result->stride * ((height - 1) - slice_row));
         result->stride = -result->stride;
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->stride;
+        result->buf = buf + slice_row * result->stride;
     }
 }
 
@@ -654,7 +739,9 @@ void Stage_IMCx(Stage* result, uint8_t thread_index, uint8_t thread_count, int32
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->width = width;
     result->height = slice_height;
@@ -664,16 +751,20 @@ void Stage_IMCx(Stage* result, uint8_t thread_index, uint8_t thread_count, int32
 
     result->uv_width = width / 2;
     result->uv_height = height / 2;
-    result->uv_slice_height = result->uv_height / thread_count;
+    result->uv_slice_height = (slice_row + slice_height) / 2 - slice_row / 2;
+    int32_t uv_slice_row = slice_row / 2;
 
     if (result->stride < width)
         result->stride = width;
 
+    // The chroma rows are as wide as the luma rows.
+    result->uv_stride = result->stride;
+
     if (flipped)
     {
-        result->buf = buf + (result->stride * ((height - 1) - thread_index * slice_height));
+        result->buf = buf + (result->stride * ((height - 1) - slice_row));
 
-        int32_t offset_from_bottom = result->stride * ((result->uv_height - 1) - thread_index * result->uv_slice_height);
+        int32_t offset_from_bottom = result->stride * ((result->uv_height - 1) - uv_slice_row);
 
         if (ufirst)
         {
@@ -713,12 +804,13 @@ void Stage_IMCx(Stage* result, uint8_t thread_index, uint8_t thread_count, int32
         }
 
         result->stride = -result->stride;
+        result->uv_stride = -result->uv_stride;
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->stride;
+        result->buf = buf + slice_row * result->stride;
 
-        int32_t offset_from_top = thread_index * result->uv_slice_height * result->stride;
+        int32_t offset_from_top = uv_slice_row * result->stride;
 
         if (ufirst)
         {
@@ -787,7 +879,9 @@ void Stage_NVx(Stage* result, uint8_t thread_index, uint8_t thread_count, int32_
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->width = width;
     result->height = slice_height;
@@ -797,7 +891,8 @@ void Stage_NVx(Stage* result, uint8_t thread_index, uint8_t thread_count, int32_
 
     result->uv_width = width;
     result->uv_height = height / 2;
-    result->uv_slice_height = result->uv_height / thread_count;
+    result->uv_slice_height = (slice_row + slice_height) / 2 - slice_row / 2;
+    int32_t uv_slice_row = slice_row / 2;
 
     if (result->stride < width)
         result->stride = width;
@@ -813,18 +908,22 @@ void Stage_NVx(Stage* result, uint8_t thread_index, uint8_t thread_count, int32_
         result->v_index = 0;
     }
 
+    // The interleaved chroma rows are as wide as the luma rows.
+    result->uv_stride = result->stride;
+
     uint8_t* uvbuf = buf + (result->stride * height);
 
     if (flipped)
     {
-        result->buf = buf + (result->stride * ((height - 1) - thread_index * slice_height));
-        result->uvplane = uvbuf + result->stride * ((result->uv_height - 1) - thread_index * result->uv_slice_height);
+        result->buf = buf + (result->stride * ((height - 1) - slice_row));
+        result->uvplane = uvbuf + result->stride * ((result->uv_height - 1) - uv_slice_row);
         result->stride = -result->stride;
+        result->uv_stride = -result->uv_stride;
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->stride;
-        result->uvplane = uvbuf + thread_index * result->uv_slice_height * result->stride;
+        result->buf = buf + slice_row * result->stride;
+        result->uvplane = uvbuf + uv_slice_row * result->stride;
     }
 }
 
@@ -844,7 +943,9 @@ void blipvert::Stage_Y42T(Stage* result, uint8_t thread_index, uint8_t thread_co
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->format = &MVFMT_Y42T;
     result->width = width;
@@ -857,12 +958,12 @@ void blipvert::Stage_Y42T(Stage* result, uint8_t thread_index, uint8_t thread_co
 
     if (result->flipped)
     {
-        result->buf = buf + (result->stride * ((height - 1) - thread_index * (slice_height)));
+        result->buf = buf + (result->stride * ((height - 1) - slice_row));
         result->stride = -result->stride;
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->stride;
+        result->buf = buf + slice_row * result->stride;
     }
 }
 
@@ -870,7 +971,9 @@ void blipvert::Stage_Y41T(Stage* result, uint8_t thread_index, uint8_t thread_co
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->format = &MVFMT_Y41T;
     result->width = width;
@@ -883,12 +986,12 @@ void blipvert::Stage_Y41T(Stage* result, uint8_t thread_index, uint8_t thread_co
 
     if (result->flipped)
     {
-        result->buf = buf + (result->stride * ((height - 1) - thread_index * (slice_height)));
+        result->buf = buf + (result->stride * ((height - 1) - slice_row));
         result->stride = -result->stride;
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->stride;
+        result->buf = buf + slice_row * result->stride;
     }
 }
 
@@ -896,7 +999,9 @@ void blipvert::Stage_YV16(Stage* result, uint8_t thread_index, uint8_t thread_co
 {
     memset(result, 0, sizeof(Stage));
 
-    int32_t slice_height = height / thread_count;
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
 
     result->format = &MVFMT_YV16;
     result->width = width;
@@ -919,9 +1024,9 @@ void blipvert::Stage_YV16(Stage* result, uint8_t thread_index, uint8_t thread_co
 
     if (flipped)
     {
-        result->buf = buf + (result->y_stride * ((height - 1) - thread_index * slice_height));
+        result->buf = buf + (result->y_stride * ((height - 1) - slice_row));
 
-        int32_t offset_from_bottom = result->uv_stride * ((height - 1) - thread_index * slice_height);
+        int32_t offset_from_bottom = result->uv_stride * ((height - 1) - slice_row);
 
         uint8_t* vbuf = buf + (result->y_stride * height);
         result->vplane = vbuf + offset_from_bottom;
@@ -933,9 +1038,9 @@ void blipvert::Stage_YV16(Stage* result, uint8_t thread_index, uint8_t thread_co
     }
     else
     {
-        result->buf = buf + thread_index * slice_height * result->y_stride;
+        result->buf = buf + slice_row * result->y_stride;
 
-        int32_t offset_from_top = thread_index * slice_height * result->uv_stride;
+        int32_t offset_from_top = slice_row * result->uv_stride;
         uint8_t* vbuf = buf + (result->y_stride * height);
         result->vplane = vbuf + offset_from_top;
         uint8_t* ubuf = vbuf + (result->uv_stride * height);
@@ -943,42 +1048,175 @@ void blipvert::Stage_YV16(Stage* result, uint8_t thread_index, uint8_t thread_co
     }
 }
 
-int blipvert::GetFormatMaxThreadCount(const MediaFormatID& format, uint32_t width, uint32_t height, int requested_threads)
+bool IsPlanarYUVStage(const Stage* stage)
 {
-    if (format == MVFMT_I420 || format == MVFMT_YV12 ||
-        format == MVFMT_NV12 || format == MVFMT_NV21 ||
-        format == MVFMT_IMC1 || format == MVFMT_IMC2 ||
-        format == MVFMT_IMC3 || format == MVFMT_IMC4)
+    return stage->format == &MVFMT_I420 || stage->format == &MVFMT_YV12 ||
+        stage->format == &MVFMT_YUV9 || stage->format == &MVFMT_YVU9 ||
+        stage->format == &MVFMT_YV16;
+}
+
+bool IsIMCxStage(const Stage* stage)
+{
+    return stage->format == &MVFMT_IMC1 || stage->format == &MVFMT_IMC2 ||
+        stage->format == &MVFMT_IMC3 || stage->format == &MVFMT_IMC4;
+}
+
+bool IsNVxStage(const Stage* stage)
+{
+    return stage->format == &MVFMT_NV12 || stage->format == &MVFMT_NV21;
+}
+
+// Returns the first row of a slice of one plane and sets stride to the step between its rows, which is
+// negative when the frame is flipped.
+uint8_t* GetPlaneSliceRow(uint8_t* plane, int32_t& stride, int32_t plane_rows, int32_t slice_row, bool flipped)
+{
+    if (flipped)
     {
-        int testcount = requested_threads;
-        
-        while (testcount > 1)
-        {
-            if (height % 2 == 0 && (height / 2) % testcount == 0)
-            {
-                break;
-            }
+        uint8_t* row = plane + (stride * ((plane_rows - 1) - slice_row));
+        stride = -stride;
+        return row;
+    }
 
-            testcount--;
-        }
-        return testcount;
+    return plane + (stride * slice_row);
+}
+
+bool blipvert::StagePlanes(Stage* result, const MediaFormatID& format, uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height,
+    const PlaneFrame& frame, bool flipped, xRGBQUAD* palette)
+{
+    t_stagetransformfunc pstage = FindTransformStage(format);
+    if (pstage == nullptr || frame.planes[0] == nullptr)
+        return false;
+
+    // The format's own staging function fills in everything but the plane addresses, which are then
+    // pointed at the frame's planes.
+    pstage(result, thread_index, thread_count, width, height, frame.planes[0], frame.strides[0], flipped, palette);
+
+    bool planar = IsPlanarYUVStage(result);
+    bool imcx = IsIMCxStage(result);
+    bool nvx = IsNVxStage(result);
+    if (!planar && !imcx && !nvx)
+        return true;
+
+    bool separate_uv = planar || (imcx && !result->interlaced);
+    if (frame.planes[1] == nullptr || (separate_uv && frame.planes[2] == nullptr))
+        return false;
+
+    int32_t slice_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, slice_row, slice_height);
+
+    int32_t uv_decimation = 2;
+    if (result->format == &MVFMT_YV16)
+        uv_decimation = 1;
+    else if (planar)
+        uv_decimation = result->decimation;
+
+    int32_t uv_rows = height / uv_decimation;
+    int32_t uv_slice_row = slice_row / uv_decimation;
+
+    // The narrowest a row of the chroma plane can be.
+    int32_t uv_row_width = separate_uv ? result->uv_width : width;
+
+    int32_t y_stride = max(frame.strides[0], width);
+    int32_t uv_stride = max(frame.strides[1], uv_row_width);
+    if (separate_uv && max(frame.strides[2], uv_row_width) != uv_stride)
+        return false;
+
+    result->buf = GetPlaneSliceRow(frame.planes[0], y_stride, height, slice_row, flipped);
+
+    if (nvx)
+    {
+        result->uvplane = GetPlaneSliceRow(frame.planes[1], uv_stride, uv_rows, uv_slice_row, flipped);
     }
-    else if (format == MVFMT_YUV9 || format == MVFMT_YVU9)
+    else if (separate_uv)
     {
-        int testcount = requested_threads;
+        int32_t v_stride = uv_stride;
+        result->uplane = GetPlaneSliceRow(frame.planes[1], uv_stride, uv_rows, uv_slice_row, flipped);
+        result->vplane = GetPlaneSliceRow(frame.planes[2], v_stride, uv_rows, uv_slice_row, flipped);
+    }
+    else
+    {
+        // IMC2 and IMC4 keep the U and V half rows side by side, in the same order as the contiguous layout.
+        bool ufirst = result->uplane < result->vplane;
+        uint8_t* uvrow = GetPlaneSliceRow(frame.planes[1], uv_stride, uv_rows, uv_slice_row, flipped);
+        result->uplane = ufirst ? uvrow : uvrow + result->uv_width;
+        result->vplane = ufirst ? uvrow + result->uv_width : uvrow;
+    }
 
-        while (testcount > 1)
-        {
-            if (height % 4 == 0 && (height / 4) % testcount == 0)
-            {
-                break;
-            }
+    if (planar)
+        result->y_stride = y_stride;
+    else
+        result->stride = y_stride;
 
-            testcount--;
-        }
-        return testcount;
+    result->uv_stride = uv_stride;
+
+    return true;
+}
+
+bool blipvert::GetFramePlanes(const MediaFormatID& format, int32_t width, int32_t height, uint8_t* buf, int32_t stride, PlaneFrame& frame)
+{
+    t_stagetransformfunc pstage = FindTransformStage(format);
+    if (pstage == nullptr)
+        return false;
+
+    // Staging the whole frame as one slice lays out the planes the way the format's transforms expect them.
+    Stage stage;
+    pstage(&stage, 0, 1, width, height, buf, stride, false, nullptr);
+
+    memset(&frame, 0, sizeof(PlaneFrame));
+    frame.planes[0] = stage.buf;
+    frame.strides[0] = stage.stride;
+
+    if (IsPlanarYUVStage(&stage) || (IsIMCxStage(&stage) && !stage.interlaced))
+    {
+        if (IsPlanarYUVStage(&stage))
+            frame.strides[0] = stage.y_stride;
+
+        frame.planes[1] = stage.uplane;
+        frame.planes[2] = stage.vplane;
+        frame.strides[1] = stage.uv_stride;
+        frame.strides[2] = stage.uv_stride;
+    }
+    else if (IsIMCxStage(&stage))
+    {
+        frame.planes[1] = min(stage.uplane, stage.vplane);
+        frame.strides[1] = stage.uv_stride;
+    }
+    else if (IsNVxStage(&stage))
+    {
+        frame.planes[1] = stage.uvplane;
+        frame.strides[1] = stage.uv_stride;
+    }
+
+    return true;
+}
+
+void blipvert::GetInPlaceRows(Stage* in, Stage* out, uint8_t*& in_buf, uint8_t*& out_buf, int32_t& in_stride, int32_t& out_stride)
+{
+    in_buf = in->buf;
+    out_buf = out->buf;
+    in_stride = in->stride;
+    out_stride = out->stride;
+
+    if (in_stride < 0)
+    {
+        // A flipped stage starts at its highest addressed row.
+        in_buf += in_stride * (in->height - 1);
+        out_buf += out_stride * (in->height - 1);
+        in_stride = -in_stride;
+        out_stride = -out_stride;
     }
-    else if (format == MVFMT_Y41T || format == MVFMT_Y42T ||
+}
+
+// Returns true for the formats whose staging functions can cut a frame into slices and tiles.
+static bool IsSliceableFormat(const MediaFormatID& format)
+{
+    return format == MVFMT_I420 || format == MVFMT_YV12 ||
+        format == MVFMT_NV12 || format == MVFMT_NV21 ||
+        format == MVFMT_IMC1 || format == MVFMT_IMC2 ||
+        format == MVFMT_IMC3 || format == MVFMT_IMC4 ||
+        format == MVFMT_YUV9 || format == MVFMT_YVU9 ||
+        format == MVFMT_Y41T || format == MVFMT_Y42T ||
         format == MVFMT_Y41P || format == MVFMT_CLJR ||
         format == MVFMT_IYU1 || format == MVFMT_IYU2 ||
         format == MVFMT_YV16 || format == MVFMT_YUY2 ||
@@ -987,20 +1225,73 @@ int blipvert::GetFormatMaxThreadCount(const MediaFormatID& format, uint32_t widt
         format == MVFMT_Y800 || format == MVFMT_Y16 ||
         format == MVFMT_RGBA || format == MVFMT_RGB32 ||
         format == MVFMT_RGB24 || format == MVFMT_RGB565 ||
-        format == MVFMT_RGB555 || format == MVFMT_ARGB1555)
+        format == MVFMT_RGB555 || format == MVFMT_ARGB1555;
+}
+
+bool blipvert::StageTileColumns(Stage* result, int32_t first_column, int32_t tile_width)
+{
+    // Bytes from the start of a row to the first column, for the packed formats and the Y plane.
+    int32_t offset;
+    const MediaFormatID* format = result->format;
+    if (format == &MVFMT_RGBA || format == &MVFMT_RGB32 || format == &MVFMT_AYUV)
+        offset = first_column * 4;
+    else if (format == &MVFMT_RGB24 || format == &MVFMT_IYU2)
+        offset = first_column * 3;
+    else if (format == &MVFMT_RGB565 || format == &MVFMT_RGB555 || format == &MVFMT_ARGB1555 || format == &MVFMT_Y16 ||
+        format == &MVFMT_YUY2 || format == &MVFMT_UYVY || format == &MVFMT_YVYU || format == &MVFMT_VYUY || format == &MVFMT_Y42T)
+        offset = first_column * 2;
+    else if (format == &MVFMT_Y41P || format == &MVFMT_Y41T || format == &MVFMT_IYU1)
+        offset = first_column / 8 * 12;
+    else if (format == &MVFMT_CLJR || format == &MVFMT_Y800 || IsPlanarYUVStage(result) || IsIMCxStage(result) || IsNVxStage(result))
+        offset = first_column;
+    else
+        return false;
+
+    result->buf += offset;
+    result->width = tile_width;
+    result->tiled = true;
+    result->first_column = first_column;
+
+    if (IsPlanarYUVStage(result) || IsIMCxStage(result))
     {
-        int testcount = requested_threads;
+        // YV16 only halves the chroma columns, the others decimate them as much as their rows.
+        int32_t uv_decimation = (result->format == &MVFMT_YV16 || IsIMCxStage(result)) ? 2 : result->decimation;
+        result->uplane += first_column / uv_decimation;
+        result->vplane += first_column / uv_decimation;
+        result->uv_width = tile_width / uv_decimation;
+    }
+    else if (IsNVxStage(result))
+    {
+        // A U and V pair for every two columns.
+        result->uvplane += first_column;
+        result->uv_width = tile_width;
+    }
 
-        while (testcount > 1)
-        {
-            if (height % testcount == 0 && height / testcount >= 16)
-            {
-                break;
-            }
+    return true;
+}
 
-            testcount--;
-        }
-        return testcount;
+void blipvert::GetTileShape(const MediaFormatID& format1, const MediaFormatID& format2, int32_t width, int32_t height, int tile_count,
+    uint8_t& row_count, uint8_t& column_count)
+{
+    tile_count = max(1, min(tile_count, 255));
+
+    int rows = GetCommonMaxThreadCount(format1, format2, width, height, min(tile_count, max(1, height / MinTileRows)));
+    int columns = 1;
+    if (IsSliceableFormat(format1) && IsSliceableFormat(format2) && format1 != MVFMT_CLJR && format1 != MVFMT_IYU1)
+        columns = max(1, min(tile_count / rows, width / MinTileColumns));
+
+    row_count = static_cast<uint8_t>(rows);
+    column_count = static_cast<uint8_t>(columns);
+}
+
+int blipvert::GetFormatMaxThreadCount(const MediaFormatID& format, uint32_t width, uint32_t height, int requested_threads)
+{
+    if (IsSliceableFormat(format))
+    {
+        // The slices don't have to divide the frame evenly, see GetSliceRows(), so the requested count
+        // is only limited to one group of rows per slice.
+        int maxcount = max(1, static_cast<int>(height / SliceRowGranularity));
+        return max(1, min(min(requested_threads, maxcount), 255));
     }
     else
     {
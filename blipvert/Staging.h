@@ -40,6 +40,7 @@ namespace blipvert
         bool flipped;
         bool interlaced;
         xRGBQUAD* palette;
+        uint16_t palette_entries;   // Entries the palette holds, or 0 if that isn't known, see GetPaletteTables().
         bool has_odd;
         uint16_t remainder;
         int16_t y0_index;
@@ -55,6 +56,9 @@ namespace blipvert
         uint8_t* uplane;
         uint8_t* uvplane;
         int32_t decimation;
+        bool stream_stores;     // The SIMD kernels that support it write this stage with non-temporal stores, see StreamingStores.h.
+        bool tiled;             // The stage covers only some of each row's columns, see StageTileColumns().
+        int32_t first_column;   // The frame column a tile starts at.
     } Stage;
 
     typedef struct TransformStage {
@@ -99,6 +103,106 @@ namespace blipvert
     void Stage_Y41T(Stage* result, uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, bool flipped = false, xRGBQUAD* palette = nullptr);
     void Stage_YV16(Stage* result, uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, bool flipped = false, xRGBQUAD* palette = nullptr);
 
+    // Slices start on a multiple of this many rows, which keeps every format's chroma rows whole and gives
+    // every format the same slice boundaries for a given height and thread count.
+    const int32_t SliceRowGranularity = 4;
+
+    // Returns the first row and the height of the slice for thread_index. The slices are as even as the row granularity
+    // allows and the last slice takes whatever rows are left over.
+    void GetSliceRows(uint8_t thread_index, uint8_t thread_count, int32_t height, int32_t& first_row, int32_t& slice_height);
+
+    // Rows per band that GetBandCount() aims for by default. Small enough that a frame has several bands per worker,
+    // so a worker that's slowed down or running on a slower core holds up a band rather than a whole share of the
+    // frame, and big enough that claiming a band costs next to nothing against transforming it.
+    const int32_t DefaultBandRows = 32;
+
+    // Returns how many slices of about band_rows rows to cut a frame of the given height into, for handing out to
+    // workers one band at a time, see ParallelTransformBands(). band_rows is rounded up to SliceRowGranularity, so
+    // every band keeps its chroma rows whole. The result is at least 1 and at most 255.
+    uint8_t GetBandCount(int32_t height, int32_t band_rows = DefaultBandRows);
+
+    //
+    // Tiles cut the slices of a frame into column ranges as well, so a wide, short frame such as a 7680 x 64
+    // panorama or a line-scan strip can be split between more threads than it has groups of rows. A tile is
+    // staged as a row slice with the format's staging function and then narrowed to its columns with
+    // StageTileColumns(). The transforms only see a stage with a smaller width, so they run on tiles unchanged.
+    //
+
+    // Tiles start on a multiple of this many columns, which keeps the pixel groups of every packed format whole
+    // (8 for Y41P and Y41T, 4 for CLJR and IYU1, 2 for the 4:2:2 formats) along with the chroma columns of every
+    // planar format, the 4 x 4 blocks of YUV9 included.
+    const int32_t TileColumnGranularity = 16;
+
+    // The smallest tile GetTileShape() makes. Narrower or shorter tiles spend more time on row setup and
+    // partly written cache lines than they save.
+    const int32_t MinTileRows = 16;
+    const int32_t MinTileColumns = 128;
+
+    // Returns the first column and the width of the tile for column_index. The tiles are as even as the column
+    // granularity allows and the last tile takes whatever columns are left over.
+    void GetTileColumns(uint8_t column_index, uint8_t column_count, int32_t width, int32_t& first_column, int32_t& tile_width);
+
+    // Narrows a staged slice to tile_width columns starting at first_column, which must be a multiple of
+    // TileColumnGranularity, and sets the stage's tiled flag so transforms that copy a whole plane at once
+    // when the strides match copy the tile's rows one by one instead. Returns false, leaving the stage as it
+    // was, for the palettized formats, whose pixels don't start on a byte.
+    bool StageTileColumns(Stage* result, int32_t first_column, int32_t tile_width);
+
+    // Picks how to cut a frame into at most tile_count tiles that both formats can be staged as. The frame is cut
+    // into row slices of at least MinTileRows rows first, since whole rows are contiguous in memory, and each
+    // slice is then cut into as many columns of at least MinTileColumns as the rest of the count allows. A
+    // 1920 x 1080 frame stays in row slices while a 7680 x 64 strip is cut into 4 rows of columns.
+    // row_count * column_count is at most tile_count and at most 255. CLJR and IYU1 inputs are only cut
+    // into rows, since their transforms interpolate chroma from the next pixel group across a tile's edge.
+    void GetTileShape(const MediaFormatID& format1, const MediaFormatID& format2, int32_t width, int32_t height, int tile_count,
+        uint8_t& row_count, uint8_t& column_count);
+
+    //
+    // A plane frame describes a frame whose planes don't have to follow each other in one buffer, such as the
+    // multi-planar buffers V4L2 hands out or an imported DMA-BUF, so it can be transformed without first copying
+    // the planes together.
+    //
+    //      planes[0]:  The Y plane, or the only plane of a packed format.
+    //      planes[1]:  The U plane of I420, YV12, YUV9, YVU9, YV16, IMC1 and IMC3, whatever order the format
+    //                  stores its planes in. The interleaved chroma plane of NV12 and NV21, and the chroma plane
+    //                  of IMC2 and IMC4 with its U and V half rows side by side.
+    //      planes[2]:  The V plane of the formats with separate U and V planes, unused otherwise.
+    //
+    // Each plane has a stride of its own. A stride smaller than a row of the plane, 0 included, means the rows
+    // are packed. The U and V planes of a format must share a stride since the transforms step through them
+    // together.
+    //
+    typedef struct PlaneFrame {
+        uint8_t* planes[3];
+        int32_t strides[3];
+    } PlaneFrame;
+
+    // Stages the slice for thread_index of a plane frame. It fills in the same fields as the format's staging
+    // function does for a contiguous buffer, with buf, uplane, vplane and uvplane pointing into the frame's
+    // own planes, so any transform function runs on them directly.
+    //
+    // Parameters:
+    //      result:         OUT -> The staged slice.
+    //      format:         IN  -> The media format of the frame.
+    //      thread_index:   IN  -> The slice to stage.
+    //      thread_count:   IN  -> The number of slices the frame is cut into.
+    //      width, height:  IN  -> The logical dimensions of the frame.
+    //      frame:          IN  -> The frame's planes and strides.
+    //      flipped:        IN  -> true if the frame is flipped.
+    //      palette:        IN  -> The palette for palettized formats, nullptr otherwise.
+    // Returns false if the format is unknown, a plane the format needs is missing or the U and V strides differ.
+    bool StagePlanes(Stage* result, const MediaFormatID& format, uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height,
+        const PlaneFrame& frame, bool flipped = false, xRGBQUAD* palette = nullptr);
+
+    // Describes a contiguous buffer of the given format as a plane frame.
+    // Returns false if the format is unknown.
+    bool GetFramePlanes(const MediaFormatID& format, int32_t width, int32_t height, uint8_t* buf, int32_t stride, PlaneFrame& frame);
+
+    // Returns the lowest addressed rows of an in-place transform's input and output stages and the positive steps
+    // between their rows. Walking the rows up from there keeps an output row from overwriting input that hasn't been
+    // read yet when the output stride is smaller than the input stride. Both stages must be flipped the same way.
+    void GetInPlaceRows(Stage* in, Stage* out, uint8_t*& in_buf, uint8_t*& out_buf, int32_t& in_stride, int32_t& out_stride);
+
     // Returns the maximum number of worker threads that is compatible with the bitmap format.
     int GetFormatMaxThreadCount(const MediaFormatID& format, uint32_t width, uint32_t height, int requested_threads);
 
@@ -0,0 +1,74 @@
+#pragma once
+
+//
+//  blipvert C++ library
+//
+//  MIT License
+//
+//  Copyright(c) 2021-2025 Don Jordan
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+//
+
+#include "CpuFeatures.h"
+#include "Staging.h"
+
+#if defined(BLIPVERT_X86_SIMD)
+#include <immintrin.h>
+
+namespace blipvert
+{
+    //
+    // Non-temporal stores for the SIMD kernels that support Stage::stream_stores. They write around the cache
+    // instead of reading every line of the output in first, so a frame bigger than the last level cache doesn't
+    // evict the input on its way out. A kernel checks each row with StreamRow(), writes it with StoreSI128()
+    // or StoreSI256(), and calls EndStreaming() before it returns so the slice's stores are visible to whoever
+    // waits for it.
+    //
+
+    // Non-temporal stores have to be aligned, so a row that doesn't start on an alignment byte boundary is
+    // written with ordinary stores. alignment is the size of the kernel's stores, 16 or 32.
+    inline bool StreamRow(const Stage* out, const uint8_t* row, uintptr_t alignment)
+    {
+        return out->stream_stores && (reinterpret_cast<uintptr_t>(row) & (alignment - 1)) == 0;
+    }
+
+    BLIPVERT_TARGET_SSE41 inline void StoreSI128(uint8_t* pdst, __m128i value, bool stream)
+    {
+        if (stream)
+            _mm_stream_si128(reinterpret_cast<__m128i*>(pdst), value);
+        else
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pdst), value);
+    }
+
+    BLIPVERT_TARGET_AVX2 inline void StoreSI256(uint8_t* pdst, __m256i value, bool stream)
+    {
+        if (stream)
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(pdst), value);
+        else
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(pdst), value);
+    }
+
+    BLIPVERT_TARGET_SSE41 inline void EndStreaming(const Stage* out)
+    {
+        if (out->stream_stores)
+            _mm_sfence();
+    }
+}
+#endif
@@ -0,0 +1,645 @@
+//
+//  blipvert C++ library
+//
+//  MIT License
+//
+//  Copyright(c) 2021-2025 Don Jordan
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+//
+
+#include "pch.h"
+#include "ThreadPool.h"
+#include "CpuFeatures.h"
+#include "Numa.h"
+#include "blipvert.h"
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+#if defined(BLIPVERT_X86_SIMD)
+#include <immintrin.h>
+#endif
+
+using namespace blipvert;
+
+//
+// Frames are handed to the workers through a ring of MaxFramesInFlight slots, filled in the order the frames are
+// submitted. Each slot has a ticket that packs the frame's number, the NUMA node its slices are kept on, its slice
+// count and the index of the next unclaimed slice into one 64 bit word. Slices are claimed with compare-and-swap on
+// the whole ticket, so a worker that read a slot before it was reused can never claim a slice of the later frame
+// using the earlier frame's count, or one of a frame kept on another node. Workers claim from the oldest frame that
+// has slices left, so they move on to the next frame while the last slices of the one before are still running.
+//
+//      bits 32 - 63:   frame number
+//      bits 24 - 31:   node + 1, 0 for any node
+//      bits 16 - 23:   slice count
+//      bits  0 - 15:   next slice
+//
+
+static inline uint32_t TicketGeneration(uint64_t ticket)
+{
+    return static_cast<uint32_t>(ticket >> 32);
+}
+
+static inline uint32_t TicketNode(uint64_t ticket)
+{
+    return static_cast<uint32_t>(ticket >> 24) & 0xFF;
+}
+
+static inline uint32_t TicketCount(uint64_t ticket)
+{
+    return static_cast<uint32_t>(ticket >> 16) & 0xFF;
+}
+
+static inline uint32_t TicketNext(uint64_t ticket)
+{
+    return static_cast<uint32_t>(ticket) & 0xFFFF;
+}
+
+static inline uint64_t MakeTicket(uint32_t generation, int32_t node, uint32_t count)
+{
+    return (static_cast<uint64_t>(generation) << 32) | (static_cast<uint64_t>(node + 1) << 24) | (static_cast<uint64_t>(count) << 16);
+}
+
+// The highest node a frame can be kept on. Frames on higher nodes run on any worker.
+static const int32_t MaxTicketNode = 254;
+
+// Claims slices of frames kept on any node, for threads that are waiting for the pool to make progress.
+static const int32_t AnyNode = -2;
+
+// Number of polls an idle worker makes before it sleeps, and how often it gives up its time slice while polling
+// so a pool larger than the number of free cores doesn't starve the thread that is running the frame.
+static const int WorkerSpinCount = 2048;
+static const int WorkerYieldInterval = 64;
+
+// A frame in flight. func, context, done and done_context are written before the ticket is published and read only
+// after a slice is claimed, or by the thread that finishes the last slice.
+typedef struct alignas(64) FrameSlot {
+    std::atomic<uint64_t> ticket;
+    std::atomic<uint32_t> remaining;    // Slices claimed or not that haven't finished.
+    std::atomic<bool> busy;             // From when the frame is submitted until its last slice finishes.
+    t_slicefunc func;
+    void* context;
+    t_framedonefunc done;
+    void* done_context;
+} FrameSlot;
+
+// Frame numbers wrap around at 2^32, which MaxFramesInFlight has to divide so a frame always maps to the same slot.
+static_assert((MaxFramesInFlight & (MaxFramesInFlight - 1)) == 0, "MaxFramesInFlight must be a power of two.");
+
+static FrameSlot Frames[MaxFramesInFlight];
+static std::atomic<uint32_t> SubmittedFrames(0);    // The number of the newest frame, which idle workers wait on.
+static std::atomic<bool> StopWorkers(false);
+static std::atomic<uint32_t> SleepingWorkers(0);
+
+// Everything the workers use is allocated once and never destroyed, and nothing joins the workers when the program
+// exits; they end with the process. Joining them from a static destructor can deadlock in a DLL, whose destructors
+// run under the loader lock, and would wait forever on a frame another thread still has in flight. A DLL that's
+// unloaded while the process keeps running must call ShutdownThreadPool() first.
+static std::mutex& SleepMutex = *new std::mutex;
+static std::condition_variable& SleepCondition = *new std::condition_variable;
+
+// Where RunSlices() callers sleep when their frame takes longer than a spin to finish, and how many of them do.
+static std::mutex& FinishMutex = *new std::mutex;
+static std::condition_variable& FinishCondition = *new std::condition_variable;
+static std::atomic<uint32_t> WaitingCallers(0);
+
+// Serializes submitting frames and starting or stopping the pool.
+static std::mutex& DispatchMutex = *new std::mutex;
+static std::vector<std::thread>& Workers = *new std::vector<std::thread>;
+static ThreadPoolOptions& PoolOptions = *new ThreadPoolOptions{ 0, {}, false };
+static bool PoolStarted = false;
+
+// A copy of PoolOptions.numa_local that's read without DispatchMutex, to decide whether to look up a frame's node.
+static std::atomic<bool> NumaLocalFrames(false);
+
+// The number of workers pinned to each node, so a frame is only kept on a node that has some.
+static std::vector<uint32_t>& NodeWorkerCounts = *new std::vector<uint32_t>;
+
+static inline void CpuRelax()
+{
+#if defined(BLIPVERT_X86_SIMD)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// Called after each slice. The thread that finishes the last one frees the slot and then calls the frame's done
+// function, so the function can submit another frame.
+static void FinishSlice(FrameSlot& slot)
+{
+    if (slot.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+
+    t_framedonefunc done = slot.done;
+    void* done_context = slot.done_context;
+    slot.busy.store(false, std::memory_order_release);
+
+    if (done != nullptr)
+        done(done_context);
+}
+
+// Claims and runs one slice of frame number, unless it has none left, its slot has been reused or it's kept on
+// another node than the thread's. node is -1 for a thread on an unknown node. Returns false if no slice was run.
+static bool RunFrameSlice(uint32_t number, int32_t node)
+{
+    FrameSlot& slot = Frames[number % MaxFramesInFlight];
+    uint64_t ticket = slot.ticket.load(std::memory_order_acquire);
+    while (TicketGeneration(ticket) == number && TicketNext(ticket) < TicketCount(ticket))
+    {
+        if (node != AnyNode && TicketNode(ticket) != 0 && TicketNode(ticket) != static_cast<uint32_t>(node + 1))
+            return false;
+
+        if (slot.ticket.compare_exchange_weak(ticket, ticket + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            slot.func(slot.context, static_cast<uint8_t>(TicketNext(ticket)));
+            FinishSlice(slot);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Runs one slice of the oldest frame in flight that has any left. Returns false if there weren't any.
+static bool RunNextSlice(int32_t node)
+{
+    uint32_t newest = SubmittedFrames.load(std::memory_order_acquire);
+    for (uint32_t number = newest - MaxFramesInFlight + 1; number != newest + 1; number++)
+    {
+        if (RunFrameSlice(number, node))
+            return true;
+    }
+
+    return false;
+}
+
+static void WorkerMain(int32_t node, std::vector<uint32_t> cpus)
+{
+    if (!cpus.empty())
+        SetCurrentThreadCpus(cpus);
+
+    uint32_t seen = SubmittedFrames.load(std::memory_order_acquire);
+    while (true)
+    {
+        while (RunNextSlice(node))
+        {
+        }
+
+        int spins = 0;
+        uint32_t newest;
+        while ((newest = SubmittedFrames.load(std::memory_order_acquire)) == seen)
+        {
+            if (StopWorkers.load(std::memory_order_acquire))
+                return;
+
+            if (++spins < WorkerSpinCount)
+            {
+                if (spins % WorkerYieldInterval == 0)
+                    std::this_thread::yield();
+                else
+                    CpuRelax();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(SleepMutex);
+            SleepingWorkers.fetch_add(1);
+            SleepCondition.wait(lock, [seen]() {
+                return SubmittedFrames.load() != seen || StopWorkers.load();
+                });
+            SleepingWorkers.fetch_sub(1);
+            spins = 0;
+        }
+
+        seen = newest;
+    }
+}
+
+static uint32_t DefaultWorkerCount()
+{
+    uint32_t hardware_threads = std::thread::hardware_concurrency();
+    return hardware_threads > 1 ? hardware_threads - 1 : 0;
+}
+
+// DispatchMutex must be held.
+static void StartWorkers()
+{
+    if (PoolStarted)
+        return;
+
+    PoolStarted = true;
+    uint32_t count = PoolOptions.worker_count ? PoolOptions.worker_count : DefaultWorkerCount();
+
+    // Without CPU sets of its own, a pool that keeps frames on their node spreads the workers over the nodes.
+    std::vector<std::vector<uint32_t>> cpu_sets = PoolOptions.cpu_sets;
+    if (cpu_sets.empty() && PoolOptions.numa_local && GetNumaNodeCount() > 1)
+    {
+        std::vector<uint32_t> cpus;
+        for (uint32_t node = 0; node < GetNumaNodeCount(); node++)
+        {
+            if (GetNumaNodeCpus(node, cpus))
+                cpu_sets.push_back(cpus);
+        }
+    }
+
+    NodeWorkerCounts.assign(MaxTicketNode + 1, 0);
+    StopWorkers.store(false);
+    for (uint32_t index = 0; index < count; index++)
+    {
+        std::vector<uint32_t> cpus;
+        int32_t node = -1;
+        if (!cpu_sets.empty())
+        {
+            cpus = cpu_sets[index % cpu_sets.size()];
+            if (!cpus.empty())
+                node = GetCpuNumaNode(cpus[0]);
+            if (node >= 0 && node <= MaxTicketNode)
+                NodeWorkerCounts[node]++;
+        }
+
+        Workers.emplace_back(WorkerMain, node, cpus);
+    }
+}
+
+// Finishes the frames in flight and stops the workers. Finishing a frame calls its done function, which may submit
+// another frame or resume a coroutine, so dispatch is unlocked while the calling thread runs slices and the pool
+// stays started until every slot is free. dispatch must hold DispatchMutex.
+static void StopAndJoinWorkers(std::unique_lock<std::mutex>& dispatch)
+{
+    if (Workers.empty())
+    {
+        PoolStarted = false;
+        return;
+    }
+
+    // Nothing would run the slices of the frames in flight once the workers are gone, so they're finished first.
+    for (uint32_t index = 0; index < MaxFramesInFlight; )
+    {
+        if (!Frames[index].busy.load(std::memory_order_acquire))
+        {
+            index++;
+            continue;
+        }
+
+        dispatch.unlock();
+        if (!RunNextSlice(AnyNode))
+            CpuRelax();
+        dispatch.lock();
+
+        // A frame submitted meanwhile may have gone in a slot that was already checked.
+        index = 0;
+    }
+
+    // Another thread may have stopped the workers while dispatch was unlocked.
+    PoolStarted = false;
+    if (Workers.empty())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(SleepMutex);
+        StopWorkers.store(true);
+    }
+    SleepCondition.notify_all();
+
+    for (auto& worker : Workers)
+    {
+        worker.join();
+    }
+    Workers.clear();
+}
+
+// Returns the node buf's memory is on when the pool keeps frames on their node, -1 otherwise. Finding the node takes
+// a system call, so it's done before DispatchMutex is taken and submitting threads don't queue behind it.
+static int32_t FindBufferNode(const void* buf)
+{
+    if (!NumaLocalFrames.load(std::memory_order_relaxed) || buf == nullptr)
+        return -1;
+
+    return GetBufferNumaNode(buf);
+}
+
+// Returns the node to keep a frame whose buffer is on buffer_node on, or -1 if it can run on any worker.
+// DispatchMutex must be held and the workers started.
+static int32_t FindFrameNode(int32_t buffer_node)
+{
+    if (!PoolOptions.numa_local || buffer_node < 0 || buffer_node > MaxTicketNode || NodeWorkerCounts[buffer_node] == 0)
+        return -1;
+
+    return buffer_node;
+}
+
+// Puts a frame kept on node, or on any node when it's -1, in the next slot and returns its number. If the slot's
+// last frame hasn't finished yet, the calling thread runs slices of the frames in flight until it has. Finishing
+// one of them calls its done function, which may submit a frame of its own, so dispatch is unlocked meanwhile.
+// dispatch must hold DispatchMutex and the workers must be started.
+static uint32_t SubmitFrame(std::unique_lock<std::mutex>& dispatch, t_slicefunc func, void* context, uint8_t slice_count,
+    int32_t node, t_framedonefunc done, void* done_context)
+{
+    uint32_t number = SubmittedFrames.load(std::memory_order_relaxed) + 1;
+    while (Frames[number % MaxFramesInFlight].busy.load(std::memory_order_acquire))
+    {
+        dispatch.unlock();
+        if (!RunNextSlice(AnyNode))
+            CpuRelax();
+        dispatch.lock();
+
+        StartWorkers();
+        number = SubmittedFrames.load(std::memory_order_relaxed) + 1;
+    }
+
+    FrameSlot& slot = Frames[number % MaxFramesInFlight];
+
+    slot.func = func;
+    slot.context = context;
+    slot.done = done;
+    slot.done_context = done_context;
+    slot.remaining.store(slice_count, std::memory_order_relaxed);
+    slot.busy.store(true, std::memory_order_relaxed);
+    slot.ticket.store(MakeTicket(number, node, slice_count), std::memory_order_release);
+    SubmittedFrames.store(number);
+
+    if (SleepingWorkers.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(SleepMutex);
+        SleepCondition.notify_all();
+    }
+
+    return number;
+}
+
+// The caller may return as soon as it sees finished set, so nothing touches it after the store.
+static void __cdecl SetFrameFinished(void* context)
+{
+    static_cast<std::atomic<bool>*>(context)->store(true);
+
+    if (WaitingCallers.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(FinishMutex);
+        FinishCondition.notify_all();
+    }
+}
+
+void blipvert::RunSlices(t_slicefunc func, void* context, uint8_t slice_count)
+{
+    RunSlicesNear(func, context, slice_count, nullptr);
+}
+
+void blipvert::RunSlicesNear(t_slicefunc func, void* context, uint8_t slice_count, const void* buf)
+{
+    if (slice_count == 0)
+        return;
+
+    if (slice_count == 1)
+    {
+        func(context, 0);
+        return;
+    }
+
+    std::atomic<bool> finished(false);
+    uint32_t number;
+    int32_t node;
+    int32_t buffer_node = FindBufferNode(buf);
+    {
+        std::unique_lock<std::mutex> dispatch(DispatchMutex);
+        StartWorkers();
+        node = FindFrameNode(buffer_node);
+        number = SubmitFrame(dispatch, func, context, slice_count, node, SetFrameFinished, &finished);
+    }
+
+    // The calling thread helps with its own frame unless the frame is kept on another node.
+    if (node < 0 || GetCurrentNumaNode() == node)
+    {
+        while (RunFrameSlice(number, node))
+        {
+        }
+    }
+
+    // The last slices usually finish within a spin. A caller that didn't help, or whose frame is held up behind
+    // a long one, sleeps like an idle worker rather than keep a core busy.
+    int spins = 0;
+    while (!finished.load(std::memory_order_acquire))
+    {
+        if (++spins < WorkerSpinCount)
+        {
+            if (spins % WorkerYieldInterval == 0)
+                std::this_thread::yield();
+            else
+                CpuRelax();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(FinishMutex);
+        WaitingCallers.fetch_add(1);
+        FinishCondition.wait(lock, [&finished]() {
+            return finished.load();
+            });
+        WaitingCallers.fetch_sub(1);
+    }
+}
+
+void blipvert::SubmitSlices(t_slicefunc func, void* context, uint8_t slice_count, t_framedonefunc done, const void* buf)
+{
+    int32_t buffer_node = slice_count != 0 ? FindBufferNode(buf) : -1;
+    std::unique_lock<std::mutex> dispatch(DispatchMutex);
+    StartWorkers();
+
+    if (slice_count == 0 || Workers.empty())
+    {
+        dispatch.unlock();
+        for (uint8_t index = 0; index < slice_count; index++)
+        {
+            func(context, index);
+        }
+
+        if (done != nullptr)
+            done(context);
+        return;
+    }
+
+    SubmitFrame(dispatch, func, context, slice_count, FindFrameNode(buffer_node), done, context);
+}
+
+void blipvert::SetThreadPoolSize(uint32_t worker_count)
+{
+    std::unique_lock<std::mutex> dispatch(DispatchMutex);
+    StopAndJoinWorkers(dispatch);
+    PoolOptions.worker_count = worker_count;
+}
+
+uint32_t blipvert::GetThreadPoolSize()
+{
+    std::lock_guard<std::mutex> dispatch(DispatchMutex);
+    return PoolOptions.worker_count ? PoolOptions.worker_count : DefaultWorkerCount();
+}
+
+void blipvert::SetThreadPoolOptions(const ThreadPoolOptions& options)
+{
+    std::unique_lock<std::mutex> dispatch(DispatchMutex);
+    StopAndJoinWorkers(dispatch);
+    PoolOptions = options;
+    NumaLocalFrames.store(options.numa_local, std::memory_order_relaxed);
+}
+
+void blipvert::GetThreadPoolOptions(ThreadPoolOptions& options)
+{
+    std::lock_guard<std::mutex> dispatch(DispatchMutex);
+    options = PoolOptions;
+}
+
+void blipvert::ShutdownThreadPool()
+{
+    std::unique_lock<std::mutex> dispatch(DispatchMutex);
+    StopAndJoinWorkers(dispatch);
+}
+
+typedef struct {
+    t_transformfunc transform;
+    t_stagetransformfunc stage_in;
+    t_stagetransformfunc stage_out;
+    int32_t width;
+    int32_t height;
+    uint8_t* in_buf;
+    int32_t in_stride;
+    uint8_t* out_buf;
+    int32_t out_stride;
+    bool in_flipped;
+    bool out_flipped;
+    xRGBQUAD* in_palette;
+    xRGBQUAD* out_palette;
+    uint8_t thread_count;
+} ParallelTransformContext;
+
+// Each slice is staged on the stack of the thread that runs it, so a call made from a done function or a resumed
+// coroutine while this frame waits for a slot can't restage it.
+static void __cdecl TransformSlice(void* context, uint8_t slice_index)
+{
+    ParallelTransformContext* frame = static_cast<ParallelTransformContext*>(context);
+    TransformStage stage;
+    frame->stage_in(&stage.inStage, slice_index, frame->thread_count, frame->width, frame->height,
+        frame->in_buf, frame->in_stride, frame->in_flipped, frame->in_palette);
+    frame->stage_out(&stage.outStage, slice_index, frame->thread_count, frame->width, frame->height,
+        frame->out_buf, frame->out_stride, frame->out_flipped, frame->out_palette);
+    frame->transform(&stage.inStage, &stage.outStage);
+}
+
+// Stages a frame as slice_count slices, reduced to what both formats allow, and runs them on the pool.
+static bool RunTransformSlices(const MediaFormatID& inFormat, const MediaFormatID& outFormat, int32_t width, int32_t height,
+    uint8_t* in_buf, int32_t in_stride, uint8_t* out_buf, int32_t out_stride, int slice_count,
+    bool in_flipped, bool out_flipped, xRGBQUAD* in_palette, xRGBQUAD* out_palette)
+{
+    FormatIndex in_index = GetFormatIndex(inFormat);
+    FormatIndex out_index = GetFormatIndex(outFormat);
+
+    t_transformfunc transform = FindVideoTransform(in_index, out_index);
+    t_stagetransformfunc pstage_in = FindTransformStage(in_index);
+    t_stagetransformfunc pstage_out = FindTransformStage(out_index);
+    if (transform == nullptr || pstage_in == nullptr || pstage_out == nullptr)
+        return false;
+
+    if (slice_count < 1)
+        slice_count = 1;
+    uint8_t thread_count = static_cast<uint8_t>(GetCommonMaxThreadCount(inFormat, outFormat, width, height, slice_count));
+
+    ParallelTransformContext context = { transform, pstage_in, pstage_out, width, height, in_buf, in_stride, out_buf, out_stride,
+        in_flipped, out_flipped, in_palette, out_palette, thread_count };
+    RunSlicesNear(TransformSlice, &context, thread_count, in_buf);
+    return true;
+}
+
+bool blipvert::ParallelTransform(const MediaFormatID& inFormat, const MediaFormatID& outFormat, int32_t width, int32_t height,
+    uint8_t* in_buf, int32_t in_stride, uint8_t* out_buf, int32_t out_stride, uint8_t thread_count,
+    bool in_flipped, bool out_flipped, xRGBQUAD* in_palette, xRGBQUAD* out_palette)
+{
+    return RunTransformSlices(inFormat, outFormat, width, height, in_buf, in_stride, out_buf, out_stride, thread_count,
+        in_flipped, out_flipped, in_palette, out_palette);
+}
+
+bool blipvert::ParallelTransformBands(const MediaFormatID& inFormat, const MediaFormatID& outFormat, int32_t width, int32_t height,
+    uint8_t* in_buf, int32_t in_stride, uint8_t* out_buf, int32_t out_stride, int32_t band_rows,
+    bool in_flipped, bool out_flipped, xRGBQUAD* in_palette, xRGBQUAD* out_palette)
+{
+    return RunTransformSlices(inFormat, outFormat, width, height, in_buf, in_stride, out_buf, out_stride, GetBandCount(height, band_rows),
+        in_flipped, out_flipped, in_palette, out_palette);
+}
+
+typedef struct {
+    t_flipverticalslicefunc flip;
+    int32_t width;
+    int32_t height;
+    uint8_t* buf;
+    int32_t stride;
+    uint8_t thread_count;
+} ParallelFlipContext;
+
+static void __cdecl FlipSlice(void* context, uint8_t slice_index)
+{
+    ParallelFlipContext* frame = static_cast<ParallelFlipContext*>(context);
+    frame->flip(slice_index, frame->thread_count, frame->width, frame->height, frame->buf, frame->stride);
+}
+
+bool blipvert::ParallelFlipVertical(const MediaFormatID& format, int32_t width, int32_t height, uint8_t* buf, int32_t stride,
+    uint8_t thread_count)
+{
+    t_flipverticalslicefunc flip = FindFlipVerticalSliceTransform(format);
+    if (flip == nullptr)
+        return false;
+
+    if (thread_count < 1)
+        thread_count = 1;
+
+    ParallelFlipContext context = { flip, width, height, buf, stride, thread_count };
+    RunSlicesNear(FlipSlice, &context, thread_count, buf);
+    return true;
+}
+
+typedef struct {
+    t_greyscaleslicefunc greyscale;
+    int32_t width;
+    int32_t height;
+    uint8_t* buf;
+    int32_t stride;
+    uint8_t thread_count;
+    xRGBQUAD* palette;
+} ParallelGreyscaleContext;
+
+static void __cdecl GreyscaleSlice(void* context, uint8_t slice_index)
+{
+    ParallelGreyscaleContext* frame = static_cast<ParallelGreyscaleContext*>(context);
+    frame->greyscale(slice_index, frame->thread_count, frame->width, frame->height, frame->buf, frame->stride, frame->palette);
+}
+
+bool blipvert::ParallelGreyscale(const MediaFormatID& format, int32_t width, int32_t height, uint8_t* buf, int32_t stride,
+    uint8_t thread_count, xRGBQUAD* in_palette)
+{
+    t_greyscaleslicefunc greyscale = FindGreyscaleSliceTransform(format);
+    if (greyscale == nullptr)
+        return false;
+
+    if (thread_count < 1)
+        thread_count = 1;
+
+    ParallelGreyscaleContext context = { greyscale, width, height, buf, stride, thread_count, in_palette };
+    RunSlicesNear(GreyscaleSlice, &context, thread_count, buf);
+    return true;
+}
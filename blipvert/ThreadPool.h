@@ -0,0 +1,170 @@
+#pragma once
+
+//
+//  blipvert C++ library
+//
+//  MIT License
+//
+//  Copyright(c) 2021-2025 Don Jordan
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+//
+
+#include "blipverttypes.h"
+#include "Staging.h"
+
+#include <vector>
+
+namespace blipvert
+{
+    //
+    // Library owned worker pool.
+    //
+    // The workers are created on first use and stay alive between frames. Submitting a frame is serialized by
+    // a lock held while the frame is put in a slot and its single atomic ticket is published; each worker, and
+    // the calling thread, then claim slices from the ticket with compare-and-swap until none are left, without
+    // taking a lock. Idle workers spin briefly before going to sleep, so back to back frames don't pay for a
+    // wake-up. Up to MaxFramesInFlight frames can be queued at once, and the workers claim slices from the oldest
+    // one that has any left.
+    //
+
+    // Function run for each slice. context is passed through from RunSlices().
+    typedef void(__cdecl* t_slicefunc) (void* context, uint8_t slice_index);
+
+    // Function called once every slice of a frame from SubmitSlices() has finished, on the thread that finished
+    // the last one. That's a worker, or a thread inside another pool call that runs slices while it waits:
+    // SubmitSlices(), RunSlices(), the Parallel functions, SetThreadPoolSize(), SetThreadPoolOptions() or
+    // ShutdownThreadPool(). None of the pool's locks are held, so it may submit another frame, but it must not
+    // resize, reconfigure or shut down the pool, which would wait for the thread it's running on. context is
+    // passed through from SubmitSlices().
+    typedef void(__cdecl* t_framedonefunc) (void* context);
+
+    // The most frames the pool holds at once, counting the ones RunSlices() callers are waiting for.
+    const uint32_t MaxFramesInFlight = 16;
+
+    // Runs func(context, index) for every index from 0 to slice_count - 1 on the worker pool and the calling
+    // thread. Returns once every slice has finished. Frames from different calling threads can be in flight at
+    // the same time.
+    void RunSlices(t_slicefunc func, void* context, uint8_t slice_count);
+
+    // Same as RunSlices(), but when the pool keeps frames on their NUMA node, see ThreadPoolOptions::numa_local, only
+    // the workers on the node holding buf's memory run the slices. The calling thread only helps if it's running on
+    // that node too. The Parallel functions below and ExecuteTransformPlanParallel() pass their input frame.
+    void RunSlicesNear(t_slicefunc func, void* context, uint8_t slice_count, const void* buf);
+
+    // Queues func(context, index) for every index from 0 to slice_count - 1 on the worker pool and returns without
+    // waiting, so a capture thread can hand a frame off and get back to the device. done(context), if it isn't
+    // nullptr, is called once the frame is finished; it may submit another frame. Frames start in the order they're
+    // submitted, and the workers move on to a frame's slices as soon as the frames before it have handed out all of
+    // theirs, so the cores aren't left idle while the last slices of the previous frame finish. context must stay
+    // valid until done is called. buf is the frame's input, see RunSlicesNear(), or nullptr.
+    //
+    // The call only waits when MaxFramesInFlight frames are already in flight, and runs slices of the oldest of them
+    // while it does. With no worker threads, see SetThreadPoolSize(), the frame runs on the calling thread before the
+    // call returns.
+    void SubmitSlices(t_slicefunc func, void* context, uint8_t slice_count, t_framedonefunc done, const void* buf = nullptr);
+
+    // Sets the number of worker threads, not counting the calling thread. 0 selects one less than the number
+    // of hardware threads. Any running workers are stopped and the pool is started again on its next use.
+    void SetThreadPoolSize(uint32_t worker_count);
+
+    // Returns the number of worker threads the pool runs, not counting the calling thread.
+    uint32_t GetThreadPoolSize();
+
+    // Where the worker threads run, for machines with more than one NUMA node or cores set aside for other work.
+    typedef struct ThreadPoolOptions {
+        uint32_t worker_count;                          // The number of workers, see SetThreadPoolSize().
+        std::vector<std::vector<uint32_t>> cpu_sets;    // Worker n is pinned to cpu_sets[n % size]. Empty leaves the
+                                                        // workers unpinned, see SetCurrentThreadCpus().
+        bool numa_local;                                // Keep each frame's slices on the workers pinned to the node
+                                                        // holding the frame, see RunSlicesNear(). Without cpu_sets the
+                                                        // workers are spread over the nodes and pinned to them.
+    } ThreadPoolOptions;
+
+    // Sets the pool's options. Any running workers are stopped and the pool is started again on its next use.
+    // A frame is kept on a node by the node of the first processor in its workers' CPU sets, so a set should not
+    // span nodes. Frames on a node without workers, or in memory whose node isn't known, run on any worker.
+    void SetThreadPoolOptions(const ThreadPoolOptions& options);
+
+    // Returns the pool's options.
+    void GetThreadPoolOptions(ThreadPoolOptions& options);
+
+    // Stops and joins the worker threads, after finishing any frames in flight, including the ones their done
+    // functions submit, so a chain of frames that never ends keeps the call from returning. The calling thread runs
+    // slices meanwhile, and may call done functions. The pool starts again if it's used afterwards, and resizing it
+    // or giving it new options stops it the same way. The workers aren't joined when the program exits, they end with the
+    // process, so a DLL that uses the pool and is unloaded before then must call this first. Don't call it from
+    // DllMain.
+    void ShutdownThreadPool();
+
+    // Transforms a frame using the worker pool. The frame is cut into slices with the staging functions
+    // and each slice is transformed on its own thread. Returns when the whole frame is done.
+    //
+    // Parameters:
+    //      inFormat, outFormat:    IN -> The input and output media formats.
+    //      width, height:          IN -> The logical dimensions of the frame.
+    //      in_buf, in_stride:      IN -> The input frame and its stride, or 0 for the format's minimum stride.
+    //      out_buf, out_stride:    IN -> The output frame and its stride, or 0 for the format's minimum stride.
+    //      thread_count:           IN -> The number of slices requested. It's reduced to what both formats allow,
+    //                                    see GetCommonMaxThreadCount().
+    //      in_flipped, out_flipped:IN -> true if the input or output frame is flipped.
+    //      in_palette, out_palette:IN -> Palettes for palettized formats, nullptr otherwise.
+    // Returns false if there's no transform between the formats.
+    bool ParallelTransform(const MediaFormatID& inFormat, const MediaFormatID& outFormat, int32_t width, int32_t height,
+        uint8_t* in_buf, int32_t in_stride, uint8_t* out_buf, int32_t out_stride, uint8_t thread_count,
+        bool in_flipped = false, bool out_flipped = false, xRGBQUAD* in_palette = nullptr, xRGBQUAD* out_palette = nullptr);
+
+    // Transforms a frame using the worker pool, cut into many small row bands instead of one slice per thread.
+    // The workers and the calling thread claim the bands in order from the frame ticket as they finish their last
+    // one, so a thread that's preempted or running on a slower core only holds up the band it's working on and the
+    // others pick up the rest. Returns when the whole frame is done.
+    //
+    // Parameters:
+    //      band_rows:              IN -> The rows per band, see GetBandCount(). The other parameters are the same as
+    //                                    ParallelTransform().
+    // Returns false if there's no transform between the formats.
+    bool ParallelTransformBands(const MediaFormatID& inFormat, const MediaFormatID& outFormat, int32_t width, int32_t height,
+        uint8_t* in_buf, int32_t in_stride, uint8_t* out_buf, int32_t out_stride, int32_t band_rows = DefaultBandRows,
+        bool in_flipped = false, bool out_flipped = false, xRGBQUAD* in_palette = nullptr, xRGBQUAD* out_palette = nullptr);
+
+    // Flips a frame in place using the worker pool, such as a bottom-up DIB that needs to be top-down. Each slice
+    // swaps its share of the row pairs, see t_flipverticalslicefunc. Returns when the whole frame is done.
+    //
+    // Parameters:
+    //      format:                 IN -> The media format of the frame.
+    //      width, height:          IN -> The logical dimensions of the frame.
+    //      buf, stride:            IN -> The frame and its stride, or 0 for the format's minimum stride.
+    //      thread_count:           IN -> The number of slices.
+    // Returns false if there's no vertical flip for the format.
+    bool ParallelFlipVertical(const MediaFormatID& format, int32_t width, int32_t height, uint8_t* buf, int32_t stride,
+        uint8_t thread_count);
+
+    // Converts a frame to greyscale in place using the worker pool, see t_greyscaleslicefunc. Returns when the whole
+    // frame is done.
+    //
+    // Parameters:
+    //      format:                 IN -> The media format of the frame.
+    //      width, height:          IN -> The logical dimensions of the frame.
+    //      buf, stride:            IN -> The frame and its stride, or 0 for the format's minimum stride.
+    //      thread_count:           IN -> The number of slices.
+    //      in_palette:             IN -> The palette to convert for palettized formats, nullptr otherwise.
+    // Returns false if there's no greyscale transform for the format.
+    bool ParallelGreyscale(const MediaFormatID& format, int32_t width, int32_t height, uint8_t* buf, int32_t stride,
+        uint8_t thread_count, xRGBQUAD* in_palette = nullptr);
+}
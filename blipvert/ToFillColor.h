@@ -26,6 +26,8 @@
 //  SOFTWARE.
 //
 
+#include "blipverttypes.h"
+
 namespace blipvert
 {
     typedef void(__cdecl* t_fillcolorfunc) (uint8_t ry_level, uint8_t gu_level, uint8_t bv_level, uint8_t alpha, int32_t width, int32_t height, uint8_t* buf, int32_t stride);
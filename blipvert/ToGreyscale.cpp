@@ -28,174 +28,208 @@
 #include "ToGreyscale.h"
 #include "LookupTables.h"
 #include "CommonMacros.h"
+#include "CpuFeatures.h"
+#include "Staging.h"
 #include "blipvert.h"
 #include <cstring>
 
+#if defined(BLIPVERT_X86_SIMD)
+#include <immintrin.h>
+#endif
+
 using namespace blipvert;
 
-void blipvert::RGBA_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+// Converts the pixels of one row in place.
+typedef void(*t_greyscalerowfunc) (uint8_t* row, int32_t width);
+
+static void GreyscaleRow_RGBA(uint8_t* row, int32_t width)
 {
-    if (!stride)
+    while (width)
     {
-        uint32_t count = width * height;
-        while (count)
-        {
-            *reinterpret_cast<uint32_t*>(buf) = (*reinterpret_cast<uint32_t*>(buf) & 0xFF000000) | rgba_greyscale[static_cast<uint8_t>(((yr_table[buf[2]] + yg_table[buf[1]] + yb_table[buf[0]]) >> 15) + 16)];
-            buf += 4;
-            count--;
-        }
+        *reinterpret_cast<uint32_t*>(row) = (*reinterpret_cast<uint32_t*>(row) & 0xFF000000) | rgba_greyscale[static_cast<uint8_t>(((yr_table[row[2]] + yg_table[row[1]] + yb_table[row[0]]) >> 15) + 16)];
+        row += 4;
+        width--;
     }
-    else
+}
+
+static void GreyscaleRow_RGB32(uint8_t* row, int32_t width)
+{
+    while (width)
     {
-        while (height)
-        {
-            uint8_t* pdst = buf;
-            int32_t hcount = width;
-            while (hcount)
-            {
-                *reinterpret_cast<uint32_t*>(pdst) = (*reinterpret_cast<uint32_t*>(pdst) & 0xFF000000) | rgba_greyscale[static_cast<uint8_t>(((yr_table[pdst[2]] + yg_table[pdst[1]] + yb_table[pdst[0]]) >> 15) + 16)];
-                pdst += 4;
-                hcount--;
-            }
-
-            buf += stride;
-            height--;
-        }
+        *reinterpret_cast<uint32_t*>(row) = rgb32_greyscale[static_cast<uint8_t>(((yr_table[row[2]] + yg_table[row[1]] + yb_table[row[0]]) >> 15) + 16)];
+        row += 4;
+        width--;
     }
 }
 
-void blipvert::RGB32_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+static void GreyscaleRow_RGB24(uint8_t* row, int32_t width)
 {
-    if (!stride)
+    while (width)
     {
-        uint32_t count = width * height;
-        while (count)
-        {
-            *reinterpret_cast<uint32_t*>(buf) = rgb32_greyscale[static_cast<uint8_t>(((yr_table[buf[2]] + yg_table[buf[1]] + yb_table[buf[0]]) >> 15) + 16)];
-            buf += 4;
-            count--;
-        }
+        uint8_t Y = static_cast<uint8_t>(((yr_table[row[2]] + yg_table[row[1]] + yb_table[row[0]]) >> 15) + 16);
+        *row++ = Y;
+        *row++ = Y;
+        *row++ = Y;
+        width--;
     }
-    else
+}
+
+static void GreyscaleRow_RGB565(uint8_t* row, int32_t width)
+{
+    uint16_t* pdst = reinterpret_cast<uint16_t*>(row);
+    while (width)
     {
-        while (height)
-        {
-            uint8_t* pdst = buf;
-            int32_t hcount = width;
-            while (hcount)
-            {
-                *reinterpret_cast<uint32_t*>(pdst) = rgb32_greyscale[static_cast<uint8_t>(((yr_table[pdst[2]] + yg_table[pdst[1]] + yb_table[pdst[0]]) >> 15) + 16)];
-                pdst += 4;
-                hcount--;
-            }
-
-            buf += stride;
-            height--;
-        }
+        *pdst = rgb565_greyscale[((yr_table[UnpackRGB565Red(*pdst)] + yg_table[UnpackRGB565Green(*pdst)] + yb_table[UnpackRGB565Blue(*pdst)]) >> 15) + 16];
+        pdst++;
+        width--;
     }
 }
 
-void blipvert::RGB24_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+static void GreyscaleRow_RGB555(uint8_t* row, int32_t width)
 {
-    if (!stride)
+    uint16_t* pdst = reinterpret_cast<uint16_t*>(row);
+    while (width)
     {
-        uint32_t count = width * height;
-        while (count)
-        {
-            uint8_t Y = static_cast<uint8_t>(((yr_table[buf[2]] + yg_table[buf[1]] + yb_table[buf[0]]) >> 15) + 16);
-            *buf++ = Y;
-            *buf++ = Y;
-            *buf++ = Y;
-            count--;
-        }
+        *pdst = (*pdst & RGB555_ALPHA_MASK) | rgba555_greyscale[((yr_table[UnpackRGB555Red(*pdst)] + yg_table[UnpackRGB555Green(*pdst)] + yb_table[UnpackRGB555Blue(*pdst)]) >> 15) + 16];
+        pdst++;
+        width--;
     }
-    else
+}
+
+#if defined(BLIPVERT_X86_SIMD)
+static void GreyscaleRow_RGBA_SSE41(uint8_t* row, int32_t width);
+static void GreyscaleRow_RGBA_AVX2(uint8_t* row, int32_t width);
+static void GreyscaleRow_RGB32_SSE41(uint8_t* row, int32_t width);
+static void GreyscaleRow_RGB32_AVX2(uint8_t* row, int32_t width);
+static void GreyscaleRow_RGB24_SSE41(uint8_t* row, int32_t width);
+static void GreyscaleRow_RGB565_SSE41(uint8_t* row, int32_t width);
+static void GreyscaleRow_RGB555_SSE41(uint8_t* row, int32_t width);
+
+// Picks the fastest row function the processor supports. avx2 can be nullptr.
+static t_greyscalerowfunc SelectGreyscaleRow(t_greyscalerowfunc generic, t_greyscalerowfunc sse41, t_greyscalerowfunc avx2)
+{
+    const CpuFeatures& features = GetCpuFeatures();
+    if (avx2 != nullptr && features.avx2)
+        return avx2;
+    if (features.sse41)
+        return sse41;
+    return generic;
+}
+#endif
+
+// Runs the row function over the rows of slice thread_index of a single plane.
+static void GreyscaleSinglePlane(t_greyscalerowfunc row_func, uint8_t thread_index, uint8_t thread_count,
+    int32_t width, int32_t height, uint8_t* buf, int32_t stride)
+{
+    int32_t first_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, first_row, slice_height);
+
+    buf += stride * first_row;
+    for (int32_t y = 0; y < slice_height; y++)
     {
-        while (height)
-        {
-            uint8_t* pdst = buf;
-            int32_t hcount = width;
-            while (hcount)
-            {
-                uint8_t Y = static_cast<uint8_t>(((yr_table[pdst[2]] + yg_table[pdst[1]] + yb_table[pdst[0]]) >> 15) + 16);
-                *pdst++ = Y;
-                *pdst++ = Y;
-                *pdst++ = Y;
-                hcount--;
-            }
-
-            buf += stride;
-            height--;
-        }
+        row_func(buf, width);
+        buf += stride;
     }
 }
 
-void blipvert::RGB565_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+// Zeroes the rows of slice thread_index of a chroma plane. A plane without padding is one memset.
+static void ClearPlaneSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* plane, int32_t stride)
 {
-    if (!stride)
+    int32_t first_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, first_row, slice_height);
+
+    plane += stride * first_row;
+    if (stride == width)
     {
-        uint16_t* pdst = reinterpret_cast<uint16_t*>(buf);
-        uint32_t count = width * height;
-        while (count)
-        {
-            *pdst = rgb565_greyscale[((yr_table[UnpackRGB565Red(*pdst)] +  yg_table[UnpackRGB565Green(*pdst)] +  yb_table[UnpackRGB565Blue(*pdst)]) >> 15) + 16];
-            pdst++;
-            count--;
-        }
+        memset(plane, 0, width * slice_height);
     }
     else
     {
-        while (height)
+        for (int32_t y = 0; y < slice_height; y++)
         {
-            uint16_t* pdst = reinterpret_cast<uint16_t*>(buf);
-            int32_t hcount = width;
-            while (hcount)
-            {
-                *pdst = rgb565_greyscale[((yr_table[UnpackRGB565Red(*pdst)] +  yg_table[UnpackRGB565Green(*pdst)] +  yb_table[UnpackRGB565Blue(*pdst)]) >> 15) + 16];
-                pdst++;
-                hcount--;
-            }
-
-            buf += stride;
-            height--;
+            memset(plane, 0, width);
+            plane += stride;
         }
     }
 }
 
-void blipvert::RGB555_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+// Zeroes the chroma bytes of the 32-bit words in slice thread_index of a packed format, keeping the bytes in
+// luma_mask. The words don't depend on each other, so the compiler vectorizes the inner loop.
+static void ClearChromaWordsSlice(uint8_t thread_index, uint8_t thread_count, int32_t words, int32_t height, uint8_t* buf, int32_t stride, uint32_t luma_mask)
 {
-    if (!stride)
-    {
-        uint16_t* pdst = reinterpret_cast<uint16_t*>(buf);
-        uint32_t count = width * height;
-        while (count)
-        {
-            *pdst = (*reinterpret_cast<uint16_t*>(buf) & RGB555_ALPHA_MASK) | rgba555_greyscale[((yr_table[UnpackRGB555Red(*pdst)] +  yg_table[UnpackRGB555Green(*pdst)] +  yb_table[UnpackRGB555Blue(*pdst)]) >> 15) + 16];
-            pdst++;
-            count--;
-        }
-    }
-    else
+    int32_t first_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, first_row, slice_height);
+
+    buf += stride * first_row;
+    for (int32_t y = 0; y < slice_height; y++)
     {
-        while (height)
+        uint32_t* pdst = reinterpret_cast<uint32_t*>(buf);
+        for (int32_t x = 0; x < words; x++)
         {
-            uint16_t* pdst = reinterpret_cast<uint16_t*>(buf);
-            int32_t hcount = width;
-            while (hcount)
-            {
-                *pdst = (*reinterpret_cast<uint16_t*>(buf) & RGB555_ALPHA_MASK) | rgba555_greyscale[((yr_table[UnpackRGB555Red(*pdst)] +  yg_table[UnpackRGB555Green(*pdst)] + yb_table[UnpackRGB555Blue(*pdst)]) >> 15) + 16];
-                pdst++;
-                hcount--;
-            }
-
-            buf += stride;
-            height--;
+            pdst[x] &= luma_mask;
         }
+
+        buf += stride;
     }
 }
 
-void Palletized_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette, uint16_t num_colors)
+#if defined(BLIPVERT_X86_SIMD)
+#define GREYSCALE_ROW(format) SelectGreyscaleRow(GreyscaleRow_##format, GreyscaleRow_##format##_SSE41, nullptr)
+#define GREYSCALE_ROW_AVX2(format) SelectGreyscaleRow(GreyscaleRow_##format, GreyscaleRow_##format##_SSE41, GreyscaleRow_##format##_AVX2)
+#else
+#define GREYSCALE_ROW(format) GreyscaleRow_##format
+#define GREYSCALE_ROW_AVX2(format) GreyscaleRow_##format
+#endif
+
+void blipvert::RGBA_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
+{
+    if (!stride)
+        stride = width * 4;
+
+    GreyscaleSinglePlane(GREYSCALE_ROW_AVX2(RGBA), thread_index, thread_count, width, height, buf, stride);
+}
+
+void blipvert::RGB32_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
+{
+    if (!stride)
+        stride = width * 4;
+
+    GreyscaleSinglePlane(GREYSCALE_ROW_AVX2(RGB32), thread_index, thread_count, width, height, buf, stride);
+}
+
+void blipvert::RGB24_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
+{
+    if (!stride)
+        stride = width * 3;
+
+    GreyscaleSinglePlane(GREYSCALE_ROW(RGB24), thread_index, thread_count, width, height, buf, stride);
+}
+
+void blipvert::RGB565_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
+{
+    if (!stride)
+        stride = width * 2;
+
+    GreyscaleSinglePlane(GREYSCALE_ROW(RGB565), thread_index, thread_count, width, height, buf, stride);
+}
+
+void blipvert::RGB555_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
 {
+    if (!stride)
+        stride = width * 2;
+
+    GreyscaleSinglePlane(GREYSCALE_ROW(RGB555), thread_index, thread_count, width, height, buf, stride);
+}
+
+// Only the palette changes, so the first slice does all of the work.
+static void Palletized_to_Greyscale(uint8_t thread_index, xRGBQUAD* in_palette, uint16_t num_colors)
+{
+    if (thread_index != 0)
+        return;
+
     for (uint16_t index = 0; index < num_colors; index++)
     {
         uint8_t Y = static_cast<uint8_t>(((yr_table[in_palette[index].rgbRed] + \
@@ -208,94 +242,59 @@ void Palletized_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32
     }
 }
 
-void blipvert::RGB8_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::RGB8_to_GreyscaleSlice(uint8_t thread_index, uint8_t /*thread_count*/, int32_t /*width*/, int32_t /*height*/, uint8_t* /*buf*/, int32_t /*stride*/, xRGBQUAD* in_palette)
 {
-    Palletized_to_Greyscale(width, height, buf, stride, in_palette, 256);
+    Palletized_to_Greyscale(thread_index, in_palette, 256);
 }
 
-void blipvert::RGB4_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::RGB4_to_GreyscaleSlice(uint8_t thread_index, uint8_t /*thread_count*/, int32_t /*width*/, int32_t /*height*/, uint8_t* /*buf*/, int32_t /*stride*/, xRGBQUAD* in_palette)
 {
-    Palletized_to_Greyscale(width, height, buf, stride, in_palette, 16);
+    Palletized_to_Greyscale(thread_index, in_palette, 16);
 }
 
-void blipvert::RGB1_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::RGB1_to_GreyscaleSlice(uint8_t thread_index, uint8_t /*thread_count*/, int32_t /*width*/, int32_t /*height*/, uint8_t* /*buf*/, int32_t /*stride*/, xRGBQUAD* in_palette)
 {
-    Palletized_to_Greyscale(width, height, buf, stride, in_palette, 2);
+    Palletized_to_Greyscale(thread_index, in_palette, 2);
 }
 
-
-void PackedY422_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, int32_t out_u, int32_t out_v)
+void blipvert::AYUV_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
 {
     if (!stride)
-        stride = width * 2;
+        stride = width * 4;
 
-    for (int32_t y = 0; y < height; y++)
-    {
-        uint8_t* pdst = buf;
-        for (int32_t x = 0; x < width; x += 2)
-        {
-            pdst[out_u] = 0;
-            pdst[out_v] = 0;
-            pdst += 4;
-        }
-
-        buf += stride;
-    }
+    ClearChromaWordsSlice(thread_index, thread_count, width, height, buf, stride, 0xFFFF0000);
 }
 
-
-void blipvert::AYUV_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+// luma_mask keeps the two Y bytes of each little-endian macropixel.
+static void PackedY422_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, uint32_t luma_mask)
 {
     if (!stride)
-    {
-        uint32_t count = width * height;
-        while (count)
-        {
-            *reinterpret_cast<uint32_t*>(buf) = (*reinterpret_cast<uint32_t*>(buf) & 0xFFFF0000);
-            buf += 4;
-            count--;
-        }
-    }
-    else
-    {
-        while (height)
-        {
-            uint8_t* pdst = buf;
-            int32_t hcount = width;
-            while (hcount)
-            {
-                *reinterpret_cast<uint32_t*>(pdst) = (*reinterpret_cast<uint32_t*>(pdst) & 0xFFFF0000);
-                pdst += 4;
-                hcount--;
-            }
-
-            buf += stride;
-            height--;
-        }
-    }
+        stride = width * 2;
+
+    ClearChromaWordsSlice(thread_index, thread_count, (width + 1) / 2, height, buf, stride, luma_mask);
 }
 
-void blipvert::UYVY_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::UYVY_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
 {
-    PackedY422_to_Greyscale(width, height, buf, stride, 0, 2);
+    PackedY422_to_GreyscaleSlice(thread_index, thread_count, width, height, buf, stride, 0xFF00FF00);
 }
 
-void blipvert::YVYU_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::YVYU_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
 {
-    PackedY422_to_Greyscale(width, height, buf, stride, 3, 1);
+    PackedY422_to_GreyscaleSlice(thread_index, thread_count, width, height, buf, stride, 0x00FF00FF);
 }
 
-void blipvert::VYUY_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::VYUY_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
 {
-    PackedY422_to_Greyscale(width, height, buf, stride, 2, 0);
+    PackedY422_to_GreyscaleSlice(thread_index, thread_count, width, height, buf, stride, 0xFF00FF00);
 }
 
-void blipvert::YUY2_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::YUY2_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
 {
-    PackedY422_to_Greyscale(width, height, buf, stride, 1, 3);
+    PackedY422_to_GreyscaleSlice(thread_index, thread_count, width, height, buf, stride, 0x00FF00FF);
 }
 
-void PlanarYUV_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, int32_t decimation)
+static void PlanarYUV_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, int32_t decimation)
 {
     int32_t out_uv_width = width / decimation;
     int32_t out_uv_height = height / decimation;
@@ -314,25 +313,11 @@ void PlanarYUV_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t
 
     uint8_t* out_uplane = buf + (out_y_stride * height);
     uint8_t* out_vplane = out_uplane + (out_uv_stride * out_uv_height);
-    if (out_y_stride == width)
-    {
-        memset(out_uplane, 0, out_uv_stride * out_uv_height);
-        memset(out_vplane, 0, out_uv_stride * out_uv_height);
-    }
-    else
-    {
-        for (int32_t y = 0; y < out_uv_height; y++)
-        {
-            memset(out_uplane, 0, out_uv_width);
-            memset(out_vplane, 0, out_uv_width);
-            out_uplane += out_uv_stride;
-            out_vplane += out_uv_stride;
-        }
-    }
+    ClearPlaneSlice(thread_index, thread_count, out_uv_width, out_uv_height, out_uplane, out_uv_stride);
+    ClearPlaneSlice(thread_index, thread_count, out_uv_width, out_uv_height, out_vplane, out_uv_stride);
 }
 
-
-void IMCx_to_Greyscale(int32_t width, int32_t height,
+static void IMCx_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height,
     uint8_t* buf, int32_t stride, bool interlaced)
 {
     int32_t uv_width = width / 2;
@@ -356,64 +341,61 @@ void IMCx_to_Greyscale(int32_t width, int32_t height,
         uplane = buf + (Align16(voffset + uv_height) * stride);
     }
 
-    for (int32_t y = 0; y < uv_height; y++)
-    {
-        memset(uplane, 0, uv_width);
-        memset(vplane, 0, uv_width);
-        uplane += stride;
-        vplane += stride;
-    }
+    ClearPlaneSlice(thread_index, thread_count, uv_width, uv_height, uplane, stride);
+    ClearPlaneSlice(thread_index, thread_count, uv_width, uv_height, vplane, stride);
 }
 
-void blipvert::IMC1_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::IMC1_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
 {
-    IMCx_to_Greyscale(width, height, buf, stride, false);
+    IMCx_to_GreyscaleSlice(thread_index, thread_count, width, height, buf, stride, false);
 }
 
-void blipvert::IMC2_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::IMC2_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
 {
-    IMCx_to_Greyscale(width, height, buf, stride, true);
+    IMCx_to_GreyscaleSlice(thread_index, thread_count, width, height, buf, stride, true);
 }
 
-void blipvert::IMC3_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::IMC3_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
 {
-    IMCx_to_Greyscale(width, height, buf, stride, false);
+    IMCx_to_GreyscaleSlice(thread_index, thread_count, width, height, buf, stride, false);
 }
 
-void blipvert::IMC4_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::IMC4_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
 {
-    IMCx_to_Greyscale(width, height, buf, stride, true);
+    IMCx_to_GreyscaleSlice(thread_index, thread_count, width, height, buf, stride, true);
 }
 
-void blipvert::I420_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::I420_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
 {
-    PlanarYUV_to_Greyscale(width, height, buf, stride, 2);
+    PlanarYUV_to_GreyscaleSlice(thread_index, thread_count, width, height, buf, stride, 2);
 }
 
-void blipvert::YV12_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::YV12_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
 {
-    PlanarYUV_to_Greyscale(width, height, buf, stride, 2);
+    PlanarYUV_to_GreyscaleSlice(thread_index, thread_count, width, height, buf, stride, 2);
 }
 
-
-void blipvert::YVU9_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::YVU9_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
 {
-    PlanarYUV_to_Greyscale(width, height, buf, stride, 4);
+    PlanarYUV_to_GreyscaleSlice(thread_index, thread_count, width, height, buf, stride, 4);
 }
 
-
-void blipvert::YUV9_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::YUV9_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
 {
-    PlanarYUV_to_Greyscale(width, height, buf, stride, 4);
+    PlanarYUV_to_GreyscaleSlice(thread_index, thread_count, width, height, buf, stride, 4);
 }
 
-
-void blipvert::IYU1_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::IYU1_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
 {
     if (!stride)
         stride = width * 12 / 8;
 
-    while (height)
+    int32_t first_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, first_row, slice_height);
+
+    buf += stride * first_row;
+    while (slice_height)
     {
         uint8_t* pdst = buf;
         int32_t hcount = width;
@@ -426,16 +408,21 @@ void blipvert::IYU1_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, i
         }
 
         buf += stride;
-        height--;
+        slice_height--;
     }
 }
 
-void blipvert::IYU2_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::IYU2_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
 {
     if (!stride)
         stride = width * 3;
 
-    while (height)
+    int32_t first_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, first_row, slice_height);
+
+    buf += stride * first_row;
+    while (slice_height)
     {
         uint8_t* pdst = buf;
         int32_t hcount = width;
@@ -447,17 +434,21 @@ void blipvert::IYU2_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, i
             hcount--;
         }
         buf += stride;
-        height--;
+        slice_height--;
     }
 }
 
-
-void blipvert::Y41P_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::Y41P_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
 {
     if (!stride)
         stride = width / 8 * 12;
 
-    while (height)
+    int32_t first_row;
+    int32_t slice_height;
+    GetSliceRows(thread_index, thread_count, height, first_row, slice_height);
+
+    buf += stride * first_row;
+    while (slice_height)
     {
         uint8_t* pdst = buf;
         int32_t hcount = width;
@@ -472,31 +463,19 @@ void blipvert::Y41P_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, i
         }
 
         buf += stride;
-        height--;
+        slice_height--;
     }
 }
 
-void blipvert::CLJR_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::CLJR_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
 {
     if (!stride)
         stride = width;
 
-    while (height)
-    {
-        uint32_t* pdst = reinterpret_cast<uint32_t*>(buf);
-        int32_t hcount = width;
-        while (hcount)
-        {
-            *pdst++ = *pdst & 0xFFFFF000;
-            hcount -= 4;
-        }
-
-        buf += stride;
-        height--;
-    }
+    ClearChromaWordsSlice(thread_index, thread_count, width / 4, height, buf, stride, 0xFFFFF000);
 }
 
-void NVx_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride)
+static void NVx_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride)
 {
     int32_t uv_height = height / 2;
 
@@ -504,46 +483,34 @@ void NVx_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stri
         stride = width;
 
     uint8_t* uvplane = buf + (stride * height);
-
-    if (stride == width)
-    {
-        memset(uvplane, 0, width * uv_height);
-    }
-    else
-    {
-        for (int32_t y = 0; y < uv_height; y++)
-        {
-            memset(uvplane, 0, width);
-            uvplane += stride;
-        }
-    }
+    ClearPlaneSlice(thread_index, thread_count, width, uv_height, uvplane, stride);
 }
 
-void blipvert::NV12_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::NV12_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
 {
-    NVx_to_Greyscale(width, height, buf, stride);
+    NVx_to_GreyscaleSlice(thread_index, thread_count, width, height, buf, stride);
 }
 
-void blipvert::NV21_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::NV21_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
 {
-    NVx_to_Greyscale(width, height, buf, stride);
+    NVx_to_GreyscaleSlice(thread_index, thread_count, width, height, buf, stride);
 }
 
-void blipvert::Y42T_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::Y42T_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
 {
-    PackedY422_to_Greyscale(width, height, buf, stride, 0, 2);
+    PackedY422_to_GreyscaleSlice(thread_index, thread_count, width, height, buf, stride, 0xFF00FF00);
 }
 
-void blipvert::Y41T_to_Greyscale(int32_t  width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::Y41T_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
 {
-    Y41P_to_Greyscale(width, height, buf, stride);
+    Y41P_to_GreyscaleSlice(thread_index, thread_count, width, height, buf, stride, in_palette);
 }
 
-void blipvert::YV16_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+void blipvert::YV16_to_GreyscaleSlice(uint8_t thread_index, uint8_t thread_count, int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* /*in_palette*/)
 {
     int32_t uv_width = width / 2;
 
-    int16_t y_stride, uv_stride;
+    int32_t y_stride, uv_stride;
     if (stride <= width)
     {
         y_stride = width;
@@ -557,20 +524,338 @@ void blipvert::YV16_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, in
 
     uint8_t* vplane = buf + (y_stride * height);
     uint8_t* uplane = vplane + (uv_stride * height);
+    ClearPlaneSlice(thread_index, thread_count, uv_width, height, vplane, uv_stride);
+    ClearPlaneSlice(thread_index, thread_count, uv_width, height, uplane, uv_stride);
+}
+
+//
+// Whole frame versions, a single slice covering the bitmap.
+//
+
+void blipvert::RGBA_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    RGBA_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
 
-    if (y_stride == width)
+void blipvert::RGB32_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    RGB32_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::RGB24_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    RGB24_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::RGB565_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    RGB565_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::RGB555_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    RGB555_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::RGB8_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    RGB8_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::RGB4_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    RGB4_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::RGB1_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    RGB1_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::AYUV_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    AYUV_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::UYVY_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    UYVY_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::YVYU_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    YVYU_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::VYUY_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    VYUY_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::YUY2_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    YUY2_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::I420_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    I420_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::YV12_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    YV12_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::YVU9_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    YVU9_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::YUV9_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    YUV9_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::IYU1_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    IYU1_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::IYU2_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    IYU2_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::Y41P_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    Y41P_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::CLJR_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    CLJR_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::IMC1_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    IMC1_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::IMC2_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    IMC2_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::IMC3_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    IMC3_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::IMC4_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    IMC4_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::NV12_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    NV12_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::NV21_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    NV21_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::Y42T_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    Y42T_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::Y41T_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    Y41T_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+void blipvert::YV16_to_Greyscale(int32_t width, int32_t height, uint8_t* buf, int32_t stride, xRGBQUAD* in_palette)
+{
+    YV16_to_GreyscaleSlice(0, 1, width, height, buf, stride, in_palette);
+}
+
+#if defined(BLIPVERT_X86_SIMD)
+
+//
+// SSE4.1 and AVX2 RGB luma
+//
+// The pixels are widened to 16-bit B, G, R, 1 and multiplied with pmaddwd against the luma coefficients, the
+// same way as the RGB to YUV kernels. See YUV_COEFF_YR in CommonMacros.h. The result can be 1 away from the
+// lookup tables. The columns left over go to the generic row function.
+//
+
+// Computes Y for the 4 BGR1 pixels in px. The results are 32-bit.
+BLIPVERT_TARGET_SSE41 static inline __m128i BGR1toY_SSE41(__m128i px)
+{
+    const __m128i coeff = _mm_setr_epi16(YUV_COEFF_YB, YUV_COEFF_YG, YUV_COEFF_YR, YUV_BIAS_Y, YUV_COEFF_YB, YUV_COEFF_YG, YUV_COEFF_YR, YUV_BIAS_Y);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(px, zero), coeff);
+    __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(px, zero), coeff);
+    return _mm_add_epi32(_mm_srai_epi32(_mm_hadd_epi32(lo, hi), 15), _mm_set1_epi32(16));
+}
+
+// Replaces the RGB of each 32-bit pixel with its Y, 4 pixels per pass. keep_alpha keeps the original alpha, or
+// else the pixels are made opaque like rgb32_greyscale.
+BLIPVERT_TARGET_SSE41 static inline void GreyscaleRow32_SSE41(uint8_t* row, int32_t width, bool keep_alpha, t_greyscalerowfunc generic)
+{
+    const __m128i rgb_mask = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i one = _mm_set1_epi32(0x01000000);
+    const __m128i opaque = _mm_set1_epi32(static_cast<int32_t>(0xFF000000));
+    const __m128i spread = _mm_setr_epi8(0, 0, 0, -128, 4, 4, 4, -128, 8, 8, 8, -128, 12, 12, 12, -128);
+
+    for (; width >= 4; width -= 4)
     {
-        memset(vplane, 0, uv_stride * height);
-        memset(uplane, 0, uv_stride * height);
+        __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row));
+        __m128i y = BGR1toY_SSE41(_mm_or_si128(_mm_and_si128(px, rgb_mask), one));
+        __m128i alpha = keep_alpha ? _mm_andnot_si128(rgb_mask, px) : opaque;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row), _mm_or_si128(_mm_shuffle_epi8(y, spread), alpha));
+        row += 16;
     }
-    else
+
+    generic(row, width);
+}
+
+BLIPVERT_TARGET_SSE41 static void GreyscaleRow_RGBA_SSE41(uint8_t* row, int32_t width)
+{
+    GreyscaleRow32_SSE41(row, width, true, GreyscaleRow_RGBA);
+}
+
+BLIPVERT_TARGET_SSE41 static void GreyscaleRow_RGB32_SSE41(uint8_t* row, int32_t width)
+{
+    GreyscaleRow32_SSE41(row, width, false, GreyscaleRow_RGB32);
+}
+
+// 16 pixels per pass. The 48 bytes are realigned into 4 pixel groups and the 16 Y bytes are spread back out
+// into 3 vectors of B, G, R triplets.
+BLIPVERT_TARGET_SSE41 static void GreyscaleRow_RGB24_SSE41(uint8_t* row, int32_t width)
+{
+    const __m128i to_bgr1 = _mm_setr_epi8(0, 1, 2, -128, 3, 4, 5, -128, 6, 7, 8, -128, 9, 10, 11, -128);
+    const __m128i one = _mm_set1_epi32(0x01000000);
+    const __m128i spread0 = _mm_setr_epi8(0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5);
+    const __m128i spread1 = _mm_setr_epi8(5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10);
+    const __m128i spread2 = _mm_setr_epi8(10, 11, 11, 11, 12, 12, 12, 13, 13, 13, 14, 14, 14, 15, 15, 15);
+
+    for (; width >= 16; width -= 16)
     {
-        for (int32_t y = 0; y < height; y++)
-        {
-            memset(uplane, 0, uv_width);
-            memset(vplane, 0, uv_width);
-            uplane += uv_stride;
-            vplane += uv_stride;
-        }
+        __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row));
+        __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 16));
+        __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 32));
+
+        __m128i y0 = BGR1toY_SSE41(_mm_or_si128(_mm_shuffle_epi8(v0, to_bgr1), one));
+        __m128i y1 = BGR1toY_SSE41(_mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(v1, v0, 12), to_bgr1), one));
+        __m128i y2 = BGR1toY_SSE41(_mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(v2, v1, 8), to_bgr1), one));
+        __m128i y3 = BGR1toY_SSE41(_mm_or_si128(_mm_shuffle_epi8(_mm_srli_si128(v2, 4), to_bgr1), one));
+        __m128i y = _mm_packus_epi16(_mm_packs_epi32(y0, y1), _mm_packs_epi32(y2, y3));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row), _mm_shuffle_epi8(y, spread0));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row + 16), _mm_shuffle_epi8(y, spread1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row + 32), _mm_shuffle_epi8(y, spread2));
+        row += 48;
+    }
+
+    GreyscaleRow_RGB24(row, width);
+}
+
+// Computes Y for 8 pixels from their 16-bit red, green and blue. The results are 16-bit.
+BLIPVERT_TARGET_SSE41 static inline __m128i RGB16toY_SSE41(__m128i red, __m128i green, __m128i blue)
+{
+    const __m128i bg_coeff = _mm_setr_epi16(YUV_COEFF_YB, YUV_COEFF_YG, YUV_COEFF_YB, YUV_COEFF_YG, YUV_COEFF_YB, YUV_COEFF_YG, YUV_COEFF_YB, YUV_COEFF_YG);
+    const __m128i r1_coeff = _mm_setr_epi16(YUV_COEFF_YR, YUV_BIAS_Y, YUV_COEFF_YR, YUV_BIAS_Y, YUV_COEFF_YR, YUV_BIAS_Y, YUV_COEFF_YR, YUV_BIAS_Y);
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i offset = _mm_set1_epi32(16);
+
+    __m128i lo = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(blue, green), bg_coeff), _mm_madd_epi16(_mm_unpacklo_epi16(red, one), r1_coeff));
+    __m128i hi = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(blue, green), bg_coeff), _mm_madd_epi16(_mm_unpackhi_epi16(red, one), r1_coeff));
+    return _mm_packs_epi32(_mm_add_epi32(_mm_srai_epi32(lo, 15), offset), _mm_add_epi32(_mm_srai_epi32(hi, 15), offset));
+}
+
+BLIPVERT_TARGET_SSE41 static void GreyscaleRow_RGB565_SSE41(uint8_t* row, int32_t width)
+{
+    const __m128i mask_f8 = _mm_set1_epi16(0xF8);
+    const __m128i mask_fc = _mm_set1_epi16(0xFC);
+
+    for (; width >= 8; width -= 8)
+    {
+        __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row));
+        __m128i y = RGB16toY_SSE41(_mm_and_si128(_mm_srli_epi16(px, 8), mask_f8),
+            _mm_and_si128(_mm_srli_epi16(px, 3), mask_fc),
+            _mm_and_si128(_mm_slli_epi16(px, 3), mask_f8));
+
+        __m128i grey = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(y, mask_f8), 8), _mm_slli_epi16(_mm_and_si128(y, mask_fc), 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row), _mm_or_si128(grey, _mm_srli_epi16(y, 3)));
+        row += 16;
+    }
+
+    GreyscaleRow_RGB565(row, width);
+}
+
+BLIPVERT_TARGET_SSE41 static void GreyscaleRow_RGB555_SSE41(uint8_t* row, int32_t width)
+{
+    const __m128i mask_f8 = _mm_set1_epi16(0xF8);
+    const __m128i alpha_mask = _mm_set1_epi16(static_cast<int16_t>(RGB555_ALPHA_MASK));
+
+    for (; width >= 8; width -= 8)
+    {
+        __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row));
+        __m128i y = RGB16toY_SSE41(_mm_and_si128(_mm_srli_epi16(px, 7), mask_f8),
+            _mm_and_si128(_mm_srli_epi16(px, 2), mask_f8),
+            _mm_and_si128(_mm_slli_epi16(px, 3), mask_f8));
+
+        __m128i y5 = _mm_and_si128(y, mask_f8);
+        __m128i grey = _mm_or_si128(_mm_slli_epi16(y5, 7), _mm_slli_epi16(y5, 2));
+        grey = _mm_or_si128(grey, _mm_srli_epi16(y5, 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row), _mm_or_si128(grey, _mm_and_si128(px, alpha_mask)));
+        row += 16;
+    }
+
+    GreyscaleRow_RGB555(row, width);
+}
+
+// AVX2 version of GreyscaleRow32_SSE41, 8 pixels per pass. The unpack, madd and hadd all stay within the
+// 128-bit lanes, so each lane ends up with the Y of its own 4 pixels in order.
+BLIPVERT_TARGET_AVX2 static inline void GreyscaleRow32_AVX2(uint8_t* row, int32_t width, bool keep_alpha, t_greyscalerowfunc generic)
+{
+    const __m256i coeff = _mm256_setr_epi16(YUV_COEFF_YB, YUV_COEFF_YG, YUV_COEFF_YR, YUV_BIAS_Y, YUV_COEFF_YB, YUV_COEFF_YG, YUV_COEFF_YR, YUV_BIAS_Y,
+        YUV_COEFF_YB, YUV_COEFF_YG, YUV_COEFF_YR, YUV_BIAS_Y, YUV_COEFF_YB, YUV_COEFF_YG, YUV_COEFF_YR, YUV_BIAS_Y);
+    const __m256i rgb_mask = _mm256_set1_epi32(0x00FFFFFF);
+    const __m256i one = _mm256_set1_epi32(0x01000000);
+    const __m256i opaque = _mm256_set1_epi32(static_cast<int32_t>(0xFF000000));
+    const __m256i offset = _mm256_set1_epi32(16);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i spread = _mm256_setr_epi8(0, 0, 0, -128, 4, 4, 4, -128, 8, 8, 8, -128, 12, 12, 12, -128,
+        0, 0, 0, -128, 4, 4, 4, -128, 8, 8, 8, -128, 12, 12, 12, -128);
+
+    for (; width >= 8; width -= 8)
+    {
+        __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row));
+        __m256i bgr1 = _mm256_or_si256(_mm256_and_si256(px, rgb_mask), one);
+        __m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi8(bgr1, zero), coeff);
+        __m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi8(bgr1, zero), coeff);
+        __m256i y = _mm256_add_epi32(_mm256_srai_epi32(_mm256_hadd_epi32(lo, hi), 15), offset);
+        __m256i alpha = keep_alpha ? _mm256_andnot_si256(rgb_mask, px) : opaque;
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(row), _mm256_or_si256(_mm256_shuffle_epi8(y, spread), alpha));
+        row += 32;
     }
+
+    generic(row, width);
+}
+
+BLIPVERT_TARGET_AVX2 static void GreyscaleRow_RGBA_AVX2(uint8_t* row, int32_t width)
+{
+    GreyscaleRow32_AVX2(row, width, true, GreyscaleRow_RGBA);
 }
+
+BLIPVERT_TARGET_AVX2 static void GreyscaleRow_RGB32_AVX2(uint8_t* row, int32_t width)
+{
+    GreyscaleRow32_AVX2(row, width, false, GreyscaleRow_RGB32);
+}
+
+#endif
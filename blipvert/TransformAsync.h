@@ -0,0 +1,122 @@
+#pragma once
+
+//
+//  blipvert C++ library
+//
+//  MIT License
+//
+//  Copyright(c) 2021-2025 Don Jordan
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+//
+
+#include "TransformPlan.h"
+#include "ThreadPool.h"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <atomic>
+#include <coroutine>
+
+namespace blipvert
+{
+    //
+    // Awaitable frame transform for C++20 coroutines. co_await TransformAsync(plan, in_buf, out_buf) queues the
+    // frame's slices on the library's worker pool with SubmitSlices(), suspends the coroutine, and resumes it
+    // from the frame's done function. Each slice runs through ExecuteTransformPlanSlice() on the thread that picks
+    // it up, so it's staged on that thread's stack. The awaiter lives in the coroutine frame and the
+    // pool keeps the frame in one of its fixed slots, so nothing is allocated per frame.
+    //
+    // The coroutine carries on without suspending on the thread that awaited if the frame is already finished
+    // by then, which is always the case when the pool has no workers. Otherwise it's resumed on whichever thread
+    // finishes the last slice, see t_framedonefunc: a worker, or another thread that's inside a pool call and
+    // runs slices while it waits, such as one submitting a frame when the pool is full or one resizing or
+    // shutting down the pool. No lock of the pool's is held then, so the coroutine can await further frames or
+    // run RunSlices() and the Parallel functions, but until it has moved off that thread it must not call
+    // SetThreadPoolSize(), SetThreadPoolOptions() or ShutdownThreadPool(), which wait for the workers to exit.
+    // It also holds up the thread it was resumed on, so a reactor, or a coroutine with more than a little to
+    // do, should post itself to its own thread after the co_await. The plan and both buffers must stay valid
+    // until the co_await returns.
+    //
+    // Only available when the including code is built with C++20 coroutines; the library itself doesn't need them.
+    //
+    class TransformAwaiter
+    {
+    public:
+        TransformAwaiter(const TransformPlan& plan, uint8_t* in_buf, uint8_t* out_buf) :
+            plan(&plan),
+            in_buf(in_buf),
+            out_buf(out_buf),
+            waiting(),
+            arrived(false)
+        {
+        }
+
+        TransformAwaiter(const TransformAwaiter&) = delete;
+        TransformAwaiter& operator=(const TransformAwaiter&) = delete;
+
+        // A plan with no slices has nothing to run, so the coroutine doesn't suspend.
+        bool await_ready() const noexcept
+        {
+            return plan->thread_count == 0;
+        }
+
+        // The frame and this call race to the arrived flag. If the frame finishes first, which is always the case
+        // when the pool has no workers and SubmitSlices() runs it inline, the coroutine carries on without
+        // suspending; otherwise the frame's done callback resumes it.
+        bool await_suspend(std::coroutine_handle<> coroutine) noexcept
+        {
+            waiting = coroutine;
+            SubmitSlices(RunSlice, this, plan->thread_count, FinishFrame, in_buf);
+            return !arrived.exchange(true, std::memory_order_acq_rel);
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+
+    private:
+        static void __cdecl RunSlice(void* context, uint8_t slice_index)
+        {
+            TransformAwaiter* awaiter = static_cast<TransformAwaiter*>(context);
+            ExecuteTransformPlanSlice(*awaiter->plan, slice_index, awaiter->in_buf, awaiter->out_buf);
+        }
+
+        static void __cdecl FinishFrame(void* context)
+        {
+            TransformAwaiter* awaiter = static_cast<TransformAwaiter*>(context);
+            if (awaiter->arrived.exchange(true, std::memory_order_acq_rel))
+                awaiter->waiting.resume();
+        }
+
+        const TransformPlan* plan;
+        uint8_t* in_buf;
+        uint8_t* out_buf;
+        std::coroutine_handle<> waiting;
+        std::atomic<bool> arrived;
+    };
+
+    // Returns an awaitable that transforms a frame on the library's worker pool, see TransformAwaiter.
+    inline TransformAwaiter TransformAsync(const TransformPlan& plan, uint8_t* in_buf, uint8_t* out_buf)
+    {
+        return TransformAwaiter(plan, in_buf, out_buf);
+    }
+}
+
+#endif
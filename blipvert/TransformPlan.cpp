@@ -0,0 +1,306 @@
+//
+//  blipvert C++ library
+//
+//  MIT License
+//
+//  Copyright(c) 2021-2025 Don Jordan
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+//
+
+#include "pch.h"
+#include "TransformPlan.h"
+#include "ThreadPool.h"
+#include "Utilities.h"
+#include "CpuFeatures.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace blipvert;
+
+// The slices of a plan are staged against this address and later moved onto the real buffers.
+static const uintptr_t PlanBaseAddress = 0x10000000;
+
+static inline uint8_t* RebasePlanPointer(uint8_t* ptr, uint8_t* buf)
+{
+    if (ptr == nullptr)
+        return nullptr;
+
+    return buf + (reinterpret_cast<uintptr_t>(ptr) - PlanBaseAddress);
+}
+
+static inline void RebaseStage(Stage& stage, uint8_t* buf)
+{
+    stage.buf = RebasePlanPointer(stage.buf, buf);
+    stage.uplane = RebasePlanPointer(stage.uplane, buf);
+    stage.vplane = RebasePlanPointer(stage.vplane, buf);
+    stage.uvplane = RebasePlanPointer(stage.uvplane, buf);
+}
+
+// Leaves a plan with no transform and no slices, so running it does nothing.
+static void ClearTransformPlan(TransformPlan& plan)
+{
+    plan.transform = nullptr;
+    plan.thread_count = 0;
+    plan.column_count = 1;
+    plan.stream_stores = false;
+    plan.stages.clear();
+}
+
+// Builds a plan of row_count slices, each cut into column_count tiles. The tiles are stored row by row, so the
+// plan's thread_count is the number of tiles.
+static bool BuildTransformPlan(TransformPlan& plan, const MediaFormatID& inFormat, const MediaFormatID& outFormat,
+    int32_t width, int32_t height, int32_t in_stride, int32_t out_stride,
+    bool in_flipped, bool out_flipped, uint8_t row_count, uint8_t column_count,
+    xRGBQUAD* in_palette, xRGBQUAD* out_palette, uint16_t in_palette_entries)
+{
+    ClearTransformPlan(plan);
+    plan.in_format = GetFormatIndex(inFormat);
+    plan.out_format = GetFormatIndex(outFormat);
+
+    t_transformfunc transform = FindVideoTransform(plan.in_format, plan.out_format);
+    t_stagetransformfunc pstage_in = FindTransformStage(plan.in_format);
+    t_stagetransformfunc pstage_out = FindTransformStage(plan.out_format);
+    if (transform == nullptr || pstage_in == nullptr || pstage_out == nullptr)
+        return false;
+
+    plan.transform = transform;
+
+    plan.width = width;
+    plan.height = height;
+    plan.in_stride = in_stride;
+    plan.out_stride = out_stride;
+    plan.in_flipped = in_flipped;
+    plan.out_flipped = out_flipped;
+    plan.thread_count = static_cast<uint8_t>(row_count * column_count);
+    plan.column_count = column_count;
+    plan.stream_stores = CalculateBufferSize(outFormat, width, height, out_stride) > GetStreamingStoreThreshold();
+
+    uint8_t* base = reinterpret_cast<uint8_t*>(PlanBaseAddress);
+    plan.stages.resize(plan.thread_count);
+    for (uint8_t index = 0; index < plan.thread_count; index++)
+    {
+        uint8_t row = index / column_count;
+        TransformStage& stage = plan.stages[index];
+        pstage_in(&stage.inStage, row, row_count, width, height, base, in_stride, in_flipped, in_palette);
+        pstage_out(&stage.outStage, row, row_count, width, height, base, out_stride, out_flipped, out_palette);
+        if (in_palette != nullptr && in_palette_entries != 0)
+            stage.inStage.palette_entries = in_palette_entries;
+
+        if (column_count > 1)
+        {
+            int32_t first_column;
+            int32_t tile_width;
+            GetTileColumns(index % column_count, column_count, width, first_column, tile_width);
+            if (!StageTileColumns(&stage.inStage, first_column, tile_width) ||
+                !StageTileColumns(&stage.outStage, first_column, tile_width))
+            {
+                ClearTransformPlan(plan);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool blipvert::CreateTransformPlan(TransformPlan& plan, const MediaFormatID& inFormat, const MediaFormatID& outFormat,
+    int32_t width, int32_t height, int32_t in_stride, int32_t out_stride,
+    bool in_flipped, bool out_flipped, uint8_t thread_count,
+    xRGBQUAD* in_palette, xRGBQUAD* out_palette, uint16_t in_palette_entries)
+{
+    if (thread_count < 1)
+        thread_count = 1;
+
+    uint8_t row_count = static_cast<uint8_t>(GetCommonMaxThreadCount(inFormat, outFormat, width, height, thread_count));
+    return BuildTransformPlan(plan, inFormat, outFormat, width, height, in_stride, out_stride, in_flipped, out_flipped,
+        row_count, 1, in_palette, out_palette, in_palette_entries);
+}
+
+bool blipvert::CreateTiledTransformPlan(TransformPlan& plan, const MediaFormatID& inFormat, const MediaFormatID& outFormat,
+    int32_t width, int32_t height, int32_t in_stride, int32_t out_stride,
+    bool in_flipped, bool out_flipped, uint8_t tile_count,
+    xRGBQUAD* in_palette, xRGBQUAD* out_palette, uint16_t in_palette_entries)
+{
+    uint8_t row_count;
+    uint8_t column_count;
+    GetTileShape(inFormat, outFormat, width, height, tile_count, row_count, column_count);
+    return BuildTransformPlan(plan, inFormat, outFormat, width, height, in_stride, out_stride, in_flipped, out_flipped,
+        row_count, column_count, in_palette, out_palette, in_palette_entries);
+}
+
+void blipvert::StageTransformPlan(const TransformPlan& plan, uint8_t thread_index, uint8_t* in_buf, uint8_t* out_buf, TransformStage& result)
+{
+    result = plan.stages[thread_index];
+    RebaseStage(result.inStage, in_buf);
+    RebaseStage(result.outStage, out_buf);
+    result.outStage.stream_stores = plan.stream_stores;
+}
+
+void blipvert::ExecuteTransformPlanSlice(const TransformPlan& plan, uint8_t thread_index, uint8_t* in_buf, uint8_t* out_buf)
+{
+    TransformStage stage;
+    StageTransformPlan(plan, thread_index, in_buf, out_buf, stage);
+    plan.transform(&stage.inStage, &stage.outStage);
+}
+
+void blipvert::ExecuteTransformPlan(const TransformPlan& plan, uint8_t* in_buf, uint8_t* out_buf)
+{
+    for (uint8_t index = 0; index < plan.thread_count; index++)
+    {
+        ExecuteTransformPlanSlice(plan, index, in_buf, out_buf);
+    }
+}
+
+typedef struct {
+    const TransformPlan* plan;
+    uint8_t* in_buf;
+    uint8_t* out_buf;
+} PlanFrame;
+
+static void __cdecl ExecutePlanFrameSlice(void* context, uint8_t slice_index)
+{
+    PlanFrame* frame = static_cast<PlanFrame*>(context);
+    ExecuteTransformPlanSlice(*frame->plan, slice_index, frame->in_buf, frame->out_buf);
+}
+
+void blipvert::ExecuteTransformPlanParallel(const TransformPlan& plan, uint8_t* in_buf, uint8_t* out_buf)
+{
+    PlanFrame frame = { &plan, in_buf, out_buf };
+    RunSlicesNear(ExecutePlanFrameSlice, &frame, plan.thread_count, in_buf);
+}
+
+static void __cdecl ExecuteJobSlice(void* context, uint8_t slice_index)
+{
+    TransformJob* job = static_cast<TransformJob*>(context);
+    ExecuteTransformPlanSlice(*job->plan, slice_index, job->in_buf, job->out_buf);
+}
+
+static void __cdecl FinishJob(void* context)
+{
+    TransformJob* job = static_cast<TransformJob*>(context);
+    if (job->done != nullptr)
+        job->done(job->context);
+}
+
+void blipvert::SubmitTransform(const TransformPlan& plan, uint8_t* in_buf, uint8_t* out_buf, TransformJob& job,
+    t_transformdonefunc done, void* context)
+{
+    job.plan = &plan;
+    job.in_buf = in_buf;
+    job.out_buf = out_buf;
+    job.done = done;
+    job.context = context;
+    SubmitSlices(ExecuteJobSlice, &job, plan.thread_count, FinishJob, in_buf);
+}
+
+typedef struct {
+    TransformJob job;
+    promise<void> finished;
+} FutureJob;
+
+static void __cdecl FinishFutureJob(void* context)
+{
+    FutureJob* future_job = static_cast<FutureJob*>(context);
+    future_job->finished.set_value();
+    delete future_job;
+}
+
+future<void> blipvert::SubmitTransform(const TransformPlan& plan, uint8_t* in_buf, uint8_t* out_buf)
+{
+    FutureJob* future_job = new FutureJob;
+    future<void> result = future_job->finished.get_future();
+    SubmitTransform(plan, in_buf, out_buf, future_job->job, FinishFutureJob, future_job);
+    return result;
+}
+
+bool blipvert::CreateFanOutPlan(FanOutPlan& plan, const MediaFormatID& inFormat, const vector<MediaFormatID>& outFormats,
+    int32_t width, int32_t height, int32_t in_stride, const vector<int32_t>& out_strides,
+    bool in_flipped, xRGBQUAD* in_palette, const vector<xRGBQUAD*>& out_palettes, const vector<bool>& out_flipped,
+    uint16_t in_palette_entries)
+{
+    plan.outputs.clear();
+    plan.band_count = 0;
+
+    if (outFormats.empty() || (!out_strides.empty() && out_strides.size() != outFormats.size()) ||
+        (!out_palettes.empty() && out_palettes.size() != outFormats.size()) ||
+        (!out_flipped.empty() && out_flipped.size() != outFormats.size()))
+    {
+        return false;
+    }
+
+    uint32_t bands = CalculateBufferSize(inFormat, width, height, in_stride) / FanOutBandBytes;
+    bands = min(max(bands, static_cast<uint32_t>(1)), static_cast<uint32_t>(255));
+    for (const MediaFormatID& outFormat : outFormats)
+    {
+        bands = min(bands, static_cast<uint32_t>(GetCommonMaxThreadCount(inFormat, outFormat, width, height, static_cast<int>(bands))));
+    }
+
+    plan.outputs.resize(outFormats.size());
+    for (size_t index = 0; index < outFormats.size(); index++)
+    {
+        int32_t out_stride = out_strides.empty() ? 0 : out_strides[index];
+        xRGBQUAD* out_palette = out_palettes.empty() ? nullptr : out_palettes[index];
+        bool out_flip = out_flipped.empty() ? false : out_flipped[index];
+        if (!CreateTransformPlan(plan.outputs[index], inFormat, outFormats[index], width, height, in_stride, out_stride,
+            in_flipped, out_flip, static_cast<uint8_t>(bands), in_palette, out_palette, in_palette_entries))
+        {
+            plan.outputs.clear();
+            return false;
+        }
+    }
+
+    plan.band_count = static_cast<uint8_t>(bands);
+    return true;
+}
+
+void blipvert::ExecuteFanOutPlanBand(const FanOutPlan& plan, uint8_t band_index, uint8_t* in_buf, uint8_t* const* out_bufs)
+{
+    for (size_t index = 0; index < plan.outputs.size(); index++)
+    {
+        ExecuteTransformPlanSlice(plan.outputs[index], band_index, in_buf, out_bufs[index]);
+    }
+}
+
+void blipvert::ExecuteFanOutPlan(const FanOutPlan& plan, uint8_t* in_buf, uint8_t* const* out_bufs)
+{
+    for (uint8_t index = 0; index < plan.band_count; index++)
+    {
+        ExecuteFanOutPlanBand(plan, index, in_buf, out_bufs);
+    }
+}
+
+typedef struct {
+    const FanOutPlan* plan;
+    uint8_t* in_buf;
+    uint8_t* const* out_bufs;
+} FanOutFrame;
+
+static void __cdecl ExecuteFanOutFrameBand(void* context, uint8_t slice_index)
+{
+    FanOutFrame* frame = static_cast<FanOutFrame*>(context);
+    ExecuteFanOutPlanBand(*frame->plan, slice_index, frame->in_buf, frame->out_bufs);
+}
+
+void blipvert::ExecuteFanOutPlanParallel(const FanOutPlan& plan, uint8_t* in_buf, uint8_t* const* out_bufs)
+{
+    FanOutFrame frame = { &plan, in_buf, out_bufs };
+    RunSlicesNear(ExecuteFanOutFrameBand, &frame, plan.band_count, in_buf);
+}
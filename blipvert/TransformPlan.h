@@ -0,0 +1,193 @@
+#pragma once
+
+//
+//  blipvert C++ library
+//
+//  MIT License
+//
+//  Copyright(c) 2021-2025 Don Jordan
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+//
+
+#include "blipverttypes.h"
+#include "Staging.h"
+#include "blipvert.h"
+
+#include <vector>
+#include <future>
+
+namespace blipvert
+{
+    //
+    // A transform plan is built once for a pair of formats, a frame geometry and a thread count. It holds the
+    // resolved transform function and the staged slices of the frame, so running a frame only has to rebase
+    // the cached stages onto the frame's buffers. The slices are staged against a placeholder address and
+    // never touch memory until a frame is run.
+    //
+    typedef struct TransformPlan {
+        t_transformfunc transform;
+        FormatIndex in_format;
+        FormatIndex out_format;
+        int32_t width;
+        int32_t height;
+        int32_t in_stride;
+        int32_t out_stride;
+        bool in_flipped;
+        bool out_flipped;
+        uint8_t thread_count;                   // The number of slices, or of tiles when column_count is more than 1.
+        uint8_t column_count;                   // Tiles per row slice, 1 unless the plan was made by CreateTiledTransformPlan().
+        bool stream_stores;                     // Write the output with non-temporal stores, see Stage::stream_stores.
+        std::vector<TransformStage> stages;     // One entry per slice, staged against the placeholder address.
+    } TransformPlan;
+
+    // Builds a transform plan.
+    //
+    // Parameters:
+    //      plan:           OUT -> The plan to build.
+    //      inFormat:       IN  -> The input media format.
+    //      outFormat:      IN  -> The output media format.
+    //      width, height:  IN  -> The logical dimensions of the frames.
+    //      in_stride:      IN  -> The input stride, or 0 for the format's minimum stride.
+    //      out_stride:     IN  -> The output stride, or 0 for the format's minimum stride.
+    //      in_flipped:     IN  -> true if the input frames are flipped.
+    //      out_flipped:    IN  -> true if the output frames are flipped.
+    //      thread_count:   IN  -> The number of slices requested. It's reduced to what both formats allow,
+    //                             see GetCommonMaxThreadCount(). plan.thread_count holds the number used.
+    //                             Pass GetBandCount(height) to cut the frame into small row bands that
+    //                             ExecuteTransformPlanParallel() hands out to the workers as they free up.
+    //      in_palette:     IN  -> The input palette for palettized formats, nullptr otherwise.
+    //      out_palette:    IN  -> The output palette for palettized formats, nullptr otherwise.
+    //      in_palette_entries: IN -> The number of entries in_palette holds, or 0 if it isn't known. The indexed
+    //                             transforms then don't have to scan each frame for the entries it uses, see
+    //                             GetPaletteTables().
+    // Returns true if the plan was built, false if there's no transform or staging function for the formats.
+    // A plan that fails to build is left with no slices, so running it does nothing.
+    // plan.stream_stores is set when an output frame is bigger than GetStreamingStoreThreshold(), and can be
+    // changed before the plan is run.
+    bool CreateTransformPlan(TransformPlan& plan, const MediaFormatID& inFormat, const MediaFormatID& outFormat,
+        int32_t width, int32_t height, int32_t in_stride = 0, int32_t out_stride = 0,
+        bool in_flipped = false, bool out_flipped = false, uint8_t thread_count = 1,
+        xRGBQUAD* in_palette = nullptr, xRGBQUAD* out_palette = nullptr, uint16_t in_palette_entries = 0);
+
+    // Builds a transform plan that cuts the frame into tiles, for wide, short frames that don't have enough rows to
+    // give every thread a slice. GetTileShape() picks the number of row slices and of columns in each from the
+    // frame's aspect ratio, so frames with rows to spare stay in whole-row slices. The tiles are numbered row by
+    // row and plan.thread_count holds how many there are; the plan then runs like any other.
+    //
+    // Parameters:
+    //      tile_count:     IN  -> The most tiles to cut the frame into. The other parameters are the same as
+    //                             CreateTransformPlan().
+    // Returns true if the plan was built, false if there's no transform or staging function for the formats or
+    // a tile can't be narrowed to its columns, see StageTileColumns().
+    bool CreateTiledTransformPlan(TransformPlan& plan, const MediaFormatID& inFormat, const MediaFormatID& outFormat,
+        int32_t width, int32_t height, int32_t in_stride = 0, int32_t out_stride = 0,
+        bool in_flipped = false, bool out_flipped = false, uint8_t tile_count = 1,
+        xRGBQUAD* in_palette = nullptr, xRGBQUAD* out_palette = nullptr, uint16_t in_palette_entries = 0);
+
+    // Fills result with the plan's slice for thread_index, rebased onto the given frame buffers.
+    void StageTransformPlan(const TransformPlan& plan, uint8_t thread_index, uint8_t* in_buf, uint8_t* out_buf, TransformStage& result);
+
+    // Transforms the plan's slice for thread_index. Call it once per slice, from any thread, to run a frame in parallel.
+    void ExecuteTransformPlanSlice(const TransformPlan& plan, uint8_t thread_index, uint8_t* in_buf, uint8_t* out_buf);
+
+    // Transforms every slice of a frame on the calling thread.
+    void ExecuteTransformPlan(const TransformPlan& plan, uint8_t* in_buf, uint8_t* out_buf);
+
+    // Transforms every slice of a frame on the library's worker pool, see ThreadPool.h. Returns when the frame is done.
+    void ExecuteTransformPlanParallel(const TransformPlan& plan, uint8_t* in_buf, uint8_t* out_buf);
+
+    // Function called when a frame from SubmitTransform() is done, on the thread that finished its last slice.
+    typedef void(__cdecl* t_transformdonefunc) (void* context);
+
+    // A frame submitted with SubmitTransform(). SubmitTransform() fills it in, and it must stay valid and in the same
+    // place until the frame is done.
+    typedef struct TransformJob {
+        const TransformPlan* plan;
+        uint8_t* in_buf;
+        uint8_t* out_buf;
+        t_transformdonefunc done;
+        void* context;
+    } TransformJob;
+
+    // Queues a frame on the library's worker pool and returns without waiting for it, see SubmitSlices(). Several
+    // frames can be in flight at once, and the workers start on the next frame's slices while the last slices of
+    // the one before finish.
+    //
+    // Parameters:
+    //      plan:           IN  -> The plan to run, which must stay valid until the frame is done.
+    //      in_buf:         IN  -> The input frame.
+    //      out_buf:        IN  -> The output frame.
+    //      job:            OUT -> Holds the frame while it's in flight.
+    //      done:           IN  -> Called with context once the frame is done, or nullptr.
+    //      context:        IN  -> Passed to done.
+    void SubmitTransform(const TransformPlan& plan, uint8_t* in_buf, uint8_t* out_buf, TransformJob& job,
+        t_transformdonefunc done, void* context = nullptr);
+
+    // Same as above, with the job kept by the library. The future is ready once the frame is done.
+    std::future<void> SubmitTransform(const TransformPlan& plan, uint8_t* in_buf, uint8_t* out_buf);
+
+    //
+    // A fan-out plan converts one input frame to several output formats in a single pass over the input. The
+    // frame is cut into row bands of about FanOutBandBytes of input, and every output's transform runs on a
+    // band while it's still in the cache, so the input is read from memory once no matter how many outputs
+    // there are. The bands are the slices of one transform plan per output, all built with the same count.
+    //
+    typedef struct FanOutPlan {
+        std::vector<TransformPlan> outputs;     // One plan per output format, in the order they were given.
+        uint8_t band_count;
+    } FanOutPlan;
+
+    // Input bytes per band that CreateFanOutPlan() aims for, small enough that a band and the outputs made from it
+    // stay in a typical L2 cache. A plan has at most 255 bands, the most slices a transform plan can have, so a
+    // frame with more than 255 * FanOutBandBytes of input gets bigger bands; a 4K RGB32 frame has about 130 KB of
+    // input per band, which only fits in the larger L2 caches, though each band is still read from memory once.
+    const uint32_t FanOutBandBytes = 32 * 1024;
+
+    // Builds a fan-out plan.
+    //
+    // Parameters:
+    //      plan:           OUT -> The plan to build.
+    //      inFormat:       IN  -> The input media format.
+    //      outFormats:     IN  -> The output media formats.
+    //      width, height:  IN  -> The logical dimensions of the frames.
+    //      in_stride:      IN  -> The input stride, or 0 for the format's minimum stride.
+    //      out_strides:    IN  -> The output strides, one per output format, or empty for the minimum strides.
+    //      in_flipped:     IN  -> true if the input frames are flipped.
+    //      in_palette:     IN  -> The input palette for palettized formats, nullptr otherwise.
+    //      out_palettes:   IN  -> The output palettes, one per output format, or empty for none.
+    //      out_flipped:    IN  -> true for each output format to be flipped, or empty for none.
+    //      in_palette_entries: IN -> The number of entries in_palette holds, or 0, see CreateTransformPlan().
+    // Returns true if the plan was built, false if any of the outputs has no transform or staging function.
+    // Formats that can't be sliced drop the whole plan to a single band, which still works but reads the input
+    // once per output.
+    bool CreateFanOutPlan(FanOutPlan& plan, const MediaFormatID& inFormat, const std::vector<MediaFormatID>& outFormats,
+        int32_t width, int32_t height, int32_t in_stride = 0, const std::vector<int32_t>& out_strides = {},
+        bool in_flipped = false, xRGBQUAD* in_palette = nullptr, const std::vector<xRGBQUAD*>& out_palettes = {},
+        const std::vector<bool>& out_flipped = {}, uint16_t in_palette_entries = 0);
+
+    // Converts one band of a frame to every output. out_bufs holds one buffer per output format.
+    void ExecuteFanOutPlanBand(const FanOutPlan& plan, uint8_t band_index, uint8_t* in_buf, uint8_t* const* out_bufs);
+
+    // Converts a frame to every output on the calling thread.
+    void ExecuteFanOutPlan(const FanOutPlan& plan, uint8_t* in_buf, uint8_t* const* out_bufs);
+
+    // Converts a frame to every output on the library's worker pool, one band at a time per worker. Returns when the frame is done.
+    void ExecuteFanOutPlanParallel(const FanOutPlan& plan, uint8_t* in_buf, uint8_t* const* out_bufs);
+}
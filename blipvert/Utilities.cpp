@@ -70,7 +70,7 @@ void blipvert::FastYUVtoRGB(uint8_t Y, uint8_t U, uint8_t V, uint8_t* R, uint8_t
 {
     int32_t Yprime = luminance_table[Y];
     *B = saturation_table[Yprime + u_table[U]];
-    *G = saturation_table[Yprime + uv_table[U][V]];
+    *G = saturation_table[Yprime + GreenChroma(U, V)];
     *R = saturation_table[Yprime + v_table[V]];
 }
 
@@ -30,6 +30,12 @@
 #include "CommonMacros.h"
 #include "LookupTables.h"
 #include "blipvert.h"
+#include "CpuFeatures.h"
+#include "StreamingStores.h"
+
+#if defined(BLIPVERT_X86_SIMD)
+#include <immintrin.h>
+#endif
 
 using namespace blipvert;
 
@@ -62,7 +68,7 @@ void blipvert::PackedY422_to_RGB32(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[U]];
-            int32_t green = uv_table[psrc[U]][psrc[V]];
+            int32_t green = GreenChroma(psrc[U], psrc[V]);
             int32_t red = v_table[psrc[V]];
 
             int32_t Y = luminance_table[psrc[Y0]];
@@ -110,7 +116,7 @@ void blipvert::PackedY422_to_RGB24(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[U]];
-            int32_t green = uv_table[psrc[U]][psrc[V]];
+            int32_t green = GreenChroma(psrc[U], psrc[V]);
             int32_t red = v_table[psrc[V]];
 
             int32_t Y = luminance_table[psrc[Y0]];
@@ -155,7 +161,7 @@ void blipvert::PackedY422_to_RGB565(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[U]];
-            int32_t green = uv_table[psrc[U]][psrc[V]];
+            int32_t green = GreenChroma(psrc[U], psrc[V]);
             int32_t red = v_table[psrc[V]];
 
             int32_t Y = luminance_table[psrc[Y0]];
@@ -200,7 +206,7 @@ void blipvert::PackedY422_to_RGB555(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[U]];
-            int32_t green = uv_table[psrc[U]][psrc[V]];
+            int32_t green = GreenChroma(psrc[U], psrc[V]);
             int32_t red = v_table[psrc[V]];
 
             int32_t Y = luminance_table[psrc[Y0]];
@@ -261,7 +267,7 @@ void blipvert::PlanarYUV_to_RGB32(Stage* in, Stage* out)
             for (int16_t x = 0; x < uv_width; x++)
             {
                 int32_t bprime = u_table[*up];
-                int32_t gprime = uv_table[*up][*vp];
+                int32_t gprime = GreenChroma(*up, *vp);
                 int32_t rprime = v_table[*vp];
 
                 // column 1 row 1
@@ -316,7 +322,7 @@ void blipvert::PlanarYUV_to_RGB32(Stage* in, Stage* out)
             for (int16_t x = 0; x < uv_width; x++)
             {
                 int32_t bprime = u_table[*up];
-                int32_t gprime = uv_table[*up][*vp];
+                int32_t gprime = GreenChroma(*up, *vp);
                 int32_t rprime = v_table[*vp];
 
                 for (int16_t row = 0; row < 4; row++)
@@ -382,7 +388,7 @@ void blipvert::PlanarYUV_to_RGB24(Stage* in, Stage* out)
             for (int16_t x = 0; x < uv_width; x++)
             {
                 int32_t bprime = u_table[*up];
-                int32_t gprime = uv_table[*up][*vp];
+                int32_t gprime = GreenChroma(*up, *vp);
                 int32_t rprime = v_table[*vp];
 
                 // column 1 row 1
@@ -433,7 +439,7 @@ void blipvert::PlanarYUV_to_RGB24(Stage* in, Stage* out)
             for (int16_t x = 0; x < uv_width; x++)
             {
                 int32_t bprime = u_table[*up];
-                int32_t gprime = uv_table[*up][*vp];
+                int32_t gprime = GreenChroma(*up, *vp);
                 int32_t rprime = v_table[*vp];
 
                 for (int16_t row = 0; row < 4; row++)
@@ -498,7 +504,7 @@ void blipvert::PlanarYUV_to_RGB565(Stage* in, Stage* out)
             for (int16_t x = 0; x < uv_width; x++)
             {
                 int32_t bprime = u_table[*up];
-                int32_t gprime = uv_table[*up][*vp];
+                int32_t gprime = GreenChroma(*up, *vp);
                 int32_t rprime = v_table[*vp];
 
                 // column 1 row 1
@@ -553,7 +559,7 @@ void blipvert::PlanarYUV_to_RGB565(Stage* in, Stage* out)
             for (int16_t x = 0; x < uv_width; x++)
             {
                 int32_t bprime = u_table[*up];
-                int32_t gprime = uv_table[*up][*vp];
+                int32_t gprime = GreenChroma(*up, *vp);
                 int32_t rprime = v_table[*vp];
 
                 for (int16_t row = 0; row < 4; row++)
@@ -618,7 +624,7 @@ void blipvert::PlanarYUV_to_RGB555(Stage* in, Stage* out)
             for (int16_t x = 0; x < uv_width; x++)
             {
                 int32_t bprime = u_table[*up];
-                int32_t gprime = uv_table[*up][*vp];
+                int32_t gprime = GreenChroma(*up, *vp);
                 int32_t rprime = v_table[*vp];
 
                 // column 1 row 1
@@ -673,7 +679,7 @@ void blipvert::PlanarYUV_to_RGB555(Stage* in, Stage* out)
             for (int16_t x = 0; x < uv_width; x++)
             {
                 int32_t bprime = u_table[*up];
-                int32_t gprime = uv_table[*up][*vp];
+                int32_t gprime = GreenChroma(*up, *vp);
                 int32_t rprime = v_table[*vp];
 
                 for (int16_t row = 0; row < 4; row++)
@@ -709,6 +715,7 @@ void blipvert::IMCx_to_RGB32(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t uv_width = in->uv_width;
@@ -731,7 +738,7 @@ void blipvert::IMCx_to_RGB32(Stage* in, Stage* out)
         for (int16_t x = 0; x < width; x += 2)
         {
             int32_t bprime = u_table[*up];
-            int32_t gprime = uv_table[*up][*vp];
+            int32_t gprime = GreenChroma(*up, *vp);
             int32_t rprime = v_table[*vp];
 
             // column 1 row 1
@@ -769,8 +776,8 @@ void blipvert::IMCx_to_RGB32(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        uplane += in_stride;
-        vplane += in_stride;
+        uplane += in_uv_stride;
+        vplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 }
@@ -779,6 +786,7 @@ void blipvert::IMCx_to_RGB24(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t uv_width = in->uv_width;
@@ -801,7 +809,7 @@ void blipvert::IMCx_to_RGB24(Stage* in, Stage* out)
         for (int16_t x = 0; x < width; x += 2)
         {
             int32_t bprime = u_table[*up];
-            int32_t gprime = uv_table[*up][*vp];
+            int32_t gprime = GreenChroma(*up, *vp);
             int32_t rprime = v_table[*vp];
 
             // column 1 row 1
@@ -835,8 +843,8 @@ void blipvert::IMCx_to_RGB24(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        uplane += in_stride;
-        vplane += in_stride;
+        uplane += in_uv_stride;
+        vplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 }
@@ -845,6 +853,7 @@ void blipvert::IMCx_to_RGB565(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t uv_width = in->uv_width;
@@ -867,7 +876,7 @@ void blipvert::IMCx_to_RGB565(Stage* in, Stage* out)
         for (int16_t x = 0; x < width; x += 2)
         {
             int32_t bprime = u_table[*up];
-            int32_t gprime = uv_table[*up][*vp];
+            int32_t gprime = GreenChroma(*up, *vp);
             int32_t rprime = v_table[*vp];
 
             // column 1 row 1
@@ -905,8 +914,8 @@ void blipvert::IMCx_to_RGB565(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        uplane += in_stride;
-        vplane += in_stride;
+        uplane += in_uv_stride;
+        vplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 }
@@ -915,6 +924,7 @@ void blipvert::IMCx_to_RGB555(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t uv_width = in->uv_width;
@@ -937,7 +947,7 @@ void blipvert::IMCx_to_RGB555(Stage* in, Stage* out)
         for (int16_t x = 0; x < width; x += 2)
         {
             int32_t bprime = u_table[*up];
-            int32_t gprime = uv_table[*up][*vp];
+            int32_t gprime = GreenChroma(*up, *vp);
             int32_t rprime = v_table[*vp];
 
             // column 1 row 1
@@ -975,8 +985,8 @@ void blipvert::IMCx_to_RGB555(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        uplane += in_stride;
-        vplane += in_stride;
+        uplane += in_uv_stride;
+        vplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 }
@@ -1005,7 +1015,7 @@ void blipvert::CLJR_to_RGB32(Stage* in, Stage* out)
             uint32_t U = UnpackCLJR_U(mpixel);
             uint32_t V = UnpackCLJR_V(mpixel);
             int32_t blue = u_table[U];
-            int32_t green = uv_table[U][V];
+            int32_t green = GreenChroma(U, V);
             int32_t red = v_table[V];
 
             int32_t Y = luminance_table[UnpackCLJR_Y0(mpixel)];
@@ -1062,7 +1072,7 @@ void blipvert::CLJR_to_RGB24(Stage* in, Stage* out)
             uint32_t U = UnpackCLJR_U(mpixel);
             uint32_t V = UnpackCLJR_V(mpixel);
             uint32_t blue = u_table[U];
-            uint32_t green = uv_table[U][V];
+            uint32_t green = GreenChroma(U, V);
             uint32_t red = v_table[V];
 
             uint32_t Y = luminance_table[UnpackCLJR_Y0(mpixel)];
@@ -1115,7 +1125,7 @@ void blipvert::CLJR_to_RGB565(Stage* in, Stage* out)
             uint32_t U = UnpackCLJR_U(mpixel);
             uint32_t V = UnpackCLJR_V(mpixel);
             uint32_t blue = u_table[U];
-            uint32_t green = uv_table[U][V];
+            uint32_t green = GreenChroma(U, V);
             uint32_t red = v_table[V];
 
             uint32_t Y = luminance_table[UnpackCLJR_Y0(mpixel)];
@@ -1168,7 +1178,7 @@ void blipvert::CLJR_to_RGB555(Stage* in, Stage* out)
             uint32_t U = UnpackCLJR_U(mpixel);
             uint32_t V = UnpackCLJR_V(mpixel);
             uint32_t blue = u_table[U];
-            uint32_t green = uv_table[U][V];
+            uint32_t green = GreenChroma(U, V);
             uint32_t red = v_table[V];
 
             uint32_t Y = luminance_table[UnpackCLJR_Y0(mpixel)];
@@ -1222,7 +1232,7 @@ void blipvert::Y41P_to_RGB32(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[0]];
-            int32_t green = uv_table[psrc[0]][psrc[2]];
+            int32_t green = GreenChroma(psrc[0], psrc[2]);
             int32_t red = v_table[psrc[2]];
 
             int32_t Y = luminance_table[psrc[1]];
@@ -1250,7 +1260,7 @@ void blipvert::Y41P_to_RGB32(Stage* in, Stage* out)
             pdst[15] = 0xFF;
 
             blue = u_table[psrc[4]];
-            green = uv_table[psrc[4]][psrc[6]];
+            green = GreenChroma(psrc[4], psrc[6]);
             red = v_table[psrc[6]];
 
             Y = luminance_table[psrc[8]];
@@ -1305,7 +1315,7 @@ void blipvert::Y41P_to_RGB24(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[0]];
-            int32_t green = uv_table[psrc[0]][psrc[2]];
+            int32_t green = GreenChroma(psrc[0], psrc[2]);
             int32_t red = v_table[psrc[2]];
 
             int32_t Y = luminance_table[psrc[1]];
@@ -1329,7 +1339,7 @@ void blipvert::Y41P_to_RGB24(Stage* in, Stage* out)
             pdst[11] = saturation_table[Y + red];
 
             blue = u_table[psrc[4]];
-            green = uv_table[psrc[4]][psrc[6]];
+            green = GreenChroma(psrc[4], psrc[6]);
             red = v_table[psrc[6]];
 
             Y = luminance_table[psrc[8]];
@@ -1380,7 +1390,7 @@ void blipvert::Y41P_to_RGB565(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[0]];
-            int32_t green = uv_table[psrc[0]][psrc[2]];
+            int32_t green = GreenChroma(psrc[0], psrc[2]);
             int32_t red = v_table[psrc[2]];
 
             int32_t Y = luminance_table[psrc[1]];
@@ -1404,7 +1414,7 @@ void blipvert::Y41P_to_RGB565(Stage* in, Stage* out)
                 saturation_table[Y + blue]);
 
             blue = u_table[psrc[4]];
-            green = uv_table[psrc[4]][psrc[6]];
+            green = GreenChroma(psrc[4], psrc[6]);
             red = v_table[psrc[6]];
 
             Y = luminance_table[psrc[8]];
@@ -1455,7 +1465,7 @@ void blipvert::Y41P_to_RGB555(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[0]];
-            int32_t green = uv_table[psrc[0]][psrc[2]];
+            int32_t green = GreenChroma(psrc[0], psrc[2]);
             int32_t red = v_table[psrc[2]];
 
             int32_t Y = luminance_table[psrc[1]];
@@ -1479,7 +1489,7 @@ void blipvert::Y41P_to_RGB555(Stage* in, Stage* out)
                 saturation_table[Y + blue]);
 
             blue = u_table[psrc[4]];
-            green = uv_table[psrc[4]][psrc[6]];
+            green = GreenChroma(psrc[4], psrc[6]);
             red = v_table[psrc[6]];
 
             Y = luminance_table[psrc[8]];
@@ -1534,7 +1544,7 @@ void blipvert::IYU1_to_RGB32(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[0]];
-            int32_t green = uv_table[psrc[0]][psrc[3]];
+            int32_t green = GreenChroma(psrc[0], psrc[3]);
             int32_t red = v_table[psrc[3]];
 
             int32_t Y = luminance_table[psrc[1]];
@@ -1589,7 +1599,7 @@ void blipvert::IYU1_to_RGB24(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[0]];
-            int32_t green = uv_table[psrc[0]][psrc[3]];
+            int32_t green = GreenChroma(psrc[0], psrc[3]);
             int32_t red = v_table[psrc[3]];
 
             int32_t Y = luminance_table[psrc[1]];
@@ -1640,7 +1650,7 @@ void blipvert::IYU1_to_RGB565(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[0]];
-            int32_t green = uv_table[psrc[0]][psrc[3]];
+            int32_t green = GreenChroma(psrc[0], psrc[3]);
             int32_t red = v_table[psrc[3]];
 
             int32_t Y = luminance_table[psrc[1]];
@@ -1691,7 +1701,7 @@ void blipvert::IYU1_to_RGB555(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[0]];
-            int32_t green = uv_table[psrc[0]][psrc[3]];
+            int32_t green = GreenChroma(psrc[0], psrc[3]);
             int32_t red = v_table[psrc[3]];
 
             int32_t Y = luminance_table[psrc[1]];
@@ -1749,7 +1759,7 @@ void blipvert::IYU2_to_RGB32(Stage* in, Stage* out)
             int32_t U = psrc[0];
             int32_t V = psrc[2];
             pdst[0] = saturation_table[Yprime + u_table[U]];        // blue
-            pdst[1] = saturation_table[Yprime + uv_table[U][V]];    // green
+            pdst[1] = saturation_table[Yprime + GreenChroma(U, V)];    // green
             pdst[2] = saturation_table[Yprime + v_table[V]];        // red
             pdst[3] = 0xFF;
 
@@ -1784,7 +1794,7 @@ void blipvert::IYU2_to_RGB24(Stage* in, Stage* out)
             int32_t U = psrc[0];
             int32_t V = psrc[2];
             pdst[0] = saturation_table[Yprime + u_table[U]];        // blue
-            pdst[1] = saturation_table[Yprime + uv_table[U][V]];    // green
+            pdst[1] = saturation_table[Yprime + GreenChroma(U, V)];    // green
             pdst[2] = saturation_table[Yprime + v_table[V]];        // red
 
             psrc += 3;
@@ -1818,7 +1828,7 @@ void blipvert::IYU2_to_RGB565(Stage* in, Stage* out)
             int32_t U = psrc[0];
             int32_t V = psrc[2];
             PackRGB565Word(*pdst++, saturation_table[Yprime + v_table[V]],
-                saturation_table[Yprime + uv_table[U][V]],
+                saturation_table[Yprime + GreenChroma(U, V)],
                 saturation_table[Yprime + u_table[U]]);
 
             psrc += 3;
@@ -1851,7 +1861,7 @@ void blipvert::IYU2_to_RGB555(Stage* in, Stage* out)
             int32_t U = psrc[0];
             int32_t V = psrc[2];
             PackRGB555Word(*pdst++, saturation_table[Yprime + v_table[V]],
-                saturation_table[Yprime + uv_table[U][V]],
+                saturation_table[Yprime + GreenChroma(U, V)],
                 saturation_table[Yprime + u_table[U]]);
             psrc += 3;
             hcount--;
@@ -2164,7 +2174,7 @@ void blipvert::AYUV_to_RGBA(Stage* in, Stage* out)
         {
             int32_t Y = luminance_table[psrc[2]];
             pdst[0] = saturation_table[Y + u_table[psrc[1]]];               // blue
-            pdst[1] = saturation_table[Y + uv_table[psrc[1]][psrc[0]]];     // green
+            pdst[1] = saturation_table[Y + GreenChroma(psrc[1], psrc[0])];     // green
             pdst[2] = saturation_table[Y + v_table[psrc[0]]];               // red
             pdst[3] = psrc[3];  
 
@@ -2198,7 +2208,7 @@ void blipvert::AYUV_to_RGB32(Stage* in, Stage* out)
         {
             int32_t Y = luminance_table[psrc[2]];
             pdst[0] = saturation_table[Y + u_table[psrc[1]]];               // blue
-            pdst[1] = saturation_table[Y + uv_table[psrc[1]][psrc[0]]];     // green
+            pdst[1] = saturation_table[Y + GreenChroma(psrc[1], psrc[0])];     // green
             pdst[2] = saturation_table[Y + v_table[psrc[0]]];               // red
             pdst[3] = 0xFF;
 
@@ -2232,7 +2242,7 @@ void blipvert::AYUV_to_RGB24(Stage* in, Stage* out)
         {
             int32_t Y = luminance_table[psrc[2]];
             pdst[0] = saturation_table[Y + u_table[psrc[1]]];               // blue
-            pdst[1] = saturation_table[Y + uv_table[psrc[1]][psrc[0]]];     // green
+            pdst[1] = saturation_table[Y + GreenChroma(psrc[1], psrc[0])];     // green
             pdst[2] = saturation_table[Y + v_table[psrc[0]]];               // red
 
             psrc += 4;
@@ -2266,7 +2276,7 @@ void blipvert::AYUV_to_RGB565(Stage* in, Stage* out)
             int32_t Y = luminance_table[psrc[2]];
             PackRGB565Word(*pdst,
                 saturation_table[Y + v_table[psrc[0]]],                 // red
-                saturation_table[Y + uv_table[psrc[1]][psrc[0]]],       // green
+                saturation_table[Y + GreenChroma(psrc[1], psrc[0])],       // green
                 saturation_table[Y + u_table[psrc[1]]]);                // blue
                 
             psrc += 4;
@@ -2300,7 +2310,7 @@ void blipvert::AYUV_to_RGB555(Stage* in, Stage* out)
             int32_t Y = luminance_table[psrc[2]];
             PackRGB555Word(*pdst,
                 saturation_table[Y + v_table[psrc[0]]],                 // red
-                saturation_table[Y + uv_table[psrc[1]][psrc[0]]],       // green
+                saturation_table[Y + GreenChroma(psrc[1], psrc[0])],       // green
                 saturation_table[Y + u_table[psrc[1]]]);                // blue
 
             psrc += 4;
@@ -2334,7 +2344,7 @@ void blipvert::AYUV_to_ARGB1555(Stage* in, Stage* out)
             int32_t Y = luminance_table[psrc[2]];
             PackARGB555Word(*pdst, (psrc[3] > 127 ? RGB555_ALPHA_MASK : 0x0000),
                 saturation_table[Y + v_table[psrc[0]]],                 // red
-                saturation_table[Y + uv_table[psrc[1]][psrc[0]]],       // green
+                saturation_table[Y + GreenChroma(psrc[1], psrc[0])],       // green
                 saturation_table[Y + u_table[psrc[1]]]);                // blue
 
             psrc += 4;
@@ -2355,6 +2365,7 @@ void blipvert::NVx_to_RGB32(Stage* in, Stage* out)
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     uint8_t* in_uvplane = in->uvplane;
     uint16_t in_u = in->u_index;
     uint16_t in_v = in->v_index;
@@ -2375,7 +2386,7 @@ void blipvert::NVx_to_RGB32(Stage* in, Stage* out)
         for (int16_t x = 0; x < width; x += 2)
         {
             int32_t bprime = u_table[*up];
-            int32_t gprime = uv_table[*up][*vp];
+            int32_t gprime = GreenChroma(*up, *vp);
             int32_t rprime = v_table[*vp];
 
             // column 1 row 1
@@ -2413,7 +2424,7 @@ void blipvert::NVx_to_RGB32(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        in_uvplane += in_stride;
+        in_uvplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 }
@@ -2424,6 +2435,7 @@ void blipvert::NVx_to_RGB24(Stage* in, Stage* out)
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     uint8_t* in_uvplane = in->uvplane;
     uint16_t in_u = in->u_index;
     uint16_t in_v = in->v_index;
@@ -2444,7 +2456,7 @@ void blipvert::NVx_to_RGB24(Stage* in, Stage* out)
         for (int16_t x = 0; x < width; x += 2)
         {
             int32_t bprime = u_table[*up];
-            int32_t gprime = uv_table[*up][*vp];
+            int32_t gprime = GreenChroma(*up, *vp);
             int32_t rprime = v_table[*vp];
 
             // column 1 row 1
@@ -2478,7 +2490,7 @@ void blipvert::NVx_to_RGB24(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        in_uvplane += in_stride;
+        in_uvplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 }
@@ -2489,6 +2501,7 @@ void blipvert::NVx_to_RGB565(Stage* in, Stage* out)
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     uint8_t* in_uvplane = in->uvplane;
     uint16_t in_u = in->u_index;
     uint16_t in_v = in->v_index;
@@ -2509,7 +2522,7 @@ void blipvert::NVx_to_RGB565(Stage* in, Stage* out)
         for (int16_t x = 0; x < width; x += 2)
         {
             int32_t bprime = u_table[*up];
-            int32_t gprime = uv_table[*up][*vp];
+            int32_t gprime = GreenChroma(*up, *vp);
             int32_t rprime = v_table[*vp];
 
             // column 1 row 1
@@ -2547,7 +2560,7 @@ void blipvert::NVx_to_RGB565(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        in_uvplane += in_stride;
+        in_uvplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 }
@@ -2558,6 +2571,7 @@ void blipvert::NVx_to_RGB555(Stage* in, Stage* out)
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     uint8_t* in_uvplane = in->uvplane;
     uint16_t in_u = in->u_index;
     uint16_t in_v = in->v_index;
@@ -2578,7 +2592,7 @@ void blipvert::NVx_to_RGB555(Stage* in, Stage* out)
         for (int16_t x = 0; x < width; x += 2)
         {
             int32_t bprime = u_table[*up];
-            int32_t gprime = uv_table[*up][*vp];
+            int32_t gprime = GreenChroma(*up, *vp);
             int32_t rprime = v_table[*vp];
 
             // column 1 row 1
@@ -2616,7 +2630,7 @@ void blipvert::NVx_to_RGB555(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        in_uvplane += in_stride;
+        in_uvplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 }
@@ -2638,7 +2652,7 @@ void blipvert::Y42T_to_RGBA(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[0]];
-            int32_t green = uv_table[psrc[0]][psrc[2]];
+            int32_t green = GreenChroma(psrc[0], psrc[2]);
             int32_t red = v_table[psrc[2]];
 
             int32_t Y = luminance_table[psrc[1] & 0xFE];
@@ -2682,7 +2696,7 @@ void blipvert::Y42T_to_RGB32(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[0]];
-            int32_t green = uv_table[psrc[0]][psrc[2]];
+            int32_t green = GreenChroma(psrc[0], psrc[2]);
             int32_t red = v_table[psrc[2]];
 
             int32_t Y = luminance_table[psrc[1] & 0xFE];
@@ -2726,7 +2740,7 @@ void blipvert::Y42T_to_RGB24(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[0]];
-            int32_t green = uv_table[psrc[0]][psrc[2]];
+            int32_t green = GreenChroma(psrc[0], psrc[2]);
             int32_t red = v_table[psrc[2]];
 
             int32_t Y = luminance_table[psrc[1] & 0xFE];
@@ -2767,7 +2781,7 @@ void blipvert::Y42T_to_RGB565(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[0]];
-            int32_t green = uv_table[psrc[0]][psrc[2]];
+            int32_t green = GreenChroma(psrc[0], psrc[2]);
             int32_t red = v_table[psrc[2]];
 
             int32_t Y = luminance_table[psrc[1] & 0xFE];
@@ -2810,7 +2824,7 @@ void blipvert::Y42T_to_RGB555(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[0]];
-            int32_t green = uv_table[psrc[0]][psrc[2]];
+            int32_t green = GreenChroma(psrc[0], psrc[2]);
             int32_t red = v_table[psrc[2]];
 
             int32_t Y = luminance_table[psrc[1] & 0xFE];
@@ -2851,7 +2865,7 @@ void blipvert::Y42T_to_ARGB1555(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[0]];
-            int32_t green = uv_table[psrc[0]][psrc[2]];
+            int32_t green = GreenChroma(psrc[0], psrc[2]);
             int32_t red = v_table[psrc[2]];
 
             int32_t Y = luminance_table[psrc[1] & 0xFE];
@@ -2899,7 +2913,7 @@ void blipvert::Y41T_to_RGBA(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[0]];
-            int32_t green = uv_table[psrc[0]][psrc[2]];
+            int32_t green = GreenChroma(psrc[0], psrc[2]);
             int32_t red = v_table[psrc[2]];
 
             int32_t Y = luminance_table[psrc[1] & 0xFE];
@@ -2927,7 +2941,7 @@ void blipvert::Y41T_to_RGBA(Stage* in, Stage* out)
             pdst[15] = psrc[7] & 0x01 ? 0xFF : 0x00;
 
             blue = u_table[psrc[4]];
-            green = uv_table[psrc[4]][psrc[6]];
+            green = GreenChroma(psrc[4], psrc[6]);
             red = v_table[psrc[6]];
 
             Y = luminance_table[psrc[8] & 0xFE];
@@ -2982,7 +2996,7 @@ void blipvert::Y41T_to_RGB32(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[0]];
-            int32_t green = uv_table[psrc[0]][psrc[2]];
+            int32_t green = GreenChroma(psrc[0], psrc[2]);
             int32_t red = v_table[psrc[2]];
 
             int32_t Y = luminance_table[psrc[1] & 0xFE];
@@ -3010,7 +3024,7 @@ void blipvert::Y41T_to_RGB32(Stage* in, Stage* out)
             pdst[15] = 0xFF;
 
             blue = u_table[psrc[4]];
-            green = uv_table[psrc[4]][psrc[6]];
+            green = GreenChroma(psrc[4], psrc[6]);
             red = v_table[psrc[6]];
 
             Y = luminance_table[psrc[8] & 0xFE];
@@ -3065,7 +3079,7 @@ void blipvert::Y41T_to_RGB24(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[0]];
-            int32_t green = uv_table[psrc[0]][psrc[2]];
+            int32_t green = GreenChroma(psrc[0], psrc[2]);
             int32_t red = v_table[psrc[2]];
 
             int32_t Y = luminance_table[psrc[1] & 0xFE];
@@ -3089,7 +3103,7 @@ void blipvert::Y41T_to_RGB24(Stage* in, Stage* out)
             pdst[11] = saturation_table[Y + red];
 
             blue = u_table[psrc[4]];
-            green = uv_table[psrc[4]][psrc[6]];
+            green = GreenChroma(psrc[4], psrc[6]);
             red = v_table[psrc[6]];
 
             Y = luminance_table[psrc[8] & 0xFE];
@@ -3140,7 +3154,7 @@ void blipvert::Y41T_to_RGB565(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[0]];
-            int32_t green = uv_table[psrc[0]][psrc[2]];
+            int32_t green = GreenChroma(psrc[0], psrc[2]);
             int32_t red = v_table[psrc[2]];
 
             int32_t Y = luminance_table[psrc[1] & 0xFE];
@@ -3164,7 +3178,7 @@ void blipvert::Y41T_to_RGB565(Stage* in, Stage* out)
                 saturation_table[Y + blue]);
 
             blue = u_table[psrc[4]];
-            green = uv_table[psrc[4]][psrc[6]];
+            green = GreenChroma(psrc[4], psrc[6]);
             red = v_table[psrc[6]];
 
             Y = luminance_table[psrc[8] & 0xFE];
@@ -3215,7 +3229,7 @@ void blipvert::Y41T_to_RGB555(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[0]];
-            int32_t green = uv_table[psrc[0]][psrc[2]];
+            int32_t green = GreenChroma(psrc[0], psrc[2]);
             int32_t red = v_table[psrc[2]];
 
             int32_t Y = luminance_table[psrc[1] & 0xFE];
@@ -3239,7 +3253,7 @@ void blipvert::Y41T_to_RGB555(Stage* in, Stage* out)
                 saturation_table[Y + blue]);
 
             blue = u_table[psrc[4]];
-            green = uv_table[psrc[4]][psrc[6]];
+            green = GreenChroma(psrc[4], psrc[6]);
             red = v_table[psrc[6]];
 
             Y = luminance_table[psrc[8] & 0xFE];
@@ -3291,7 +3305,7 @@ void blipvert::Y41T_to_ARGB1555(Stage* in, Stage* out)
         while (hcount)
         {
             int32_t blue = u_table[psrc[0]];
-            int32_t green = uv_table[psrc[0]][psrc[2]];
+            int32_t green = GreenChroma(psrc[0], psrc[2]);
             int32_t red = v_table[psrc[2]];
 
             int32_t Y = luminance_table[psrc[1] & 0xFE];
@@ -3319,7 +3333,7 @@ void blipvert::Y41T_to_ARGB1555(Stage* in, Stage* out)
                 saturation_table[Y + blue]);
 
             blue = u_table[psrc[4]];
-            green = uv_table[psrc[4]][psrc[6]];
+            green = GreenChroma(psrc[4], psrc[6]);
             red = v_table[psrc[6]];
 
             Y = luminance_table[psrc[8] & 0xFE];
@@ -3385,7 +3399,7 @@ void blipvert::YV16_to_RGB32(Stage* in, Stage* out)
         for (int16_t x = 0; x < uv_width; x++)
         {
             int32_t bprime = u_table[*up];
-            int32_t gprime = uv_table[*up][*vp];
+            int32_t gprime = GreenChroma(*up, *vp);
             int32_t rprime = v_table[*vp];
 
             int32_t Y = luminance_table[*yp++];
@@ -3436,7 +3450,7 @@ void blipvert::YV16_to_RGB24(Stage* in, Stage* out)
         for (int16_t x = 0; x < uv_width; x++)
         {
             int32_t bprime = u_table[*up];
-            int32_t gprime = uv_table[*up][*vp];
+            int32_t gprime = GreenChroma(*up, *vp);
             int32_t rprime = v_table[*vp];
 
             int32_t Y = luminance_table[*yp++];
@@ -3485,7 +3499,7 @@ void blipvert::YV16_to_RGB565(Stage* in, Stage* out)
         for (int16_t x = 0; x < uv_width; x++)
         {
             int32_t bprime = u_table[*up];
-            int32_t gprime = uv_table[*up][*vp];
+            int32_t gprime = GreenChroma(*up, *vp);
             int32_t rprime = v_table[*vp];
 
             int32_t Y = luminance_table[*yp++];
@@ -3537,7 +3551,7 @@ void blipvert::YV16_to_RGB555(Stage* in, Stage* out)
         for (int16_t x = 0; x < uv_width; x++)
         {
             int32_t bprime = u_table[*up];
-            int32_t gprime = uv_table[*up][*vp];
+            int32_t gprime = GreenChroma(*up, *vp);
             int32_t rprime = v_table[*vp];
 
             int32_t Y = luminance_table[*yp++];
@@ -3565,3 +3579,546 @@ void blipvert::YV16_to_RGB555(Stage* in, Stage* out)
         out_buf += out_stride;
     }
 }
+
+#if defined(BLIPVERT_X86_SIMD)
+
+//
+// SSE4.1 and AVX2 packed Y422 to RGB
+//
+// These produce exactly the same bytes as the table-driven transforms above. The luminance and the
+// blue and red chroma terms are reproduced with fixed-point arithmetic that was checked against
+// every entry of luminance_table, u_table and v_table. The green term cannot be reproduced that way,
+// since a few entries of uv_table carry double precision rounding, so it is still read from uv_table
+// unless the library is built with BLIPVERT_FIXED_POINT_GREEN, see LookupTables.h.
+// The add and clamp through saturation_table becomes a 16-bit add and an unsigned saturating pack.
+//
+
+#define Y422_LUMA_SCALE 38142           // trunc(1.164 * Y) == (Y * 38142) >> 15
+#define Y422_BLUE_SCALE 4133            // trunc(2.018 * U - 276.928) == (U * 4133 - 567171) / 2048
+#define Y422_BLUE_OFFSET (-567171)
+#define Y422_RED_SCALE 13075            // trunc(1.596 * V - 204.288) == (V * 13075 - 1673635) / 8192
+#define Y422_RED_OFFSET (-1673635)
+
+// Builds the pshufb mask that gathers the 8 Y bytes of 4 macro-pixels into bytes 0-7,
+// their 4 U bytes into bytes 8-11 and their 4 V bytes into bytes 12-15.
+static void BuildY422ShuffleMask(Stage* in, int8_t* mask)
+{
+    for (int8_t macro = 0; macro < 4; macro++)
+    {
+        int8_t base = macro * 4;
+        mask[macro * 2] = base + static_cast<int8_t>(in->y0_index);
+        mask[macro * 2 + 1] = base + static_cast<int8_t>(in->y1_index);
+        mask[8 + macro] = base + static_cast<int8_t>(in->u_index);
+        mask[12 + macro] = base + static_cast<int8_t>(in->v_index);
+    }
+}
+
+// Transforms the columns a SIMD kernel left over with the table-driven version of the transform.
+static void Y422RemainingColumns(t_transformfunc transform, Stage* in, Stage* out, int32_t done, int32_t out_bytes_per_pixel)
+{
+    if (done >= in->width)
+        return;
+
+    Stage in_strip = *in;
+    Stage out_strip = *out;
+    in_strip.buf += done * 2;
+    in_strip.width -= done;
+    out_strip.buf += done * out_bytes_per_pixel;
+    out_strip.width -= done;
+    transform(&in_strip, &out_strip);
+}
+
+// Truncating (round toward zero) arithmetic shift right of signed 32-bit values.
+#define TruncShift32_SSE(value, bits) _mm_srai_epi32(_mm_add_epi32(value, _mm_srli_epi32(_mm_srai_epi32(value, 31), 32 - (bits))), bits)
+#define TruncShift32_AVX2(value, bits) _mm256_srai_epi32(_mm256_add_epi32(value, _mm256_srli_epi32(_mm256_srai_epi32(value, 31), 32 - (bits))), bits)
+
+// Decodes 16 pixels (32 bytes) of a packed Y422 row into 16 blue, green and red bytes.
+BLIPVERT_TARGET_SSE41 static inline void DecodeY422x16_SSE41(const uint8_t* psrc, __m128i shuffle, __m128i& blue, __m128i& green, __m128i& red)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i blue_coeff = _mm_set1_epi32(Y422_BLUE_SCALE);                       // (u * scale) + (v * 0)
+    const __m128i red_coeff = _mm_set1_epi32(Y422_RED_SCALE << 16);                   // (u * 0) + (v * scale)
+
+    __m128i s0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc)), shuffle);
+    __m128i s1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc + 16)), shuffle);
+
+    __m128i luma = _mm_unpacklo_epi64(s0, s1);                                        // Y0 - Y15
+    __m128i chroma = _mm_unpackhi_epi32(s0, s1);                                      // U0 - U7, V0 - V7
+    __m128i u16 = _mm_unpacklo_epi8(chroma, zero);
+    __m128i v16 = _mm_unpackhi_epi8(chroma, zero);
+    __m128i uv_lo = _mm_unpacklo_epi16(u16, v16);
+    __m128i uv_hi = _mm_unpackhi_epi16(u16, v16);
+
+    __m128i b_lo = TruncShift32_SSE(_mm_add_epi32(_mm_madd_epi16(uv_lo, blue_coeff), _mm_set1_epi32(Y422_BLUE_OFFSET)), 11);
+    __m128i b_hi = TruncShift32_SSE(_mm_add_epi32(_mm_madd_epi16(uv_hi, blue_coeff), _mm_set1_epi32(Y422_BLUE_OFFSET)), 11);
+    __m128i r_lo = TruncShift32_SSE(_mm_add_epi32(_mm_madd_epi16(uv_lo, red_coeff), _mm_set1_epi32(Y422_RED_OFFSET)), 13);
+    __m128i r_hi = TruncShift32_SSE(_mm_add_epi32(_mm_madd_epi16(uv_hi, red_coeff), _mm_set1_epi32(Y422_RED_OFFSET)), 13);
+
+#if defined(BLIPVERT_FIXED_POINT_GREEN)
+    const __m128i green_coeff = _mm_unpacklo_epi16(_mm_set1_epi16(static_cast<int16_t>(UV_GREEN_U_SCALE)), _mm_set1_epi16(static_cast<int16_t>(UV_GREEN_V_SCALE)));
+    __m128i g_lo = TruncShift32_SSE(_mm_add_epi32(_mm_madd_epi16(uv_lo, green_coeff), _mm_set1_epi32(UV_GREEN_OFFSET)), UV_GREEN_SHIFT);
+    __m128i g_hi = TruncShift32_SSE(_mm_add_epi32(_mm_madd_epi16(uv_hi, green_coeff), _mm_set1_epi32(UV_GREEN_OFFSET)), UV_GREEN_SHIFT);
+#else
+    const __m128i index_coeff = _mm_set1_epi32((1 << 16) | 256);                      // (u * 256) + v
+    const int32_t* uv_flat = &uv_table[0][0];
+
+    alignas(16) int32_t index[8];
+    _mm_store_si128(reinterpret_cast<__m128i*>(index), _mm_madd_epi16(uv_lo, index_coeff));
+    _mm_store_si128(reinterpret_cast<__m128i*>(index + 4), _mm_madd_epi16(uv_hi, index_coeff));
+    __m128i g_lo = _mm_set_epi32(uv_flat[index[3]], uv_flat[index[2]], uv_flat[index[1]], uv_flat[index[0]]);
+    __m128i g_hi = _mm_set_epi32(uv_flat[index[7]], uv_flat[index[6]], uv_flat[index[5]], uv_flat[index[4]]);
+#endif
+
+    // One chroma term per macro-pixel, repeated for both of its pixels.
+    __m128i bprime = _mm_packs_epi32(b_lo, b_hi);
+    __m128i gprime = _mm_packs_epi32(g_lo, g_hi);
+    __m128i rprime = _mm_packs_epi32(r_lo, r_hi);
+
+    const __m128i luma_scale = _mm_set1_epi16(static_cast<int16_t>(Y422_LUMA_SCALE));
+    __m128i y_lo = _mm_mulhi_epu16(_mm_slli_epi16(_mm_unpacklo_epi8(luma, zero), 1), luma_scale);
+    __m128i y_hi = _mm_mulhi_epu16(_mm_slli_epi16(_mm_unpackhi_epi8(luma, zero), 1), luma_scale);
+
+    blue = _mm_packus_epi16(_mm_add_epi16(y_lo, _mm_unpacklo_epi16(bprime, bprime)), _mm_add_epi16(y_hi, _mm_unpackhi_epi16(bprime, bprime)));
+    green = _mm_packus_epi16(_mm_add_epi16(y_lo, _mm_unpacklo_epi16(gprime, gprime)), _mm_add_epi16(y_hi, _mm_unpackhi_epi16(gprime, gprime)));
+    red = _mm_packus_epi16(_mm_add_epi16(y_lo, _mm_unpacklo_epi16(rprime, rprime)), _mm_add_epi16(y_hi, _mm_unpackhi_epi16(rprime, rprime)));
+}
+
+// Writes 4 BGRA vectors (16 pixels) as 48 bytes of RGB24.
+BLIPVERT_TARGET_SSE41 static inline void StoreBGRAasRGB24_SSE41(uint8_t* pdst, __m128i p0, __m128i p1, __m128i p2, __m128i p3)
+{
+    const __m128i drop_alpha = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    p0 = _mm_shuffle_epi8(p0, drop_alpha);
+    p1 = _mm_shuffle_epi8(p1, drop_alpha);
+    p2 = _mm_shuffle_epi8(p2, drop_alpha);
+    p3 = _mm_shuffle_epi8(p3, drop_alpha);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pdst), _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pdst + 16), _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pdst + 32), _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+}
+
+BLIPVERT_TARGET_SSE41 static inline __m128i PackRGB565_SSE41(__m128i r16, __m128i g16, __m128i b16)
+{
+    return _mm_or_si128(_mm_or_si128(_mm_slli_epi16(_mm_and_si128(r16, _mm_set1_epi16(0xF8)), 8),
+        _mm_slli_epi16(_mm_and_si128(g16, _mm_set1_epi16(0xFC)), 3)),
+        _mm_srli_epi16(b16, 3));
+}
+
+BLIPVERT_TARGET_SSE41 static inline __m128i PackRGB555_SSE41(__m128i r16, __m128i g16, __m128i b16)
+{
+    return _mm_or_si128(_mm_or_si128(_mm_set1_epi16(static_cast<int16_t>(RGB555_ALPHA_MASK)),
+        _mm_slli_epi16(_mm_and_si128(r16, _mm_set1_epi16(0xF8)), 7)),
+        _mm_or_si128(_mm_slli_epi16(_mm_and_si128(g16, _mm_set1_epi16(0xF8)), 2), _mm_srli_epi16(b16, 3)));
+}
+
+BLIPVERT_TARGET_SSE41 void blipvert::PackedY422_to_RGB32_SSE41(Stage* in, Stage* out)
+{
+    uint8_t* in_buf = in->buf;
+    uint8_t* out_buf = out->buf;
+    int32_t width = in->width & ~15;
+    int32_t height = in->height;
+    int32_t in_stride = in->stride;
+    int32_t out_stride = out->stride;
+
+    alignas(16) int8_t mask[16];
+    BuildY422ShuffleMask(in, mask);
+    const __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+    const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xFF));
+
+    while (height)
+    {
+        uint8_t* psrc = in_buf;
+        uint8_t* pdst = out_buf;
+        bool stream = StreamRow(out, pdst, 16);
+        for (int32_t x = 0; x < width; x += 16)
+        {
+            __m128i blue, green, red;
+            DecodeY422x16_SSE41(psrc, shuffle, blue, green, red);
+
+            __m128i bg_lo = _mm_unpacklo_epi8(blue, green);
+            __m128i bg_hi = _mm_unpackhi_epi8(blue, green);
+            __m128i ra_lo = _mm_unpacklo_epi8(red, alpha);
+            __m128i ra_hi = _mm_unpackhi_epi8(red, alpha);
+            StoreSI128(pdst, _mm_unpacklo_epi16(bg_lo, ra_lo), stream);
+            StoreSI128(pdst + 16, _mm_unpackhi_epi16(bg_lo, ra_lo), stream);
+            StoreSI128(pdst + 32, _mm_unpacklo_epi16(bg_hi, ra_hi), stream);
+            StoreSI128(pdst + 48, _mm_unpackhi_epi16(bg_hi, ra_hi), stream);
+
+            psrc += 32;
+            pdst += 64;
+        }
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+        height--;
+    }
+
+    EndStreaming(out);
+    Y422RemainingColumns(PackedY422_to_RGB32, in, out, width, 4);
+}
+
+BLIPVERT_TARGET_SSE41 void blipvert::PackedY422_to_RGB24_SSE41(Stage* in, Stage* out)
+{
+    uint8_t* in_buf = in->buf;
+    uint8_t* out_buf = out->buf;
+    int32_t width = in->width & ~15;
+    int32_t height = in->height;
+    int32_t in_stride = in->stride;
+    int32_t out_stride = out->stride;
+
+    alignas(16) int8_t mask[16];
+    BuildY422ShuffleMask(in, mask);
+    const __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+    const __m128i zero = _mm_setzero_si128();
+
+    while (height)
+    {
+        uint8_t* psrc = in_buf;
+        uint8_t* pdst = out_buf;
+        for (int32_t x = 0; x < width; x += 16)
+        {
+            __m128i blue, green, red;
+            DecodeY422x16_SSE41(psrc, shuffle, blue, green, red);
+
+            __m128i bg_lo = _mm_unpacklo_epi8(blue, green);
+            __m128i bg_hi = _mm_unpackhi_epi8(blue, green);
+            __m128i r_lo = _mm_unpacklo_epi8(red, zero);
+            __m128i r_hi = _mm_unpackhi_epi8(red, zero);
+            StoreBGRAasRGB24_SSE41(pdst, _mm_unpacklo_epi16(bg_lo, r_lo), _mm_unpackhi_epi16(bg_lo, r_lo),
+                _mm_unpacklo_epi16(bg_hi, r_hi), _mm_unpackhi_epi16(bg_hi, r_hi));
+
+            psrc += 32;
+            pdst += 48;
+        }
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+        height--;
+    }
+
+    Y422RemainingColumns(PackedY422_to_RGB24, in, out, width, 3);
+}
+
+BLIPVERT_TARGET_SSE41 void blipvert::PackedY422_to_RGB565_SSE41(Stage* in, Stage* out)
+{
+    uint8_t* in_buf = in->buf;
+    uint8_t* out_buf = out->buf;
+    int32_t width = in->width & ~15;
+    int32_t height = in->height;
+    int32_t in_stride = in->stride;
+    int32_t out_stride = out->stride;
+
+    alignas(16) int8_t mask[16];
+    BuildY422ShuffleMask(in, mask);
+    const __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+    const __m128i zero = _mm_setzero_si128();
+
+    while (height)
+    {
+        uint8_t* psrc = in_buf;
+        uint8_t* pdst = out_buf;
+        for (int32_t x = 0; x < width; x += 16)
+        {
+            __m128i blue, green, red;
+            DecodeY422x16_SSE41(psrc, shuffle, blue, green, red);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pdst), PackRGB565_SSE41(_mm_unpacklo_epi8(red, zero),
+                _mm_unpacklo_epi8(green, zero), _mm_unpacklo_epi8(blue, zero)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pdst + 16), PackRGB565_SSE41(_mm_unpackhi_epi8(red, zero),
+                _mm_unpackhi_epi8(green, zero), _mm_unpackhi_epi8(blue, zero)));
+
+            psrc += 32;
+            pdst += 32;
+        }
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+        height--;
+    }
+
+    Y422RemainingColumns(PackedY422_to_RGB565, in, out, width, 2);
+}
+
+BLIPVERT_TARGET_SSE41 void blipvert::PackedY422_to_RGB555_SSE41(Stage* in, Stage* out)
+{
+    uint8_t* in_buf = in->buf;
+    uint8_t* out_buf = out->buf;
+    int32_t width = in->width & ~15;
+    int32_t height = in->height;
+    int32_t in_stride = in->stride;
+    int32_t out_stride = out->stride;
+
+    alignas(16) int8_t mask[16];
+    BuildY422ShuffleMask(in, mask);
+    const __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+    const __m128i zero = _mm_setzero_si128();
+
+    while (height)
+    {
+        uint8_t* psrc = in_buf;
+        uint8_t* pdst = out_buf;
+        for (int32_t x = 0; x < width; x += 16)
+        {
+            __m128i blue, green, red;
+            DecodeY422x16_SSE41(psrc, shuffle, blue, green, red);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pdst), PackRGB555_SSE41(_mm_unpacklo_epi8(red, zero),
+                _mm_unpacklo_epi8(green, zero), _mm_unpacklo_epi8(blue, zero)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pdst + 16), PackRGB555_SSE41(_mm_unpackhi_epi8(red, zero),
+                _mm_unpackhi_epi8(green, zero), _mm_unpackhi_epi8(blue, zero)));
+
+            psrc += 32;
+            pdst += 32;
+        }
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+        height--;
+    }
+
+    Y422RemainingColumns(PackedY422_to_RGB555, in, out, width, 2);
+}
+
+// Decodes 32 pixels (64 bytes) of a packed Y422 row. Each 128-bit lane works like the SSE4.1 version:
+// the low lanes hold pixels 0 - 15 and the high lanes hold pixels 16 - 31.
+BLIPVERT_TARGET_AVX2 static inline void DecodeY422x32_AVX2(const uint8_t* psrc, __m256i shuffle, __m256i& blue, __m256i& green, __m256i& red)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i blue_coeff = _mm256_set1_epi32(Y422_BLUE_SCALE);
+    const __m256i red_coeff = _mm256_set1_epi32(Y422_RED_SCALE << 16);
+
+    __m256i m0 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc))),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc + 32)), 1);
+    __m256i m1 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc + 16))),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(psrc + 48)), 1);
+    __m256i s0 = _mm256_shuffle_epi8(m0, shuffle);
+    __m256i s1 = _mm256_shuffle_epi8(m1, shuffle);
+
+    __m256i luma = _mm256_unpacklo_epi64(s0, s1);
+    __m256i chroma = _mm256_unpackhi_epi32(s0, s1);
+    __m256i u16 = _mm256_unpacklo_epi8(chroma, zero);
+    __m256i v16 = _mm256_unpackhi_epi8(chroma, zero);
+    __m256i uv_lo = _mm256_unpacklo_epi16(u16, v16);
+    __m256i uv_hi = _mm256_unpackhi_epi16(u16, v16);
+
+    __m256i b_lo = TruncShift32_AVX2(_mm256_add_epi32(_mm256_madd_epi16(uv_lo, blue_coeff), _mm256_set1_epi32(Y422_BLUE_OFFSET)), 11);
+    __m256i b_hi = TruncShift32_AVX2(_mm256_add_epi32(_mm256_madd_epi16(uv_hi, blue_coeff), _mm256_set1_epi32(Y422_BLUE_OFFSET)), 11);
+    __m256i r_lo = TruncShift32_AVX2(_mm256_add_epi32(_mm256_madd_epi16(uv_lo, red_coeff), _mm256_set1_epi32(Y422_RED_OFFSET)), 13);
+    __m256i r_hi = TruncShift32_AVX2(_mm256_add_epi32(_mm256_madd_epi16(uv_hi, red_coeff), _mm256_set1_epi32(Y422_RED_OFFSET)), 13);
+#if defined(BLIPVERT_FIXED_POINT_GREEN)
+    const __m256i green_coeff = _mm256_unpacklo_epi16(_mm256_set1_epi16(static_cast<int16_t>(UV_GREEN_U_SCALE)), _mm256_set1_epi16(static_cast<int16_t>(UV_GREEN_V_SCALE)));
+    __m256i g_lo = TruncShift32_AVX2(_mm256_add_epi32(_mm256_madd_epi16(uv_lo, green_coeff), _mm256_set1_epi32(UV_GREEN_OFFSET)), UV_GREEN_SHIFT);
+    __m256i g_hi = TruncShift32_AVX2(_mm256_add_epi32(_mm256_madd_epi16(uv_hi, green_coeff), _mm256_set1_epi32(UV_GREEN_OFFSET)), UV_GREEN_SHIFT);
+#else
+    const __m256i index_coeff = _mm256_set1_epi32((1 << 16) | 256);
+    const int* uv_flat = reinterpret_cast<const int*>(&uv_table[0][0]);
+    __m256i g_lo = _mm256_i32gather_epi32(uv_flat, _mm256_madd_epi16(uv_lo, index_coeff), 4);
+    __m256i g_hi = _mm256_i32gather_epi32(uv_flat, _mm256_madd_epi16(uv_hi, index_coeff), 4);
+#endif
+
+    __m256i bprime = _mm256_packs_epi32(b_lo, b_hi);
+    __m256i gprime = _mm256_packs_epi32(g_lo, g_hi);
+    __m256i rprime = _mm256_packs_epi32(r_lo, r_hi);
+
+    const __m256i luma_scale = _mm256_set1_epi16(static_cast<int16_t>(Y422_LUMA_SCALE));
+    __m256i y_lo = _mm256_mulhi_epu16(_mm256_slli_epi16(_mm256_unpacklo_epi8(luma, zero), 1), luma_scale);
+    __m256i y_hi = _mm256_mulhi_epu16(_mm256_slli_epi16(_mm256_unpackhi_epi8(luma, zero), 1), luma_scale);
+
+    blue = _mm256_packus_epi16(_mm256_add_epi16(y_lo, _mm256_unpacklo_epi16(bprime, bprime)), _mm256_add_epi16(y_hi, _mm256_unpackhi_epi16(bprime, bprime)));
+    green = _mm256_packus_epi16(_mm256_add_epi16(y_lo, _mm256_unpacklo_epi16(gprime, gprime)), _mm256_add_epi16(y_hi, _mm256_unpackhi_epi16(gprime, gprime)));
+    red = _mm256_packus_epi16(_mm256_add_epi16(y_lo, _mm256_unpacklo_epi16(rprime, rprime)), _mm256_add_epi16(y_hi, _mm256_unpackhi_epi16(rprime, rprime)));
+}
+
+BLIPVERT_TARGET_AVX2 void blipvert::PackedY422_to_RGB32_AVX2(Stage* in, Stage* out)
+{
+    uint8_t* in_buf = in->buf;
+    uint8_t* out_buf = out->buf;
+    int32_t width = in->width & ~31;
+    int32_t height = in->height;
+    int32_t in_stride = in->stride;
+    int32_t out_stride = out->stride;
+
+    alignas(16) int8_t mask[16];
+    BuildY422ShuffleMask(in, mask);
+    const __m256i shuffle = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(mask)));
+    const __m256i alpha = _mm256_set1_epi8(static_cast<char>(0xFF));
+
+    while (height)
+    {
+        uint8_t* psrc = in_buf;
+        uint8_t* pdst = out_buf;
+        bool stream = StreamRow(out, pdst, 32);
+        for (int32_t x = 0; x < width; x += 32)
+        {
+            __m256i blue, green, red;
+            DecodeY422x32_AVX2(psrc, shuffle, blue, green, red);
+
+            __m256i bg_lo = _mm256_unpacklo_epi8(blue, green);
+            __m256i bg_hi = _mm256_unpackhi_epi8(blue, green);
+            __m256i ra_lo = _mm256_unpacklo_epi8(red, alpha);
+            __m256i ra_hi = _mm256_unpackhi_epi8(red, alpha);
+            __m256i p0 = _mm256_unpacklo_epi16(bg_lo, ra_lo);
+            __m256i p1 = _mm256_unpackhi_epi16(bg_lo, ra_lo);
+            __m256i p2 = _mm256_unpacklo_epi16(bg_hi, ra_hi);
+            __m256i p3 = _mm256_unpackhi_epi16(bg_hi, ra_hi);
+            StoreSI256(pdst, _mm256_permute2x128_si256(p0, p1, 0x20), stream);
+            StoreSI256(pdst + 32, _mm256_permute2x128_si256(p2, p3, 0x20), stream);
+            StoreSI256(pdst + 64, _mm256_permute2x128_si256(p0, p1, 0x31), stream);
+            StoreSI256(pdst + 96, _mm256_permute2x128_si256(p2, p3, 0x31), stream);
+
+            psrc += 64;
+            pdst += 128;
+        }
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+        height--;
+    }
+
+    EndStreaming(out);
+    Y422RemainingColumns(PackedY422_to_RGB32_SSE41, in, out, width, 4);
+}
+
+BLIPVERT_TARGET_AVX2 void blipvert::PackedY422_to_RGB24_AVX2(Stage* in, Stage* out)
+{
+    uint8_t* in_buf = in->buf;
+    uint8_t* out_buf = out->buf;
+    int32_t width = in->width & ~31;
+    int32_t height = in->height;
+    int32_t in_stride = in->stride;
+    int32_t out_stride = out->stride;
+
+    alignas(16) int8_t mask[16];
+    BuildY422ShuffleMask(in, mask);
+    const __m256i shuffle = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(mask)));
+    const __m256i zero = _mm256_setzero_si256();
+
+    while (height)
+    {
+        uint8_t* psrc = in_buf;
+        uint8_t* pdst = out_buf;
+        for (int32_t x = 0; x < width; x += 32)
+        {
+            __m256i blue, green, red;
+            DecodeY422x32_AVX2(psrc, shuffle, blue, green, red);
+
+            __m256i bg_lo = _mm256_unpacklo_epi8(blue, green);
+            __m256i bg_hi = _mm256_unpackhi_epi8(blue, green);
+            __m256i r_lo = _mm256_unpacklo_epi8(red, zero);
+            __m256i r_hi = _mm256_unpackhi_epi8(red, zero);
+            __m256i p0 = _mm256_unpacklo_epi16(bg_lo, r_lo);
+            __m256i p1 = _mm256_unpackhi_epi16(bg_lo, r_lo);
+            __m256i p2 = _mm256_unpacklo_epi16(bg_hi, r_hi);
+            __m256i p3 = _mm256_unpackhi_epi16(bg_hi, r_hi);
+            StoreBGRAasRGB24_SSE41(pdst, _mm256_castsi256_si128(p0), _mm256_castsi256_si128(p1),
+                _mm256_castsi256_si128(p2), _mm256_castsi256_si128(p3));
+            StoreBGRAasRGB24_SSE41(pdst + 48, _mm256_extracti128_si256(p0, 1), _mm256_extracti128_si256(p1, 1),
+                _mm256_extracti128_si256(p2, 1), _mm256_extracti128_si256(p3, 1));
+
+            psrc += 64;
+            pdst += 96;
+        }
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+        height--;
+    }
+
+    Y422RemainingColumns(PackedY422_to_RGB24_SSE41, in, out, width, 3);
+}
+
+BLIPVERT_TARGET_AVX2 static inline __m256i PackRGB565_AVX2(__m256i r16, __m256i g16, __m256i b16)
+{
+    return _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(r16, _mm256_set1_epi16(0xF8)), 8),
+        _mm256_slli_epi16(_mm256_and_si256(g16, _mm256_set1_epi16(0xFC)), 3)),
+        _mm256_srli_epi16(b16, 3));
+}
+
+BLIPVERT_TARGET_AVX2 static inline __m256i PackRGB555_AVX2(__m256i r16, __m256i g16, __m256i b16)
+{
+    return _mm256_or_si256(_mm256_or_si256(_mm256_set1_epi16(static_cast<int16_t>(RGB555_ALPHA_MASK)),
+        _mm256_slli_epi16(_mm256_and_si256(r16, _mm256_set1_epi16(0xF8)), 7)),
+        _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(g16, _mm256_set1_epi16(0xF8)), 2), _mm256_srli_epi16(b16, 3)));
+}
+
+BLIPVERT_TARGET_AVX2 void blipvert::PackedY422_to_RGB565_AVX2(Stage* in, Stage* out)
+{
+    uint8_t* in_buf = in->buf;
+    uint8_t* out_buf = out->buf;
+    int32_t width = in->width & ~31;
+    int32_t height = in->height;
+    int32_t in_stride = in->stride;
+    int32_t out_stride = out->stride;
+
+    alignas(16) int8_t mask[16];
+    BuildY422ShuffleMask(in, mask);
+    const __m256i shuffle = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(mask)));
+    const __m256i zero = _mm256_setzero_si256();
+
+    while (height)
+    {
+        uint8_t* psrc = in_buf;
+        uint8_t* pdst = out_buf;
+        for (int32_t x = 0; x < width; x += 32)
+        {
+            __m256i blue, green, red;
+            DecodeY422x32_AVX2(psrc, shuffle, blue, green, red);
+
+            __m256i lo = PackRGB565_AVX2(_mm256_unpacklo_epi8(red, zero), _mm256_unpacklo_epi8(green, zero), _mm256_unpacklo_epi8(blue, zero));
+            __m256i hi = PackRGB565_AVX2(_mm256_unpackhi_epi8(red, zero), _mm256_unpackhi_epi8(green, zero), _mm256_unpackhi_epi8(blue, zero));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(pdst), _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(pdst + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+
+            psrc += 64;
+            pdst += 64;
+        }
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+        height--;
+    }
+
+    Y422RemainingColumns(PackedY422_to_RGB565_SSE41, in, out, width, 2);
+}
+
+BLIPVERT_TARGET_AVX2 void blipvert::PackedY422_to_RGB555_AVX2(Stage* in, Stage* out)
+{
+    uint8_t* in_buf = in->buf;
+    uint8_t* out_buf = out->buf;
+    int32_t width = in->width & ~31;
+    int32_t height = in->height;
+    int32_t in_stride = in->stride;
+    int32_t out_stride = out->stride;
+
+    alignas(16) int8_t mask[16];
+    BuildY422ShuffleMask(in, mask);
+    const __m256i shuffle = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(mask)));
+    const __m256i zero = _mm256_setzero_si256();
+
+    while (height)
+    {
+        uint8_t* psrc = in_buf;
+        uint8_t* pdst = out_buf;
+        for (int32_t x = 0; x < width; x += 32)
+        {
+            __m256i blue, green, red;
+            DecodeY422x32_AVX2(psrc, shuffle, blue, green, red);
+
+            __m256i lo = PackRGB555_AVX2(_mm256_unpacklo_epi8(red, zero), _mm256_unpacklo_epi8(green, zero), _mm256_unpacklo_epi8(blue, zero));
+            __m256i hi = PackRGB555_AVX2(_mm256_unpackhi_epi8(red, zero), _mm256_unpackhi_epi8(green, zero), _mm256_unpackhi_epi8(blue, zero));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(pdst), _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(pdst + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+
+            psrc += 64;
+            pdst += 64;
+        }
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+        height--;
+    }
+
+    Y422RemainingColumns(PackedY422_to_RGB555_SSE41, in, out, width, 2);
+}
+
+#endif
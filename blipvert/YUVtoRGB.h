@@ -29,6 +29,7 @@
 
 #include "blipverttypes.h"
 #include "Staging.h"
+#include "CpuFeatures.h"
 
 namespace blipvert
 {
@@ -39,6 +40,21 @@ namespace blipvert
     void PackedY422_to_RGB565(Stage* in, Stage* out);
     void PackedY422_to_RGB555(Stage* in, Stage* out);
 
+#if defined(BLIPVERT_X86_SIMD)
+    // SSE4.1 and AVX2 versions of the packed Y422 transforms. Their output is identical to the
+    // versions above. InitializeLibrary() selects them when the processor supports them.
+
+    void PackedY422_to_RGB32_SSE41(Stage* in, Stage* out);
+    void PackedY422_to_RGB24_SSE41(Stage* in, Stage* out);
+    void PackedY422_to_RGB565_SSE41(Stage* in, Stage* out);
+    void PackedY422_to_RGB555_SSE41(Stage* in, Stage* out);
+
+    void PackedY422_to_RGB32_AVX2(Stage* in, Stage* out);
+    void PackedY422_to_RGB24_AVX2(Stage* in, Stage* out);
+    void PackedY422_to_RGB565_AVX2(Stage* in, Stage* out);
+    void PackedY422_to_RGB555_AVX2(Stage* in, Stage* out);
+#endif
+
     void CLJR_to_RGB32(Stage* in, Stage* out);
     void CLJR_to_RGB24(Stage* in, Stage* out);
     void CLJR_to_RGB565(Stage* in, Stage* out);
@@ -29,9 +29,14 @@
 #include "CommonMacros.h"
 #include "Utilities.h"
 #include "LookupTables.h"
+#include "CpuFeatures.h"
 
 #include <cstring>
 
+#if defined(BLIPVERT_X86_SIMD)
+#include <immintrin.h>
+#endif
+
 using namespace blipvert;
 
 //
@@ -98,7 +103,7 @@ void blipvert::PlanarYUV_to_PlanarYUV(Stage* in, Stage* out)
     int32_t out_decimation = out->decimation;
 
     // Copy the y plane
-    if (out_y_stride != in_y_stride || out->flipped)
+    if (out_y_stride != in_y_stride || out->flipped || out->tiled)
     {
         for (int32_t line = 0; line < height; line++)
         {
@@ -115,7 +120,7 @@ void blipvert::PlanarYUV_to_PlanarYUV(Stage* in, Stage* out)
     if (out_decimation == in_decimation)
     {
         // Copy the u & v planes without scaling
-        if (out_uv_stride != in_uv_stride || out->flipped)
+        if (out_uv_stride != in_uv_stride || out->flipped || out->tiled)
         {
             for (int32_t line = 0; line < out_uv_height; line++)
             {
@@ -1113,6 +1118,7 @@ void blipvert::IYU2_to_IMCx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uplane = out->uplane;
@@ -1150,8 +1156,8 @@ void blipvert::IYU2_to_IMCx(Stage* in, Stage* out)
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
 
-        out_uplane += out_stride;
-        out_vplane += out_stride;
+        out_uplane += out_uv_stride;
+        out_vplane += out_uv_stride;
     }
 }
 
@@ -1159,6 +1165,7 @@ void blipvert::IMCx_to_IYU2(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_uv_height = in->uv_slice_height;
@@ -1206,8 +1213,8 @@ void blipvert::IMCx_to_IYU2(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        in_uplane += in_stride;
-        in_vplane += in_stride;
+        in_uplane += in_uv_stride;
+        in_vplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 }
@@ -2062,7 +2069,7 @@ void blipvert::PlanarYUV_to_Y800(Stage* in, Stage* out)
 
     // Copy the y plane
 
-    if (out_stride != in_y_stride || out->flipped)
+    if (out_stride != in_y_stride || out->flipped || out->tiled)
     {
         for (int32_t y = 0; y < height; y++)
         {
@@ -2469,7 +2476,7 @@ void blipvert::Y800_to_PlanarYUV(Stage* in, Stage* out)
     uint8_t* out_buf = out->buf;
     int32_t out_y_stride = out->y_stride;
 
-    if (out_y_stride == in_stride)
+    if (out_y_stride == in_stride && !out->flipped && !out->tiled)
     {
         memcpy(out_buf, in_buf, out_y_stride * height);
     }
@@ -2493,6 +2500,7 @@ void blipvert::Y800_to_IMCx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uplane = out->uplane;
@@ -2502,11 +2510,11 @@ void blipvert::Y800_to_IMCx(Stage* in, Stage* out)
     {
         memset(out_uplane, 0, out_uv_width);
         memset(out_vplane, 0, out_uv_width);
-        out_uplane += out_stride;
-        out_vplane += out_stride;
+        out_uplane += out_uv_stride;
+        out_vplane += out_uv_stride;
     }
 
-    if (out_stride == in_stride)
+    if (out_stride == in_stride && !out->flipped && !out->tiled)
     {
         memcpy(out_buf, in_buf, out_stride * height);
     }
@@ -2533,7 +2541,7 @@ void blipvert::IMCx_to_Y800(Stage* in, Stage* out)
 
     // Copy the y plane
 
-    if (out_stride != in_stride || out->flipped)
+    if (out_stride != in_stride || out->flipped || out->tiled)
     {
         for (int32_t y = 0; y < height; y++)
         {
@@ -2646,6 +2654,7 @@ void blipvert::Y16_to_IMCx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uplane = out->uplane;
@@ -2655,8 +2664,8 @@ void blipvert::Y16_to_IMCx(Stage* in, Stage* out)
     {
         memset(out_uplane, 0, out_uv_width);
         memset(out_vplane, 0, out_uv_width);
-        out_uplane += out_stride;
-        out_vplane += out_stride;
+        out_uplane += out_uv_stride;
+        out_vplane += out_uv_stride;
     }
 
     for (int32_t y = 0; y < height; y++)
@@ -2944,6 +2953,7 @@ void blipvert::Y41P_to_IMCx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uplane = out->uplane;
@@ -3004,8 +3014,8 @@ void blipvert::Y41P_to_IMCx(Stage* in, Stage* out)
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
 
-        out_uplane += out_stride;
-        out_vplane += out_stride;
+        out_uplane += out_uv_stride;
+        out_vplane += out_uv_stride;
     }
 }
 
@@ -3013,6 +3023,7 @@ void blipvert::IMCx_to_Y41P(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t uv_width = in->uv_width;
@@ -3049,12 +3060,12 @@ void blipvert::IMCx_to_Y41P(Stage* in, Stage* out)
 
             pdst[out_stride] = static_cast<uint8_t>((static_cast<uint16_t>(up[0]) + \
                 static_cast<uint16_t>(up[1]) + \
-                static_cast<uint16_t>(up[in_stride]) + \
-                static_cast<uint16_t>(up[1 + in_stride])) >> 2);
+                static_cast<uint16_t>(up[in_uv_stride]) + \
+                static_cast<uint16_t>(up[1 + in_uv_stride])) >> 2);
             pdst[2 + out_stride] = static_cast<uint8_t>((static_cast<uint16_t>(vp[0]) + \
                 static_cast<uint16_t>(vp[1]) + \
-                static_cast<uint16_t>(vp[in_stride]) + \
-                static_cast<uint16_t>(vp[1 + in_stride])) >> 2);
+                static_cast<uint16_t>(vp[in_uv_stride]) + \
+                static_cast<uint16_t>(vp[1 + in_uv_stride])) >> 2);
             pdst[1 + out_stride] = yp[in_stride];
             pdst[3 + out_stride] = yp[1 + in_stride];
             pdst[5 + out_stride] = yp[2 + in_stride];
@@ -3069,12 +3080,12 @@ void blipvert::IMCx_to_Y41P(Stage* in, Stage* out)
 
             pdst[4 + out_stride] = static_cast<uint8_t>((static_cast<uint16_t>(up[2]) + \
                 static_cast<uint16_t>(up[3]) + \
-                static_cast<uint16_t>(up[2 + in_stride]) + \
-                static_cast<uint16_t>(up[3 + in_stride])) >> 2);
+                static_cast<uint16_t>(up[2 + in_uv_stride]) + \
+                static_cast<uint16_t>(up[3 + in_uv_stride])) >> 2);
             pdst[6 + out_stride] = static_cast<uint8_t>((static_cast<uint16_t>(vp[2]) + \
                 static_cast<uint16_t>(vp[3]) + \
-                static_cast<uint16_t>(vp[2 + in_stride]) + \
-                static_cast<uint16_t>(vp[3 + in_stride])) >> 2);
+                static_cast<uint16_t>(vp[2 + in_uv_stride]) + \
+                static_cast<uint16_t>(vp[3 + in_uv_stride])) >> 2);
             pdst[8 + out_stride] = yp[4 + in_stride];
             pdst[9 + out_stride] = yp[5 + in_stride];
             pdst[10 + out_stride] = yp[6 + in_stride];
@@ -3087,8 +3098,8 @@ void blipvert::IMCx_to_Y41P(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        uplane += in_stride;
-        vplane += in_stride;
+        uplane += in_uv_stride;
+        vplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 
@@ -3135,6 +3146,7 @@ void blipvert::IMCx_to_Y41T(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t uv_width = in->uv_width;
@@ -3171,12 +3183,12 @@ void blipvert::IMCx_to_Y41T(Stage* in, Stage* out)
 
             pdst[out_stride] = static_cast<uint8_t>((static_cast<uint16_t>(up[0]) + \
                 static_cast<uint16_t>(up[1]) + \
-                static_cast<uint16_t>(up[in_stride]) + \
-                static_cast<uint16_t>(up[1 + in_stride])) >> 2);
+                static_cast<uint16_t>(up[in_uv_stride]) + \
+                static_cast<uint16_t>(up[1 + in_uv_stride])) >> 2);
             pdst[2 + out_stride] = static_cast<uint8_t>((static_cast<uint16_t>(vp[0]) + \
                 static_cast<uint16_t>(vp[1]) + \
-                static_cast<uint16_t>(vp[in_stride]) + \
-                static_cast<uint16_t>(vp[1 + in_stride])) >> 2);
+                static_cast<uint16_t>(vp[in_uv_stride]) + \
+                static_cast<uint16_t>(vp[1 + in_uv_stride])) >> 2);
             pdst[1 + out_stride] = yp[in_stride] | 0x01;
             pdst[3 + out_stride] = yp[1 + in_stride] | 0x01;
             pdst[5 + out_stride] = yp[2 + in_stride] | 0x01;
@@ -3191,12 +3203,12 @@ void blipvert::IMCx_to_Y41T(Stage* in, Stage* out)
 
             pdst[4 + out_stride] = static_cast<uint8_t>((static_cast<uint16_t>(up[2]) + \
                 static_cast<uint16_t>(up[3]) + \
-                static_cast<uint16_t>(up[2 + in_stride]) + \
-                static_cast<uint16_t>(up[3 + in_stride])) >> 2);
+                static_cast<uint16_t>(up[2 + in_uv_stride]) + \
+                static_cast<uint16_t>(up[3 + in_uv_stride])) >> 2);
             pdst[6 + out_stride] = static_cast<uint8_t>((static_cast<uint16_t>(vp[2]) + \
                 static_cast<uint16_t>(vp[3]) + \
-                static_cast<uint16_t>(vp[2 + in_stride]) + \
-                static_cast<uint16_t>(vp[3 + in_stride])) >> 2);
+                static_cast<uint16_t>(vp[2 + in_uv_stride]) + \
+                static_cast<uint16_t>(vp[3 + in_uv_stride])) >> 2);
             pdst[8 + out_stride] = yp[4 + in_stride] | 0x01;
             pdst[9 + out_stride] = yp[5 + in_stride] | 0x01;
             pdst[10 + out_stride] = yp[6 + in_stride] | 0x01;
@@ -3209,8 +3221,8 @@ void blipvert::IMCx_to_Y41T(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        uplane += in_stride;
-        vplane += in_stride;
+        uplane += in_uv_stride;
+        vplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 
@@ -3317,6 +3329,7 @@ void blipvert::CLJR_to_IMCx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uplane = out->uplane;
@@ -3361,8 +3374,8 @@ void blipvert::CLJR_to_IMCx(Stage* in, Stage* out)
         in_buf += in_stride_x_2;
         out_buf += y_stride_x_2;
 
-        out_uplane += out_stride;
-        out_vplane += out_stride;
+        out_uplane += out_uv_stride;
+        out_vplane += out_uv_stride;
     }
 }
 
@@ -3370,6 +3383,7 @@ void blipvert::IMCx_to_CLJR(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_uv_width = in->uv_width;
@@ -3404,8 +3418,8 @@ void blipvert::IMCx_to_CLJR(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        in_uplane += in_stride;
-        in_vplane += in_stride;
+        in_uplane += in_uv_stride;
+        in_vplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 }
@@ -3837,6 +3851,7 @@ void blipvert::AYUV_to_IMCx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uplane = out->uplane;
@@ -3876,8 +3891,8 @@ void blipvert::AYUV_to_IMCx(Stage* in, Stage* out)
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
 
-        out_uplane += out_stride;
-        out_vplane += out_stride;
+        out_uplane += out_uv_stride;
+        out_vplane += out_uv_stride;
     }
 }
 
@@ -3885,6 +3900,7 @@ void blipvert::IMCx_to_AYUV(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_uv_width = in->uv_width;
@@ -3938,8 +3954,8 @@ void blipvert::IMCx_to_AYUV(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        in_uplane += in_stride;
-        in_vplane += in_stride;
+        in_uplane += in_uv_stride;
+        in_vplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 }
@@ -3957,6 +3973,7 @@ void blipvert::PackedY422_to_IMCx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uplane = out->uplane;
@@ -3989,8 +4006,8 @@ void blipvert::PackedY422_to_IMCx(Stage* in, Stage* out)
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
 
-        out_uplane += out_stride;
-        out_vplane += out_stride;
+        out_uplane += out_uv_stride;
+        out_vplane += out_uv_stride;
     }
 }
 
@@ -3998,6 +4015,7 @@ void blipvert::IMCx_to_PackedY422(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_uv_width = in->uv_width;
@@ -4041,8 +4059,8 @@ void blipvert::IMCx_to_PackedY422(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        in_uplane += in_stride;
-        in_vplane += in_stride;
+        in_uplane += in_uv_stride;
+        in_vplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 }
@@ -4062,13 +4080,14 @@ void blipvert::PlanarYUV_to_IMCx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uplane = out->uplane;
     uint8_t* out_vplane = out->vplane;
 
     // Copy the y plane
-    if (out_stride != in_y_stride || out->flipped)
+    if (out_stride != in_y_stride || out->flipped || out->tiled)
     {
         for (int32_t line = 0; line < height; line++)
         {
@@ -4085,28 +4104,28 @@ void blipvert::PlanarYUV_to_IMCx(Stage* in, Stage* out)
     if (in_decimation == 2)
     {
         // Copy the u & v planes without scaling
-        if (out_stride != in_uv_stride || out->flipped || out->interlaced)
+        if (out_uv_stride != in_uv_stride || out->flipped || out->interlaced || out->tiled)
         {
             for (int32_t line = 0; line < out_uv_height; line++)
             {
                 memcpy(out_uplane, in_uplane, out_uv_width);
                 memcpy(out_vplane, in_vplane, out_uv_width);
-                out_uplane += out_stride;
-                out_vplane += out_stride;
+                out_uplane += out_uv_stride;
+                out_vplane += out_uv_stride;
                 in_uplane += in_uv_stride;
                 in_vplane += in_uv_stride;
             }
         }
         else
         {
-            memcpy(out_uplane, in_uplane, out_stride * out_uv_height);
-            memcpy(out_vplane, in_vplane, out_stride * out_uv_height);
+            memcpy(out_uplane, in_uplane, out_uv_stride * out_uv_height);
+            memcpy(out_vplane, in_vplane, out_uv_stride * out_uv_height);
         }
     }
     else
     {
         // Scaling from 4 to 2 decimation
-        int32_t out_uv_stride_x_2 = out_stride * 2;
+        int32_t out_uv_stride_x_2 = out_uv_stride * 2;
         uint8_t* in_up = in_uplane;
         uint8_t* in_vp = in_vplane;
         uint8_t* out_up = out_uplane;
@@ -4117,14 +4136,14 @@ void blipvert::PlanarYUV_to_IMCx(Stage* in, Stage* out)
             for (int32_t x = 0; x < in_uv_width; x++)
             {
                 out_up[dst_index] = in_up[x];
-                out_up[dst_index + out_stride] = in_up[x];
+                out_up[dst_index + out_uv_stride] = in_up[x];
                 out_vp[dst_index] = in_vp[x];
-                out_vp[dst_index + out_stride] = in_vp[x];
+                out_vp[dst_index + out_uv_stride] = in_vp[x];
                 dst_index++;
                 out_up[dst_index] = in_up[x];
-                out_up[dst_index + out_stride] = in_up[x];
+                out_up[dst_index + out_uv_stride] = in_up[x];
                 out_vp[dst_index] = in_vp[x];
-                out_vp[dst_index + out_stride] = in_vp[x];
+                out_vp[dst_index + out_uv_stride] = in_vp[x];
                 dst_index++;
             }
 
@@ -4141,6 +4160,7 @@ void blipvert::IMCx_to_PlanarYUV(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_uv_width = in->uv_width;
@@ -4158,7 +4178,7 @@ void blipvert::IMCx_to_PlanarYUV(Stage* in, Stage* out)
     int32_t out_decimation = out->decimation;
 
     // Copy the y plane
-    if (out_y_stride != in_stride || out->flipped)
+    if (out_y_stride != in_stride || out->flipped || out->tiled)
     {
         for (int32_t line = 0; line < height; line++)
         {
@@ -4175,7 +4195,7 @@ void blipvert::IMCx_to_PlanarYUV(Stage* in, Stage* out)
     if (out_decimation == 2)
     {
         // Copy the u & v planes without scaling
-        if (out_uv_stride != in_stride || out->flipped || in->interlaced)
+        if (out_uv_stride != in_uv_stride || out->flipped || in->interlaced || out->tiled)
         {
             for (int32_t line = 0; line < out_uv_height; line++)
             {
@@ -4183,8 +4203,8 @@ void blipvert::IMCx_to_PlanarYUV(Stage* in, Stage* out)
                 memcpy(out_vplane, in_vplane, out_uv_width);
                 out_uplane += out_uv_stride;
                 out_vplane += out_uv_stride;
-                in_uplane += in_stride;
-                in_vplane += in_stride;
+                in_uplane += in_uv_stride;
+                in_vplane += in_uv_stride;
             }
         }
         else
@@ -4196,7 +4216,7 @@ void blipvert::IMCx_to_PlanarYUV(Stage* in, Stage* out)
     else
     {
         // Scaling from 2 to 4 decimation
-        int32_t in_uv_stride_x_2 = in_stride * 2;
+        int32_t in_uv_stride_x_2 = in_uv_stride * 2;
 
         for (int32_t y = 0; y < in_uv_height; y += 2)
         {
@@ -4205,12 +4225,12 @@ void blipvert::IMCx_to_PlanarYUV(Stage* in, Stage* out)
             {
                 out_uplane[out_index] = static_cast<uint8_t>((static_cast<uint16_t>(in_uplane[x]) + \
                     static_cast<uint16_t>(in_uplane[x + 1]) + \
-                    static_cast<uint16_t>(in_uplane[x + in_stride]) + \
-                    static_cast<uint16_t>(in_uplane[x + in_stride + 1])) >> 2);
+                    static_cast<uint16_t>(in_uplane[x + in_uv_stride]) + \
+                    static_cast<uint16_t>(in_uplane[x + in_uv_stride + 1])) >> 2);
                 out_vplane[out_index] = static_cast<uint8_t>((static_cast<uint16_t>(in_vplane[x]) + \
                     static_cast<uint16_t>(in_vplane[x + 1]) + \
-                    static_cast<uint16_t>(in_vplane[x + in_stride]) + \
-                    static_cast<uint16_t>(in_vplane[x + in_stride + 1])) >> 2);
+                    static_cast<uint16_t>(in_vplane[x + in_uv_stride]) + \
+                    static_cast<uint16_t>(in_vplane[x + in_uv_stride + 1])) >> 2);
                 out_index++;
             }
 
@@ -4231,6 +4251,7 @@ void blipvert::IYU1_to_IMCx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uplane = out->uplane;
@@ -4272,8 +4293,8 @@ void blipvert::IYU1_to_IMCx(Stage* in, Stage* out)
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
 
-        out_uplane += out_stride;
-        out_vplane += out_stride;
+        out_uplane += out_uv_stride;
+        out_vplane += out_uv_stride;
     }
 }
 
@@ -4281,6 +4302,7 @@ void blipvert::IMCx_to_IYU1(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t uv_height = in->uv_slice_height;
@@ -4316,12 +4338,12 @@ void blipvert::IMCx_to_IYU1(Stage* in, Stage* out)
 
             pdst[out_stride] = static_cast<uint8_t>((static_cast<uint16_t>(up[0]) + \
                 static_cast<uint16_t>(up[1]) + \
-                static_cast<uint16_t>(up[in_stride]) + \
-                static_cast<uint16_t>(up[1 + in_stride])) >> 2);
+                static_cast<uint16_t>(up[in_uv_stride]) + \
+                static_cast<uint16_t>(up[1 + in_uv_stride])) >> 2);
             pdst[3 + out_stride] = static_cast<uint8_t>((static_cast<uint16_t>(vp[0]) + \
                 static_cast<uint16_t>(vp[1]) + \
-                static_cast<uint16_t>(vp[in_stride]) + \
-                static_cast<uint16_t>(vp[1 + in_stride])) >> 2);
+                static_cast<uint16_t>(vp[in_uv_stride]) + \
+                static_cast<uint16_t>(vp[1 + in_uv_stride])) >> 2);
             pdst[1 + out_stride] = yp[in_stride];
             pdst[2 + out_stride] = yp[1 + in_stride];
             pdst[4 + out_stride] = yp[2 + in_stride];
@@ -4334,8 +4356,8 @@ void blipvert::IMCx_to_IYU1(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        in_uplane += in_stride;
-        in_vplane += in_stride;
+        in_uplane += in_uv_stride;
+        in_vplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 
@@ -4378,6 +4400,7 @@ void blipvert::PackedY422_to_NVx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uvplane = out->uvplane;
@@ -4414,7 +4437,7 @@ void blipvert::PackedY422_to_NVx(Stage* in, Stage* out)
 
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
-        out_uvplane += out_stride;
+        out_uvplane += out_uv_stride;
     }
 }
 
@@ -4422,6 +4445,7 @@ void blipvert::NVx_to_PackedY422(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     uint8_t* in_uvplane = in->uvplane;
@@ -4465,7 +4489,7 @@ void blipvert::NVx_to_PackedY422(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        in_uvplane += in_stride;
+        in_uvplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 }
@@ -4485,6 +4509,7 @@ void blipvert::PlanarYUV_to_NVx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uvplane = out->uvplane;
@@ -4494,7 +4519,7 @@ void blipvert::PlanarYUV_to_NVx(Stage* in, Stage* out)
     int32_t out_stride_x_2 = out_stride * 2;
 
     // Copy the y plane
-    if (out_stride != in_y_stride || out->flipped)
+    if (out_stride != in_y_stride || out->flipped || out->tiled)
     {
         for (int32_t line = 0; line < height; line++)
         {
@@ -4526,15 +4551,15 @@ void blipvert::PlanarYUV_to_NVx(Stage* in, Stage* out)
                 out_vp += 2;
             }
 
-            in_up += in_uv_stride;
-            in_vp += in_uv_stride;
-            out_uvplane += out_stride;
+            in_uplane += in_uv_stride;
+            in_vplane += in_uv_stride;
+            out_uvplane += out_uv_stride;
         }
     }
     else if (in_decimation == 4)
     {
         // Scaling from 4 to 2 decimation
-        int32_t out_uv_stride_x_2 = out_stride * 2;
+        int32_t out_uv_stride_x_2 = out_uv_stride * 2;
         uint8_t* in_up = in_uplane;
         uint8_t* in_vp = in_vplane;
         uint8_t* out_up = out_uvplane + out_u;
@@ -4545,20 +4570,22 @@ void blipvert::PlanarYUV_to_NVx(Stage* in, Stage* out)
             for (int32_t x = 0; x < in_uv_width; x++)
             {
                 out_up[dst_index] = in_up[x];
-                out_up[dst_index + out_stride] = in_up[x];
+                out_up[dst_index + out_uv_stride] = in_up[x];
                 out_vp[dst_index] = in_vp[x];
-                out_vp[dst_index + out_stride] = in_vp[x];
+                out_vp[dst_index + out_uv_stride] = in_vp[x];
                 dst_index += 2;
                 out_up[dst_index] = in_up[x];
-                out_up[dst_index + out_stride] = in_up[x];
+                out_up[dst_index + out_uv_stride] = in_up[x];
                 out_vp[dst_index] = in_vp[x];
-                out_vp[dst_index + out_stride] = in_vp[x];
+                out_vp[dst_index + out_uv_stride] = in_vp[x];
                 dst_index += 2;
             }
 
             out_up += out_uv_stride_x_2;
             out_vp += out_uv_stride_x_2;
-            out_uvplane += out_stride;
+
+            in_up += in_uv_stride;
+            in_vp += in_uv_stride;
         }
     }
 }
@@ -4567,10 +4594,9 @@ void blipvert::NVx_to_PlanarYUV(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
-    int32_t in_uv_width = in->uv_width;
-    int32_t in_uv_height = in->uv_slice_height;
     uint8_t* in_uvplane = in->uvplane;
     int16_t in_u = in->u_index;
     int16_t in_v = in->v_index;
@@ -4585,7 +4611,7 @@ void blipvert::NVx_to_PlanarYUV(Stage* in, Stage* out)
     int32_t out_decimation = out->decimation;
 
     // Copy the y plane
-    if (out_y_stride != in_stride || out->flipped)
+    if (out_y_stride != in_stride || out->flipped || out->tiled)
     {
         for (int32_t line = 0; line < height; line++)
         {
@@ -4619,32 +4645,34 @@ void blipvert::NVx_to_PlanarYUV(Stage* in, Stage* out)
 
             out_uplane += out_uv_stride;
             out_vplane += out_uv_stride;
-            in_uvplane += in_stride;
+            in_uvplane += in_uv_stride;
         }
     }
     else
     {
-        // Scaling from 2 to 4 decimation
-        int32_t in_uv_stride_x_2 = in_stride * 2;
+        // Scaling from 2 to 4 decimation. Each output row averages a pair of input chroma rows, so an odd
+        // input row at the bottom is left out, the same as the odd luma rows the output chroma doesn't cover.
+        int32_t in_uv_stride_x_2 = in_uv_stride * 2;
         uint8_t* in_u_line = in_uvplane + in_u;
         uint8_t* in_v_line = in_uvplane + in_v;
 
-        for (int32_t y = 0; y < in_uv_height; y += 2)
+        for (int32_t y = 0; y < out_uv_height; y++)
         {
-            for (int32_t x = 0; x < in_uv_width; x += 4)
+            for (int32_t x = 0; x < out_uv_width; x++)
             {
-                out_uplane[x >> 2] = static_cast<uint8_t>((static_cast<uint16_t>(in_u_line[x]) + \
-                    static_cast<uint16_t>(in_u_line[x + 2]) + \
-                    static_cast<uint16_t>(in_u_line[x + in_stride]) + \
-                    static_cast<uint16_t>(in_u_line[x + in_stride + 2])) >> 2);
-                out_vplane[x >> 2] = static_cast<uint8_t>((static_cast<uint16_t>(in_v_line[x]) + \
-                    static_cast<uint16_t>(in_v_line[x + 2]) + \
-                    static_cast<uint16_t>(in_v_line[x + in_stride]) + \
-                    static_cast<uint16_t>(in_v_line[x + in_stride + 2])) >> 2);
+                int32_t in_x = x * 4;
+                out_uplane[x] = static_cast<uint8_t>((static_cast<uint16_t>(in_u_line[in_x]) + \
+                    static_cast<uint16_t>(in_u_line[in_x + 2]) + \
+                    static_cast<uint16_t>(in_u_line[in_x + in_uv_stride]) + \
+                    static_cast<uint16_t>(in_u_line[in_x + in_uv_stride + 2])) >> 2);
+                out_vplane[x] = static_cast<uint8_t>((static_cast<uint16_t>(in_v_line[in_x]) + \
+                    static_cast<uint16_t>(in_v_line[in_x + 2]) + \
+                    static_cast<uint16_t>(in_v_line[in_x + in_uv_stride]) + \
+                    static_cast<uint16_t>(in_v_line[in_x + in_uv_stride + 2])) >> 2);
             }
 
-            in_u_line += in_stride;
-            in_v_line += in_stride;
+            in_u_line += in_uv_stride_x_2;
+            in_v_line += in_uv_stride_x_2;
             out_uplane += out_uv_stride;
             out_vplane += out_uv_stride;
         }
@@ -4712,7 +4740,7 @@ void blipvert::PlanarYUV_to_YV16(Stage* in, Stage* out)
     uint8_t* out_vplane = out->vplane;
 
     // Copy the y plane
-    if (out_y_stride != in_y_stride || out->flipped)
+    if (out_y_stride != in_y_stride || out->flipped || out->tiled)
     {
         for (int32_t line = 0; line < height; line++)
         {
@@ -4912,7 +4940,7 @@ void blipvert::Y800_to_YV16(Stage* in, Stage* out)
         }
     }
 
-    if (out_y_stride == in_stride)
+    if (out_y_stride == in_stride && !out->flipped && !out->tiled)
     {
         memcpy(out_buf, in_buf, out_y_stride * height);
     }
@@ -5076,6 +5104,7 @@ void blipvert::IMCx_to_YV16(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_uv_width = in->uv_width;
@@ -5091,7 +5120,7 @@ void blipvert::IMCx_to_YV16(Stage* in, Stage* out)
     uint8_t* out_vplane = out->vplane;
 
     // Copy the y plane
-    if (out_y_stride != in_stride || out->flipped)
+    if (out_y_stride != in_stride || out->flipped || out->tiled)
     {
         for (int32_t line = 0; line < height; line++)
         {
@@ -5117,8 +5146,8 @@ void blipvert::IMCx_to_YV16(Stage* in, Stage* out)
         out_uplane += out_uv_stride;
         out_vplane += out_uv_stride;
 
-        in_uplane += in_stride;
-        in_vplane += in_stride;
+        in_uplane += in_uv_stride;
+        in_vplane += in_uv_stride;
     }
 }
 
@@ -5127,6 +5156,7 @@ void blipvert::NVx_to_YV16(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_uv_width = in->uv_width;
@@ -5144,7 +5174,7 @@ void blipvert::NVx_to_YV16(Stage* in, Stage* out)
 
 
     // Copy the y plane
-    if (out_y_stride != in_stride || out->flipped)
+    if (out_y_stride != in_stride || out->flipped || out->tiled)
     {
         for (int32_t line = 0; line < height; line++)
         {
@@ -5179,7 +5209,7 @@ void blipvert::NVx_to_YV16(Stage* in, Stage* out)
 
         out_uplane += out_uv_stride * 2;
         out_vplane += out_uv_stride * 2;
-        in_uvplane += in_stride;
+        in_uvplane += in_uv_stride;
     }
 }
 
@@ -5454,6 +5484,7 @@ void blipvert::AYUV_to_NVx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_height;
     uint8_t* out_uvplane = out->uvplane;
@@ -5501,7 +5532,7 @@ void blipvert::AYUV_to_NVx(Stage* in, Stage* out)
 
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
-        out_uvplane += out_stride;
+        out_uvplane += out_uv_stride;
     }
 }
 
@@ -5920,6 +5951,7 @@ void blipvert::IYU1_to_NVx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uvplane = out->uvplane;
@@ -5963,7 +5995,7 @@ void blipvert::IYU1_to_NVx(Stage* in, Stage* out)
 
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
-        out_uvplane += out_stride;
+        out_uvplane += out_uv_stride;
     }
 }
 
@@ -6256,6 +6288,7 @@ void blipvert::IYU2_to_NVx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uvplane = out->uvplane;
@@ -6295,7 +6328,7 @@ void blipvert::IYU2_to_NVx(Stage* in, Stage* out)
 
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
-        out_uvplane += out_stride;
+        out_uvplane += out_uv_stride;
     }
 }
 
@@ -6570,6 +6603,7 @@ void blipvert::Y800_to_NVx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uvplane = out->uvplane;
@@ -6577,10 +6611,10 @@ void blipvert::Y800_to_NVx(Stage* in, Stage* out)
     for (int32_t y = 0; y < out_uv_height; y++)
     {
         memset(out_uvplane, 0, out_uv_width);
-        out_uvplane += out_stride;
+        out_uvplane += out_uv_stride;
     }
 
-    if (out_stride == in_stride)
+    if (out_stride == in_stride && !out->flipped && !out->tiled)
     {
         memcpy(out_buf, in_buf, out_stride * height);
     }
@@ -6856,6 +6890,7 @@ void blipvert::Y16_to_NVx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uvplane = out->uvplane;
@@ -6863,7 +6898,7 @@ void blipvert::Y16_to_NVx(Stage* in, Stage* out)
     for (int32_t y = 0; y < out_uv_height; y++)
     {
         memset(out_uvplane, 0, out_uv_width);
-        out_uvplane += out_stride;
+        out_uvplane += out_uv_stride;
     }
 
     for (int32_t y = 0; y < height; y++)
@@ -7239,6 +7274,7 @@ void blipvert::CLJR_to_NVx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uvplane = out->uvplane;
@@ -7285,7 +7321,7 @@ void blipvert::CLJR_to_NVx(Stage* in, Stage* out)
 
         in_buf += in_stride_x_2;
         out_buf += y_stride_x_2;
-        out_uvplane += out_stride;
+        out_uvplane += out_uv_stride;
     }
 }
 
@@ -7713,6 +7749,7 @@ void blipvert::Y41P_to_NVx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uvplane = out->uvplane;
@@ -7776,7 +7813,7 @@ void blipvert::Y41P_to_NVx(Stage* in, Stage* out)
 
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
-        out_uvplane += out_stride;
+        out_uvplane += out_uv_stride;
     }
 }
 
@@ -7868,6 +7905,7 @@ void blipvert::IMCx_to_IMCx(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_uv_width = in->uv_width;
@@ -7877,13 +7915,14 @@ void blipvert::IMCx_to_IMCx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uplane = out->uplane;
     uint8_t* out_vplane = out->vplane;
 
     // Copy the y plane
-    if (out_stride != in_stride || out->flipped)
+    if (out_stride != in_stride || out->flipped || out->tiled)
     {
         for (int32_t line = 0; line < height; line++)
         {
@@ -7898,22 +7937,22 @@ void blipvert::IMCx_to_IMCx(Stage* in, Stage* out)
     }
 
     // Copy the u & v planes without scaling
-    if (out_stride != in_stride || out->flipped || in->interlaced || out->interlaced)
+    if (out_uv_stride != in_uv_stride || out->flipped || in->interlaced || out->interlaced || out->tiled)
     {
         for (int32_t line = 0; line < in_uv_height; line++)
         {
             memcpy(out_uplane, in_uplane, in_uv_width);
             memcpy(out_vplane, in_vplane, in_uv_width);
-            out_uplane += out_stride;
-            out_vplane += out_stride;
-            in_uplane += in_stride;
-            in_vplane += in_stride;
+            out_uplane += out_uv_stride;
+            out_vplane += out_uv_stride;
+            in_uplane += in_uv_stride;
+            in_vplane += in_uv_stride;
         }
     }
     else
     {
-        memcpy(out_uplane, in_uplane, out_stride * in_uv_height);
-        memcpy(out_vplane, in_vplane, out_stride * in_uv_height);
+        memcpy(out_uplane, in_uplane, out_uv_stride * in_uv_height);
+        memcpy(out_vplane, in_vplane, out_uv_stride * in_uv_height);
     }
 }
 
@@ -7921,6 +7960,7 @@ void blipvert::IMCx_to_NVx(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_uv_width = in->uv_width;
@@ -7930,6 +7970,7 @@ void blipvert::IMCx_to_NVx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uvplane = out->uvplane;
@@ -7937,7 +7978,7 @@ void blipvert::IMCx_to_NVx(Stage* in, Stage* out)
     int16_t out_v = out->v_index;
 
     // Copy the y plane
-    if (out_stride != in_stride || out->flipped)
+    if (out_stride != in_stride || out->flipped || out->tiled)
     {
         for (int32_t line = 0; line < height; line++)
         {
@@ -7967,9 +8008,9 @@ void blipvert::IMCx_to_NVx(Stage* in, Stage* out)
             out_vp += 2;
         }
 
-        out_uvplane += out_stride;
-        in_uplane += in_stride;
-        in_vplane += in_stride;
+        out_uvplane += out_uv_stride;
+        in_uplane += in_uv_stride;
+        in_vplane += in_uv_stride;
     }
 }
 
@@ -7977,6 +8018,7 @@ void blipvert::IMCx_to_Y42T(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_uv_width = in->uv_width;
@@ -8016,8 +8058,8 @@ void blipvert::IMCx_to_Y42T(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        in_uplane += in_stride;
-        in_vplane += in_stride;
+        in_uplane += in_uv_stride;
+        in_vplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 }
@@ -8030,6 +8072,7 @@ void blipvert::NVx_to_AYUV(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_uv_width = in->uv_width;
@@ -8084,7 +8127,7 @@ void blipvert::NVx_to_AYUV(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        in_uvplane += in_stride;
+        in_uvplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 }
@@ -8097,6 +8140,7 @@ void blipvert::NVx_to_IYU1(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_uv_width = in->uv_width;
@@ -8134,12 +8178,12 @@ void blipvert::NVx_to_IYU1(Stage* in, Stage* out)
 
             pdst[out_stride] = static_cast<uint8_t>((static_cast<uint16_t>(up[0]) + \
                 static_cast<uint16_t>(up[2]) + \
-                static_cast<uint16_t>(up[in_stride]) + \
-                static_cast<uint16_t>(up[2 + in_stride])) >> 2);
+                static_cast<uint16_t>(up[in_uv_stride]) + \
+                static_cast<uint16_t>(up[2 + in_uv_stride])) >> 2);
             pdst[3 + out_stride] = static_cast<uint8_t>((static_cast<uint16_t>(vp[0]) + \
                 static_cast<uint16_t>(vp[2]) + \
-                static_cast<uint16_t>(vp[in_stride]) + \
-                static_cast<uint16_t>(vp[2 + in_stride])) >> 2);
+                static_cast<uint16_t>(vp[in_uv_stride]) + \
+                static_cast<uint16_t>(vp[2 + in_uv_stride])) >> 2);
             pdst[1 + out_stride] = yp[in_stride];
             pdst[2 + out_stride] = yp[1 + in_stride];
             pdst[4 + out_stride] = yp[2 + in_stride];
@@ -8152,7 +8196,7 @@ void blipvert::NVx_to_IYU1(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        in_uvplane += in_stride;
+        in_uvplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 
@@ -8186,6 +8230,7 @@ void blipvert::NVx_to_IYU2(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_uv_width = in->uv_width;
@@ -8236,7 +8281,7 @@ void blipvert::NVx_to_IYU2(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        in_uvplane += in_stride;
+        in_uvplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 }
@@ -8253,7 +8298,7 @@ void blipvert::NVx_to_Y800(Stage* in, Stage* out)
 
     // Copy the y plane
 
-    if (out_stride != in_stride || out->flipped)
+    if (out_stride != in_stride || out->flipped || out->tiled)
     {
         for (int32_t y = 0; y < height; y++)
         {
@@ -8310,6 +8355,7 @@ void blipvert::NVx_to_CLJR(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_uv_width = in->uv_width;
@@ -8345,7 +8391,7 @@ void blipvert::NVx_to_CLJR(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        in_uvplane += in_stride;
+        in_uvplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 }
@@ -8354,6 +8400,7 @@ void blipvert::NVx_to_Y41P(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_uv_width = in->uv_width;
@@ -8391,12 +8438,12 @@ void blipvert::NVx_to_Y41P(Stage* in, Stage* out)
 
             pdst[out_stride] = static_cast<uint8_t>((static_cast<uint16_t>(up[0]) + \
                 static_cast<uint16_t>(up[2]) + \
-                static_cast<uint16_t>(up[in_stride]) + \
-                static_cast<uint16_t>(up[2 + in_stride])) >> 2);
+                static_cast<uint16_t>(up[in_uv_stride]) + \
+                static_cast<uint16_t>(up[2 + in_uv_stride])) >> 2);
             pdst[2 + out_stride] = static_cast<uint8_t>((static_cast<uint16_t>(vp[0]) + \
                 static_cast<uint16_t>(vp[2]) + \
-                static_cast<uint16_t>(vp[in_stride]) + \
-                static_cast<uint16_t>(vp[2 + in_stride])) >> 2);
+                static_cast<uint16_t>(vp[in_uv_stride]) + \
+                static_cast<uint16_t>(vp[2 + in_uv_stride])) >> 2);
             pdst[1 + out_stride] = yp[in_stride];
             pdst[3 + out_stride] = yp[1 + in_stride];
             pdst[5 + out_stride] = yp[2 + in_stride];
@@ -8411,12 +8458,12 @@ void blipvert::NVx_to_Y41P(Stage* in, Stage* out)
 
             pdst[4 + out_stride] = static_cast<uint8_t>((static_cast<uint16_t>(up[4]) + \
                 static_cast<uint16_t>(up[6]) + \
-                static_cast<uint16_t>(up[4 + in_stride]) + \
-                static_cast<uint16_t>(up[6 + in_stride])) >> 2);
+                static_cast<uint16_t>(up[4 + in_uv_stride]) + \
+                static_cast<uint16_t>(up[6 + in_uv_stride])) >> 2);
             pdst[6 + out_stride] = static_cast<uint8_t>((static_cast<uint16_t>(vp[4]) + \
                 static_cast<uint16_t>(vp[6]) + \
-                static_cast<uint16_t>(vp[4 + in_stride]) + \
-                static_cast<uint16_t>(vp[6 + in_stride])) >> 2);
+                static_cast<uint16_t>(vp[4 + in_uv_stride]) + \
+                static_cast<uint16_t>(vp[6 + in_uv_stride])) >> 2);
             pdst[8 + out_stride] = yp[4 + in_stride];
             pdst[9 + out_stride] = yp[5 + in_stride];
             pdst[10 + out_stride] = yp[6 + in_stride];
@@ -8429,7 +8476,7 @@ void blipvert::NVx_to_Y41P(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        in_uvplane += in_stride;
+        in_uvplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 
@@ -8467,8 +8514,8 @@ void blipvert::NVx_to_Y41P(Stage* in, Stage* out)
 
         pdst += 12;
         yp += 8;
-        up += 4;
-        vp += 4;
+        up += 8;
+        vp += 8;
     }
 }
 
@@ -8476,6 +8523,7 @@ void blipvert::NVx_to_IMCx(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_uv_width = in->uv_width;
@@ -8486,6 +8534,7 @@ void blipvert::NVx_to_IMCx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uplane = out->uplane;
@@ -8493,7 +8542,7 @@ void blipvert::NVx_to_IMCx(Stage* in, Stage* out)
 
 
     // Copy the y plane
-    if (out_stride != in_stride || out->flipped)
+    if (out_stride != in_stride || out->flipped || out->tiled)
     {
         for (int32_t line = 0; line < height; line++)
         {
@@ -8523,9 +8572,9 @@ void blipvert::NVx_to_IMCx(Stage* in, Stage* out)
             in_vp += 2;
         }
 
-        in_uvplane += in_stride;
-        out_uplane += out_stride;
-        out_vplane += out_stride;
+        in_uvplane += in_uv_stride;
+        out_uplane += out_uv_stride;
+        out_vplane += out_uv_stride;
     }
 }
 
@@ -8533,6 +8582,7 @@ void blipvert::NVx_to_NVx(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_uv_width = in->uv_width;
@@ -8543,6 +8593,7 @@ void blipvert::NVx_to_NVx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width / 2;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uvplane = out->uvplane;
@@ -8551,7 +8602,7 @@ void blipvert::NVx_to_NVx(Stage* in, Stage* out)
 
 
     // Copy the y plane
-    if (out_stride != in_stride || out->flipped)
+    if (out_stride != in_stride || out->flipped || out->tiled)
     {
         for (int32_t line = 0; line < height; line++)
         {
@@ -8583,8 +8634,8 @@ void blipvert::NVx_to_NVx(Stage* in, Stage* out)
             out_vp += 2;
         }
 
-        in_uvplane += in_stride;
-        out_uvplane += out_stride;
+        in_uvplane += in_uv_stride;
+        out_uvplane += out_uv_stride;
     }
 }
 
@@ -8592,6 +8643,7 @@ void blipvert::NVx_to_Y42T(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_uv_width = in->uv_width;
@@ -8633,7 +8685,7 @@ void blipvert::NVx_to_Y42T(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        in_uvplane += in_stride;
+        in_uvplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 }
@@ -8642,6 +8694,7 @@ void blipvert::NVx_to_Y41T(Stage* in, Stage* out)
 {
     uint8_t* in_buf = in->buf;
     int32_t in_stride = in->stride;
+    int32_t in_uv_stride = in->uv_stride;
     int32_t width = in->width;
     int32_t height = in->height;
     int32_t in_uv_width = in->uv_width;
@@ -8679,12 +8732,12 @@ void blipvert::NVx_to_Y41T(Stage* in, Stage* out)
 
             pdst[out_stride] = static_cast<uint8_t>((static_cast<uint16_t>(up[0]) + \
                 static_cast<uint16_t>(up[2]) + \
-                static_cast<uint16_t>(up[in_stride]) + \
-                static_cast<uint16_t>(up[2 + in_stride])) >> 2);
+                static_cast<uint16_t>(up[in_uv_stride]) + \
+                static_cast<uint16_t>(up[2 + in_uv_stride])) >> 2);
             pdst[2 + out_stride] = static_cast<uint8_t>((static_cast<uint16_t>(vp[0]) + \
                 static_cast<uint16_t>(vp[2]) + \
-                static_cast<uint16_t>(vp[in_stride]) + \
-                static_cast<uint16_t>(vp[2 + in_stride])) >> 2);
+                static_cast<uint16_t>(vp[in_uv_stride]) + \
+                static_cast<uint16_t>(vp[2 + in_uv_stride])) >> 2);
             pdst[1 + out_stride] = yp[in_stride] | 0x01;
             pdst[3 + out_stride] = yp[1 + in_stride] | 0x01;
             pdst[5 + out_stride] = yp[2 + in_stride] | 0x01;
@@ -8699,12 +8752,12 @@ void blipvert::NVx_to_Y41T(Stage* in, Stage* out)
 
             pdst[4 + out_stride] = static_cast<uint8_t>((static_cast<uint16_t>(up[4]) + \
                 static_cast<uint16_t>(up[6]) + \
-                static_cast<uint16_t>(up[4 + in_stride]) + \
-                static_cast<uint16_t>(up[6 + in_stride])) >> 2);
+                static_cast<uint16_t>(up[4 + in_uv_stride]) + \
+                static_cast<uint16_t>(up[6 + in_uv_stride])) >> 2);
             pdst[6 + out_stride] = static_cast<uint8_t>((static_cast<uint16_t>(vp[4]) + \
                 static_cast<uint16_t>(vp[6]) + \
-                static_cast<uint16_t>(vp[4 + in_stride]) + \
-                static_cast<uint16_t>(vp[6 + in_stride])) >> 2);
+                static_cast<uint16_t>(vp[4 + in_uv_stride]) + \
+                static_cast<uint16_t>(vp[6 + in_uv_stride])) >> 2);
             pdst[8 + out_stride] = yp[4 + in_stride] | 0x01;
             pdst[9 + out_stride] = yp[5 + in_stride] | 0x01;
             pdst[10 + out_stride] = yp[6 + in_stride] | 0x01;
@@ -8717,7 +8770,7 @@ void blipvert::NVx_to_Y41T(Stage* in, Stage* out)
         }
 
         in_buf += in_stride_x_2;
-        in_uvplane += in_stride;
+        in_uvplane += in_uv_stride;
         out_buf += out_stride_x_2;
     }
 
@@ -8755,8 +8808,8 @@ void blipvert::NVx_to_Y41T(Stage* in, Stage* out)
 
         pdst += 12;
         yp += 8;
-        up += 4;
-        vp += 4;
+        up += 8;
+        vp += 8;
     }
 }
 
@@ -9016,6 +9069,7 @@ void blipvert::Y42T_to_IMCx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uplane = out->uplane;
@@ -9048,8 +9102,8 @@ void blipvert::Y42T_to_IMCx(Stage* in, Stage* out)
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
 
-        out_uplane += out_stride;
-        out_vplane += out_stride;
+        out_uplane += out_uv_stride;
+        out_vplane += out_uv_stride;
     }
 }
 
@@ -9062,6 +9116,7 @@ void blipvert::Y42T_to_NVx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uvplane = out->uvplane;
@@ -9098,7 +9153,7 @@ void blipvert::Y42T_to_NVx(Stage* in, Stage* out)
 
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
-        out_uvplane += out_stride;
+        out_uvplane += out_uv_stride;
     }
 }
 
@@ -9796,6 +9851,7 @@ void blipvert::Y41T_to_IMCx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uplane = out->uplane;
@@ -9857,8 +9913,8 @@ void blipvert::Y41T_to_IMCx(Stage* in, Stage* out)
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
 
-        out_uplane += out_stride;
-        out_vplane += out_stride;
+        out_uplane += out_uv_stride;
+        out_vplane += out_uv_stride;
     }
 }
 
@@ -9871,6 +9927,7 @@ void blipvert::Y41T_to_NVx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uvplane = out->uvplane;
@@ -9934,7 +9991,7 @@ void blipvert::Y41T_to_NVx(Stage* in, Stage* out)
 
         in_buf += in_stride_x_2;
         out_buf += out_stride_x_2;
-        out_uvplane += out_stride;
+        out_uvplane += out_uv_stride;
     }
 }
 
@@ -10102,7 +10159,7 @@ void blipvert::YV16_to_PlanarYUV(Stage* in, Stage* out)
 
 
     // Copy the y plane
-    if (out_y_stride != in_y_stride || out->flipped)
+    if (out_y_stride != in_y_stride || out->flipped || out->tiled)
     {
         for (int32_t line = 0; line < height; line++)
         {
@@ -10403,13 +10460,14 @@ void blipvert::YV16_to_IMCx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uplane = out->uplane;
     uint8_t* out_vplane = out->vplane;
 
     // Copy the y plane
-    if (out_stride != in_y_stride || out->flipped)
+    if (out_stride != in_y_stride || out->flipped || out->tiled)
     {
         for (int32_t y = 0; y < height; y++)
         {
@@ -10436,8 +10494,8 @@ void blipvert::YV16_to_IMCx(Stage* in, Stage* out)
             *out_up++ = (static_cast<uint16_t>(*in_up) + static_cast<uint16_t>(*(in_up++ + in_uv_stride))) >> 1;
             *out_vp++ = (static_cast<uint16_t>(*in_vp) + static_cast<uint16_t>(*(in_vp++ + in_uv_stride))) >> 1;
         }
-        out_uplane += out_stride;
-        out_vplane += out_stride;
+        out_uplane += out_uv_stride;
+        out_vplane += out_uv_stride;
 
         in_uplane += in_uv_stride;
         in_vplane += in_uv_stride;
@@ -10457,6 +10515,7 @@ void blipvert::YV16_to_NVx(Stage* in, Stage* out)
 
     uint8_t* out_buf = out->buf;
     int32_t out_stride = out->stride;
+    int32_t out_uv_stride = out->uv_stride;
     int32_t out_uv_width = out->uv_width;
     int32_t out_uv_height = out->uv_slice_height;
     uint8_t* out_uvplane = out->uvplane;
@@ -10464,7 +10523,7 @@ void blipvert::YV16_to_NVx(Stage* in, Stage* out)
     int16_t out_v = out->v_index;
 
     // Copy the y plane
-    if (out_stride != in_y_stride || out->flipped)
+    if (out_stride != in_y_stride || out->flipped || out->tiled)
     {
         for (int32_t line = 0; line < height; line++)
         {
@@ -10496,7 +10555,7 @@ void blipvert::YV16_to_NVx(Stage* in, Stage* out)
 
         in_uplane += in_uv_stride;
         in_vplane += in_uv_stride;
-        out_uvplane += out_stride;
+        out_uvplane += out_uv_stride;
     }
 }
 
@@ -10588,3 +10647,415 @@ void blipvert::YV16_to_Y41T(Stage* in, Stage* out)
         out_buf += out_stride;
     }
 }
+
+//
+// In-place packed Y422 swizzle
+//
+// The input and output stages point to the same memory and are flipped the same way. Each macro-pixel
+// is read whole before it's rewritten, and the rows are walked up from the lowest address.
+//
+
+void blipvert::PackedY422_to_PackedY422_InPlace(Stage* in, Stage* out)
+{
+    uint8_t* in_buf;
+    uint8_t* out_buf;
+    int32_t in_stride;
+    int32_t out_stride;
+    GetInPlaceRows(in, out, in_buf, out_buf, in_stride, out_stride);
+    int32_t width = in->width;
+    int32_t height = in->height;
+    int16_t in_y0 = in->y0_index;
+    int16_t in_y1 = in->y1_index;
+    int16_t in_u = in->u_index;
+    int16_t in_v = in->v_index;
+    int16_t out_y0 = out->y0_index;
+    int16_t out_y1 = out->y1_index;
+    int16_t out_u = out->u_index;
+    int16_t out_v = out->v_index;
+
+    for (int32_t y = 0; y < height; y++)
+    {
+        uint8_t* psrc = in_buf;
+        uint8_t* pdst = out_buf;
+        for (int32_t x = 0; x < width; x += 2)
+        {
+            uint8_t y0 = psrc[in_y0];
+            uint8_t y1 = psrc[in_y1];
+            uint8_t u = psrc[in_u];
+            uint8_t v = psrc[in_v];
+            pdst[out_y0] = y0;
+            pdst[out_y1] = y1;
+            pdst[out_u] = u;
+            pdst[out_v] = v;
+            psrc += 4;
+            pdst += 4;
+        }
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+    }
+}
+
+#if defined(BLIPVERT_X86_SIMD)
+
+//
+// SSE4.1 and AVX2 packed Y422 swizzle
+//
+// Converting between YUY2, UYVY, YVYU and VYUY only reorders the 4 bytes of each macro-pixel, so a
+// pshufb with a mask built from the two stages' byte indexes does 4 macro-pixels per 16 bytes. The
+// AVX2 versions repeat the mask in both lanes and do 64 bytes per pass.
+//
+
+// Builds the pshufb mask that moves the bytes of 4 macro-pixels from the input layout to the output layout.
+static void BuildY422SwizzleMask(Stage* in, Stage* out, int8_t* mask)
+{
+    for (int8_t macro = 0; macro < 4; macro++)
+    {
+        int8_t base = macro * 4;
+        mask[base + out->y0_index] = base + static_cast<int8_t>(in->y0_index);
+        mask[base + out->y1_index] = base + static_cast<int8_t>(in->y1_index);
+        mask[base + out->u_index] = base + static_cast<int8_t>(in->u_index);
+        mask[base + out->v_index] = base + static_cast<int8_t>(in->v_index);
+    }
+}
+
+// Swizzles the macro-pixels of a row from byte x on, the columns a SIMD kernel left over.
+static inline void SwizzleY422Columns(Stage* in, Stage* out, uint8_t* psrc, uint8_t* pdst, int32_t x, int32_t row_bytes)
+{
+    for (; x < row_bytes; x += 4)
+    {
+        uint8_t y0 = psrc[x + in->y0_index];
+        uint8_t y1 = psrc[x + in->y1_index];
+        uint8_t u = psrc[x + in->u_index];
+        uint8_t v = psrc[x + in->v_index];
+        pdst[x + out->y0_index] = y0;
+        pdst[x + out->y1_index] = y1;
+        pdst[x + out->u_index] = u;
+        pdst[x + out->v_index] = v;
+    }
+}
+
+BLIPVERT_TARGET_SSE41 void blipvert::PackedY422_to_PackedY422_SSE41(Stage* in, Stage* out)
+{
+    uint8_t* in_buf = in->buf;
+    uint8_t* out_buf = out->buf;
+    int32_t in_stride = in->stride;
+    int32_t out_stride = out->stride;
+    int32_t height = in->height;
+    int32_t row_bytes = in->width * 2;
+    int32_t simd_bytes = row_bytes & ~31;
+
+    alignas(16) int8_t mask[16];
+    BuildY422SwizzleMask(in, out, mask);
+    const __m128i swizzle = _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+
+    do
+    {
+        int32_t x = 0;
+        for (; x < simd_bytes; x += 32)
+        {
+            __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in_buf + x));
+            __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in_buf + x + 16));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out_buf + x), _mm_shuffle_epi8(p0, swizzle));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out_buf + x + 16), _mm_shuffle_epi8(p1, swizzle));
+        }
+
+        SwizzleY422Columns(in, out, in_buf, out_buf, x, row_bytes);
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+    } while (--height);
+}
+
+BLIPVERT_TARGET_AVX2 void blipvert::PackedY422_to_PackedY422_AVX2(Stage* in, Stage* out)
+{
+    uint8_t* in_buf = in->buf;
+    uint8_t* out_buf = out->buf;
+    int32_t in_stride = in->stride;
+    int32_t out_stride = out->stride;
+    int32_t height = in->height;
+    int32_t row_bytes = in->width * 2;
+    int32_t simd_bytes = row_bytes & ~63;
+
+    alignas(16) int8_t mask[16];
+    BuildY422SwizzleMask(in, out, mask);
+    const __m256i swizzle = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(mask)));
+
+    do
+    {
+        int32_t x = 0;
+        for (; x < simd_bytes; x += 64)
+        {
+            __m256i p0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in_buf + x));
+            __m256i p1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in_buf + x + 32));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out_buf + x), _mm256_shuffle_epi8(p0, swizzle));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out_buf + x + 32), _mm256_shuffle_epi8(p1, swizzle));
+        }
+
+        SwizzleY422Columns(in, out, in_buf, out_buf, x, row_bytes);
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+    } while (--height);
+}
+
+BLIPVERT_TARGET_SSE41 void blipvert::PackedY422_to_PackedY422_InPlace_SSE41(Stage* in, Stage* out)
+{
+    uint8_t* in_buf;
+    uint8_t* out_buf;
+    int32_t in_stride;
+    int32_t out_stride;
+    GetInPlaceRows(in, out, in_buf, out_buf, in_stride, out_stride);
+    int32_t width = in->width;
+    int32_t height = in->height;
+    int32_t row_bytes = width * 2;
+    int32_t simd_bytes = row_bytes & ~15;
+
+    alignas(16) int8_t mask[16];
+    BuildY422SwizzleMask(in, out, mask);
+    const __m128i swizzle = _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+
+    do
+    {
+        int32_t x = 0;
+        for (; x < simd_bytes; x += 16)
+        {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in_buf + x));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out_buf + x), _mm_shuffle_epi8(pixels, swizzle));
+        }
+
+        SwizzleY422Columns(in, out, in_buf, out_buf, x, row_bytes);
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+    } while (--height);
+}
+
+BLIPVERT_TARGET_AVX2 void blipvert::PackedY422_to_PackedY422_InPlace_AVX2(Stage* in, Stage* out)
+{
+    uint8_t* in_buf;
+    uint8_t* out_buf;
+    int32_t in_stride;
+    int32_t out_stride;
+    GetInPlaceRows(in, out, in_buf, out_buf, in_stride, out_stride);
+    int32_t height = in->height;
+    int32_t row_bytes = in->width * 2;
+    int32_t simd_bytes = row_bytes & ~31;
+
+    alignas(16) int8_t mask[16];
+    BuildY422SwizzleMask(in, out, mask);
+    const __m256i swizzle = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(mask)));
+
+    do
+    {
+        int32_t x = 0;
+        for (; x < simd_bytes; x += 32)
+        {
+            __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in_buf + x));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out_buf + x), _mm256_shuffle_epi8(pixels, swizzle));
+        }
+
+        SwizzleY422Columns(in, out, in_buf, out_buf, x, row_bytes);
+
+        in_buf += in_stride;
+        out_buf += out_stride;
+    } while (--height);
+}
+
+//
+// SSE4.1 and AVX2 NVx chroma interleave and deinterleave
+//
+// The Y plane is copied with memcpy, which already moves whole rows with the widest loads and stores the
+// processor has. The separate U and V rows are merged into an NVx chroma row with punpcklbw/punpckhbw, and
+// split back out with a pshufb that gathers the even and odd bytes of each 16 byte block. The AVX2 versions
+// fix up the lane order with 128-bit permutes. Only 2x2 decimation is vectorized. YUV9 and YVU9 go to the
+// generic versions.
+//
+
+// Writes count U and V byte pairs to uv. first and second are the planes that go to the even and odd bytes.
+typedef void (*t_interleaveuvrow)(const uint8_t* first, const uint8_t* second, uint8_t* uv, int32_t count);
+
+// Splits count byte pairs of uv into the first (even) and second (odd) planes.
+typedef void (*t_deinterleaveuvrow)(const uint8_t* uv, uint8_t* first, uint8_t* second, int32_t count);
+
+BLIPVERT_TARGET_SSE41 static void InterleaveUVRow_SSE41(const uint8_t* first, const uint8_t* second, uint8_t* uv, int32_t count)
+{
+    int32_t x = 0;
+    for (; x + 16 <= count; x += 16)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + x));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(second + x));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(uv + x * 2), _mm_unpacklo_epi8(a, b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(uv + x * 2 + 16), _mm_unpackhi_epi8(a, b));
+    }
+
+    for (; x < count; x++)
+    {
+        uv[x * 2] = first[x];
+        uv[x * 2 + 1] = second[x];
+    }
+}
+
+BLIPVERT_TARGET_AVX2 static void InterleaveUVRow_AVX2(const uint8_t* first, const uint8_t* second, uint8_t* uv, int32_t count)
+{
+    int32_t x = 0;
+    for (; x + 32 <= count; x += 32)
+    {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + x));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(second + x));
+        __m256i lo = _mm256_unpacklo_epi8(a, b);        // Pairs 0-7 and 16-23
+        __m256i hi = _mm256_unpackhi_epi8(a, b);        // Pairs 8-15 and 24-31
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(uv + x * 2), _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(uv + x * 2 + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+
+    InterleaveUVRow_SSE41(first + x, second + x, uv + x * 2, count - x);
+}
+
+BLIPVERT_TARGET_SSE41 static void DeinterleaveUVRow_SSE41(const uint8_t* uv, uint8_t* first, uint8_t* second, int32_t count)
+{
+    const __m128i split = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+
+    int32_t x = 0;
+    for (; x + 16 <= count; x += 16)
+    {
+        __m128i a = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(uv + x * 2)), split);
+        __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(uv + x * 2 + 16)), split);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(first + x), _mm_unpacklo_epi64(a, b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(second + x), _mm_unpackhi_epi64(a, b));
+    }
+
+    for (; x < count; x++)
+    {
+        first[x] = uv[x * 2];
+        second[x] = uv[x * 2 + 1];
+    }
+}
+
+BLIPVERT_TARGET_AVX2 static void DeinterleaveUVRow_AVX2(const uint8_t* uv, uint8_t* first, uint8_t* second, int32_t count)
+{
+    const __m256i split = _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15,
+                                           0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+
+    int32_t x = 0;
+    for (; x + 32 <= count; x += 32)
+    {
+        // Each lane holds 8 even bytes then 8 odd bytes. Gathering the 64-bit halves puts the even bytes
+        // of the register in its low lane and the odd bytes in its high lane.
+        __m256i a = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(uv + x * 2)), split), 0xD8);
+        __m256i b = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(uv + x * 2 + 32)), split), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(first + x), _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(second + x), _mm256_permute2x128_si256(a, b, 0x31));
+    }
+
+    DeinterleaveUVRow_SSE41(uv + x * 2, first + x, second + x, count - x);
+}
+
+// Copies the rows one at a time when row_by_row is set, for flipped frames and tiles, and as one block otherwise
+// if the strides match.
+static void CopyYPlane(uint8_t* in_buf, int32_t in_stride, uint8_t* out_buf, int32_t out_stride, int32_t width, int32_t height, bool row_by_row)
+{
+    if (out_stride != in_stride || row_by_row)
+    {
+        for (int32_t line = 0; line < height; line++)
+        {
+            memcpy(out_buf, in_buf, width);
+            out_buf += out_stride;
+            in_buf += in_stride;
+        }
+    }
+    else
+    {
+        memcpy(out_buf, in_buf, out_stride * height);
+    }
+}
+
+// Copies the Y plane of a 2x2 decimated stage with separate U and V planes (PlanarYUV or IMCx) and
+// interleaves the chroma into an NVx stage.
+static void SeparateUV_to_NVx(Stage* in, int32_t in_y_stride, Stage* out, t_interleaveuvrow interleave)
+{
+    CopyYPlane(in->buf, in_y_stride, out->buf, out->stride, in->width, in->height, out->flipped || out->tiled);
+
+    uint8_t* first = out->u_index == 0 ? in->uplane : in->vplane;
+    uint8_t* second = out->u_index == 0 ? in->vplane : in->uplane;
+    uint8_t* out_uvplane = out->uvplane;
+    for (int32_t y = 0; y < in->uv_slice_height; y++)
+    {
+        interleave(first, second, out_uvplane, in->uv_width);
+        first += in->uv_stride;
+        second += in->uv_stride;
+        out_uvplane += out->uv_stride;
+    }
+}
+
+// Copies the Y plane of an NVx stage and splits its chroma into a 2x2 decimated stage with separate
+// U and V planes (PlanarYUV or IMCx).
+static void NVx_to_SeparateUV(Stage* in, Stage* out, int32_t out_y_stride, t_deinterleaveuvrow deinterleave)
+{
+    CopyYPlane(in->buf, in->stride, out->buf, out_y_stride, in->width, in->height, out->flipped || out->tiled);
+
+    uint8_t* in_uvplane = in->uvplane;
+    uint8_t* first = in->u_index == 0 ? out->uplane : out->vplane;
+    uint8_t* second = in->u_index == 0 ? out->vplane : out->uplane;
+    for (int32_t y = 0; y < out->uv_slice_height; y++)
+    {
+        deinterleave(in_uvplane, first, second, out->uv_width);
+        in_uvplane += in->uv_stride;
+        first += out->uv_stride;
+        second += out->uv_stride;
+    }
+}
+
+void blipvert::PlanarYUV_to_NVx_SSE41(Stage* in, Stage* out)
+{
+    if (in->decimation != 2)
+        PlanarYUV_to_NVx(in, out);
+    else
+        SeparateUV_to_NVx(in, in->y_stride, out, InterleaveUVRow_SSE41);
+}
+
+void blipvert::PlanarYUV_to_NVx_AVX2(Stage* in, Stage* out)
+{
+    if (in->decimation != 2)
+        PlanarYUV_to_NVx(in, out);
+    else
+        SeparateUV_to_NVx(in, in->y_stride, out, InterleaveUVRow_AVX2);
+}
+
+void blipvert::NVx_to_PlanarYUV_SSE41(Stage* in, Stage* out)
+{
+    if (out->decimation != 2)
+        NVx_to_PlanarYUV(in, out);
+    else
+        NVx_to_SeparateUV(in, out, out->y_stride, DeinterleaveUVRow_SSE41);
+}
+
+void blipvert::NVx_to_PlanarYUV_AVX2(Stage* in, Stage* out)
+{
+    if (out->decimation != 2)
+        NVx_to_PlanarYUV(in, out);
+    else
+        NVx_to_SeparateUV(in, out, out->y_stride, DeinterleaveUVRow_AVX2);
+}
+
+void blipvert::IMCx_to_NVx_SSE41(Stage* in, Stage* out)
+{
+    SeparateUV_to_NVx(in, in->stride, out, InterleaveUVRow_SSE41);
+}
+
+void blipvert::IMCx_to_NVx_AVX2(Stage* in, Stage* out)
+{
+    SeparateUV_to_NVx(in, in->stride, out, InterleaveUVRow_AVX2);
+}
+
+void blipvert::NVx_to_IMCx_SSE41(Stage* in, Stage* out)
+{
+    NVx_to_SeparateUV(in, out, out->stride, DeinterleaveUVRow_SSE41);
+}
+
+void blipvert::NVx_to_IMCx_AVX2(Stage* in, Stage* out)
+{
+    NVx_to_SeparateUV(in, out, out->stride, DeinterleaveUVRow_AVX2);
+}
+
+#endif
@@ -28,6 +28,7 @@
 
 #include "blipverttypes.h"
 #include "Staging.h"
+#include "CpuFeatures.h"
 
 namespace blipvert
 {
@@ -235,5 +236,28 @@ namespace blipvert
     void IUYV_to_UYVY(Stage* in, Stage* out);
     void IY41_to_Y41P(Stage* in, Stage* out);
     void Y41P_to_IY41(Stage* in, Stage* out);
+
+    // In-place packed Y422 swizzle. The input and output stages share one buffer, see FindInPlaceTransform().
+    void PackedY422_to_PackedY422_InPlace(Stage* in, Stage* out);
+
+#if defined(BLIPVERT_X86_SIMD)
+    // pshufb versions of the packed Y422 swizzles. Their output is identical to the generic versions.
+    // InitializeLibrary() selects them when the processor supports them.
+    void PackedY422_to_PackedY422_SSE41(Stage* in, Stage* out);
+    void PackedY422_to_PackedY422_AVX2(Stage* in, Stage* out);
+    void PackedY422_to_PackedY422_InPlace_SSE41(Stage* in, Stage* out);
+    void PackedY422_to_PackedY422_InPlace_AVX2(Stage* in, Stage* out);
+
+    // SSE4.1 and AVX2 versions of the NVx chroma interleave and deinterleave transforms. Their output is
+    // identical to the generic versions. InitializeLibrary() selects them when the processor supports them.
+    void PlanarYUV_to_NVx_SSE41(Stage* in, Stage* out);
+    void PlanarYUV_to_NVx_AVX2(Stage* in, Stage* out);
+    void NVx_to_PlanarYUV_SSE41(Stage* in, Stage* out);
+    void NVx_to_PlanarYUV_AVX2(Stage* in, Stage* out);
+    void IMCx_to_NVx_SSE41(Stage* in, Stage* out);
+    void IMCx_to_NVx_AVX2(Stage* in, Stage* out);
+    void NVx_to_IMCx_SSE41(Stage* in, Stage* out);
+    void NVx_to_IMCx_AVX2(Stage* in, Stage* out);
+#endif
 }
 
@@ -31,6 +31,7 @@
 #include "blipvert.h"
 #include "CommonMacros.h"
 #include "LookupTables.h"
+#include "CpuFeatures.h"
 
 #include "YUVtoRGB.h"
 #include "RGBtoYUV.h"
@@ -39,6 +40,8 @@
 #include "Utilities.h"
 
 #include <map>
+#include <unordered_map>
+#include <mutex>
 
 using namespace std;
 using namespace blipvert;
@@ -1169,6 +1172,35 @@ map<std::string, t_transformfunc> TransformMap = {
     { MVFMT_IY41 + MVFMT_Y41P, IY41_to_Y41P }
 };
 
+//
+// Transforms that convert a frame in its own buffer. The output of each one is no larger than its input.
+//
+
+map<std::string, t_transformfunc> InPlaceTransformMap = {
+    { MVFMT_RGBA + MVFMT_RGB32, RGBA_to_RGB32_InPlace },
+    { MVFMT_RGBA + MVFMT_RGB24, RGB32_to_RGB24_InPlace },
+    { MVFMT_RGB32 + MVFMT_RGBA, RGB32_to_RGBA_InPlace },
+    { MVFMT_RGB32 + MVFMT_RGB24, RGB32_to_RGB24_InPlace },
+
+    { MVFMT_RGB555 + MVFMT_RGB565, RGB555_to_RGB565_InPlace },
+    { MVFMT_ARGB1555 + MVFMT_RGB565, RGB555_to_RGB565_InPlace },
+    { MVFMT_RGB565 + MVFMT_RGB555, RGB565_to_RGB555_InPlace },
+    { MVFMT_RGB565 + MVFMT_ARGB1555, RGB565_to_RGB555_InPlace },
+
+    { MVFMT_YUY2 + MVFMT_UYVY, PackedY422_to_PackedY422_InPlace },
+    { MVFMT_YUY2 + MVFMT_YVYU, PackedY422_to_PackedY422_InPlace },
+    { MVFMT_YUY2 + MVFMT_VYUY, PackedY422_to_PackedY422_InPlace },
+    { MVFMT_UYVY + MVFMT_YUY2, PackedY422_to_PackedY422_InPlace },
+    { MVFMT_UYVY + MVFMT_YVYU, PackedY422_to_PackedY422_InPlace },
+    { MVFMT_UYVY + MVFMT_VYUY, PackedY422_to_PackedY422_InPlace },
+    { MVFMT_YVYU + MVFMT_YUY2, PackedY422_to_PackedY422_InPlace },
+    { MVFMT_YVYU + MVFMT_UYVY, PackedY422_to_PackedY422_InPlace },
+    { MVFMT_YVYU + MVFMT_VYUY, PackedY422_to_PackedY422_InPlace },
+    { MVFMT_VYUY + MVFMT_YUY2, PackedY422_to_PackedY422_InPlace },
+    { MVFMT_VYUY + MVFMT_UYVY, PackedY422_to_PackedY422_InPlace },
+    { MVFMT_VYUY + MVFMT_YVYU, PackedY422_to_PackedY422_InPlace }
+};
+
 map<MediaFormatID, t_greyscalefunc> GreyscaleMap = {
     { MVFMT_RGBA, RGBA_to_Greyscale },
     { MVFMT_RGB32, RGB32_to_Greyscale },
@@ -1203,6 +1235,40 @@ map<MediaFormatID, t_greyscalefunc> GreyscaleMap = {
     { MVFMT_YV16, YV16_to_Greyscale }
 };
 
+map<MediaFormatID, t_greyscaleslicefunc> GreyscaleSliceMap = {
+    { MVFMT_RGBA, RGBA_to_GreyscaleSlice },
+    { MVFMT_RGB32, RGB32_to_GreyscaleSlice },
+    { MVFMT_RGB24, RGB24_to_GreyscaleSlice },
+    { MVFMT_RGB565, RGB565_to_GreyscaleSlice },
+    { MVFMT_RGB555, RGB555_to_GreyscaleSlice },
+    { MVFMT_ARGB1555, RGB555_to_GreyscaleSlice },
+    { MVFMT_RGB8, RGB8_to_GreyscaleSlice },
+    { MVFMT_RGB4, RGB4_to_GreyscaleSlice },
+    { MVFMT_RGB1, RGB1_to_GreyscaleSlice },
+    { MVFMT_AYUV, AYUV_to_GreyscaleSlice },
+    { MVFMT_UYVY, UYVY_to_GreyscaleSlice },
+    { MVFMT_YVYU, YVYU_to_GreyscaleSlice },
+    { MVFMT_VYUY, VYUY_to_GreyscaleSlice },
+    { MVFMT_YUY2, YUY2_to_GreyscaleSlice },
+    { MVFMT_I420, I420_to_GreyscaleSlice },
+    { MVFMT_YV12, YV12_to_GreyscaleSlice },
+    { MVFMT_YVU9, YVU9_to_GreyscaleSlice },
+    { MVFMT_YUV9, YUV9_to_GreyscaleSlice },
+    { MVFMT_IYU1, IYU1_to_GreyscaleSlice },
+    { MVFMT_IYU2, IYU2_to_GreyscaleSlice },
+    { MVFMT_Y41P, Y41P_to_GreyscaleSlice },
+    { MVFMT_CLJR, CLJR_to_GreyscaleSlice },
+    { MVFMT_IMC1, IMC1_to_GreyscaleSlice },
+    { MVFMT_IMC2, IMC2_to_GreyscaleSlice },
+    { MVFMT_IMC3, IMC3_to_GreyscaleSlice },
+    { MVFMT_IMC4, IMC4_to_GreyscaleSlice },
+    { MVFMT_NV12, NV12_to_GreyscaleSlice },
+    { MVFMT_NV21, NV21_to_GreyscaleSlice },
+    { MVFMT_Y42T, Y42T_to_GreyscaleSlice },
+    { MVFMT_Y41T, Y41T_to_GreyscaleSlice },
+    { MVFMT_YV16, YV16_to_GreyscaleSlice }
+};
+
 map<MediaFormatID, t_fillcolorfunc> FillColorMap = {
     { MVFMT_RGBA, Fill_RGBA },
     { MVFMT_RGB32, Fill_RGB32 },
@@ -1338,6 +1404,39 @@ map<MediaFormatID, t_flipverticalfunc> FlipVerticalMap = {
     { MVFMT_YV16, FlipVertical_YV16 }
 };
 
+map<MediaFormatID, t_flipverticalslicefunc> FlipVerticalSliceMap = {
+    { MVFMT_RGBA, FlipVerticalSlice_RGBA },
+    { MVFMT_RGB32, FlipVerticalSlice_RGB32 },
+    { MVFMT_RGB24, FlipVerticalSlice_RGB24 },
+    { MVFMT_RGB565, FlipVerticalSlice_RGB565 },
+    { MVFMT_RGB555, FlipVerticalSlice_RGB555 },
+    { MVFMT_ARGB1555, FlipVerticalSlice_ARGB1555 },
+    { MVFMT_YUY2, FlipVerticalSlice_YUY2 },
+    { MVFMT_UYVY, FlipVerticalSlice_UYVY },
+    { MVFMT_YVYU, FlipVerticalSlice_YVYU },
+    { MVFMT_VYUY, FlipVerticalSlice_VYUY },
+    { MVFMT_I420, FlipVerticalSlice_I420 },
+    { MVFMT_YV12, FlipVerticalSlice_YV12 },
+    { MVFMT_YVU9, FlipVerticalSlice_YVU9 },
+    { MVFMT_YUV9, FlipVerticalSlice_YUV9 },
+    { MVFMT_IYU1, FlipVerticalSlice_IYU1 },
+    { MVFMT_IYU2, FlipVerticalSlice_IYU2 },
+    { MVFMT_Y800, FlipVerticalSlice_Y800 },
+    { MVFMT_Y16, FlipVerticalSlice_Y16 },
+    { MVFMT_Y41P, FlipVerticalSlice_Y41P },
+    { MVFMT_CLJR, FlipVerticalSlice_CLJR },
+    { MVFMT_AYUV, FlipVerticalSlice_AYUV },
+    { MVFMT_IMC1, FlipVerticalSlice_IMC1 },
+    { MVFMT_IMC2, FlipVerticalSlice_IMC2 },
+    { MVFMT_IMC3, FlipVerticalSlice_IMC3 },
+    { MVFMT_IMC4, FlipVerticalSlice_IMC4 },
+    { MVFMT_NV12, FlipVerticalSlice_NV12 },
+    { MVFMT_NV21, FlipVerticalSlice_NV21 },
+    { MVFMT_Y42T, FlipVerticalSlice_Y42T },
+    { MVFMT_Y41T, FlipVerticalSlice_Y41T },
+    { MVFMT_YV16, FlipVerticalSlice_YV16 }
+};
+
 VideoFormatInfo VideoFmtTable[] = {
     // Unpacked YUV formats:
     {MVFMT_AYUV, FOURCC_AYUV, FOURCC_UNDEFINED, 32, ColorspaceType::YUV, true},
@@ -1399,7 +1498,7 @@ VideoFormatInfo VideoFmtTable[] = {
     // I420 master format
     {MVFMT_I420, FOURCC_I420, FOURCC_I420, 12, ColorspaceType::YUV, false},
     {MVFMT_P420, FOURCC_P420, FOURCC_I420, 12, ColorspaceType::YUV, false},
-    {MVFMT_I420, FOURCC_I420, FOURCC_I420, 12, ColorspaceType::YUV, false},
+    {MVFMT_IYUV, FOURCC_IYUV, FOURCC_I420, 12, ColorspaceType::YUV, false},
     {MVFMT_CLPL, FOURCC_CLPL, FOURCC_I420, 12, ColorspaceType::YUV, false},
 
     // Planar YUV with no known duplicate definitions
@@ -1467,25 +1566,162 @@ map<MediaFormatID, t_stagetransformfunc> StagingMap = {
     { MVFMT_YV16, Stage_YV16 }
 };
 
-map<MediaFormatID, VideoFormatInfo*> MediaFormatInfoMap;
+//
+// Processor specific replacements for the generic transforms in TransformMap and InPlaceTransformMap.
+// InitializeLibrary() swaps in the fastest version the host processor supports.
+//
+
+typedef struct {
+    t_transformfunc generic;
+    t_transformfunc sse41;
+    t_transformfunc avx2;
+} SIMDTransform;
+
+#if defined(BLIPVERT_X86_SIMD)
+SIMDTransform SIMDTransformTable[] = {
+    { PackedY422_to_RGB32, PackedY422_to_RGB32_SSE41, PackedY422_to_RGB32_AVX2 },
+    { PackedY422_to_RGB24, PackedY422_to_RGB24_SSE41, PackedY422_to_RGB24_AVX2 },
+    { PackedY422_to_RGB565, PackedY422_to_RGB565_SSE41, PackedY422_to_RGB565_AVX2 },
+    { PackedY422_to_RGB555, PackedY422_to_RGB555_SSE41, PackedY422_to_RGB555_AVX2 },
+    { RGB32_to_PlanarYUV, RGB32_to_PlanarYUV_SSE41, RGB32_to_PlanarYUV_AVX2 },
+    { RGB24_to_PlanarYUV, RGB24_to_PlanarYUV_SSE41, RGB24_to_PlanarYUV_AVX2 },
+    { RGB24_to_RGB32, RGB24_to_RGB32_SSE41, nullptr },
+    { RGB32_to_RGB24, RGB32_to_RGB24_SSE41, nullptr },
+    { RGB32_to_RGB565, RGB32_to_RGB565_SSE41, nullptr },
+    { RGB32_to_RGB555, RGB32_to_RGB555_SSE41, nullptr },
+    { RGB565_to_RGB32, RGB565_to_RGB32_SSE41, nullptr },
+    { RGB555_to_RGB32, RGB555_to_RGB32_SSE41, nullptr },
+    { RGB8_to_RGB32, nullptr, RGB8_to_RGB32_AVX2 },
+    { RGBA_to_RGB32_InPlace, RGBA_to_RGB32_InPlace_SSE41, nullptr },
+    { RGB32_to_RGB24_InPlace, RGB32_to_RGB24_InPlace_SSE41, nullptr },
+    { RGB555_to_RGB565_InPlace, RGB555_to_RGB565_InPlace_SSE41, nullptr },
+    { RGB565_to_RGB555_InPlace, RGB565_to_RGB555_InPlace_SSE41, nullptr },
+    { PackedY422_to_PackedY422, PackedY422_to_PackedY422_SSE41, PackedY422_to_PackedY422_AVX2 },
+    { PlanarYUV_to_NVx, PlanarYUV_to_NVx_SSE41, PlanarYUV_to_NVx_AVX2 },
+    { NVx_to_PlanarYUV, NVx_to_PlanarYUV_SSE41, NVx_to_PlanarYUV_AVX2 },
+    { IMCx_to_NVx, IMCx_to_NVx_SSE41, IMCx_to_NVx_AVX2 },
+    { NVx_to_IMCx, NVx_to_IMCx_SSE41, NVx_to_IMCx_AVX2 },
+    { PackedY422_to_PackedY422_InPlace, PackedY422_to_PackedY422_InPlace_SSE41, PackedY422_to_PackedY422_InPlace_AVX2 },
+    { nullptr, nullptr, nullptr }
+};
+#else
+SIMDTransform SIMDTransformTable[] = {
+    { nullptr, nullptr, nullptr }
+};
+#endif
+
+static void SelectSIMDTransforms(map<std::string, t_transformfunc>& transforms)
+{
+    const CpuFeatures& features = GetCpuFeatures();
+    for (auto& entry : transforms)
+    {
+        for (uint16_t index = 0; SIMDTransformTable[index].generic != nullptr; index++)
+        {
+            SIMDTransform& simd = SIMDTransformTable[index];
+            if (entry.second != simd.generic)
+                continue;
+
+            if (features.avx2 && simd.avx2 != nullptr)
+                entry.second = simd.avx2;
+            else if (features.sse41 && simd.sse41 != nullptr)
+                entry.second = simd.sse41;
+            break;
+        }
+    }
+}
+
+//
+// Dense dispatch tables indexed by FormatIndex. These are filled from the maps above by
+// InitializeLibrary(), with the cross-referenced (duplicate) formats already resolved, so
+// the Find* functions are a hash lookup of the format ID followed by an array index.
+//
+
+const FormatIndex FormatCount = static_cast<FormatIndex>(sizeof(VideoFmtTable) / sizeof(VideoFmtTable[0]));
+
+unordered_map<MediaFormatID, FormatIndex> FormatIndexMap;
 map<Fourcc, const MediaFormatID> FourccToIDMap;
 
-bool blipvert::IsInitialized = false;
+FormatIndex XRefIndexTable[FormatCount];
+t_transformfunc TransformTable[FormatCount][FormatCount];
+t_transformfunc InPlaceTransformTable[FormatCount][FormatCount];
+t_greyscalefunc GreyscaleTable[FormatCount];
+t_greyscaleslicefunc GreyscaleSliceTable[FormatCount];
+t_fillcolorfunc FillColorTable[FormatCount];
+t_setpixelfunc SetPixelTable[FormatCount];
+t_flipverticalfunc FlipVerticalTable[FormatCount];
+t_flipverticalslicefunc FlipVerticalSliceTable[FormatCount];
+t_calcbuffsizefunc CalcBufSizeTable[FormatCount];
+t_stagetransformfunc StagingTable[FormatCount];
+
+template <typename T>
+static void BuildFormatTable(map<MediaFormatID, T>& source, T* table)
+{
+    for (FormatIndex index = 0; index < FormatCount; index++)
+    {
+        table[index] = nullptr;
+
+        typename map<MediaFormatID, T>::iterator it = source.find(VideoFmtTable[index].formatId);
+        if (it == source.end() && XRefIndexTable[index] != FORMAT_INDEX_UNDEFINED)
+        {
+            // Not found, so try the cross-referenced format in case there's a known duplicate definition.
+            it = source.find(VideoFmtTable[XRefIndexTable[index]].formatId);
+        }
+
+        if (it != source.end())
+        {
+            table[index] = it->second;
+        }
+    }
+}
+
+static void BuildTransformTable(map<std::string, t_transformfunc>& source, t_transformfunc table[][FormatCount])
+{
+    for (FormatIndex in = 0; in < FormatCount; in++)
+    {
+        for (FormatIndex out = 0; out < FormatCount; out++)
+        {
+            table[in][out] = nullptr;
+
+            map<MediaFormatID, t_transformfunc>::iterator it = source.find(VideoFmtTable[in].formatId + VideoFmtTable[out].formatId);
+            if (it == source.end())
+            {
+                // Not found, so try cross-referenced formats in case either one is a known duplicate definition.
+                FormatIndex xref_in = XRefIndexTable[in] != FORMAT_INDEX_UNDEFINED ? XRefIndexTable[in] : in;
+                FormatIndex xref_out = XRefIndexTable[out] != FORMAT_INDEX_UNDEFINED ? XRefIndexTable[out] : out;
+                it = source.find(VideoFmtTable[xref_in].formatId + VideoFmtTable[xref_out].formatId);
+            }
+
+            if (it != source.end())
+            {
+                table[in][out] = it->second;
+            }
+        }
+    }
+}
+
+atomic<bool> blipvert::IsInitialized(false);
 bool blipvert::IsBigEndian = false;
 
-void blipvert::InitializeLibrary(void)
+static once_flag InitializeOnce;
+
+static void InitializeOnceImpl(void)
 {
+    // The lookup tables are generated at compile time, so all that's left to build here are the format maps
+    // and the dispatch tables.
+
     // Note the endianess of the processor.
     uint16_t value = 0x0102;
     uint8_t* ptr = reinterpret_cast<uint8_t*>(&value);
     IsBigEndian =  ptr[0] == 0x01;
 
-    InitLookupTables();
+    DetectCpuFeatures();
+    SelectSIMDTransforms(TransformMap);
+    SelectSIMDTransforms(InPlaceTransformMap);
 
-    uint16_t index = 0;
+    FormatIndex index = 0;
     while (VideoFmtTable[index].formatId != MVFMT_UNDEFINED)
     {
-        MediaFormatInfoMap.insert(make_pair(VideoFmtTable[index].formatId, &VideoFmtTable[index]));
+        FormatIndexMap.insert(make_pair(VideoFmtTable[index].formatId, index));
 
         if (VideoFmtTable[index].fourcc != FOURCC_UNDEFINED)
         {
@@ -1495,187 +1731,158 @@ void blipvert::InitializeLibrary(void)
         index++;
     }
 
-    IsInitialized = true;
-}
-
-
-t_transformfunc blipvert::FindVideoTransform(const MediaFormatID& inFormat, const MediaFormatID& outFormat)
-{
-    MediaFormatID key = inFormat + outFormat;
-    map<MediaFormatID, t_transformfunc>::iterator it = TransformMap.find(key);
-    if (it != TransformMap.end())
+    for (index = 0; index < FormatCount; index++)
     {
-        return *(it->second);
-    }
-
-    // Not found, so try cross-referenced formats in case there's a known duplicate definition.
+        XRefIndexTable[index] = FORMAT_INDEX_UNDEFINED;
 
-    VideoFormatInfo inInfo;
-    VideoFormatInfo outInfo;
-    if (GetVideoFormatInfo(inFormat, inInfo) &&
-        GetVideoFormatInfo(outFormat, outInfo))
-    {
-        MediaFormatID inid;
-        MediaFormatID outid;
-        if (GetVideoFormatID(inInfo.xRefFourcc, inid) && GetVideoFormatID(outInfo.xRefFourcc, outid))
+        map<Fourcc, const MediaFormatID>::iterator it = FourccToIDMap.find(VideoFmtTable[index].xRefFourcc);
+        if (it != FourccToIDMap.end())
         {
-            key = inid + outid;
-            map<MediaFormatID, t_transformfunc>::iterator it = TransformMap.find(key);
-            if (it != TransformMap.end())
-            {
-                return *(it->second);
-            }
+            XRefIndexTable[index] = GetFormatIndex(it->second);
         }
     }
 
-    return nullptr;
+    BuildTransformTable(TransformMap, TransformTable);
+    BuildTransformTable(InPlaceTransformMap, InPlaceTransformTable);
+    BuildFormatTable(GreyscaleMap, GreyscaleTable);
+    BuildFormatTable(GreyscaleSliceMap, GreyscaleSliceTable);
+    BuildFormatTable(FillColorMap, FillColorTable);
+    BuildFormatTable(SetPixelMap, SetPixelTable);
+    BuildFormatTable(FlipVerticalMap, FlipVerticalTable);
+    BuildFormatTable(FlipVerticalSliceMap, FlipVerticalSliceTable);
+    BuildFormatTable(CalcBufSizeMap, CalcBufSizeTable);
+    BuildFormatTable(StagingMap, StagingTable);
+
+    IsInitialized.store(true, memory_order_release);
 }
 
-t_greyscalefunc blipvert::FindGreyscaleTransform(const MediaFormatID& inFormat)
+void blipvert::InitializeLibrary(void)
 {
-    map<MediaFormatID, t_greyscalefunc>::iterator it = GreyscaleMap.find(inFormat);
-    if (it != GreyscaleMap.end())
+    call_once(InitializeOnce, InitializeOnceImpl);
+}
+
+FormatIndex blipvert::GetFormatIndex(const MediaFormatID& format)
+{
+    unordered_map<MediaFormatID, FormatIndex>::iterator it = FormatIndexMap.find(format);
+    if (it != FormatIndexMap.end())
     {
-        return *(it->second);
+        return it->second;
     }
 
-    // Not found, so try cross-referenced formats in case there's a known duplicate definition.
+    return FORMAT_INDEX_UNDEFINED;
+}
 
-    VideoFormatInfo inInfo;
-    if (GetVideoFormatInfo(inFormat, inInfo))
-    {
-        MediaFormatID inid;
-        if (GetVideoFormatID(inInfo.xRefFourcc, inid))
-        {
-            map<MediaFormatID, t_greyscalefunc>::iterator it = GreyscaleMap.find(inid);
-            if (it != GreyscaleMap.end())
-            {
-                return *(it->second);
-            }
-        }
-    }
+static inline bool IsValidFormatIndex(FormatIndex index)
+{
+    return index >= 0 && index < FormatCount;
+}
 
-    return nullptr;
+t_transformfunc blipvert::FindVideoTransform(FormatIndex inFormat, FormatIndex outFormat)
+{
+    if (!IsValidFormatIndex(inFormat) || !IsValidFormatIndex(outFormat))
+        return nullptr;
+
+    return TransformTable[inFormat][outFormat];
 }
 
-t_fillcolorfunc blipvert::FindFillColorTransform(const MediaFormatID& inFormat)
+t_transformfunc blipvert::FindVideoTransform(const MediaFormatID& inFormat, const MediaFormatID& outFormat)
 {
-    map<MediaFormatID, t_fillcolorfunc>::iterator it = FillColorMap.find(inFormat);
-    if (it != FillColorMap.end())
-    {
-        return *(it->second);
-    }
+    return FindVideoTransform(GetFormatIndex(inFormat), GetFormatIndex(outFormat));
+}
 
-    // Not found, so try cross-referenced formats in case there's a known duplicate definition.
+t_transformfunc blipvert::FindInPlaceTransform(FormatIndex inFormat, FormatIndex outFormat)
+{
+    if (!IsValidFormatIndex(inFormat) || !IsValidFormatIndex(outFormat))
+        return nullptr;
 
-    VideoFormatInfo inInfo;
-    if (GetVideoFormatInfo(inFormat, inInfo))
-    {
-        MediaFormatID inid;
-        if (GetVideoFormatID(inInfo.xRefFourcc, inid))
-        {
-            map<MediaFormatID, t_fillcolorfunc>::iterator it = FillColorMap.find(inid);
-            if (it != FillColorMap.end())
-            {
-                return *(it->second);
-            }
-        }
-    }
+    return InPlaceTransformTable[inFormat][outFormat];
+}
 
-    return nullptr;
+t_transformfunc blipvert::FindInPlaceTransform(const MediaFormatID& inFormat, const MediaFormatID& outFormat)
+{
+    return FindInPlaceTransform(GetFormatIndex(inFormat), GetFormatIndex(outFormat));
 }
 
-t_setpixelfunc blipvert::FindSetPixelColor(const MediaFormatID& inFormat)
+t_greyscalefunc blipvert::FindGreyscaleTransform(FormatIndex inFormat)
 {
-    map<MediaFormatID, t_setpixelfunc>::iterator it = SetPixelMap.find(inFormat);
-    if (it != SetPixelMap.end())
-    {
-        return *(it->second);
-    }
+    return IsValidFormatIndex(inFormat) ? GreyscaleTable[inFormat] : nullptr;
+}
 
-    // Not found, so try cross-referenced formats in case there's a known duplicate definition.
+t_greyscalefunc blipvert::FindGreyscaleTransform(const MediaFormatID& inFormat)
+{
+    return FindGreyscaleTransform(GetFormatIndex(inFormat));
+}
 
-    VideoFormatInfo inInfo;
-    if (GetVideoFormatInfo(inFormat, inInfo))
-    {
-        MediaFormatID inid;
-        if (GetVideoFormatID(inInfo.xRefFourcc, inid))
-        {
-            map<MediaFormatID, t_setpixelfunc>::iterator it = SetPixelMap.find(inid);
-            if (it != SetPixelMap.end())
-            {
-                return *(it->second);
-            }
-        }
-    }
+t_greyscaleslicefunc blipvert::FindGreyscaleSliceTransform(FormatIndex inFormat)
+{
+    return IsValidFormatIndex(inFormat) ? GreyscaleSliceTable[inFormat] : nullptr;
+}
 
-    return nullptr;
+t_greyscaleslicefunc blipvert::FindGreyscaleSliceTransform(const MediaFormatID& inFormat)
+{
+    return FindGreyscaleSliceTransform(GetFormatIndex(inFormat));
 }
 
-t_flipverticalfunc blipvert::FindFlipVerticalTransform(const MediaFormatID& inFormat)
+t_fillcolorfunc blipvert::FindFillColorTransform(FormatIndex inFormat)
 {
-    map<MediaFormatID, t_flipverticalfunc>::iterator it = FlipVerticalMap.find(inFormat);
-    if (it != FlipVerticalMap.end())
-    {
-        return *(it->second);
-    }
+    return IsValidFormatIndex(inFormat) ? FillColorTable[inFormat] : nullptr;
+}
 
-    // Not found, so try cross-referenced formats in case there's a known duplicate definition.
+t_fillcolorfunc blipvert::FindFillColorTransform(const MediaFormatID& inFormat)
+{
+    return FindFillColorTransform(GetFormatIndex(inFormat));
+}
 
-    VideoFormatInfo inInfo;
-    if (GetVideoFormatInfo(inFormat, inInfo))
-    {
-        MediaFormatID inid;
-        if (GetVideoFormatID(inInfo.xRefFourcc, inid))
-        {
-            map<MediaFormatID, t_flipverticalfunc>::iterator it = FlipVerticalMap.find(inid);
-            if (it != FlipVerticalMap.end())
-            {
-                return *(it->second);
-            }
-        }
-    }
+t_setpixelfunc blipvert::FindSetPixelColor(FormatIndex inFormat)
+{
+    return IsValidFormatIndex(inFormat) ? SetPixelTable[inFormat] : nullptr;
+}
 
-    return nullptr;
+t_setpixelfunc blipvert::FindSetPixelColor(const MediaFormatID& inFormat)
+{
+    return FindSetPixelColor(GetFormatIndex(inFormat));
 }
 
-t_calcbuffsizefunc blipvert::FindBufSizeCalculator(const MediaFormatID& inFormat)
+t_flipverticalfunc blipvert::FindFlipVerticalTransform(FormatIndex inFormat)
 {
-    map<MediaFormatID, t_calcbuffsizefunc>::iterator it = CalcBufSizeMap.find(inFormat);
-    if (it != CalcBufSizeMap.end())
-    {
-        return *(it->second);
-    }
+    return IsValidFormatIndex(inFormat) ? FlipVerticalTable[inFormat] : nullptr;
+}
 
-    // Not found, so try cross-referenced formats in case there's a known duplicate definition.
+t_flipverticalfunc blipvert::FindFlipVerticalTransform(const MediaFormatID& inFormat)
+{
+    return FindFlipVerticalTransform(GetFormatIndex(inFormat));
+}
 
-    VideoFormatInfo inInfo;
-    if (GetVideoFormatInfo(inFormat, inInfo))
-    {
-        MediaFormatID inid;
-        if (GetVideoFormatID(inInfo.xRefFourcc, inid))
-        {
-            map<MediaFormatID, t_calcbuffsizefunc>::iterator it = CalcBufSizeMap.find(inid);
-            if (it != CalcBufSizeMap.end())
-            {
-                return *(it->second);
-            }
-        }
-    }
+t_flipverticalslicefunc blipvert::FindFlipVerticalSliceTransform(FormatIndex inFormat)
+{
+    return IsValidFormatIndex(inFormat) ? FlipVerticalSliceTable[inFormat] : nullptr;
+}
+
+t_flipverticalslicefunc blipvert::FindFlipVerticalSliceTransform(const MediaFormatID& inFormat)
+{
+    return FindFlipVerticalSliceTransform(GetFormatIndex(inFormat));
+}
+
+t_calcbuffsizefunc blipvert::FindBufSizeCalculator(FormatIndex inFormat)
+{
+    return IsValidFormatIndex(inFormat) ? CalcBufSizeTable[inFormat] : nullptr;
+}
 
-    return nullptr;
+t_calcbuffsizefunc blipvert::FindBufSizeCalculator(const MediaFormatID& inFormat)
+{
+    return FindBufSizeCalculator(GetFormatIndex(inFormat));
 }
 
 bool blipvert::GetVideoFormatInfo(const MediaFormatID& format, VideoFormatInfo& info)
 {
-    map<MediaFormatID, VideoFormatInfo*>::iterator it = MediaFormatInfoMap.find(format);
-    if (it != MediaFormatInfoMap.end())
+    FormatIndex index = GetFormatIndex(format);
+    if (index != FORMAT_INDEX_UNDEFINED)
     {
-        info.fourcc = it->second->fourcc;
-        info.xRefFourcc = it->second->xRefFourcc;
-        info.effectiveBitsPerPixel = it->second->effectiveBitsPerPixel;
-        info.type = it->second->type;
-        info.hasAlpha = it->second->hasAlpha;
+        info.fourcc = VideoFmtTable[index].fourcc;
+        info.xRefFourcc = VideoFmtTable[index].xRefFourcc;
+        info.effectiveBitsPerPixel = VideoFmtTable[index].effectiveBitsPerPixel;
+        info.type = VideoFmtTable[index].type;
+        info.hasAlpha = VideoFmtTable[index].hasAlpha;
 
         return true;
     }
@@ -1696,29 +1903,29 @@ bool blipvert::GetVideoFormatID(Fourcc fourcc, MediaFormatID& outFormat)
     return false;
 }
 
-t_stagetransformfunc blipvert::FindTransformStage(const MediaFormatID& format)
+void blipvert::GetTransformFormatPairs(vector<pair<MediaFormatID, MediaFormatID>>& pairs)
 {
-    map<MediaFormatID, t_stagetransformfunc>::iterator it = StagingMap.find(format);
-    if (it != StagingMap.end())
+    pairs.clear();
+    for (FormatIndex in = 0; in < FormatCount; in++)
     {
-        return *(it->second);
-    }
-
-    // Not found, so try cross-referenced formats in case there's a known duplicate definition.
-
-    VideoFormatInfo inInfo;
-    if (GetVideoFormatInfo(format, inInfo))
-    {
-        MediaFormatID inid;
-        if (GetVideoFormatID(inInfo.xRefFourcc, inid))
+        for (FormatIndex out = 0; out < FormatCount; out++)
         {
-            map<MediaFormatID, t_stagetransformfunc>::iterator it = StagingMap.find(inid);
-            if (it != StagingMap.end())
+            // A format listed more than once in VideoFmtTable is only reported for its first entry.
+            if (GetFormatIndex(VideoFmtTable[in].formatId) == in && GetFormatIndex(VideoFmtTable[out].formatId) == out &&
+                TransformMap.find(VideoFmtTable[in].formatId + VideoFmtTable[out].formatId) != TransformMap.end())
             {
-                return *(it->second);
+                pairs.push_back(make_pair(VideoFmtTable[in].formatId, VideoFmtTable[out].formatId));
             }
         }
     }
+}
 
-    return nullptr;
+t_stagetransformfunc blipvert::FindTransformStage(FormatIndex format)
+{
+    return IsValidFormatIndex(format) ? StagingTable[format] : nullptr;
+}
+
+t_stagetransformfunc blipvert::FindTransformStage(const MediaFormatID& format)
+{
+    return FindTransformStage(GetFormatIndex(format));
 }
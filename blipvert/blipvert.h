@@ -36,6 +36,8 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include <atomic>
+#include <utility>
 
 namespace blipvert
 {
@@ -189,7 +191,15 @@ namespace blipvert
     extern const MediaFormatID MVFMT_RGBT;
     extern const MediaFormatID MVFMT_RGB_BITFIELDS;
 
-    extern bool IsInitialized;      // true / false that the library has been initialized.
+    //
+    // Interned handle for a media format. It's the position of the format in the library's format table
+    // and stays the same for the life of the process. The FormatIndex versions of the Find* functions
+    // resolve with a single table index, so they are the ones to use when transforms are looked up often.
+    //
+    typedef int16_t FormatIndex;
+    const FormatIndex FORMAT_INDEX_UNDEFINED = -1;
+
+    extern std::atomic<bool> IsInitialized;     // true / false that the library has been initialized.
     extern bool IsBigEndian;        // true indicates running on a big endian processor.
 
     //
@@ -198,7 +208,9 @@ namespace blipvert
     typedef void(__cdecl* t_transformfunc) (Stage* in, Stage* out);
 
 
-    // IMPORTANT: This must be called before using any of the colorspace transforms since it initializes the lookup tables.
+    // IMPORTANT: This must be called before using any of the colorspace transforms since it builds the dispatch tables.
+    // It's safe to call more than once and from more than one thread; only the first call does any work and the
+    // others wait for it to finish.
     void InitializeLibrary(void);
 
     // Finds a video transform for the given input / output media formats.
@@ -207,12 +219,25 @@ namespace blipvert
     //       definition name will be used if a duplicate format was requested.
     t_transformfunc FindVideoTransform(const MediaFormatID& inFormat, const MediaFormatID& outFormat);
 
+    // Finds a video transform that converts a frame in its own buffer, so no second frame buffer is needed.
+    // Stage the input and the output on the same buffer, flipped the same way, with an output stride no larger
+    // than the input stride. A frame can be cut into slices only if the strides are equal.
+    // Returns a t_transformfunc pointer for the requested transform function. Retuns nullptr if the formats can't
+    // be converted in place.
+    // Note: Since there exists duplicate fourcc definitions for the same bitmap format, the main 
+    //       definition name will be used if a duplicate format was requested.
+    t_transformfunc FindInPlaceTransform(const MediaFormatID& inFormat, const MediaFormatID& outFormat);
+
     // Finds a greyscale video transform for the given input media format.
     // Returns a t_greyscalefunc pointer for the requested transform function. Retuns nullptr if a match couldn't be found.
     // Note: Since there exists duplicate fourcc definitions for the same bitmap format, the main 
     //       definition name will be used if a duplicate format was requested.
     t_greyscalefunc FindGreyscaleTransform(const MediaFormatID& inFormat);
 
+    // Finds the sliced version of the greyscale transform for the given input media format, see t_greyscaleslicefunc.
+    // Returns a t_greyscaleslicefunc pointer for the requested function. Retuns nullptr if a match couldn't be found.
+    t_greyscaleslicefunc FindGreyscaleSliceTransform(const MediaFormatID& inFormat);
+
     // Finds a color fill video transform for the given input media format.
     // Returns a t_fillcolorfunc pointer for the requested transform function. Retuns nullptr if a match couldn't be found.
     // Note: Since there exists duplicate fourcc definitions for the same bitmap format, the main 
@@ -231,6 +256,10 @@ namespace blipvert
     //       definition name will be used if a duplicate format was requested.
     t_flipverticalfunc FindFlipVerticalTransform(const MediaFormatID& inFormat);
 
+    // Finds the sliced version of the vertical flip for the given input media format, see t_flipverticalslicefunc.
+    // Returns a t_flipverticalslicefunc pointer for the requested function. Retuns nullptr if a match couldn't be found.
+    t_flipverticalslicefunc FindFlipVerticalSliceTransform(const MediaFormatID& inFormat);
+
     // Finds a buffer size calculation function for the given format.
     // Returns a t_calcbuffsizefunc pointer for the requested transform function. Retuns nullptr if a match couldn't be found.
     // Note: Since there exists duplicate fourcc definitions for the same bitmap format, the main 
@@ -243,6 +272,22 @@ namespace blipvert
     //       definition name will be used if a duplicate format was requested.
     t_stagetransformfunc FindTransformStage(const MediaFormatID& format);
 
+    // Returns the interned FormatIndex of the given media format, or FORMAT_INDEX_UNDEFINED if the format isn't known.
+    FormatIndex GetFormatIndex(const MediaFormatID& format);
+
+    // FormatIndex versions of the functions above. They never allocate, and duplicate formats are resolved
+    // once by InitializeLibrary() instead of on every call.
+    t_transformfunc FindVideoTransform(FormatIndex inFormat, FormatIndex outFormat);
+    t_transformfunc FindInPlaceTransform(FormatIndex inFormat, FormatIndex outFormat);
+    t_greyscalefunc FindGreyscaleTransform(FormatIndex inFormat);
+    t_greyscaleslicefunc FindGreyscaleSliceTransform(FormatIndex inFormat);
+    t_fillcolorfunc FindFillColorTransform(FormatIndex inFormat);
+    t_setpixelfunc FindSetPixelColor(FormatIndex inFormat);
+    t_flipverticalfunc FindFlipVerticalTransform(FormatIndex inFormat);
+    t_flipverticalslicefunc FindFlipVerticalSliceTransform(FormatIndex inFormat);
+    t_calcbuffsizefunc FindBufSizeCalculator(FormatIndex inFormat);
+    t_stagetransformfunc FindTransformStage(FormatIndex format);
+
     // Returns information about the given video format.
     //
     // Parameters:
@@ -258,4 +303,11 @@ namespace blipvert
     //      outFormat:      OUT -> The MediaFormatID that matches the fourcc code.
     // Returns true if a match was found, false otherwise.
     bool GetVideoFormatID(Fourcc fourcc, MediaFormatID& outFormat);
+
+    // Lists the input / output format pairs that have a transform of their own. Duplicate format names that
+    // resolve to one of these aren't included.
+    //
+    // Parameters:
+    //      pairs:          OUT -> The (input, output) format pairs.
+    void GetTransformFormatPairs(std::vector<std::pair<MediaFormatID, MediaFormatID>>& pairs);
 }
\ No newline at end of file
@@ -28,6 +28,13 @@
 //
 
 #include <string>
+#include <cstdint>
+
+// The function pointer types are declared __cdecl for Visual C++. Other compilers only have the one calling
+// convention on the targets the library builds for.
+#if !defined(_MSC_VER) && !defined(__cdecl)
+#define __cdecl
+#endif
 
 namespace blipvert
 {